@@ -0,0 +1,380 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\host_test\audio_replay.c
+ * @Description: WAV 回放工具：把录音送入完整的音频管理器（参考 AFE 引擎），统计事件时延与每帧 CPU
+ *
+ * 用法：
+ *   audio_replay [选项] <file.wav>     16 kHz / 16 bit PCM，1~4 通道（作为麦克风通道）
+ *   audio_replay [选项] --synth        合成信号：两次“唤醒词”包络 + 一段持续人声
+ * 选项：
+ *   --speed X          回放倍速（默认 1 = 实时）；过快时引擎结果队列来不及取出会拒收帧（见汇总）
+ *   --wake S:L         用 [S, S+L) 毫秒的能量包络作为参考引擎的唤醒模板
+ *   --sensitivity N    唤醒灵敏度 0..3（默认 2）
+ *   --vad-mode N       VAD 模式 0..4（默认 2）
+ *   --expect-wake N    唤醒事件少于 N 次时返回失败（用于 ctest）
+ *   --expect-vad N     VAD 开始事件少于 N 次时返回失败
+ */
+#include "audio_manager.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_SAMPLE_RATE      16000
+#define REPLAY_MAX_CHANNELS     4
+#define REPLAY_FRAME_SAMPLES    256     ///< 与参考引擎每帧采样点数一致（模板按此分帧）
+#define REPLAY_MAX_EVENTS       256
+#define REPLAY_TEMPLATE_MAX     128
+
+typedef struct {
+    audio_mgr_event_type_t type;
+    int64_t wall_us;                ///< 事件送达应用的时间（相对回放开始）
+    uint32_t audio_ms;              ///< 事件送达时已送入的音频位置
+    uint32_t afe_latency_us;        ///< 帧送入引擎 → AFE 事件回调
+} replay_event_t;
+
+typedef struct {
+    int16_t *pcm;                   ///< 按帧交织
+    size_t frames;
+    size_t channels;
+    volatile size_t pos;            ///< 已送出的每通道采样点数
+    double speed;                   ///< 回放倍速
+    int64_t start_us;
+    volatile bool done;
+
+    replay_event_t events[REPLAY_MAX_EVENTS];
+    volatile uint32_t event_count;
+} replay_ctx_t;
+
+static replay_ctx_t s_replay;
+
+/*********************
+ * 输入
+ *********************/
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static bool load_wav(const char *path, replay_ctx_t *ctx)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "无法打开 %s\n", path);
+        return false;
+    }
+
+    uint8_t hdr[12];
+    if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "%s 不是 WAV 文件\n", path);
+        fclose(f);
+        return false;
+    }
+
+    bool have_fmt = false;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, 8, f) == 8) {
+        uint32_t size = read_le32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, f) != 16) {
+                break;
+            }
+            fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+            uint16_t format = read_le16(fmt);
+            ctx->channels = read_le16(fmt + 2);
+            uint32_t rate = read_le32(fmt + 4);
+            uint16_t bits = read_le16(fmt + 14);
+            if (format != 1 || bits != 16 || rate != REPLAY_SAMPLE_RATE ||
+                ctx->channels == 0 || ctx->channels > REPLAY_MAX_CHANNELS) {
+                fprintf(stderr, "只支持 16 kHz / 16 bit PCM / 1~%d 通道（当前 fmt=%u rate=%u bits=%u ch=%u）\n",
+                        REPLAY_MAX_CHANNELS, format, (unsigned)rate, bits, (unsigned)ctx->channels);
+                break;
+            }
+            have_fmt = true;
+        } else if (memcmp(chunk, "data", 4) == 0 && have_fmt) {
+            ctx->frames = size / (2 * ctx->channels);
+            ctx->pcm = malloc(ctx->frames * ctx->channels * sizeof(int16_t));
+            if (!ctx->pcm || fread(ctx->pcm, 2 * ctx->channels, ctx->frames, f) != ctx->frames) {
+                fprintf(stderr, "读取音频数据失败\n");
+                break;
+            }
+            fclose(f);
+            return true;
+        } else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return false;
+}
+
+/** 合成一段带包络的谐波音 */
+static void synth_burst(int16_t *pcm, size_t start, size_t len, float freq, float amp)
+{
+    for (size_t i = 0; i < len; i++) {
+        float t = (float)i / REPLAY_SAMPLE_RATE;
+        float env = sinf((float)M_PI * (float)i / (float)len);
+        float v = sinf(2.0f * (float)M_PI * freq * t) + 0.5f * sinf(4.0f * (float)M_PI * freq * t);
+        int32_t s = pcm[start + i] + (int32_t)(amp * env * v * 20000.0f);
+        pcm[start + i] = (int16_t)(s > 32767 ? 32767 : (s < -32768 ? -32768 : s));
+    }
+}
+
+/**
+ * @brief 合成 8 秒测试信号
+ *
+ * 底噪约 -50 dBFS；1.0 s 与 5.0 s 处各一个三音节“唤醒词”（约 0.7 s），
+ * 2.5 s ~ 3.7 s 为一段持续“人声”。唤醒模板取第一个唤醒词。
+ */
+static void synth_signal(replay_ctx_t *ctx, uint32_t *wake_start_ms, uint32_t *wake_len_ms)
+{
+    ctx->channels = 1;
+    ctx->frames = 8 * REPLAY_SAMPLE_RATE;
+    ctx->pcm = calloc(ctx->frames, sizeof(int16_t));
+
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < ctx->frames; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        ctx->pcm[i] = (int16_t)((int32_t)(seed >> 16) % 200 - 100);
+    }
+
+    const uint32_t wake_at_ms[] = {1000, 5000};
+    for (size_t w = 0; w < 2; w++) {
+        size_t base = wake_at_ms[w] * REPLAY_SAMPLE_RATE / 1000;
+        synth_burst(ctx->pcm, base, 3200, 300.0f, 0.9f);                 // 200 ms
+        synth_burst(ctx->pcm, base + 4800, 2400, 450.0f, 0.3f);          // 150 ms
+        synth_burst(ctx->pcm, base + 8800, 2400, 350.0f, 0.8f);          // 150 ms
+    }
+    for (size_t k = 0; k < 6; k++) {
+        synth_burst(ctx->pcm, (2500 + k * 200) * REPLAY_SAMPLE_RATE / 1000, 3400, 220.0f + k * 30.0f, 0.5f);
+    }
+
+    *wake_start_ms = 1000;
+    *wake_len_ms = 720;
+}
+
+/** 与参考引擎相同的每帧对数能量，作为唤醒模板 */
+static size_t build_template(const replay_ctx_t *ctx, uint32_t start_ms, uint32_t len_ms, float *tmpl)
+{
+    size_t first = (size_t)start_ms * REPLAY_SAMPLE_RATE / 1000 / REPLAY_FRAME_SAMPLES;
+    size_t count = (size_t)len_ms * REPLAY_SAMPLE_RATE / 1000 / REPLAY_FRAME_SAMPLES;
+    size_t n = 0;
+    for (size_t f = first; f < first + count && n < REPLAY_TEMPLATE_MAX; f++) {
+        if ((f + 1) * REPLAY_FRAME_SAMPLES > ctx->frames) {
+            break;
+        }
+        float acc = 0.0f;
+        for (size_t i = 0; i < REPLAY_FRAME_SAMPLES; i++) {
+            float s = ctx->pcm[(f * REPLAY_FRAME_SAMPLES + i) * ctx->channels];
+            acc += s * s;
+        }
+        tmpl[n++] = 10.0f * log10f(acc / REPLAY_FRAME_SAMPLES / (32768.0f * 32768.0f) + 1e-10f);
+    }
+    return n;
+}
+
+/*********************
+ * 管理器回调
+ *********************/
+
+static size_t replay_mic_source(int16_t *out, size_t frames, size_t channels, void *arg)
+{
+    replay_ctx_t *ctx = arg;
+    if (channels != ctx->channels || ctx->pos >= ctx->frames) {
+        ctx->done = true;
+        return 0;
+    }
+
+    size_t n = ctx->frames - ctx->pos < frames ? ctx->frames - ctx->pos : frames;
+    memcpy(out, ctx->pcm + ctx->pos * channels, n * channels * sizeof(int16_t));
+    ctx->pos += n;
+    return n;
+}
+
+static void replay_event_cb(const audio_mgr_event_t *event, void *user_ctx)
+{
+    replay_ctx_t *ctx = user_ctx;
+    uint32_t n = ctx->event_count;
+    if (n >= REPLAY_MAX_EVENTS) {
+        return;
+    }
+
+    audio_mgr_metrics_t m;
+    audio_manager_get_metrics(&m);
+    ctx->events[n] = (replay_event_t){
+        .type = event->type,
+        .wall_us = esp_timer_get_time() - ctx->start_us,
+        .audio_ms = (uint32_t)(ctx->pos * 1000 / REPLAY_SAMPLE_RATE),
+        .afe_latency_us = m.afe_event_latency_us_last,
+    };
+    ctx->event_count = n + 1;
+}
+
+static const char *event_name(audio_mgr_event_type_t type)
+{
+    switch (type) {
+    case AUDIO_MGR_EVENT_WAKEUP_DETECTED: return "WAKEUP";
+    case AUDIO_MGR_EVENT_VAD_START: return "VAD_START";
+    case AUDIO_MGR_EVENT_VAD_END: return "VAD_END";
+    case AUDIO_MGR_EVENT_WAKEUP_TIMEOUT: return "WAKE_TIMEOUT";
+    case AUDIO_MGR_EVENT_BUTTON_TRIGGER: return "BUTTON";
+    case AUDIO_MGR_EVENT_BUTTON_RELEASE: return "BUTTON_RELEASE";
+    default: return "?";
+    }
+}
+
+static void print_stage(const char *name, const audio_stage_stats_t *s, uint32_t mhz, double frame_us)
+{
+    if (s->count == 0) {
+        printf("  %-12s -\n", name);
+        return;
+    }
+    double avg_us = (double)s->total_cycles / s->count / mhz;
+    printf("  %-12s avg %7.2f us  max %7.2f us  (%5.2f%% of a %.0f us frame, %" PRIu32 " frames)\n",
+           name, avg_us, (double)s->max_cycles / mhz, avg_us * 100.0 / frame_us, frame_us, s->count);
+}
+
+/*********************
+ * 主程序
+ *********************/
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    bool synth = false;
+    uint32_t wake_start_ms = 0, wake_len_ms = 0;
+    int sensitivity = 2, vad_mode = 2;
+    uint32_t expect_wake = 0, expect_vad = 0;
+    s_replay.speed = 1.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--synth")) {
+            synth = true;
+        } else if (!strcmp(argv[i], "--speed") && i + 1 < argc) {
+            s_replay.speed = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--wake") && i + 1 < argc) {
+            sscanf(argv[++i], "%" SCNu32 ":%" SCNu32, &wake_start_ms, &wake_len_ms);
+        } else if (!strcmp(argv[i], "--sensitivity") && i + 1 < argc) {
+            sensitivity = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--vad-mode") && i + 1 < argc) {
+            vad_mode = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--expect-wake") && i + 1 < argc) {
+            expect_wake = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--expect-vad") && i + 1 < argc) {
+            expect_vad = (uint32_t)atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "未知参数 %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (s_replay.speed <= 0.0) {
+        fprintf(stderr, "--speed 必须大于 0\n");
+        return 2;
+    }
+
+    if (synth) {
+        uint32_t s = 0, l = 0;
+        synth_signal(&s_replay, &s, &l);
+        if (!wake_len_ms) {
+            wake_start_ms = s;
+            wake_len_ms = l;
+        }
+    } else if (!path || !load_wav(path, &s_replay)) {
+        fprintf(stderr, "用法: %s [--speed X] [--wake S:L] [--sensitivity N] [--vad-mode N] <file.wav | --synth>\n",
+                argv[0]);
+        return 2;
+    }
+
+    static float tmpl[REPLAY_TEMPLATE_MAX];
+    size_t tmpl_frames = wake_len_ms ? build_template(&s_replay, wake_start_ms, wake_len_ms, tmpl) : 0;
+
+    // 麦克风通道 + 回采
+    static char input_format[REPLAY_MAX_CHANNELS + 2];
+    memset(input_format, 'M', s_replay.channels);
+    input_format[s_replay.channels] = 'R';
+
+    esp_log_level_set("*", ESP_LOG_WARN);
+    audio_bsp_host_set_mic_source(replay_mic_source, &s_replay, (float)s_replay.speed);
+
+    audio_mgr_config_t cfg = AUDIO_MANAGER_DEFAULT_CONFIG();
+    cfg.hw_config.mic.channels = (uint8_t)s_replay.channels;
+    cfg.wakeup_config.sensitivity = sensitivity;
+    cfg.vad_config.vad_mode = vad_mode;
+    cfg.afe_config.engine = AFE_ENGINE_REFERENCE;
+    cfg.afe_config.input_format = input_format;
+    cfg.afe_config.wake_template = tmpl_frames ? tmpl : NULL;
+    cfg.afe_config.wake_template_frames = tmpl_frames;
+    cfg.event_callback = replay_event_cb;
+    cfg.user_ctx = &s_replay;
+
+    printf("回放 %s: %.2f s, %u 通道, 格式 %s, 模板 %u 帧, 倍速 %.1f\n",
+           synth ? "合成信号" : path, (double)s_replay.frames / REPLAY_SAMPLE_RATE,
+           (unsigned)s_replay.channels, input_format, (unsigned)tmpl_frames, s_replay.speed);
+
+    if (audio_manager_init(&cfg) != ESP_OK) {
+        fprintf(stderr, "audio_manager_init 失败\n");
+        return 1;
+    }
+    audio_manager_reset_metrics();
+    s_replay.start_us = esp_timer_get_time();
+    audio_manager_start();
+
+    while (!s_replay.done) {
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+    // 等最后几帧处理完
+    vTaskDelay(pdMS_TO_TICKS(200));
+    int64_t elapsed_us = esp_timer_get_time() - s_replay.start_us;
+
+    audio_mgr_metrics_t m;
+    audio_manager_get_metrics(&m);
+    audio_manager_stop();
+    audio_manager_deinit();
+
+    uint32_t wakes = 0, vads = 0;
+    printf("\n事件（音频位置 = 事件送达时已送入的音频）:\n");
+    for (uint32_t i = 0; i < s_replay.event_count; i++) {
+        const replay_event_t *e = &s_replay.events[i];
+        wakes += e->type == AUDIO_MGR_EVENT_WAKEUP_DETECTED;
+        vads += e->type == AUDIO_MGR_EVENT_VAD_START;
+        printf("  %-14s audio %6" PRIu32 " ms  wall %8.1f ms  afe latency %6.2f ms\n",
+               event_name(e->type), e->audio_ms, e->wall_us / 1000.0, e->afe_latency_us / 1000.0);
+    }
+
+    double frame_us = REPLAY_FRAME_SAMPLES * 1e6 / REPLAY_SAMPLE_RATE;
+    printf("\n每帧 CPU（主机计时，1 cycle = 1 ns）:\n");
+    print_stage("mic_read", &m.mic_read, m.cpu_freq_mhz, frame_us);
+    print_stage("interleave", &m.afe_interleave, m.cpu_freq_mhz, frame_us);
+    print_stage("afe_feed", &m.afe_feed, m.cpu_freq_mhz, frame_us);
+    print_stage("afe_result", &m.afe_result, m.cpu_freq_mhz, frame_us);
+
+    printf("\n汇总: %u 次唤醒, %u 次 VAD 开始, 事件投递 %" PRIu32 " 合并丢弃 %" PRIu32
+           ", AFE 时延 max %.2f ms, 拒收帧 %" PRIu32 ", 用时 %.2f s\n",
+           (unsigned)wakes, (unsigned)vads, m.event_posted, m.event_drops,
+           m.afe_event_latency_us_max / 1000.0, m.afe_feed_rejected, elapsed_us / 1e6);
+
+    free(s_replay.pcm);
+    if (wakes < expect_wake || vads < expect_vad) {
+        printf("FAIL: 期望至少 %u 次唤醒、%u 次 VAD 开始\n", (unsigned)expect_wake, (unsigned)expect_vad);
+        return 1;
+    }
+    return 0;
+}
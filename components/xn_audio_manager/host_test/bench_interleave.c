@@ -0,0 +1,111 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\host_test\bench_interleave.c
+ * @Description: 交织内核基准：按输入格式分段调用 audio_interleave_s16 与逐采样点通用循环对比
+ *
+ * 与 afe_read_callback 相同的用法：麦克风数据按帧交织（mics 通道），回采单声道，
+ * 输出按输入格式（MR / MMR / MMMR）交织。两种实现的输出逐点比对，不一致时返回失败。
+ *
+ *   bench_interleave [迭代次数]     默认 20000 次，每次一个 512 帧的块
+ */
+#include "audio_interleave.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES        512
+#define BENCH_MAX_CHANNELS  8
+
+/** 逐采样点通用循环（每个采样点按格式字符分支） */
+__attribute__((noinline))
+static void interleave_generic(int16_t *out, const char *format, size_t channels,
+                               const int16_t *mic, size_t mics, const int16_t *ref, size_t frames)
+{
+    for (size_t f = 0; f < frames; f++) {
+        size_t m = 0;
+        for (size_t c = 0; c < channels; c++) {
+            switch (format[c]) {
+            case 'M':
+                out[f * channels + c] = mic[f * mics + m++];
+                break;
+            case 'R':
+                out[f * channels + c] = ref[f];
+                break;
+            default:
+                out[f * channels + c] = 0;
+                break;
+            }
+        }
+    }
+}
+
+/** 与 afe_wrapper 相同：连续的 M 通道一次复制，R 单独一段 */
+__attribute__((noinline))
+static void interleave_runs(int16_t *out, size_t channels,
+                            const int16_t *mic, size_t mics, const int16_t *ref, size_t frames)
+{
+    audio_interleave_s16(out, channels, mic, mics, mics, frames);
+    audio_interleave_s16(out + mics, channels, ref, 1, 1, frames);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+    static const char *formats[] = {"MR", "MMR", "MMMR"};
+    static int16_t mic[BENCH_FRAMES * 4];
+    static int16_t ref[BENCH_FRAMES];
+    static int16_t out_a[BENCH_FRAMES * BENCH_MAX_CHANNELS];
+    static int16_t out_b[BENCH_FRAMES * BENCH_MAX_CHANNELS];
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(mic) / sizeof(mic[0]); i++) {
+        mic[i] = (int16_t)(i * 7919);
+    }
+    for (size_t i = 0; i < BENCH_FRAMES; i++) {
+        ref[i] = (int16_t)(i * 104729);
+    }
+
+    printf("%d 次迭代，每次 %d 帧\n", iterations, BENCH_FRAMES);
+    for (size_t k = 0; k < sizeof(formats) / sizeof(formats[0]); k++) {
+        const char *format = formats[k];
+        size_t channels = strlen(format);
+        size_t mics = channels - 1;
+
+        memset(out_a, 0x55, sizeof(out_a));
+        memset(out_b, 0xAA, sizeof(out_b));
+        interleave_generic(out_a, format, channels, mic, mics, ref, BENCH_FRAMES);
+        interleave_runs(out_b, channels, mic, mics, ref, BENCH_FRAMES);
+        if (memcmp(out_a, out_b, BENCH_FRAMES * channels * sizeof(int16_t)) != 0) {
+            printf("FAIL: %s 输出不一致\n", format);
+            failed = 1;
+            continue;
+        }
+
+        double t0 = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            interleave_generic(out_a, format, channels, mic, mics, ref, BENCH_FRAMES);
+            __asm__ volatile("" : : "r"(out_a) : "memory");
+        }
+        double t1 = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            interleave_runs(out_b, channels, mic, mics, ref, BENCH_FRAMES);
+            __asm__ volatile("" : : "r"(out_b) : "memory");
+        }
+        double t2 = now_ns();
+
+        printf("  %zu ch (%-4s): generic %7.0f ns -> kernel %7.0f ns per chunk\n",
+               channels, format, (t1 - t0) / iterations, (t2 - t1) / iterations);
+    }
+    return failed;
+}
@@ -0,0 +1,215 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\host_test\test_event_flood.c
+ * @Description: 1 kHz 唤醒/VAD 洪泛下的事件顺序测试
+ *
+ * 与 audio_manager_post_event / audio_manager_task 相同的协议：控制事件在 event_lock 下分配序号后进入
+ * 长度为 AUDIO_MANAGER_EVENT_QUEUE_LENGTH 的队列，唤醒/VAD 进入合并器；消费者处理每个控制事件前回放
+ * 纪元更早的合并事件。
+ *
+ * - 有序生产者：每 1 ms 投递一个 VAD 翻转或唤醒事件，每 20 ms 投递一个控制事件，
+ *   控制事件携带投递时刻的 VAD 状态与最新唤醒编号
+ * - 干扰生产者：每 4 ms 投递一个不做检查的控制事件（争用序号与队列，使队列经常满）
+ * - 消费者：每个控制事件耗时 3 ms，处理控制事件时检查已回放的 VAD 状态 / 唤醒编号与快照一致
+ *
+ *   test_event_flood [持续毫秒]     默认 3000
+ */
+#include "audio_event_coalesce.h"
+#include "audio_manager.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FLOOD_CONTROL_EVERY_MS  20
+#define FLOOD_NOISE_PERIOD_MS   4
+#define FLOOD_HANDLE_MS         3
+
+typedef struct {
+    uint32_t seq;                   ///< 控制事件序号
+    bool     checked;               ///< 是否来自有序生产者
+    uint32_t index;                 ///< 有序生产者的控制事件编号
+    audio_coalesce_kind_t vad;      ///< 投递时刻的 VAD 状态
+    int      wake_id;               ///< 投递时刻最新的唤醒编号（-1 表示尚无）
+} flood_msg_t;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static audio_coalesce_t s_coalesce;
+static QueueHandle_t s_queue;
+static TaskHandle_t s_consumer;
+static volatile bool s_producing = true;
+static volatile bool s_noise_done;
+static volatile bool s_consumer_done;
+
+static uint32_t s_posted;
+static uint32_t s_dropped;
+static uint32_t s_controls_posted;
+static uint32_t s_checked_posted;
+
+static uint32_t s_delivered;
+static uint32_t s_controls_handled;
+static uint32_t s_checked_handled;
+static uint32_t s_errors;
+static audio_coalesce_kind_t s_seen_vad = AUDIO_COALESCE_VAD_END;
+static int s_seen_wake = -1;
+
+static void flood_post_control(flood_msg_t *msg)
+{
+    portENTER_CRITICAL(&s_lock);
+    msg->seq = audio_coalesce_next_control(&s_coalesce);
+    portEXIT_CRITICAL(&s_lock);
+    xQueueSend(s_queue, msg, portMAX_DELAY);
+    xTaskNotifyGive(s_consumer);
+}
+
+static void flood_post(audio_coalesce_kind_t kind, int wake_id)
+{
+    audio_coalesce_item_t item = { .kind = kind, .wake_word_index = wake_id };
+    portENTER_CRITICAL(&s_lock);
+    s_dropped += audio_coalesce_post(&s_coalesce, &item);
+    portEXIT_CRITICAL(&s_lock);
+    s_posted++;
+    xTaskNotifyGive(s_consumer);
+}
+
+static void flood_drain(uint32_t upto)
+{
+    audio_coalesce_item_t items[AUDIO_EVENT_COALESCE_BUCKET_MAX];
+    size_t n;
+    do {
+        portENTER_CRITICAL(&s_lock);
+        n = audio_coalesce_take(&s_coalesce, upto, items);
+        portEXIT_CRITICAL(&s_lock);
+        for (size_t i = 0; i < n; i++) {
+            if (items[i].kind == AUDIO_COALESCE_WAKE) {
+                if (items[i].wake_word_index <= s_seen_wake) {
+                    printf("wake %d replayed after %d\n", items[i].wake_word_index, s_seen_wake);
+                    s_errors++;
+                }
+                s_seen_wake = items[i].wake_word_index;
+            } else {
+                s_seen_vad = items[i].kind;
+            }
+            s_delivered++;
+        }
+    } while (n);
+}
+
+static void consumer_task(void *arg)
+{
+    uint32_t handled = 0;
+    flood_msg_t msg;
+
+    while (s_producing || !s_noise_done || uxQueueMessagesWaiting(s_queue)) {
+        while (xQueueReceive(s_queue, &msg, 0) == pdTRUE) {
+            flood_drain(msg.seq - 1);
+            s_controls_handled++;
+            if (msg.checked) {
+                if (msg.index != s_checked_handled) {
+                    printf("control #%" PRIu32 " handled as #%" PRIu32 "\n", msg.index, s_checked_handled);
+                    s_errors++;
+                }
+                if (msg.vad != s_seen_vad || msg.wake_id != s_seen_wake) {
+                    printf("control #%" PRIu32 ": expected vad=%d wake=%d, replayed vad=%d wake=%d\n",
+                           msg.index, msg.vad, msg.wake_id, s_seen_vad, s_seen_wake);
+                    s_errors++;
+                }
+                s_checked_handled++;
+            }
+            if ((int32_t)(msg.seq - handled) > 0) {
+                handled = msg.seq;
+            }
+            vTaskDelay(pdMS_TO_TICKS(FLOOD_HANDLE_MS));
+        }
+        flood_drain(handled);
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(AUDIO_MANAGER_STEP_INTERVAL_MS));
+    }
+    flood_drain(handled);
+    s_consumer_done = true;
+    vTaskDelete(NULL);
+}
+
+static void noise_task(void *arg)
+{
+    TickType_t last = xTaskGetTickCount();
+    while (s_producing) {
+        flood_msg_t msg = { .checked = false };
+        flood_post_control(&msg);
+        __atomic_fetch_add(&s_controls_posted, 1, __ATOMIC_RELAXED);
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(FLOOD_NOISE_PERIOD_MS));
+    }
+    s_noise_done = true;
+    vTaskDelete(NULL);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t duration_ms = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 3000;
+
+    audio_coalesce_init(&s_coalesce);
+    s_queue = xQueueCreate(AUDIO_MANAGER_EVENT_QUEUE_LENGTH, sizeof(flood_msg_t));
+    xTaskCreate(consumer_task, "consumer", 4096, NULL, 5, &s_consumer);
+    TaskHandle_t noise = NULL;
+    xTaskCreate(noise_task, "noise", 4096, NULL, 5, &noise);
+
+    // 有序生产者（主线程）：1 kHz 唤醒/VAD，每 20 ms 一个带快照的控制事件
+    audio_coalesce_kind_t vad = AUDIO_COALESCE_VAD_END;
+    int wake_id = -1;
+    uint32_t rng = 12345;
+    TickType_t start = xTaskGetTickCount();
+    TickType_t last = start;
+    for (uint32_t t = 0; t < duration_ms; t++) {
+        rng = rng * 1103515245u + 12345u;
+        if (((rng >> 16) % 5) == 0) {
+            flood_post(AUDIO_COALESCE_WAKE, ++wake_id);
+        } else {
+            vad = (vad == AUDIO_COALESCE_VAD_START) ? AUDIO_COALESCE_VAD_END : AUDIO_COALESCE_VAD_START;
+            flood_post(vad, 0);
+        }
+        if (t % FLOOD_CONTROL_EVERY_MS == FLOOD_CONTROL_EVERY_MS - 1) {
+            flood_msg_t msg = { .checked = true, .index = s_checked_posted, .vad = vad, .wake_id = wake_id };
+            flood_post_control(&msg);
+            s_checked_posted++;
+            __atomic_fetch_add(&s_controls_posted, 1, __ATOMIC_RELAXED);
+        }
+        vTaskDelayUntil(&last, 1);
+    }
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    s_producing = false;
+
+    while (!s_consumer_done) {
+        xTaskNotifyGive(s_consumer);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    printf("flood: %" PRIu32 " wake/vad events in %" PRIu32 " ms (%.0f Hz), %" PRIu32 " controls\n",
+           s_posted, (uint32_t)elapsed, s_posted * 1000.0 / (elapsed ? elapsed : 1), s_controls_posted);
+    printf("replayed %" PRIu32 ", coalesced away %" PRIu32 ", clamped %" PRIu32 ", controls handled %" PRIu32
+           " (checked %" PRIu32 "/%" PRIu32 ")\n",
+           s_delivered, s_dropped, s_coalesce.clamped, s_controls_handled, s_checked_handled, s_checked_posted);
+
+    if (s_controls_handled != s_controls_posted || s_checked_handled != s_checked_posted) {
+        printf("FAIL: lost control events\n");
+        return 1;
+    }
+    if (s_delivered + s_dropped != s_posted) {
+        printf("FAIL: %" PRIu32 " events neither replayed nor counted as dropped\n",
+               s_posted - s_delivered - s_dropped);
+        return 1;
+    }
+    if (s_seen_vad != vad || s_seen_wake != wake_id) {
+        printf("FAIL: final state vad=%d wake=%d, expected vad=%d wake=%d\n", s_seen_vad, s_seen_wake, vad, wake_id);
+        return 1;
+    }
+    if (s_errors) {
+        printf("FAIL: %" PRIu32 " ordering errors\n", s_errors);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
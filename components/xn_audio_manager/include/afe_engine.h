@@ -0,0 +1,130 @@
+/*
+ * @Author: 星年 && jixingnian@gmail.com
+ * @Date: 2025-12-03
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\include\afe_engine.h
+ * @Description: AFE 引擎抽象接口 - esp-sr 实现与可移植参考实现
+ */
+#pragma once
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** AFE 唤醒词配置 */
+typedef struct {
+    bool enabled;
+    const char *wake_word_name;
+    const char *model_partition;
+    int sensitivity;
+} afe_wakeup_config_t;
+
+/** AFE VAD 配置 */
+typedef struct {
+    bool enabled;
+    int vad_mode;
+    int min_speech_ms;
+    int min_silence_ms;
+} afe_vad_config_t;
+
+/** AFE 功能配置 */
+typedef struct {
+    bool aec_enabled;
+    bool ns_enabled;
+    bool agc_enabled;
+    int afe_mode;
+} afe_feature_config_t;
+
+/** AFE 引擎类型 */
+typedef enum {
+    AFE_ENGINE_ESP_SR = 0,      ///< esp-sr AFE（AEC/NS/AGC/VAD/WakeNet）
+    AFE_ENGINE_REFERENCE,       ///< 可移植参考实现（能量 VAD + 模板唤醒），可在 Linux 上构建
+} afe_engine_type_t;
+
+/** AFE 引擎配置 */
+typedef struct {
+    const char *input_format;           ///< 输入通道格式（如 "MR"：麦克风+回采）
+    int sample_rate;                    ///< 采样率
+    afe_wakeup_config_t wakeup;         ///< 唤醒词配置
+    afe_vad_config_t vad;               ///< VAD 配置
+    afe_feature_config_t feature;       ///< 功能配置
+    const float *wake_template;         ///< 参考引擎唤醒模板（每帧对数能量 dB，可为 NULL）
+    size_t wake_template_frames;        ///< 模板帧数
+} afe_engine_config_t;
+
+/** AFE 引擎单帧处理结果 */
+typedef struct {
+    bool wakeup_detected;               ///< 本帧检测到唤醒词
+    int wake_word_index;                ///< 唤醒词索引
+    float volume_db;                    ///< 本帧音量（dB）
+    bool vad_speech;                    ///< VAD 状态：true=人声
+    const int16_t *data;                ///< 处理后的单声道音频（引擎持有，至下次 fetch 前有效）
+    size_t samples;                     ///< 音频采样点数
+} afe_engine_result_t;
+
+typedef struct afe_engine_s afe_engine_t;
+
+/** AFE 引擎操作表 */
+typedef struct {
+    const char *name;
+
+    /**
+     * @brief 送入一帧交织数据
+     * @param frames 每通道采样点数，必须等于 feed_chunk_frames
+     */
+    esp_err_t (*feed)(afe_engine_t *engine, const int16_t *interleaved, size_t frames);
+
+    /**
+     * @brief 取出一帧处理结果
+     * @return ESP_OK 有结果，ESP_ERR_TIMEOUT 超时无数据
+     */
+    esp_err_t (*fetch)(afe_engine_t *engine, afe_engine_result_t *result, uint32_t timeout_ms);
+
+    /**
+     * @brief 在线更新配置（功能开关、灵敏度等）
+     * @note 调用者需保证与 feed/fetch 串行（在帧边界调用）
+     */
+    esp_err_t (*configure)(afe_engine_t *engine, const afe_engine_config_t *config);
+
+    /** 销毁引擎并释放资源 */
+    void (*destroy)(afe_engine_t *engine);
+} afe_engine_ops_t;
+
+/** AFE 引擎基类（具体实现将其作为首个成员） */
+struct afe_engine_s {
+    const afe_engine_ops_t *ops;        ///< 操作表
+    size_t feed_chunk_frames;           ///< 每次 feed 的每通道采样点数
+    size_t channels;                    ///< 交织通道数
+};
+
+/**
+ * @brief 创建 esp-sr AFE 引擎
+ * @param config 引擎配置
+ * @return 引擎指针，失败或平台不支持返回 NULL
+ */
+afe_engine_t *afe_engine_esp_sr_create(const afe_engine_config_t *config);
+
+/**
+ * @brief 创建可移植参考引擎（能量 VAD + 模板唤醒检测）
+ * @param config 引擎配置
+ * @return 引擎指针，失败返回 NULL
+ */
+afe_engine_t *afe_engine_ref_create(const afe_engine_config_t *config);
+
+/**
+ * @brief 按类型创建 AFE 引擎
+ * @param type 引擎类型
+ * @param config 引擎配置
+ * @return 引擎指针，失败返回 NULL
+ */
+afe_engine_t *afe_engine_create(afe_engine_type_t type, const afe_engine_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
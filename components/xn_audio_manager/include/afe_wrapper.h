@@ -13,6 +13,8 @@
 #include "esp_err.h"
 #include "audio_bsp.h"
 #include "ring_buffer.h"
+#include "audio_metrics.h"
+#include "afe_engine.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -44,30 +46,6 @@ typedef void (*afe_event_callback_t)(const afe_event_t *event, void *user_ctx);
 /** 录音数据回调 */
 typedef void (*afe_record_callback_t)(const int16_t *pcm_data, size_t samples, void *user_ctx);
 
-/** AFE 唤醒词配置 */
-typedef struct {
-    bool enabled;
-    const char *wake_word_name;
-    const char *model_partition;
-    int sensitivity;
-} afe_wakeup_config_t;
-
-/** AFE VAD 配置 */
-typedef struct {
-    bool enabled;
-    int vad_mode;
-    int min_speech_ms;
-    int min_silence_ms;
-} afe_vad_config_t;
-
-/** AFE 功能配置 */
-typedef struct {
-    bool aec_enabled;
-    bool ns_enabled;
-    bool agc_enabled;
-    int afe_mode;
-} afe_feature_config_t;
-
 /** AFE 包装器配置 */
 typedef struct {
     audio_bsp_handle_t bsp_handle;             ///< BSP 句柄
@@ -75,6 +53,10 @@ typedef struct {
     afe_wakeup_config_t wakeup_config;          ///< 唤醒词配置
     afe_vad_config_t vad_config;                ///< VAD 配置
     afe_feature_config_t feature_config;        ///< 功能配置
+    const char *input_format;                   ///< 输入格式（M=麦克风, R=回采, N=空通道；NULL 为 "MR"）
+    afe_engine_type_t engine_type;              ///< AFE 引擎类型
+    const float *wake_template;                 ///< 参考引擎唤醒模板（可为 NULL）
+    size_t wake_template_frames;                ///< 唤醒模板帧数
     afe_event_callback_t event_callback;        ///< 事件回调
     void *event_ctx;                            ///< 事件回调上下文
     afe_record_callback_t record_callback;      ///< 录音回调
@@ -83,6 +65,23 @@ typedef struct {
     bool *recording_ptr;                        ///< 录音状态指针（外部管理）
 } afe_wrapper_config_t;
 
+/** AFE 包装器统计 */
+typedef struct {
+    audio_stage_stats_t interleave;    ///< afe_read_callback 交织耗时（不含麦克风读取）
+    audio_stage_stats_t feed;          ///< 引擎 feed 耗时（每帧 CPU 开销）
+    audio_stage_stats_t result;        ///< afe_result_callback 处理耗时
+    uint32_t reference_underrun;       ///< 回采数据不足、以静音补齐的次数
+    uint32_t feed_rejected;            ///< 引擎拒收的帧数（fetch 端积压）
+    uint32_t event_latency_us_last;    ///< 最近一次事件：对应帧送入引擎到事件回调的时延
+    uint32_t event_latency_us_max;     ///< 事件时延最大值
+    uint32_t reconfig_count;           ///< 在线重配置次数
+    uint32_t reconfig_latency_us_last; ///< 最近一次重配置时延（请求 → 帧边界生效）
+    uint32_t reconfig_latency_us_max;  ///< 重配置时延最大值
+    uint32_t model_swap_count;         ///< 唤醒词模型热切换次数
+    uint32_t model_swap_latency_us_last; ///< 最近一次模型切换时延（请求 → 新模型生效，含后台加载）
+    uint32_t model_swap_dropped_frames;  ///< 模型切换时旧引擎中未取出而丢弃的帧数
+} afe_wrapper_stats_t;
+
 /** AFE 包装器句柄 */
 typedef struct afe_wrapper_s *afe_wrapper_handle_t;
 
@@ -99,11 +98,33 @@ afe_wrapper_handle_t afe_wrapper_create(const afe_wrapper_config_t *config);
  */
 void afe_wrapper_destroy(afe_wrapper_handle_t wrapper);
 
+/**
+ * @brief 在线重配置 AFE（不重建管线）
+ *
+ * - 功能开关（AEC/NS/AGC/VAD/WakeNet）与灵敏度：在下一个帧边界由 feed 任务应用
+ * - 唤醒词模型或模型分区变化：后台任务加载新模型，加载完成后在帧边界原子切换
+ *
+ * @param wrapper AFE 包装器句柄
+ * @param wakeup 唤醒词配置（NULL 表示不变）
+ * @param vad VAD 配置（NULL 表示不变）
+ * @param feature 功能配置（NULL 表示不变，afe_mode 不支持在线修改）
+ * @return
+ *     - ESP_OK: 已提交
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 上一次模型切换尚未完成
+ *     - ESP_ERR_NO_MEM: 后台加载任务创建失败
+ */
+esp_err_t afe_wrapper_reconfigure(afe_wrapper_handle_t wrapper,
+                                  const afe_wakeup_config_t *wakeup,
+                                  const afe_vad_config_t *vad,
+                                  const afe_feature_config_t *feature);
+
 /**
  * @brief 更新唤醒词配置
  * @param wrapper AFE 包装器句柄
  * @param config 新配置
  * @return ESP_OK 成功
+ * @note 等价于 afe_wrapper_reconfigure(wrapper, config, NULL, NULL)
  */
 esp_err_t afe_wrapper_update_wakeup_config(afe_wrapper_handle_t wrapper, 
                                             const afe_wakeup_config_t *config);
@@ -117,6 +138,20 @@ esp_err_t afe_wrapper_update_wakeup_config(afe_wrapper_handle_t wrapper,
 esp_err_t afe_wrapper_get_wakeup_config(afe_wrapper_handle_t wrapper, 
                                          afe_wakeup_config_t *config);
 
+/**
+ * @brief 获取 AFE 包装器统计
+ * @param wrapper AFE 包装器句柄
+ * @param stats 输出统计
+ * @return ESP_OK 成功
+ */
+esp_err_t afe_wrapper_get_stats(afe_wrapper_handle_t wrapper, afe_wrapper_stats_t *stats);
+
+/**
+ * @brief 清零 AFE 包装器统计
+ * @param wrapper AFE 包装器句柄
+ */
+void afe_wrapper_reset_stats(afe_wrapper_handle_t wrapper);
+
 #ifdef __cplusplus
 }
 #endif
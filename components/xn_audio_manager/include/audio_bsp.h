@@ -9,7 +9,13 @@
 #pragma once
 
 #include "esp_err.h"
+#include "sdkconfig.h"
+#if CONFIG_IDF_TARGET_LINUX
+typedef struct i2s_channel_obj_t *i2s_chan_handle_t;
+#else
 #include "driver/i2s_std.h"
+#endif
+#include "audio_metrics.h"
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -30,6 +36,7 @@ typedef struct {
     int bits;                ///< 位深
     size_t max_frame_samples;///< 最大采样帧数（用于分配临时缓冲）
     uint8_t bit_shift;       ///< 32bit 转 16bit 的右移位数
+    uint8_t channels;        ///< 麦克风通道数（0 视为 1，多通道数据按帧交织）
 } audio_bsp_mic_config_t;
 
 /**
@@ -64,6 +71,8 @@ esp_err_t audio_bsp_read_mic(audio_bsp_handle_t handle,
                              size_t sample_count,
                              size_t *out_got);
 
+size_t audio_bsp_get_mic_channels(audio_bsp_handle_t handle);
+
 esp_err_t audio_bsp_write_speaker(audio_bsp_handle_t handle,
                                   const int16_t *samples,
                                   size_t sample_count,
@@ -73,6 +82,31 @@ i2s_chan_handle_t audio_bsp_get_rx(audio_bsp_handle_t handle);
 
 i2s_chan_handle_t audio_bsp_get_tx(audio_bsp_handle_t handle);
 
+esp_err_t audio_bsp_get_io_stats(audio_bsp_handle_t handle, audio_io_stats_t *stats);
+
+void audio_bsp_reset_io_stats(audio_bsp_handle_t handle);
+
+#if CONFIG_IDF_TARGET_LINUX
+/**
+ * @brief 主机麦克风数据源（linux 目标）
+ * @param out 输出缓冲区（多通道按帧交织）
+ * @param frames 请求的每通道采样点数
+ * @param channels 麦克风通道数
+ * @param ctx 注册时传入的上下文
+ * @return 实际写入的每通道采样点数，0 表示暂无数据
+ */
+typedef size_t (*audio_bsp_host_mic_source_t)(int16_t *out, size_t frames, size_t channels, void *ctx);
+
+/**
+ * @brief 设置主机麦克风数据源（linux 目标）
+ * @param source 数据源，NULL 表示静音
+ * @param ctx 数据源上下文
+ * @param speed 读取节拍相对采样率的倍速：1 与 I2S DMA 一致，大于 1 加速回放，0 尽快读取
+ * @note 对之后创建和已创建的 BSP 都生效；扬声器输出只计数后丢弃
+ */
+void audio_bsp_host_set_mic_source(audio_bsp_host_mic_source_t source, void *ctx, float speed);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
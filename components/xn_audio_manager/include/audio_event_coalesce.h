@@ -0,0 +1,101 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\include\audio_event_coalesce.h
+ * @Description: 高频事件（唤醒/VAD）合并器，按到达顺序与控制事件交错回放（纯 C，可在主机上构建）
+ *
+ * 控制事件走不丢弃的队列，每个控制事件在投递前分配一个递增序号；
+ * 两个控制事件之间到达的唤醒/VAD 事件落入同一个"纪元"桶，在桶内合并：
+ * - 唤醒：只保留最新一次（移到桶尾，保持与 VAD 的先后关系）
+ * - VAD：与桶内最后一个 VAD 相同则丢弃；[A, B] 再来 A 时 B/A 成对抵消
+ *
+ * 消费者处理序号为 s 的控制事件前，先取空纪元 < s 的所有桶，
+ * 因此合并后的事件不会跑到在它之后投递的控制事件后面。
+ *
+ * 本模块不加锁，所有函数都要求调用者持有同一把锁（audio_manager 中为 event_lock）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_EVENT_COALESCE_EPOCHS      32    ///< 纪元桶数量（不小于控制事件队列深度的两倍）
+#define AUDIO_EVENT_COALESCE_BUCKET_MAX  3     ///< 每个桶合并后最多的事件数（1 个唤醒 + 2 个交替 VAD）
+
+/**
+ * @brief 可合并的事件类型
+ */
+typedef enum {
+    AUDIO_COALESCE_WAKE = 0,        ///< 唤醒词
+    AUDIO_COALESCE_VAD_START,       ///< 语音开始
+    AUDIO_COALESCE_VAD_END,         ///< 语音结束
+} audio_coalesce_kind_t;
+
+/**
+ * @brief 可合并的事件
+ */
+typedef struct {
+    audio_coalesce_kind_t kind;     ///< 事件类型
+    int   wake_word_index;          ///< 唤醒词索引（仅唤醒事件）
+    float volume_db;                ///< 唤醒音量（仅唤醒事件）
+} audio_coalesce_item_t;
+
+/**
+ * @brief 一个纪元内合并后的事件（按到达顺序）
+ */
+typedef struct {
+    audio_coalesce_item_t items[AUDIO_EVENT_COALESCE_BUCKET_MAX];
+    uint8_t count;
+} audio_coalesce_bucket_t;
+
+/**
+ * @brief 合并器状态
+ */
+typedef struct {
+    audio_coalesce_bucket_t buckets[AUDIO_EVENT_COALESCE_EPOCHS];
+    uint32_t control_seq;           ///< 最近一次分配的控制事件序号（当前纪元）
+    uint32_t drain_epoch;           ///< 尚未取空的最早纪元
+    uint32_t clamped;               ///< 未处理控制事件过多、被并入较早纪元的事件数
+} audio_coalesce_t;
+
+/**
+ * @brief 复位合并器
+ */
+void audio_coalesce_init(audio_coalesce_t *c);
+
+/**
+ * @brief 为即将投递的控制事件分配序号（开启一个新纪元）
+ *
+ * @return 控制事件序号，随控制事件一起进入队列
+ */
+uint32_t audio_coalesce_next_control(audio_coalesce_t *c);
+
+/**
+ * @brief 投递一个高频事件到当前纪元并合并
+ *
+ * @return 本次被丢弃的事件数（0~2）
+ */
+uint32_t audio_coalesce_post(audio_coalesce_t *c, const audio_coalesce_item_t *item);
+
+/**
+ * @brief 取出纪元不晚于 upto 的下一个非空桶
+ *
+ * 纪元 upto 本身取出后仍保持打开（之后到达的事件还会落入其中）。
+ *
+ * @param upto 最晚纪元：处理序号为 s 的控制事件前传 s-1，空闲时传已处理的最大序号
+ * @param out 输出事件（按到达顺序）
+ * @return 取出的事件数，0 表示不晚于 upto 的桶已全部取空
+ */
+size_t audio_coalesce_take(audio_coalesce_t *c, uint32_t upto,
+                           audio_coalesce_item_t out[AUDIO_EVENT_COALESCE_BUCKET_MAX]);
+
+#ifdef __cplusplus
+}
+#endif
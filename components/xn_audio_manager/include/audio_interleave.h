@@ -0,0 +1,62 @@
+/*
+ * @Author: 星年 && jixingnian@gmail.com
+ * @Date: 2025-12-04
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-04
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\include\audio_interleave.h
+ * @Description: 多通道 PCM 交织/解交织内核（纯 C，可在主机上构建）
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 32bit 采样右移转换为 16bit
+ *
+ * 逐点处理，与通道数无关（交织数据直接整体转换）
+ *
+ * @param dst 输出缓冲区（count 个采样点）
+ * @param src 输入缓冲区（count 个采样点）
+ * @param count 采样点总数
+ * @param shift 右移位数
+ */
+void audio_convert_s32_to_s16(int16_t *dst, const int32_t *src, size_t count, uint8_t shift);
+
+/**
+ * @brief 通道块复制（交织 / 解交织通用内核）
+ *
+ * 将 src 每帧中连续的 channels 个通道复制到 dst 每帧的对应位置：
+ * - 交织：src_stride=通道块宽度，dst_stride=目标总通道数
+ * - 解交织：src_stride=源总通道数，dst_stride=通道块宽度
+ *
+ * 常见步长（1~4 通道）走展开的定步长路径，其余走通用路径
+ *
+ * @param dst 目标首帧中的起始通道
+ * @param dst_stride 目标每帧采样点数
+ * @param src 源首帧中的起始通道
+ * @param src_stride 源每帧采样点数
+ * @param channels 每帧复制的连续通道数
+ * @param frames 帧数
+ */
+void audio_interleave_s16(int16_t *dst, size_t dst_stride,
+                          const int16_t *src, size_t src_stride,
+                          size_t channels, size_t frames);
+
+/**
+ * @brief 以固定值填充交织数据中的一个通道
+ *
+ * @param dst 目标首帧中的通道位置
+ * @param dst_stride 目标每帧采样点数
+ * @param value 填充值
+ * @param frames 帧数
+ */
+void audio_fill_channel_s16(int16_t *dst, size_t dst_stride, int16_t value, size_t frames);
+
+#ifdef __cplusplus
+}
+#endif
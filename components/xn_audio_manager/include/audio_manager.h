@@ -12,6 +12,8 @@
 
 #include "esp_err.h"
 #include "audio_bsp.h"
+#include "audio_metrics.h"
+#include "afe_engine.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
@@ -24,7 +26,7 @@ extern "C" {
 
 #define AUDIO_MANAGER_TASK_STACK_SIZE        (6 * 1024)
 #define AUDIO_MANAGER_TASK_PRIORITY          7
-#define AUDIO_MANAGER_EVENT_QUEUE_LENGTH     16
+#define AUDIO_MANAGER_EVENT_QUEUE_LENGTH     16    ///< 控制事件（开始/停止/按键）通道深度
 #define AUDIO_MANAGER_STEP_INTERVAL_MS       100
 #define AUDIO_MANAGER_DEFAULT_VOLUME         80
 
@@ -32,6 +34,10 @@ extern "C" {
 #define AUDIO_MANAGER_PLAYBACK_BUFFER_BYTES  (512 * 1024)
 #define AUDIO_MANAGER_REFERENCE_BUFFER_BYTES (16 * 1024)
 
+#define AUDIO_MANAGER_METRICS_TASK_STACK_SIZE (3 * 1024)
+#define AUDIO_MANAGER_METRICS_TASK_PRIORITY   2
+#define AUDIO_MANAGER_METRICS_STOP_TIMEOUT_MS 1000  ///< 停止上报时等待任务退出的上限
+
 // ============ 状态机定义 ============
 
 typedef enum {
@@ -106,6 +112,10 @@ typedef struct {
     bool ns_enabled;                ///< 降噪
     bool agc_enabled;               ///< 自动增益
     int afe_mode;                   ///< AFE模式（0=LOW_COST, 1=HIGH_QUALITY）
+    const char *input_format;       ///< AFE 输入格式（M=麦克风, R=回采, N=空通道），M 的个数需等于麦克风通道数
+    afe_engine_type_t engine;       ///< AFE 引擎（esp-sr / 参考实现）
+    const float *wake_template;     ///< 参考引擎唤醒模板（每帧对数能量 dB，可为 NULL）
+    size_t wake_template_frames;    ///< 唤醒模板帧数
 } audio_mgr_afe_config_t;
 
 /** 音频管理器配置（应用层组装） */
@@ -124,7 +134,7 @@ typedef struct {
         .mic = {                                                     \
             .port = 0, .bclk_gpio = -1, .lrck_gpio = -1, .din_gpio = -1, \
             .sample_rate = 16000, .bits = 32,                        \
-            .max_frame_samples = 512, .bit_shift = 14,               \
+            .max_frame_samples = 512, .bit_shift = 14, .channels = 1, \
         },                                                           \
         .speaker = {                                                 \
             .port = 0, .bclk_gpio = -1, .lrck_gpio = -1, .dout_gpio = -1, \
@@ -158,6 +168,10 @@ typedef struct {
         .ns_enabled = true,                                          \
         .agc_enabled = true,                                         \
         .afe_mode = 1,                                               \
+        .input_format = "MR",                                        \
+        .engine = AFE_ENGINE_ESP_SR,                                 \
+        .wake_template = NULL,                                       \
+        .wake_template_frames = 0,                                   \
     }
 
 #define AUDIO_MANAGER_DEFAULT_CONFIG()                               \
@@ -171,6 +185,51 @@ typedef struct {
         .user_ctx = NULL,                                            \
     }
 
+// ============ 性能统计 ============
+
+/** 缓冲区填充统计（单位：采样点） */
+typedef struct {
+    size_t size;                    ///< 容量
+    size_t fill;                    ///< 当前数据量
+    size_t high_watermark;          ///< 历史最高数据量
+    uint32_t overrun_samples;       ///< 写满后被覆盖的采样点数
+} audio_mgr_buffer_metrics_t;
+
+/** 音频管线统计快照 */
+typedef struct {
+    uint32_t frames_played;                 ///< 扬声器写入帧数
+    uint32_t samples_played;                ///< 扬声器写入采样点数
+    uint32_t frames_captured;               ///< 麦克风读取帧数
+    uint32_t samples_captured;              ///< 麦克风读取采样点数
+
+    audio_stage_stats_t speaker_write;      ///< i2s_hal_write_speaker 处理耗时
+    audio_stage_stats_t mic_read;           ///< i2s_hal_read_mic 处理耗时
+    audio_stage_stats_t afe_interleave;     ///< afe_read_callback 交织耗时
+    audio_stage_stats_t afe_feed;           ///< AFE 引擎 feed 耗时（每帧 CPU 开销）
+    audio_stage_stats_t afe_result;         ///< afe_result_callback 处理耗时
+    uint32_t afe_reference_underrun;        ///< 回采不足次数
+    uint32_t afe_feed_rejected;             ///< AFE 引擎拒收帧数
+    uint32_t afe_event_latency_us_last;     ///< 最近一次 AFE 事件时延（帧送入 → 事件回调）
+    uint32_t afe_event_latency_us_max;      ///< AFE 事件时延最大值
+    uint32_t afe_reconfig_count;            ///< AFE 在线重配置次数
+    uint32_t afe_reconfig_latency_us_last;  ///< 最近一次重配置时延（请求 → 帧边界生效）
+    uint32_t afe_reconfig_latency_us_max;   ///< 重配置时延最大值
+    uint32_t afe_model_swap_count;          ///< 唤醒词模型热切换次数
+    uint32_t afe_model_swap_latency_us_last;///< 最近一次模型切换时延（含后台加载）
+    uint32_t afe_model_swap_dropped_frames; ///< 模型切换丢弃的帧数
+
+    uint32_t event_posted;                  ///< 成功投递的事件数
+    uint32_t event_drops;                   ///< 被合并丢弃的高频事件数（重复/成对抵消的 VAD、被覆盖的唤醒）
+    uint32_t event_queue_depth;             ///< 控制事件队列当前深度
+    uint32_t event_queue_high_watermark;    ///< 控制事件队列历史最高深度
+    uint32_t event_queue_length;            ///< 控制事件队列容量
+
+    audio_mgr_buffer_metrics_t playback_buffer;  ///< 播放缓冲区
+    audio_mgr_buffer_metrics_t reference_buffer; ///< 回采缓冲区
+
+    uint32_t cpu_freq_mhz;                  ///< CPU 主频（用于周期换算为微秒）
+} audio_mgr_metrics_t;
+
 // ============ API接口 ============
 
 /**
@@ -182,8 +241,9 @@ esp_err_t audio_manager_init(const audio_mgr_config_t *config);
 
 /**
  * @brief 反初始化音频管理器
+ * @return ESP_OK 成功，ESP_ERR_TIMEOUT 统计上报任务未按时退出（上下文保持不变，可稍后重试）
  */
-void audio_manager_deinit(void);
+esp_err_t audio_manager_deinit(void);
 
 /**
  * @brief 启动音频管理器（开始监听唤醒词）
@@ -269,9 +329,22 @@ uint8_t audio_manager_get_volume(void);
  * @brief 动态更新唤醒词配置（后期网页配置用）
  * @param config 新的唤醒词配置
  * @return ESP_OK 成功
+ * @note 灵敏度/开关在下一帧生效；唤醒词模型变化时后台加载新模型并原子切换，不重建音频管线
  */
 esp_err_t audio_manager_update_wakeup_config(const audio_mgr_wakeup_config_t *config);
 
+/**
+ * @brief 在线更新 VAD 与 AFE 功能开关（AEC/NS/AGC/VAD）
+ * @param vad 新的 VAD 配置（NULL 表示不变）
+ * @param afe 新的 AFE 功能配置（NULL 表示不变；afe_mode/input_format/engine 仅在初始化时生效）
+ * @return
+ *     - ESP_OK: 已提交，下一帧生效
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 未初始化或未启用 AFE
+ */
+esp_err_t audio_manager_update_afe_config(const audio_mgr_vad_config_t *vad,
+                                          const audio_mgr_afe_config_t *afe);
+
 /**
  * @brief 获取当前唤醒词配置
  * @param config 输出配置
@@ -303,6 +376,32 @@ bool audio_manager_is_playing(void);
  */
 audio_mgr_state_t audio_manager_get_state(void);
 
+/**
+ * @brief 获取音频管线统计快照
+ * @note 计数器无锁累加，快照各字段间可能存在微小的不一致
+ * @param metrics 输出快照
+ * @return ESP_OK 成功
+ */
+esp_err_t audio_manager_get_metrics(audio_mgr_metrics_t *metrics);
+
+/**
+ * @brief 清零音频管线统计（高水位、耗时、计数）
+ */
+void audio_manager_reset_metrics(void);
+
+/**
+ * @brief 启动周期性统计上报任务（日志输出）
+ * @param period_ms 上报周期（毫秒），重复调用会更新周期
+ * @return ESP_OK 成功
+ */
+esp_err_t audio_manager_start_metrics_report(uint32_t period_ms);
+
+/**
+ * @brief 停止周期性统计上报任务，等待任务确认退出
+ * @return ESP_OK 已停止（或未启动），ESP_ERR_TIMEOUT AUDIO_MANAGER_METRICS_STOP_TIMEOUT_MS 内未退出
+ */
+esp_err_t audio_manager_stop_metrics_report(void);
+
 // ============ 录音数据回调（应用层实现） ============
 
 /**
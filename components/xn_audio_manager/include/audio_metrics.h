@@ -0,0 +1,96 @@
+/*
+ * @Author: 星年 && jixingnian@gmail.com
+ * @Date: 2025-12-03
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\include\audio_metrics.h
+ * @Description: 音频管线性能统计 - 轻量级计数器（可在量产固件中常开）
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 统计开关：置 0 时所有计数宏退化为空操作，不产生任何开销。
+ * 默认开启：每个阶段只多一次周期计数器读取和几次整数累加。
+ */
+#ifndef AUDIO_METRICS_ENABLE
+#define AUDIO_METRICS_ENABLE 1
+#endif
+
+/** 周期计数换算为微秒用的主频（linux 目标以纳秒计数，按 1000 MHz 换算） */
+#if CONFIG_IDF_TARGET_LINUX
+#define AUDIO_METRICS_CPU_MHZ   1000
+#else
+#define AUDIO_METRICS_CPU_MHZ   CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#endif
+
+/** 单个处理阶段的耗时统计（CPU 周期） */
+typedef struct {
+    uint32_t count;          ///< 调用次数
+    uint64_t total_cycles;   ///< 累计 CPU 周期
+    uint32_t max_cycles;     ///< 单次最大 CPU 周期
+} audio_stage_stats_t;
+
+/** 音频 I/O 统计（麦克风采集 / 扬声器播放） */
+typedef struct {
+    uint32_t frames_captured;          ///< 麦克风读取帧数
+    uint32_t samples_captured;         ///< 麦克风读取采样点数
+    uint32_t frames_played;            ///< 扬声器写入帧数
+    uint32_t samples_played;           ///< 扬声器写入采样点数
+    audio_stage_stats_t mic_read;      ///< i2s_hal_read_mic 格式转换耗时（不含 DMA 等待）
+    audio_stage_stats_t speaker_write; ///< i2s_hal_write_speaker 音量/立体声转换耗时（不含 DMA 等待）
+} audio_io_stats_t;
+
+#if AUDIO_METRICS_ENABLE
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+
+/** linux 目标没有周期计数器，以纳秒计 */
+static inline uint32_t audio_metrics_cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+#define AUDIO_METRICS_CYCLES()  audio_metrics_cycles()
+#else
+#include "esp_cpu.h"
+
+/** 读取当前核心的周期计数器 */
+#define AUDIO_METRICS_CYCLES()  ((uint32_t)esp_cpu_get_cycle_count())
+#endif
+
+/**
+ * @brief 记录一次阶段耗时
+ * @note 单写者（各阶段固定在一个任务中），读者允许读到略微不一致的快照
+ */
+static inline void audio_stage_stats_add(audio_stage_stats_t *stats, uint32_t start_cycles)
+{
+    uint32_t cycles = AUDIO_METRICS_CYCLES() - start_cycles;
+    stats->count++;
+    stats->total_cycles += cycles;
+    if (cycles > stats->max_cycles) {
+        stats->max_cycles = cycles;
+    }
+}
+#else
+#define AUDIO_METRICS_CYCLES()  (0U)
+
+static inline void audio_stage_stats_add(audio_stage_stats_t *stats, uint32_t start_cycles)
+{
+    (void)stats;
+    (void)start_cycles;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,7 +11,10 @@
 #pragma once
 
 #include "esp_err.h"
+#include "sdkconfig.h"
+#if !CONFIG_IDF_TARGET_LINUX
 #include "driver/gpio.h"
+#endif
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -12,13 +12,18 @@
 
 #include "esp_err.h"
 #include "driver/i2s_std.h"
+#include "audio_metrics.h"
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** 麦克风最大通道数（1 通道：标准单声道；2 通道：标准立体声；3~4 通道：TDM） */
+#define I2S_HAL_MIC_MAX_CHANNELS 4
+
 /** I2S 麦克风配置 */
 typedef struct {
     int port;           ///< I2S 端口号
@@ -29,6 +34,7 @@ typedef struct {
     int bits;           ///< 位深度（硬件采集 32bit，由数据手册要求）
     size_t max_frame_samples;  ///< 最大帧采样数（用于预分配临时缓冲区，默认 512）
     uint8_t bit_shift;  ///< 32位转16位的右移位数（默认 14，可调 12-16）
+    uint8_t channels;   ///< 麦克风通道数（0 视为 1，最大 I2S_HAL_MIC_MAX_CHANNELS）
 } i2s_mic_config_t;
 
 /** I2S 扬声器配置 */
@@ -63,15 +69,22 @@ void i2s_hal_destroy(i2s_hal_handle_t hal);
 /**
  * @brief 从麦克风读取音频数据
  * @param hal I2S HAL 句柄
- * @param out_samples 输出缓冲区（16bit PCM）
- * @param sample_count 期望读取的采样点数
- * @param out_got 实际读取的采样点数（可选）
+ * @param out_samples 输出缓冲区（16bit PCM，多通道时按帧交织，大小 sample_count × 通道数）
+ * @param sample_count 期望读取的每通道采样点数（帧数）
+ * @param out_got 实际读取的每通道采样点数（可选）
  * @return ESP_OK 成功
  * @note 自动将 32bit 硬件数据转换为 16bit
  */
 esp_err_t i2s_hal_read_mic(i2s_hal_handle_t hal, int16_t *out_samples, 
                            size_t sample_count, size_t *out_got);
 
+/**
+ * @brief 获取麦克风通道数
+ * @param hal I2S HAL 句柄
+ * @return 通道数，句柄无效返回 0
+ */
+size_t i2s_hal_get_mic_channels(i2s_hal_handle_t hal);
+
 /**
  * @brief 向扬声器写入音频数据
  * @param hal I2S HAL 句柄
@@ -98,6 +111,20 @@ i2s_chan_handle_t i2s_hal_get_rx_handle(i2s_hal_handle_t hal);
  */
 i2s_chan_handle_t i2s_hal_get_tx_handle(i2s_hal_handle_t hal);
 
+/**
+ * @brief 获取 I/O 统计（帧数、格式转换耗时）
+ * @param hal I2S HAL 句柄
+ * @param stats 输出统计
+ * @return ESP_OK 成功
+ */
+esp_err_t i2s_hal_get_stats(i2s_hal_handle_t hal, audio_io_stats_t *stats);
+
+/**
+ * @brief 清零 I/O 统计
+ * @param hal I2S HAL 句柄
+ */
+void i2s_hal_reset_stats(i2s_hal_handle_t hal);
+
 #ifdef __cplusplus
 }
 #endif
@@ -102,6 +102,23 @@ size_t playback_controller_get_free_space(playback_controller_handle_t controlle
  */
 ring_buffer_handle_t playback_controller_get_reference_buffer(playback_controller_handle_t controller);
 
+/**
+ * @brief 获取播放/回采缓冲区统计
+ * @param controller 播放控制器句柄
+ * @param playback 播放缓冲区统计输出（可为 NULL）
+ * @param reference 回采缓冲区统计输出（可为 NULL）
+ * @return ESP_OK 成功
+ */
+esp_err_t playback_controller_get_buffer_stats(playback_controller_handle_t controller,
+                                               ring_buffer_stats_t *playback,
+                                               ring_buffer_stats_t *reference);
+
+/**
+ * @brief 清零播放/回采缓冲区统计
+ * @param controller 播放控制器句柄
+ */
+void playback_controller_reset_buffer_stats(playback_controller_handle_t controller);
+
 #ifdef __cplusplus
 }
 #endif
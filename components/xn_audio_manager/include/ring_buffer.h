@@ -20,6 +20,14 @@
 extern "C" {
 #endif
 
+/** 环形缓冲区统计 */
+typedef struct {
+    size_t size;              ///< 容量（采样点数）
+    size_t fill;              ///< 当前数据量（采样点数）
+    size_t high_watermark;    ///< 历史最高数据量（采样点数）
+    uint32_t overrun_samples; ///< 因写满被覆盖丢弃的采样点数
+} ring_buffer_stats_t;
+
 /** 环形缓冲区句柄 */
 typedef struct ring_buffer_s *ring_buffer_handle_t;
 
@@ -78,6 +86,20 @@ esp_err_t ring_buffer_clear(ring_buffer_handle_t rb);
  */
 size_t ring_buffer_get_size(ring_buffer_handle_t rb);
 
+/**
+ * @brief 获取环形缓冲区统计（填充量、高水位、溢出）
+ * @param rb 环形缓冲区句柄
+ * @param stats 输出统计
+ * @return ESP_OK 成功
+ */
+esp_err_t ring_buffer_get_stats(ring_buffer_handle_t rb, ring_buffer_stats_t *stats);
+
+/**
+ * @brief 清零高水位和溢出计数
+ * @param rb 环形缓冲区句柄
+ */
+void ring_buffer_reset_stats(ring_buffer_handle_t rb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,35 @@
+/*
+ * @Author: 星年 && jixingnian@gmail.com
+ * @Date: 2025-12-03
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\src\afe_engine.c
+ * @Description: AFE 引擎工厂
+ */
+#include "afe_engine.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "AFE_ENGINE";
+
+#if CONFIG_IDF_TARGET_LINUX
+afe_engine_t *afe_engine_esp_sr_create(const afe_engine_config_t *config)
+{
+    (void)config;
+    ESP_LOGE(TAG, "linux 目标不支持 esp-sr 引擎");
+    return NULL;
+}
+#endif
+
+afe_engine_t *afe_engine_create(afe_engine_type_t type, const afe_engine_config_t *config)
+{
+    switch (type) {
+    case AFE_ENGINE_ESP_SR:
+        return afe_engine_esp_sr_create(config);
+    case AFE_ENGINE_REFERENCE:
+        return afe_engine_ref_create(config);
+    default:
+        ESP_LOGE(TAG, "未知的引擎类型: %d", (int)type);
+        return NULL;
+    }
+}
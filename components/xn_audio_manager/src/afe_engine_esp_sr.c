@@ -0,0 +1,227 @@
+/*
+ * @Author: 星年 && jixingnian@gmail.com
+ * @Date: 2025-12-03
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\src\afe_engine_esp_sr.c
+ * @Description: AFE 引擎 - esp-sr 实现
+ */
+#include "afe_engine.h"
+#include "esp_log.h"
+#include "esp_afe_sr_models.h"
+#include "esp_afe_sr_iface.h"
+#include "esp_afe_config.h"
+#include "model_path.h"
+#include "freertos/FreeRTOS.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "AFE_ENGINE_SR";
+
+/**
+ * 灵敏度 0..3 对应的 WakeNet 检测阈值（越小越灵敏）。
+ * 运行中 wakenet_mode 无法修改，只能改阈值，因此创建后也立即按此表设置阈值，
+ * 保证同一个灵敏度在创建时和在线调整后的检测行为一致。
+ */
+static const float s_wakenet_threshold[] = {0.80f, 0.70f, 0.60f, 0.50f};
+
+/**
+ * @brief esp-sr 引擎上下文
+ */
+typedef struct {
+    afe_engine_t base;                  ///< 引擎基类（必须为首成员）
+    esp_afe_sr_iface_t *iface;          ///< AFE 接口
+    esp_afe_sr_data_t *data;            ///< AFE 实例
+    srmodel_list_t *models;             ///< 语音识别模型列表
+    afe_engine_config_t config;         ///< 当前生效的配置
+} afe_engine_esp_sr_t;
+
+static esp_err_t esp_sr_feed(afe_engine_t *engine, const int16_t *interleaved, size_t frames)
+{
+    afe_engine_esp_sr_t *sr = (afe_engine_esp_sr_t *)engine;
+    if (!interleaved || frames != engine->feed_chunk_frames) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    sr->iface->feed(sr->data, interleaved);
+    return ESP_OK;
+}
+
+static esp_err_t esp_sr_fetch(afe_engine_t *engine, afe_engine_result_t *result, uint32_t timeout_ms)
+{
+    afe_engine_esp_sr_t *sr = (afe_engine_esp_sr_t *)engine;
+    afe_fetch_result_t *res = sr->iface->fetch_with_delay(sr->data, pdMS_TO_TICKS(timeout_ms));
+    if (!res || res->ret_value == ESP_FAIL) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    result->wakeup_detected = (res->wakeup_state == WAKENET_DETECTED);
+    result->wake_word_index = res->wake_word_index;
+    result->volume_db = res->data_volume;
+    result->vad_speech = (res->vad_state == VAD_SPEECH);
+    result->data = res->data;
+    result->samples = res->data_size > 0 ? res->data_size / sizeof(int16_t) : 0;
+    return ESP_OK;
+}
+
+/**
+ * @brief 按灵敏度表设置 WakeNet 检测阈值（超出 0..3 时取边界）
+ */
+static void esp_sr_apply_sensitivity(afe_engine_esp_sr_t *sr, int sensitivity)
+{
+    if (!sr->models || !sr->iface->set_wakenet_threshold) {
+        return;
+    }
+    if (sensitivity < 0) sensitivity = 0;
+    if (sensitivity > 3) sensitivity = 3;
+    sr->iface->set_wakenet_threshold(sr->data, 1, s_wakenet_threshold[sensitivity]);
+}
+
+/**
+ * @brief 根据开关调用 enable/disable
+ */
+static void esp_sr_toggle(esp_afe_sr_data_t *data, bool enable,
+                          int (*on)(esp_afe_sr_data_t *), int (*off)(esp_afe_sr_data_t *))
+{
+    if (enable && on) {
+        on(data);
+    } else if (!enable && off) {
+        off(data);
+    }
+}
+
+static esp_err_t esp_sr_configure(afe_engine_t *engine, const afe_engine_config_t *config)
+{
+    afe_engine_esp_sr_t *sr = (afe_engine_esp_sr_t *)engine;
+    const afe_engine_config_t *old = &sr->config;
+    esp_afe_sr_iface_t *afe = sr->iface;
+
+    if (config->feature.aec_enabled != old->feature.aec_enabled) {
+        esp_sr_toggle(sr->data, config->feature.aec_enabled, afe->enable_aec, afe->disable_aec);
+    }
+    if (config->feature.ns_enabled != old->feature.ns_enabled) {
+        esp_sr_toggle(sr->data, config->feature.ns_enabled, afe->enable_ns, afe->disable_ns);
+    }
+    if (config->feature.agc_enabled != old->feature.agc_enabled) {
+        esp_sr_toggle(sr->data, config->feature.agc_enabled, afe->enable_agc, afe->disable_agc);
+    }
+    if (config->vad.enabled != old->vad.enabled) {
+        esp_sr_toggle(sr->data, config->vad.enabled, afe->enable_vad, afe->disable_vad);
+    }
+    if (config->wakeup.enabled != old->wakeup.enabled) {
+        if (config->wakeup.enabled && !sr->models) {
+            // 创建时未加载模型，无法在线开启 WakeNet
+            ESP_LOGW(TAG, "WakeNet 未初始化，忽略开启请求");
+        } else {
+            esp_sr_toggle(sr->data, config->wakeup.enabled, afe->enable_wakenet, afe->disable_wakenet);
+        }
+    }
+    if (config->wakeup.enabled &&
+        (config->wakeup.sensitivity != old->wakeup.sensitivity || !old->wakeup.enabled)) {
+        esp_sr_apply_sensitivity(sr, config->wakeup.sensitivity);
+    }
+
+    sr->config = *config;
+    return ESP_OK;
+}
+
+static void esp_sr_destroy(afe_engine_t *engine)
+{
+    afe_engine_esp_sr_t *sr = (afe_engine_esp_sr_t *)engine;
+    if (sr->data) {
+        sr->iface->destroy(sr->data);
+    }
+    if (sr->models) {
+        esp_srmodel_deinit(sr->models);
+    }
+    free(sr);
+}
+
+static const afe_engine_ops_t s_esp_sr_ops = {
+    .name = "esp-sr",
+    .feed = esp_sr_feed,
+    .fetch = esp_sr_fetch,
+    .configure = esp_sr_configure,
+    .destroy = esp_sr_destroy,
+};
+
+afe_engine_t *afe_engine_esp_sr_create(const afe_engine_config_t *config)
+{
+    if (!config || !config->input_format) {
+        ESP_LOGE(TAG, "无效的配置参数");
+        return NULL;
+    }
+
+    afe_engine_esp_sr_t *sr = (afe_engine_esp_sr_t *)calloc(1, sizeof(afe_engine_esp_sr_t));
+    if (!sr) {
+        ESP_LOGE(TAG, "引擎分配失败");
+        return NULL;
+    }
+    sr->config = *config;
+
+    // 加载唤醒词模型
+    if (config->wakeup.enabled) {
+        ESP_LOGI(TAG, "加载唤醒词模型: %s", config->wakeup.wake_word_name);
+        sr->models = esp_srmodel_init(config->wakeup.model_partition);
+        if (!sr->models) {
+            ESP_LOGE(TAG, "模型加载失败");
+            free(sr);
+            return NULL;
+        }
+        ESP_LOGI(TAG, "✅ 加载了 %d 个模型", sr->models->num);
+    }
+
+    afe_config_t *afe_config = afe_config_init(config->input_format, sr->models, AFE_TYPE_SR,
+                                               config->feature.afe_mode);
+    if (!afe_config) {
+        ESP_LOGE(TAG, "AFE 配置失败");
+        esp_sr_destroy(&sr->base);
+        return NULL;
+    }
+
+    // 按唤醒词名称选择模型（如 "wn9_nihaoxiaozhi_tts"），找不到时使用分区中的默认模型
+    if (sr->models && config->wakeup.wake_word_name) {
+        char *model_name = esp_srmodel_filter(sr->models, ESP_WN_PREFIX, config->wakeup.wake_word_name);
+        if (model_name) {
+            afe_config->wakenet_model_name = model_name;
+        }
+    }
+
+    // 配置音频处理功能
+    afe_config->aec_init = config->feature.aec_enabled;         // 回声消除
+    afe_config->se_init = false;                                // 语音增强（未启用）
+    afe_config->vad_init = config->vad.enabled;                 // 语音活动检测
+    afe_config->vad_mode = config->vad.vad_mode;                // VAD 模式
+    afe_config->vad_min_speech_ms = config->vad.min_speech_ms;  // 最小语音时长
+    afe_config->vad_min_noise_ms = config->vad.min_silence_ms;  // 最小静音时长
+    afe_config->wakenet_init = config->wakeup.enabled;          // 唤醒词检测
+    afe_config->wakenet_mode = config->wakeup.sensitivity;      // 唤醒词灵敏度
+    afe_config->afe_perferred_core = 0;                         // 优先运行在核心 0
+    afe_config->afe_perferred_priority = 8;                     // 任务优先级
+    afe_config->memory_alloc_mode = AFE_MEMORY_ALLOC_MORE_PSRAM;// 优先使用 PSRAM
+    afe_config->agc_init = config->feature.agc_enabled;         // 自动增益控制
+    afe_config->ns_init = config->feature.ns_enabled;           // 噪声抑制
+    afe_config->afe_ringbuf_size = 120;                         // 环形缓冲区大小
+
+    afe_config = afe_config_check(afe_config);
+    sr->iface = esp_afe_handle_from_config(afe_config);
+    sr->data = sr->iface ? sr->iface->create_from_config(afe_config) : NULL;
+    afe_config_free(afe_config);
+
+    if (!sr->data) {
+        ESP_LOGE(TAG, "AFE 实例创建失败");
+        esp_sr_destroy(&sr->base);
+        return NULL;
+    }
+
+    if (config->wakeup.enabled) {
+        esp_sr_apply_sensitivity(sr, config->wakeup.sensitivity);
+    }
+
+    sr->base.ops = &s_esp_sr_ops;
+    sr->base.feed_chunk_frames = sr->iface->get_feed_chunksize(sr->data);
+    sr->base.channels = sr->iface->get_feed_channel_num(sr->data);
+
+    ESP_LOGI(TAG, "✅ esp-sr 引擎创建成功: 格式=%s, chunk=%d, 通道=%d",
+             config->input_format, (int)sr->base.feed_chunk_frames, (int)sr->base.channels);
+    return &sr->base;
+}
@@ -0,0 +1,330 @@
+/*
+ * @Author: 星年 && jixingnian@gmail.com
+ * @Date: 2025-12-03
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\src\afe_engine_ref.c
+ * @Description: AFE 引擎 - 可移植参考实现（能量 VAD + 模板唤醒检测）
+ *
+ * 不依赖 esp-sr，仅使用 FreeRTOS 队列与标准 C 数学库，可在 linux 目标上构建，
+ * 用于主机回放录音、对比事件时序以及在无模型的硬件上做功能验证。
+ */
+#include "afe_engine.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "AFE_ENGINE_REF";
+
+#define REF_CHUNK_FRAMES        256     ///< 每次 feed 的每通道采样点数
+#define REF_QUEUE_LEN           8       ///< 结果队列深度
+#define REF_SLOT_NUM            (REF_QUEUE_LEN + 2)  ///< 输出缓冲槽数（队列满 + fetch 持有 + 正在写入）
+#define REF_TEMPLATE_MAX        128     ///< 唤醒模板最大帧数
+#define REF_WAKE_COOLDOWN_MS    1000    ///< 唤醒检测冷却时间
+
+/** VAD 模式 0..4 对应的判决门限（高于噪声底的 dB 数，模式越大越敏感） */
+static const float s_vad_offset_db[] = {12.0f, 10.0f, 8.0f, 6.0f, 4.0f};
+
+/** 唤醒灵敏度 0..3 对应的归一化相关系数门限 */
+static const float s_wake_threshold[] = {0.90f, 0.85f, 0.80f, 0.75f};
+
+/** 单帧输出槽 */
+typedef struct {
+    int16_t pcm[REF_CHUNK_FRAMES];
+    float volume_db;
+    bool vad_speech;
+    bool wakeup;
+} ref_slot_t;
+
+/**
+ * @brief 参考引擎上下文
+ */
+typedef struct {
+    afe_engine_t base;                  ///< 引擎基类（必须为首成员）
+    afe_engine_config_t config;         ///< 当前生效的配置
+    size_t mic_channel;                 ///< 麦克风通道在交织数据中的位置
+    uint32_t frame_ms;                  ///< 每帧时长
+
+    QueueHandle_t result_queue;         ///< 结果槽索引队列
+    ref_slot_t slots[REF_SLOT_NUM];     ///< 输出缓冲槽
+    uint8_t write_slot;                 ///< 下一个写入槽
+
+    // 能量 VAD
+    float noise_floor_db;               ///< 自适应噪声底
+    bool noise_floor_valid;             ///< 噪声底已初始化
+    bool vad_state;                     ///< 去抖后的 VAD 状态
+    uint32_t vad_run_ms;                ///< 与当前状态相反的原始判决持续时间
+
+    // 模板唤醒
+    float tmpl[REF_TEMPLATE_MAX];       ///< 去均值后的模板
+    float tmpl_norm;                    ///< 模板范数
+    size_t tmpl_len;                    ///< 模板帧数
+    float env[REF_TEMPLATE_MAX];        ///< 能量包络环形缓冲
+    size_t env_pos;                     ///< 包络写入位置
+    size_t env_count;                   ///< 包络有效帧数
+    uint32_t wake_cooldown_ms;          ///< 剩余冷却时间
+} afe_engine_ref_t;
+
+/**
+ * @brief 计算一帧单声道 dBFS 能量
+ */
+static float ref_frame_db(const int16_t *interleaved, size_t channels, size_t ch, size_t frames,
+                          int16_t *mono_out)
+{
+    float acc = 0.0f;
+    for (size_t i = 0; i < frames; i++) {
+        int16_t s = interleaved[i * channels + ch];
+        mono_out[i] = s;
+        acc += (float)s * (float)s;
+    }
+    float ms = acc / (float)frames / (32768.0f * 32768.0f);
+    return 10.0f * log10f(ms + 1e-10f);
+}
+
+/**
+ * @brief 能量 VAD：自适应噪声底 + 门限 + 语音/静音最短时长去抖
+ */
+static bool ref_vad_process(afe_engine_ref_t *ref, float db)
+{
+    if (!ref->noise_floor_valid) {
+        ref->noise_floor_db = db;
+        ref->noise_floor_valid = true;
+    }
+
+    // 噪声底快降慢升，避免被持续语音抬高
+    if (db < ref->noise_floor_db) {
+        ref->noise_floor_db += (db - ref->noise_floor_db) * 0.5f;
+    } else {
+        ref->noise_floor_db += (db - ref->noise_floor_db) * 0.005f;
+    }
+
+    int mode = ref->config.vad.vad_mode;
+    if (mode < 0) mode = 0;
+    if (mode > 4) mode = 4;
+    bool raw = db > ref->noise_floor_db + s_vad_offset_db[mode];
+
+    if (raw == ref->vad_state) {
+        ref->vad_run_ms = 0;
+        return ref->vad_state;
+    }
+
+    ref->vad_run_ms += ref->frame_ms;
+    uint32_t need_ms = raw ? (uint32_t)ref->config.vad.min_speech_ms
+                           : (uint32_t)ref->config.vad.min_silence_ms;
+    if (ref->vad_run_ms >= need_ms) {
+        ref->vad_state = raw;
+        ref->vad_run_ms = 0;
+    }
+    return ref->vad_state;
+}
+
+/**
+ * @brief 模板唤醒检测：能量包络与模板的去均值归一化互相关
+ */
+static bool ref_wake_process(afe_engine_ref_t *ref, float db)
+{
+    if (ref->tmpl_len == 0) {
+        return false;
+    }
+
+    ref->env[ref->env_pos] = db;
+    ref->env_pos = (ref->env_pos + 1) % ref->tmpl_len;
+    if (ref->env_count < ref->tmpl_len) {
+        ref->env_count++;
+    }
+
+    if (ref->wake_cooldown_ms > 0) {
+        ref->wake_cooldown_ms = ref->wake_cooldown_ms > ref->frame_ms
+                              ? ref->wake_cooldown_ms - ref->frame_ms : 0;
+        return false;
+    }
+    if (ref->env_count < ref->tmpl_len) {
+        return false;
+    }
+
+    // env_pos 指向最旧的一帧
+    float mean = 0.0f;
+    for (size_t i = 0; i < ref->tmpl_len; i++) {
+        mean += ref->env[i];
+    }
+    mean /= (float)ref->tmpl_len;
+
+    float dot = 0.0f;
+    float norm = 0.0f;
+    for (size_t i = 0; i < ref->tmpl_len; i++) {
+        float v = ref->env[(ref->env_pos + i) % ref->tmpl_len] - mean;
+        dot += v * ref->tmpl[i];
+        norm += v * v;
+    }
+    if (norm <= 1e-6f || ref->tmpl_norm <= 1e-6f) {
+        return false;
+    }
+
+    int sens = ref->config.wakeup.sensitivity;
+    if (sens < 0) sens = 0;
+    if (sens > 3) sens = 3;
+
+    float score = dot / (sqrtf(norm) * ref->tmpl_norm);
+    if (score < s_wake_threshold[sens]) {
+        return false;
+    }
+
+    ESP_LOGD(TAG, "模板匹配: score=%.3f", score);
+    ref->wake_cooldown_ms = REF_WAKE_COOLDOWN_MS;
+    return true;
+}
+
+/**
+ * @brief 载入唤醒模板（去均值并预计算范数）
+ */
+static void ref_load_template(afe_engine_ref_t *ref, const float *tmpl, size_t frames)
+{
+    ref->tmpl_len = 0;
+    ref->env_pos = 0;
+    ref->env_count = 0;
+    if (!tmpl || frames == 0) {
+        return;
+    }
+    if (frames > REF_TEMPLATE_MAX) {
+        ESP_LOGW(TAG, "唤醒模板过长 (%d 帧)，截断为 %d 帧", (int)frames, REF_TEMPLATE_MAX);
+        frames = REF_TEMPLATE_MAX;
+    }
+
+    float mean = 0.0f;
+    for (size_t i = 0; i < frames; i++) {
+        mean += tmpl[i];
+    }
+    mean /= (float)frames;
+
+    float norm = 0.0f;
+    for (size_t i = 0; i < frames; i++) {
+        ref->tmpl[i] = tmpl[i] - mean;
+        norm += ref->tmpl[i] * ref->tmpl[i];
+    }
+    ref->tmpl_norm = sqrtf(norm);
+    ref->tmpl_len = frames;
+}
+
+static esp_err_t ref_feed(afe_engine_t *engine, const int16_t *interleaved, size_t frames)
+{
+    afe_engine_ref_t *ref = (afe_engine_ref_t *)engine;
+    if (!interleaved || frames != REF_CHUNK_FRAMES) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    ref_slot_t *slot = &ref->slots[ref->write_slot];
+    float db = ref_frame_db(interleaved, engine->channels, ref->mic_channel, frames, slot->pcm);
+
+    slot->volume_db = db;
+    slot->vad_speech = ref->config.vad.enabled ? ref_vad_process(ref, db) : false;
+    slot->wakeup = ref->config.wakeup.enabled ? ref_wake_process(ref, db) : false;
+
+    uint8_t index = ref->write_slot;
+    if (xQueueSend(ref->result_queue, &index, 0) != pdTRUE) {
+        // fetch 端跟不上，丢弃本帧结果（槽位不前移，下次覆盖）
+        return ESP_ERR_TIMEOUT;
+    }
+    ref->write_slot = (uint8_t)((ref->write_slot + 1) % REF_SLOT_NUM);
+    return ESP_OK;
+}
+
+static esp_err_t ref_fetch(afe_engine_t *engine, afe_engine_result_t *result, uint32_t timeout_ms)
+{
+    afe_engine_ref_t *ref = (afe_engine_ref_t *)engine;
+    uint8_t index;
+    if (xQueueReceive(ref->result_queue, &index, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    const ref_slot_t *slot = &ref->slots[index];
+    result->wakeup_detected = slot->wakeup;
+    result->wake_word_index = slot->wakeup ? 1 : 0;
+    result->volume_db = slot->volume_db;
+    result->vad_speech = slot->vad_speech;
+    result->data = slot->pcm;
+    result->samples = REF_CHUNK_FRAMES;
+    return ESP_OK;
+}
+
+static esp_err_t ref_configure(afe_engine_t *engine, const afe_engine_config_t *config)
+{
+    afe_engine_ref_t *ref = (afe_engine_ref_t *)engine;
+
+    if (config->wake_template != ref->config.wake_template ||
+        config->wake_template_frames != ref->config.wake_template_frames) {
+        ref_load_template(ref, config->wake_template, config->wake_template_frames);
+    }
+    if (!config->vad.enabled) {
+        ref->vad_state = false;
+        ref->vad_run_ms = 0;
+    }
+
+    // 输入格式与采样率在创建时确定，不支持在线修改
+    const char *input_format = ref->config.input_format;
+    int sample_rate = ref->config.sample_rate;
+    ref->config = *config;
+    ref->config.input_format = input_format;
+    ref->config.sample_rate = sample_rate;
+    return ESP_OK;
+}
+
+static void ref_destroy(afe_engine_t *engine)
+{
+    afe_engine_ref_t *ref = (afe_engine_ref_t *)engine;
+    if (ref->result_queue) {
+        vQueueDelete(ref->result_queue);
+    }
+    free(ref);
+}
+
+static const afe_engine_ops_t s_ref_ops = {
+    .name = "reference",
+    .feed = ref_feed,
+    .fetch = ref_fetch,
+    .configure = ref_configure,
+    .destroy = ref_destroy,
+};
+
+afe_engine_t *afe_engine_ref_create(const afe_engine_config_t *config)
+{
+    if (!config || !config->input_format || config->sample_rate <= 0) {
+        ESP_LOGE(TAG, "无效的配置参数");
+        return NULL;
+    }
+
+    const char *mic = strchr(config->input_format, 'M');
+    size_t channels = strlen(config->input_format);
+    if (!mic || channels == 0) {
+        ESP_LOGE(TAG, "输入格式缺少麦克风通道: %s", config->input_format);
+        return NULL;
+    }
+
+    afe_engine_ref_t *ref = (afe_engine_ref_t *)calloc(1, sizeof(afe_engine_ref_t));
+    if (!ref) {
+        ESP_LOGE(TAG, "引擎分配失败");
+        return NULL;
+    }
+
+    ref->result_queue = xQueueCreate(REF_QUEUE_LEN, sizeof(uint8_t));
+    if (!ref->result_queue) {
+        ESP_LOGE(TAG, "结果队列创建失败");
+        free(ref);
+        return NULL;
+    }
+
+    ref->config = *config;
+    ref->mic_channel = (size_t)(mic - config->input_format);
+    ref->frame_ms = REF_CHUNK_FRAMES * 1000 / (uint32_t)config->sample_rate;
+    ref_load_template(ref, config->wake_template, config->wake_template_frames);
+
+    ref->base.ops = &s_ref_ops;
+    ref->base.feed_chunk_frames = REF_CHUNK_FRAMES;
+    ref->base.channels = channels;
+
+    ESP_LOGI(TAG, "✅ 参考引擎创建成功: 格式=%s, chunk=%d, 模板=%d 帧",
+             config->input_format, REF_CHUNK_FRAMES, (int)ref->tmpl_len);
+    return &ref->base;
+}
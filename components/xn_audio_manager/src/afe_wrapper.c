@@ -9,27 +9,74 @@
  * Copyright (c) 2025 by ${git_name_email}, All Rights Reserved. 
  */
 #include "afe_wrapper.h"
+#include "audio_interleave.h"
 #include "esp_log.h"
-#include "esp_gmf_afe_manager.h"
-#include "esp_afe_sr_models.h"
-#include "esp_afe_sr_iface.h"
-#include "esp_afe_config.h"
-#include "model_path.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "AFE_WRAPPER";
 
+#define AFE_WRAPPER_MAX_FRAME       512     ///< 单次 feed 每通道最大采样点数
+#define AFE_WRAPPER_MAX_MICS        4       ///< 最大麦克风通道数
+#define AFE_WRAPPER_MAX_CHANNELS    8       ///< 输入格式最大通道数
+#define AFE_WRAPPER_INPUT_FORMAT    "MR"    ///< 默认输入格式：麦克风 + 回采
+#define AFE_WRAPPER_TASK_STACK      (10 * 1024)
+#define AFE_WRAPPER_TASK_PRIO       8
+#define AFE_WRAPPER_FEED_CORE       1       ///< Feed 任务运行核心（保持在 CPU1）
+#define AFE_WRAPPER_FETCH_CORE      0       ///< Fetch 任务运行在 CPU0，与 Feed 分核
+#define AFE_WRAPPER_FETCH_TIMEOUT   100     ///< fetch 超时（毫秒），用于及时响应退出
+#define AFE_WRAPPER_IDLE_MS         20      ///< 未运行时 feed 任务轮询间隔
+#define AFE_WRAPPER_LATENCY_SLOTS   32      ///< feed 时间戳环深度（帧）
+#define AFE_WRAPPER_LOADER_STACK    (8 * 1024)  ///< 模型后台加载任务栈
+#define AFE_WRAPPER_LOADER_PRIO     3       ///< 模型后台加载任务优先级（低于音频任务）
+#define AFE_WRAPPER_LOADER_WAIT_MS  5000    ///< 销毁时等待后台加载结束的最长时间
+
+/**
+ * @brief 输入格式中的一段连续同类通道
+ */
+typedef struct {
+    uint8_t pos;                                ///< 在交织帧中的起始位置
+    uint8_t count;                              ///< 连续通道数
+    char type;                                  ///< 通道类型：'M' / 'R' / 'N'
+    uint8_t mic_index;                          ///< 起始麦克风通道（type='M'）
+} afe_channel_run_t;
+
 /**
  * @brief AFE 包装器上下文结构体
  * 
- * 封装了 AFE Manager 和语音识别相关的所有状态和资源
+ * 封装了 AFE 引擎、Feed/Fetch 任务和语音识别相关的所有状态和资源
  */
 typedef struct afe_wrapper_s {
-    esp_gmf_afe_manager_handle_t afe_manager;  ///< AFE Manager 句柄
-    esp_afe_sr_iface_t *afe_handle;            ///< AFE 接口句柄
-    srmodel_list_t *models;                     ///< 语音识别模型列表
-    
+    afe_engine_t *volatile engine;              ///< AFE 引擎（esp-sr 或参考实现）
+    afe_engine_config_t engine_config;          ///< 当前引擎生效的配置
+    afe_engine_type_t engine_type;              ///< 引擎类型（模型切换时沿用）
+    bool engine_has_wakenet;                    ///< 当前引擎创建时是否加载了唤醒词模型
+    TaskHandle_t feed_task;                     ///< Feed 任务句柄
+    TaskHandle_t fetch_task;                    ///< Fetch 任务句柄
+    volatile bool tasks_running;                ///< 任务运行标志
+    volatile bool feed_alive;                   ///< Feed 任务存活
+    volatile bool fetch_alive;                  ///< Fetch 任务存活
+    bool vad_active;                            ///< 当前 VAD 状态
+
+    // 在线重配置（在帧边界由 feed 任务应用）
+    portMUX_TYPE config_lock;                   ///< 保护 pending_config / engine_config / swap 状态
+    afe_engine_config_t pending_config;         ///< 待应用的引擎配置
+    volatile bool config_pending;               ///< 有待应用的配置
+    int64_t config_request_us;                  ///< 最早一次未应用的配置请求时间
+
+    // 唤醒词模型热切换
+    volatile bool swap_busy;                    ///< 后台加载/切换进行中
+    afe_engine_config_t swap_config;            ///< 新模型对应的引擎配置
+    int64_t swap_request_us;                    ///< 切换请求时间
+    afe_engine_t *volatile staged_engine;       ///< 后台加载完成、待切换的引擎
+    afe_engine_t *volatile pending_retire;      ///< 已切出、等待 fetch 任务放手的旧引擎
+    afe_engine_t *volatile retired_engine;      ///< fetch 任务已放手、待后台销毁的旧引擎
+    uint32_t swap_feed_seq;                     ///< 切换时的 feed 帧序号
+
     audio_bsp_handle_t bsp_handle;              ///< BSP 句柄，用于读取麦克风数据
     ring_buffer_handle_t reference_rb;         ///< 回采数据环形缓冲区
     
@@ -41,74 +88,177 @@ typedef struct afe_wrapper_s {
     
     bool *running_ptr;                          ///< 指向运行状态标志的指针
     bool *recording_ptr;                        ///< 指向录音状态标志的指针
-    
+
+    afe_wrapper_stats_t stats;                  ///< 性能统计
+    int64_t feed_time_us[AFE_WRAPPER_LATENCY_SLOTS]; ///< 最近各帧送入引擎的时间戳
+    volatile uint32_t feed_seq;                 ///< 已送入引擎的帧序号
+    uint64_t fetched_samples;                   ///< 已取出的采样点数
+
+    int16_t *feed_buffer;                       ///< 交织后的 feed 缓冲区（PSRAM）
+
+    // 输入格式
+    char input_format[AFE_WRAPPER_MAX_CHANNELS + 1]; ///< 输入格式字符串
+    size_t channels;                            ///< 交织总通道数
+    size_t mic_channels;                        ///< 麦克风通道数
+    bool has_reference;                         ///< 是否包含回采通道
+    afe_channel_run_t runs[AFE_WRAPPER_MAX_CHANNELS]; ///< 通道段
+    size_t run_count;                           ///< 通道段数
+
     // 静态缓冲区（避免频繁 malloc）
-    int16_t mic_buffer[512];                    ///< 麦克风数据缓冲区
-    int16_t ref_buffer[512];                    ///< 回采数据缓冲区
+    int16_t mic_buffer[AFE_WRAPPER_MAX_FRAME * AFE_WRAPPER_MAX_MICS]; ///< 麦克风数据缓冲区（按帧交织）
+    int16_t ref_buffer[AFE_WRAPPER_MAX_FRAME];  ///< 回采数据缓冲区
 } afe_wrapper_t;
 
 /**
- * @brief AFE 读取回调函数
+ * @brief 解析 AFE 输入格式
  * 
- * 从 I2S HAL 读取麦克风数据，从环形缓冲区读取回采数据，
- * 并将两者交织成 MR（麦克风+回采）格式供 AFE 处理
+ * 将格式字符串拆成连续同类通道段，供交织内核按段批量复制
  * 
- * @param buffer 输出缓冲区，用于存放交织后的音频数据
- * @param buf_sz 缓冲区大小（字节）
- * @param user_ctx 用户上下文，指向 afe_wrapper_t 结构体
- * @param ticks 超时时间（未使用）
- * @return int32_t 实际读取的字节数
+ * @param wrapper AFE 包装器
+ * @param format 输入格式（M=麦克风, R=回采, N=空通道）
+ * @param mic_channels 麦克风实际通道数
+ * @return esp_err_t ESP_OK 成功，ESP_ERR_INVALID_ARG 格式与硬件不匹配
  */
-static int32_t afe_read_callback(void *buffer, int buf_sz, void *user_ctx, TickType_t ticks)
+static esp_err_t afe_wrapper_parse_format(afe_wrapper_t *wrapper, const char *format,
+                                          size_t mic_channels)
 {
-    afe_wrapper_t *wrapper = (afe_wrapper_t *)user_ctx;
-    if (!buffer || buf_sz == 0 || !wrapper) return 0;
+    size_t len = strlen(format);
+    if (len == 0 || len > AFE_WRAPPER_MAX_CHANNELS) {
+        ESP_LOGE(TAG, "输入格式长度无效: %s", format);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t mics = 0;
+    size_t refs = 0;
+    wrapper->run_count = 0;
+    for (size_t i = 0; i < len; i++) {
+        char type = format[i];
+        if (type != 'M' && type != 'R' && type != 'N') {
+            ESP_LOGE(TAG, "输入格式包含未知通道 '%c': %s", type, format);
+            return ESP_ERR_INVALID_ARG;
+        }
 
-    int16_t *out_buf = (int16_t *)buffer;
-    const size_t total_samples = buf_sz / sizeof(int16_t);
-    const size_t channels = 2;  // MR: 麦克风+回采
-    const size_t frame_samples = total_samples / channels;
+        afe_channel_run_t *last = wrapper->run_count ? &wrapper->runs[wrapper->run_count - 1] : NULL;
+        if (last && last->type == type && type != 'R') {
+            last->count++;
+        } else {
+            wrapper->runs[wrapper->run_count++] = (afe_channel_run_t){
+                .pos = (uint8_t)i,
+                .count = 1,
+                .type = type,
+                .mic_index = (uint8_t)mics,
+            };
+        }
+        mics += (type == 'M');
+        refs += (type == 'R');
+    }
 
-    // 检查帧大小是否超出缓冲区限制
-    if (frame_samples > 512) {
-        ESP_LOGE(TAG, "AFE 读取帧过大: %d", (int)frame_samples);
-        memset(out_buf, 0, buf_sz);
-        return buf_sz;
+    if (mics != mic_channels || mics > AFE_WRAPPER_MAX_MICS || refs > 1) {
+        ESP_LOGE(TAG, "输入格式 %s 与硬件不匹配: 麦克风 %d 通道", format, (int)mic_channels);
+        return ESP_ERR_INVALID_ARG;
     }
 
+    memcpy(wrapper->input_format, format, len + 1);
+    wrapper->channels = len;
+    wrapper->mic_channels = mics;
+    wrapper->has_reference = refs > 0;
+    return ESP_OK;
+}
+
+/**
+ * @brief AFE 读取回调函数
+ * 
+ * 从 I2S HAL 读取（多通道交织的）麦克风数据，从环形缓冲区读取回采数据，
+ * 并按输入格式（如 MR、MMR）交织成 AFE 所需的多通道帧
+ * 
+ * @param wrapper AFE 包装器
+ * @param out_buf 输出缓冲区，用于存放交织后的音频数据
+ * @param frame_samples 每通道采样点数
+ * @return size_t 实际读取的每通道采样点数（不足部分已补零）
+ */
+static size_t afe_read_callback(afe_wrapper_t *wrapper, int16_t *out_buf, size_t frame_samples)
+{
+    const size_t channels = wrapper->channels;
     size_t mic_got = 0;
 
-    // 仅在运行状态下读取数据
-    if (wrapper->running_ptr && *wrapper->running_ptr) {
-        // 读取麦克风数据
-        esp_err_t ret = audio_bsp_read_mic(wrapper->bsp_handle, wrapper->mic_buffer, 
-                                         frame_samples, &mic_got);
+    // 读取麦克风数据
+    esp_err_t ret = audio_bsp_read_mic(wrapper->bsp_handle, wrapper->mic_buffer, 
+                                     frame_samples, &mic_got);
 
-        if (ret != ESP_OK || mic_got == 0) {
-            memset(out_buf, 0, buf_sz);
-            return buf_sz;
-        }
+    if (ret != ESP_OK || mic_got == 0) {
+        memset(out_buf, 0, frame_samples * channels * sizeof(int16_t));
+        return 0;
+    }
 
-        // 读取回采数据（用于回声消除）
-        size_t ref_got = ring_buffer_read(wrapper->reference_rb, wrapper->ref_buffer, mic_got, 0);
+    // 读取回采数据（用于回声消除）
+    size_t ref_got = wrapper->has_reference
+                   ? ring_buffer_read(wrapper->reference_rb, wrapper->ref_buffer, mic_got, 0)
+                   : mic_got;
 
-        // 如果回采数据不足，用静音填充
-        if (ref_got < mic_got) {
-            memset(wrapper->ref_buffer + ref_got, 0, (mic_got - ref_got) * sizeof(int16_t));
-        }
+    uint32_t start = AUDIO_METRICS_CYCLES();
+
+    // 如果回采数据不足，用静音填充
+    if (ref_got < mic_got) {
+        memset(wrapper->ref_buffer + ref_got, 0, (mic_got - ref_got) * sizeof(int16_t));
+        wrapper->stats.reference_underrun++;
+    }
 
-        // 交织数据: MR 格式（M=麦克风，R=回采）
-        for (size_t i = 0; i < mic_got; i++) {
-            out_buf[i * 2 + 0] = wrapper->mic_buffer[i];  // M: 麦克风
-            out_buf[i * 2 + 1] = wrapper->ref_buffer[i];  // R: 回采
+    // 按通道段交织（M=麦克风，R=回采，N=空通道）
+    for (size_t r = 0; r < wrapper->run_count; r++) {
+        const afe_channel_run_t *run = &wrapper->runs[r];
+        int16_t *dst = out_buf + run->pos;
+        switch (run->type) {
+        case 'M':
+            audio_interleave_s16(dst, channels, wrapper->mic_buffer + run->mic_index,
+                                 wrapper->mic_channels, run->count, mic_got);
+            break;
+        case 'R':
+            audio_interleave_s16(dst, channels, wrapper->ref_buffer, 1, 1, mic_got);
+            break;
+        default:
+            for (size_t c = 0; c < run->count; c++) {
+                audio_fill_channel_s16(dst + c, channels, 0, mic_got);
+            }
+            break;
         }
-    } else {
-        // 未运行时填充静音，并临时不向 AFE 提供有效数据，避免在系统尚未开始监听时填满内部 ringbuffer
-        memset(out_buf, 0, buf_sz);
-        return 0;
     }
 
-    return mic_got * channels * sizeof(int16_t);
+    // 引擎要求整帧输入，短读部分补零
+    if (mic_got < frame_samples) {
+        memset(out_buf + mic_got * channels, 0, (frame_samples - mic_got) * channels * sizeof(int16_t));
+    }
+    audio_stage_stats_add(&wrapper->stats.interleave, start);
+
+    return mic_got;
+}
+
+/**
+ * @brief 记录事件时延（从对应帧送入引擎到事件回调）
+ * 
+ * @param wrapper AFE 包装器
+ */
+static void afe_record_event_latency(afe_wrapper_t *wrapper)
+{
+    size_t chunk = wrapper->engine->feed_chunk_frames;
+    if (chunk == 0 || wrapper->fetched_samples == 0) {
+        return;
+    }
+
+    // 当前结果最后一个采样点所在的 feed 帧
+    uint32_t index = (uint32_t)((wrapper->fetched_samples - 1) / chunk);
+    uint32_t fed = wrapper->feed_seq;
+    if (index >= fed || fed - index > AFE_WRAPPER_LATENCY_SLOTS) {
+        return;  // 时间戳已被覆盖
+    }
+
+    int64_t latency = esp_timer_get_time() - wrapper->feed_time_us[index % AFE_WRAPPER_LATENCY_SLOTS];
+    if (latency < 0) {
+        return;
+    }
+    wrapper->stats.event_latency_us_last = (uint32_t)latency;
+    if (wrapper->stats.event_latency_us_last > wrapper->stats.event_latency_us_max) {
+        wrapper->stats.event_latency_us_max = wrapper->stats.event_latency_us_last;
+    }
 }
 
 /**
@@ -116,55 +266,289 @@ static int32_t afe_read_callback(void *buffer, int buf_sz, void *user_ctx, TickT
  * 
  * 处理 AFE 的处理结果，包括唤醒词检测、VAD 状态变化和录音数据
  * 
- * @param result AFE 处理结果
- * @param user_ctx 用户上下文，指向 afe_wrapper_t 结构体
+ * @param wrapper AFE 包装器
+ * @param result AFE 引擎处理结果
  */
-static void afe_result_callback(afe_fetch_result_t *result, void *user_ctx)
+static void afe_result_callback(afe_wrapper_t *wrapper, const afe_engine_result_t *result)
 {
-    afe_wrapper_t *wrapper = (afe_wrapper_t *)user_ctx;
-    if (!result || !wrapper || !wrapper->event_callback) return;
-
+    uint32_t start = AUDIO_METRICS_CYCLES();
     afe_event_t event = {0};
 
+    wrapper->fetched_samples += result->samples;
+
     // 处理唤醒词检测事件
-    if (result->wakeup_state == WAKENET_DETECTED) {
+    if (result->wakeup_detected) {
         event.type = AFE_EVENT_WAKEUP_DETECTED;
         event.data.wakeup.wake_word_index = result->wake_word_index;
-        event.data.wakeup.volume_db = result->data_volume;
+        event.data.wakeup.volume_db = result->volume_db;
 
         ESP_LOGI(TAG, "🎤 唤醒词检测: 索引=%d, 音量=%.1f dB",
-                 result->wake_word_index, result->data_volume);
+                 result->wake_word_index, result->volume_db);
 
+        afe_record_event_latency(wrapper);
         wrapper->event_callback(&event, wrapper->event_ctx);
     }
 
     // 处理 VAD（语音活动检测）状态变化
-    static bool vad_active = false;
-
-    if (result->vad_state == VAD_SPEECH && !vad_active) {
+    if (result->vad_speech && !wrapper->vad_active) {
         // 检测到语音开始
-        vad_active = true;
+        wrapper->vad_active = true;
         event.type = AFE_EVENT_VAD_START;
+        afe_record_event_latency(wrapper);
         wrapper->event_callback(&event, wrapper->event_ctx);
-    } else if (result->vad_state == VAD_SILENCE && vad_active) {
+    } else if (!result->vad_speech && wrapper->vad_active) {
         // 检测到语音结束
-        vad_active = false;
+        wrapper->vad_active = false;
         event.type = AFE_EVENT_VAD_END;
+        afe_record_event_latency(wrapper);
         wrapper->event_callback(&event, wrapper->event_ctx);
     }
 
     // 处理录音数据回调
     if (wrapper->recording_ptr && *wrapper->recording_ptr && 
-        result->data && result->data_size > 0 && wrapper->record_callback) {
-        size_t samples = result->data_size / sizeof(int16_t);
-        wrapper->record_callback((const int16_t *)result->data, samples, wrapper->record_ctx);
+        result->data && result->samples > 0 && wrapper->record_callback) {
+        wrapper->record_callback(result->data, result->samples, wrapper->record_ctx);
+    }
+
+    audio_stage_stats_add(&wrapper->stats.result, start);
+}
+
+/**
+ * @brief 比较两个可能为 NULL 的字符串
+ */
+static bool afe_wrapper_str_equal(const char *a, const char *b)
+{
+    if (!a || !b) {
+        return a == b;
+    }
+    return strcmp(a, b) == 0;
+}
+
+/**
+ * @brief 在帧边界应用待处理的模型切换与配置变更（feed 任务中调用）
+ * 
+ * @param wrapper AFE 包装器
+ */
+static void afe_wrapper_apply_pending(afe_wrapper_t *wrapper)
+{
+    // 切换到后台加载完成的新引擎（旧引擎尚未被 fetch 任务放手时推迟到下一帧）
+    afe_engine_t *staged = wrapper->staged_engine;
+    if (staged && !wrapper->pending_retire) {
+        afe_engine_t *old = wrapper->engine;
+
+        // 新引擎沿用当前的功能开关，只替换唤醒词配置
+        portENTER_CRITICAL(&wrapper->config_lock);
+        afe_engine_config_t cfg = wrapper->engine_config;
+        cfg.wakeup = wrapper->swap_config.wakeup;
+        portEXIT_CRITICAL(&wrapper->config_lock);
+        staged->ops->configure(staged, &cfg);
+
+        wrapper->staged_engine = NULL;
+        wrapper->swap_feed_seq = wrapper->feed_seq;
+        wrapper->engine = staged;           // 先发布新引擎
+        wrapper->pending_retire = old;      // 再通知 fetch 任务放手旧引擎
+
+        portENTER_CRITICAL(&wrapper->config_lock);
+        wrapper->engine_config = cfg;
+        wrapper->engine_has_wakenet = cfg.wakeup.enabled;
+        portEXIT_CRITICAL(&wrapper->config_lock);
+
+        int64_t latency = esp_timer_get_time() - wrapper->swap_request_us;
+        wrapper->stats.model_swap_count++;
+        wrapper->stats.model_swap_latency_us_last = latency > 0 ? (uint32_t)latency : 0;
+        ESP_LOGI(TAG, "✅ 唤醒词模型已切换: %s (用时 %d ms)",
+                 cfg.wakeup.wake_word_name ? cfg.wakeup.wake_word_name : "-", (int)(latency / 1000));
+    }
+
+    if (!wrapper->config_pending) {
+        return;
+    }
+
+    portENTER_CRITICAL(&wrapper->config_lock);
+    afe_engine_config_t cfg = wrapper->pending_config;
+    int64_t request_us = wrapper->config_request_us;
+    wrapper->config_pending = false;
+    // 唤醒词配置只在模型一致时生效，模型不同的配置由切换流程负责
+    if (!afe_wrapper_str_equal(cfg.wakeup.wake_word_name, wrapper->engine_config.wakeup.wake_word_name) ||
+        !afe_wrapper_str_equal(cfg.wakeup.model_partition, wrapper->engine_config.wakeup.model_partition)) {
+        cfg.wakeup = wrapper->engine_config.wakeup;
+    }
+    portEXIT_CRITICAL(&wrapper->config_lock);
+
+    afe_engine_t *engine = wrapper->engine;
+    if (engine->ops->configure(engine, &cfg) != ESP_OK) {
+        ESP_LOGW(TAG, "AFE 重配置失败");
+        return;
+    }
+
+    portENTER_CRITICAL(&wrapper->config_lock);
+    wrapper->engine_config = cfg;
+    portEXIT_CRITICAL(&wrapper->config_lock);
+
+    int64_t latency = esp_timer_get_time() - request_us;
+    wrapper->stats.reconfig_count++;
+    wrapper->stats.reconfig_latency_us_last = latency > 0 ? (uint32_t)latency : 0;
+    if (wrapper->stats.reconfig_latency_us_last > wrapper->stats.reconfig_latency_us_max) {
+        wrapper->stats.reconfig_latency_us_max = wrapper->stats.reconfig_latency_us_last;
+    }
+}
+
+/**
+ * @brief 放手已切出的旧引擎（fetch 任务中调用）
+ * 
+ * 旧引擎中已送入但未取出的帧随旧引擎丢弃，计入 model_swap_dropped_frames；
+ * 同时把取出进度对齐到切换点，保证事件时延统计仍按帧对应
+ * 
+ * @param wrapper AFE 包装器
+ * @param old 旧引擎
+ */
+static void afe_wrapper_release_engine(afe_wrapper_t *wrapper, afe_engine_t *old)
+{
+    size_t chunk = wrapper->engine->feed_chunk_frames;
+    uint64_t swap_samples = (uint64_t)wrapper->swap_feed_seq * chunk;
+    if (swap_samples > wrapper->fetched_samples) {
+        wrapper->stats.model_swap_dropped_frames +=
+            (uint32_t)((swap_samples - wrapper->fetched_samples) / chunk);
+    }
+    wrapper->fetched_samples = swap_samples;
+
+    wrapper->pending_retire = NULL;
+    wrapper->retired_engine = old;      // 交给后台加载任务销毁
+}
+
+/**
+ * @brief 唤醒词模型后台加载任务
+ * 
+ * 加载新模型并创建新引擎，交给 feed 任务在帧边界切换，
+ * 等 fetch 任务放手旧引擎后在本任务中销毁，避免阻塞音频任务
+ */
+static void afe_model_loader_task(void *arg)
+{
+    afe_wrapper_t *wrapper = (afe_wrapper_t *)arg;
+    afe_engine_t *current = wrapper->engine;
+
+    afe_engine_t *engine = afe_engine_create(wrapper->engine_type, &wrapper->swap_config);
+    if (engine && (engine->feed_chunk_frames != current->feed_chunk_frames ||
+                   engine->channels != current->channels)) {
+        ESP_LOGE(TAG, "新模型帧参数不一致: chunk=%d, 通道=%d",
+                 (int)engine->feed_chunk_frames, (int)engine->channels);
+        engine->ops->destroy(engine);
+        engine = NULL;
+    }
+    if (!engine) {
+        ESP_LOGE(TAG, "唤醒词模型加载失败，保持当前模型");
+        wrapper->swap_busy = false;
+        vTaskDelete(NULL);
+        return;
+    }
+
+    ESP_LOGI(TAG, "新模型后台加载完成，用时 %d ms，等待帧边界切换",
+             (int)((esp_timer_get_time() - wrapper->swap_request_us) / 1000));
+    wrapper->staged_engine = engine;
+
+    // 等待切换完成且 fetch 任务放手旧引擎
+    while (wrapper->tasks_running && !wrapper->retired_engine) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    afe_engine_t *old = wrapper->retired_engine;
+    if (old) {
+        wrapper->retired_engine = NULL;
+        old->ops->destroy(old);
+    }
+
+    wrapper->swap_busy = false;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Feed 任务：读取麦克风/回采，交织后送入引擎
+ * 
+ * 未运行时不向引擎提供数据，避免在系统尚未开始监听时填满引擎内部缓冲；
+ * 每帧送入前检查并应用待处理的配置变更与模型切换
+ */
+static void afe_feed_task(void *arg)
+{
+    afe_wrapper_t *wrapper = (afe_wrapper_t *)arg;
+
+    while (wrapper->tasks_running) {
+        afe_wrapper_apply_pending(wrapper);
+
+        if (!wrapper->running_ptr || !*wrapper->running_ptr) {
+            vTaskDelay(pdMS_TO_TICKS(AFE_WRAPPER_IDLE_MS));
+            continue;
+        }
+
+        afe_engine_t *engine = wrapper->engine;
+        const size_t chunk = engine->feed_chunk_frames;
+        if (afe_read_callback(wrapper, wrapper->feed_buffer, chunk) == 0) {
+            continue;
+        }
+
+        uint32_t start = AUDIO_METRICS_CYCLES();
+        int64_t now = esp_timer_get_time();
+        esp_err_t ret = engine->ops->feed(engine, wrapper->feed_buffer, chunk);
+        audio_stage_stats_add(&wrapper->stats.feed, start);
+
+        if (ret == ESP_OK) {
+            wrapper->feed_time_us[wrapper->feed_seq % AFE_WRAPPER_LATENCY_SLOTS] = now;
+            wrapper->feed_seq++;
+        } else {
+            wrapper->stats.feed_rejected++;
+        }
+    }
+
+    wrapper->feed_alive = false;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Fetch 任务：取出引擎结果并分发事件/录音数据
+ */
+static void afe_fetch_task(void *arg)
+{
+    afe_wrapper_t *wrapper = (afe_wrapper_t *)arg;
+    afe_engine_result_t result;
+
+    while (wrapper->tasks_running) {
+        // 先检查切换再读取引擎指针：发布顺序保证看到旧引擎待放手时新引擎已可见
+        afe_engine_t *old = wrapper->pending_retire;
+        if (old) {
+            afe_wrapper_release_engine(wrapper, old);
+        }
+
+        afe_engine_t *engine = wrapper->engine;
+        if (engine->ops->fetch(engine, &result, AFE_WRAPPER_FETCH_TIMEOUT) == ESP_OK) {
+            afe_result_callback(wrapper, &result);
+        }
+    }
+
+    wrapper->fetch_alive = false;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 停止 Feed/Fetch 任务并等待其退出
+ * 
+ * @param wrapper AFE 包装器
+ */
+static void afe_wrapper_stop_tasks(afe_wrapper_t *wrapper)
+{
+    wrapper->tasks_running = false;
+
+    // 等待任务退出（fetch 超时 + 一次麦克风读取）
+    for (int i = 0; i < 50 && (wrapper->feed_alive || wrapper->fetch_alive); i++) {
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+    if (wrapper->feed_alive || wrapper->fetch_alive) {
+        ESP_LOGW(TAG, "AFE 任务未能及时退出");
     }
 }
 
 /**
  * @brief 创建 AFE 包装器
  * 
- * 初始化 AFE Manager，加载唤醒词模型，配置各种音频处理功能
+ * 创建 AFE 引擎（加载唤醒词模型、配置各种音频处理功能），并启动 Feed/Fetch 任务
  * 
  * @param config AFE 包装器配置
  * @return afe_wrapper_handle_t AFE 包装器句柄，失败返回 NULL
@@ -193,88 +577,84 @@ afe_wrapper_handle_t afe_wrapper_create(const afe_wrapper_config_t *config)
     wrapper->record_ctx = config->record_ctx;
     wrapper->running_ptr = config->running_ptr;
     wrapper->recording_ptr = config->recording_ptr;
+    wrapper->config_lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    wrapper->engine_type = config->engine_type;
+    wrapper->engine_has_wakenet = config->wakeup_config.enabled;
 
-    // 加载唤醒词模型
-    if (config->wakeup_config.enabled) {
-        ESP_LOGI(TAG, "加载唤醒词模型: %s", config->wakeup_config.wake_word_name);
-        wrapper->models = esp_srmodel_init(config->wakeup_config.model_partition);
-        if (!wrapper->models) {
-            ESP_LOGE(TAG, "模型加载失败");
-            free(wrapper);
-            return NULL;
-        }
-        ESP_LOGI(TAG, "✅ 加载了 %d 个模型", wrapper->models->num);
-    }
-
-    // 配置 AFE
-    ESP_LOGI(TAG, "配置 AFE Manager...");
-    afe_config_t *afe_config = afe_config_init("MR", wrapper->models, AFE_TYPE_SR, 
-                                                config->feature_config.afe_mode);
-    if (!afe_config) {
-        ESP_LOGE(TAG, "AFE 配置失败");
-        if (wrapper->models) esp_srmodel_deinit(wrapper->models);
+    // 解析输入格式
+    const char *format = config->input_format ? config->input_format : AFE_WRAPPER_INPUT_FORMAT;
+    if (afe_wrapper_parse_format(wrapper, format, audio_bsp_get_mic_channels(config->bsp_handle)) != ESP_OK) {
         free(wrapper);
         return NULL;
     }
 
-    // 配置音频处理功能
-    afe_config->aec_init = config->feature_config.aec_enabled;      // 回声消除
-    afe_config->se_init = false;                                    // 语音增强（未启用）
-    afe_config->vad_init = config->vad_config.enabled;              // 语音活动检测
-    afe_config->vad_mode = config->vad_config.vad_mode;             // VAD 模式
-    afe_config->vad_min_speech_ms = config->vad_config.min_speech_ms;   // 最小语音时长
-    afe_config->vad_min_noise_ms = config->vad_config.min_silence_ms;   // 最小静音时长
-    afe_config->wakenet_init = config->wakeup_config.enabled;      // 唤醒词检测
-    afe_config->wakenet_mode = config->wakeup_config.sensitivity;   // 唤醒词灵敏度
-    afe_config->afe_perferred_core = 0;                             // 优先运行在核心 0
-    afe_config->afe_perferred_priority = 8;                         // 任务优先级
-    afe_config->memory_alloc_mode = AFE_MEMORY_ALLOC_MORE_PSRAM;    // 优先使用 PSRAM
-    afe_config->agc_init = config->feature_config.agc_enabled;     // 自动增益控制
-    afe_config->ns_init = config->feature_config.ns_enabled;       // 噪声抑制
-    afe_config->afe_ringbuf_size = 120;                             // 环形缓冲区大小（加大以提供更多缓冲空间）
-
-    // 验证配置并创建 AFE 句柄
-    afe_config = afe_config_check(afe_config);
-    wrapper->afe_handle = esp_afe_handle_from_config(afe_config);
-
-    // 创建 AFE Manager
-    esp_gmf_afe_manager_cfg_t mgr_cfg = {
-        .afe_cfg = afe_config,
-        .read_cb = afe_read_callback,              // 数据读取回调
-        .read_ctx = wrapper,                       // 读取回调上下文
-        .feed_task_setting = {
-            .stack_size = 10 * 1024,               // Feed 任务栈大小（缩减以降低内部RAM占用）
-            .prio = 8,                             // Feed 任务优先级
-            .core = 1,                             // Feed 任务运行核心（保持在 CPU1）
-        },
-        .fetch_task_setting = {
-            .stack_size = 10 * 1024,                // Fetch 任务栈大小（缩减占用）
-            .prio = 8,                             // Fetch 任务优先级（与Feed相同，时间片轮转）
-            .core = 0,                             // Fetch 任务运行在 CPU0，与 Feed 分核
-        },
+    // 创建 AFE 引擎
+    wrapper->engine_config = (afe_engine_config_t){
+        .input_format = wrapper->input_format,
+        .sample_rate = 16000,
+        .wakeup = config->wakeup_config,
+        .vad = config->vad_config,
+        .feature = config->feature_config,
+        .wake_template = config->wake_template,
+        .wake_template_frames = config->wake_template_frames,
     };
-
-    esp_err_t ret = esp_gmf_afe_manager_create(&mgr_cfg, &wrapper->afe_manager);
-    afe_config_free(afe_config);
-
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "AFE Manager 创建失败");
-        if (wrapper->models) esp_srmodel_deinit(wrapper->models);
+    wrapper->engine = afe_engine_create(config->engine_type, &wrapper->engine_config);
+    if (!wrapper->engine) {
+        ESP_LOGE(TAG, "AFE 引擎创建失败");
         free(wrapper);
         return NULL;
     }
 
-    // 设置结果回调
-    esp_gmf_afe_manager_set_result_cb(wrapper->afe_manager, afe_result_callback, wrapper);
+    afe_engine_t *engine = wrapper->engine;
+    if (engine->feed_chunk_frames == 0 || engine->feed_chunk_frames > AFE_WRAPPER_MAX_FRAME ||
+        engine->channels != wrapper->channels) {
+        ESP_LOGE(TAG, "AFE 引擎参数不支持: chunk=%d, 通道=%d",
+                 (int)engine->feed_chunk_frames, (int)engine->channels);
+        goto fail;
+    }
+
+    wrapper->feed_buffer = (int16_t *)heap_caps_malloc(
+        engine->feed_chunk_frames * engine->channels * sizeof(int16_t),
+        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!wrapper->feed_buffer) {
+        ESP_LOGE(TAG, "Feed 缓冲区分配失败");
+        goto fail;
+    }
+
+    // 启动 Feed/Fetch 任务
+    wrapper->tasks_running = true;
+    wrapper->feed_alive = true;
+    if (xTaskCreatePinnedToCore(afe_feed_task, "afe_feed", AFE_WRAPPER_TASK_STACK, wrapper,
+                                AFE_WRAPPER_TASK_PRIO, &wrapper->feed_task,
+                                AFE_WRAPPER_FEED_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Feed 任务创建失败");
+        wrapper->feed_alive = false;
+        goto fail;
+    }
+    wrapper->fetch_alive = true;
+    if (xTaskCreatePinnedToCore(afe_fetch_task, "afe_fetch", AFE_WRAPPER_TASK_STACK, wrapper,
+                                AFE_WRAPPER_TASK_PRIO, &wrapper->fetch_task,
+                                AFE_WRAPPER_FETCH_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Fetch 任务创建失败");
+        wrapper->fetch_alive = false;
+        goto fail;
+    }
 
-    ESP_LOGI(TAG, "✅ AFE 包装器创建成功");
+    ESP_LOGI(TAG, "✅ AFE 包装器创建成功: 引擎=%s", engine->ops->name);
     return wrapper;
+
+fail:
+    afe_wrapper_stop_tasks(wrapper);
+    engine->ops->destroy(engine);
+    heap_caps_free(wrapper->feed_buffer);
+    free(wrapper);
+    return NULL;
 }
 
 /**
  * @brief 销毁 AFE 包装器
  * 
- * 释放 AFE Manager 和模型资源
+ * 停止 Feed/Fetch 任务并释放 AFE 引擎资源
  * 
  * @param wrapper AFE 包装器句柄
  */
@@ -282,21 +662,114 @@ void afe_wrapper_destroy(afe_wrapper_handle_t wrapper)
 {
     if (!wrapper) return;
 
-    // 销毁 AFE Manager
-    if (wrapper->afe_manager) {
-        esp_gmf_afe_manager_destroy(wrapper->afe_manager);
+    // 先停止任务，再销毁引擎
+    afe_wrapper_stop_tasks(wrapper);
+
+    // 等待后台模型加载结束（加载任务看到任务停止后会尽快退出）
+    for (int i = 0; i < AFE_WRAPPER_LOADER_WAIT_MS / 20 && wrapper->swap_busy; i++) {
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+    if (wrapper->swap_busy) {
+        // 加载任务仍持有 wrapper，只能泄漏以避免释放后访问
+        ESP_LOGE(TAG, "模型加载任务未结束，放弃释放 AFE 包装器");
+        return;
     }
 
-    // 释放模型资源
-    if (wrapper->models) {
-        esp_srmodel_deinit(wrapper->models);
+    afe_engine_t *engines[] = {
+        wrapper->engine, wrapper->staged_engine, wrapper->pending_retire, wrapper->retired_engine,
+    };
+    for (size_t i = 0; i < sizeof(engines) / sizeof(engines[0]); i++) {
+        if (engines[i]) {
+            engines[i]->ops->destroy(engines[i]);
+        }
     }
+    heap_caps_free(wrapper->feed_buffer);
 
     // 释放包装器内存
     free(wrapper);
     ESP_LOGI(TAG, "AFE 包装器已销毁");
 }
 
+/**
+ * @brief 在线重配置 AFE
+ * 
+ * 功能开关与灵敏度写入 pending_config，由 feed 任务在下一个帧边界应用；
+ * 唤醒词模型变化时启动后台加载任务，加载完成后原子切换引擎
+ * 
+ * @param wrapper AFE 包装器句柄
+ * @param wakeup 唤醒词配置（NULL 表示不变）
+ * @param vad VAD 配置（NULL 表示不变）
+ * @param feature 功能配置（NULL 表示不变）
+ * @return esp_err_t ESP_OK 已提交，ESP_ERR_INVALID_STATE 上一次模型切换未完成
+ */
+esp_err_t afe_wrapper_reconfigure(afe_wrapper_handle_t wrapper,
+                                  const afe_wakeup_config_t *wakeup,
+                                  const afe_vad_config_t *vad,
+                                  const afe_feature_config_t *feature)
+{
+    if (!wrapper || (!wakeup && !vad && !feature)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t now = esp_timer_get_time();
+    bool start_loader = false;
+
+    portENTER_CRITICAL(&wrapper->config_lock);
+    afe_engine_config_t cfg = wrapper->config_pending ? wrapper->pending_config : wrapper->engine_config;
+    if (vad) {
+        cfg.vad = *vad;
+    }
+    if (feature) {
+        int afe_mode = cfg.feature.afe_mode;
+        cfg.feature = *feature;
+        cfg.feature.afe_mode = afe_mode;    // AFE 模式只在创建时生效
+    }
+
+    // 唤醒词模型（或模型分区）变化，或在未加载模型的引擎上开启唤醒：需要后台加载
+    bool model_change = wakeup && wakeup->enabled &&
+        (!wrapper->engine_has_wakenet ||
+         !afe_wrapper_str_equal(wakeup->wake_word_name, cfg.wakeup.wake_word_name) ||
+         !afe_wrapper_str_equal(wakeup->model_partition, cfg.wakeup.model_partition));
+
+    if (model_change) {
+        if (wrapper->swap_busy) {
+            portEXIT_CRITICAL(&wrapper->config_lock);
+            ESP_LOGW(TAG, "上一次模型切换尚未完成");
+            return ESP_ERR_INVALID_STATE;
+        }
+        wrapper->swap_busy = true;
+        wrapper->swap_config = cfg;
+        wrapper->swap_config.wakeup = *wakeup;
+        wrapper->swap_request_us = now;
+        start_loader = true;
+    } else if (wakeup) {
+        cfg.wakeup = *wakeup;
+    }
+
+    // 功能开关 / 灵敏度：帧边界生效（模型切换时旧引擎保持原唤醒配置）
+    if (!wrapper->config_pending) {
+        wrapper->config_request_us = now;
+    }
+    wrapper->pending_config = cfg;
+    wrapper->config_pending = true;
+    if (wakeup) {
+        wrapper->wakeup_config = *wakeup;
+    }
+    portEXIT_CRITICAL(&wrapper->config_lock);
+
+    if (start_loader) {
+        ESP_LOGI(TAG, "后台加载唤醒词模型: %s", wakeup->wake_word_name ? wakeup->wake_word_name : "-");
+        if (xTaskCreate(afe_model_loader_task, "afe_loader", AFE_WRAPPER_LOADER_STACK, wrapper,
+                        AFE_WRAPPER_LOADER_PRIO, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "模型加载任务创建失败");
+            wrapper->swap_busy = false;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    return ESP_OK;
+}
+
 /**
  * @brief 更新唤醒词配置
  * 
@@ -311,10 +784,11 @@ esp_err_t afe_wrapper_update_wakeup_config(afe_wrapper_handle_t wrapper,
         return ESP_ERR_INVALID_ARG;
     }
 
-    memcpy(&wrapper->wakeup_config, config, sizeof(afe_wakeup_config_t));
-    ESP_LOGI(TAG, "唤醒词配置已更新: %s", config->wake_word_name);
-
-    return ESP_OK;
+    esp_err_t ret = afe_wrapper_reconfigure(wrapper, config, NULL, NULL);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "唤醒词配置已更新: %s", config->wake_word_name);
+    }
+    return ret;
 }
 
 /**
@@ -335,3 +809,31 @@ esp_err_t afe_wrapper_get_wakeup_config(afe_wrapper_handle_t wrapper,
     return ESP_OK;
 }
 
+/**
+ * @brief 获取 AFE 包装器统计
+ * 
+ * @param wrapper AFE 包装器句柄
+ * @param stats 输出统计
+ * @return esp_err_t ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t afe_wrapper_get_stats(afe_wrapper_handle_t wrapper, afe_wrapper_stats_t *stats)
+{
+    if (!wrapper || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *stats = wrapper->stats;
+    return ESP_OK;
+}
+
+/**
+ * @brief 清零 AFE 包装器统计
+ * 
+ * @param wrapper AFE 包装器句柄
+ */
+void afe_wrapper_reset_stats(afe_wrapper_handle_t wrapper)
+{
+    if (wrapper) {
+        memset(&wrapper->stats, 0, sizeof(wrapper->stats));
+    }
+}
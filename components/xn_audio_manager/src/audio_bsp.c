@@ -33,6 +33,7 @@ audio_bsp_handle_t audio_bsp_create(const audio_bsp_hw_config_t *config)
         .bits = config->mic.bits,
         .max_frame_samples = config->mic.max_frame_samples ? config->mic.max_frame_samples : 512,
         .bit_shift = config->mic.bit_shift ? config->mic.bit_shift : 14,
+        .channels = config->mic.channels ? config->mic.channels : 1,
     };
 
     i2s_speaker_config_t speaker_cfg = {
@@ -88,6 +89,14 @@ esp_err_t audio_bsp_read_mic(audio_bsp_handle_t handle,
     return i2s_hal_read_mic(handle->i2s, out_samples, sample_count, out_got);
 }
 
+size_t audio_bsp_get_mic_channels(audio_bsp_handle_t handle)
+{
+    if (!handle || !handle->i2s) {
+        return 0;
+    }
+    return i2s_hal_get_mic_channels(handle->i2s);
+}
+
 esp_err_t audio_bsp_write_speaker(audio_bsp_handle_t handle,
                                   const int16_t *samples,
                                   size_t sample_count,
@@ -115,4 +124,18 @@ i2s_chan_handle_t audio_bsp_get_tx(audio_bsp_handle_t handle)
     return i2s_hal_get_tx_handle(handle->i2s);
 }
 
+esp_err_t audio_bsp_get_io_stats(audio_bsp_handle_t handle, audio_io_stats_t *stats)
+{
+    if (!handle || !handle->i2s) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return i2s_hal_get_stats(handle->i2s, stats);
+}
 
+void audio_bsp_reset_io_stats(audio_bsp_handle_t handle)
+{
+    if (!handle || !handle->i2s) {
+        return;
+    }
+    i2s_hal_reset_stats(handle->i2s);
+}
@@ -0,0 +1,166 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\src\audio_bsp_host.c
+ * @Description: linux 目标的音频 BSP：麦克风数据来自注册的数据源，扬声器只计数
+ *
+ * 按采样率（乘以倍速）节拍返回数据，与 I2S DMA 的阻塞读一致；节拍等待不计入 mic_read 耗时。
+ * 没有数据源或数据源暂无数据时，等待一帧时长后返回超时，避免 feed 任务空转。
+ */
+
+#include "audio_bsp.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "audio_bsp";
+
+struct audio_bsp_s {
+    int mic_sample_rate;
+    int speaker_sample_rate;
+    size_t mic_channels;
+    int64_t mic_next_us;            ///< 按节拍读取时下一帧的到达时间
+    audio_io_stats_t stats;
+};
+
+static audio_bsp_host_mic_source_t s_mic_source = NULL;
+static void *s_mic_ctx = NULL;
+static float s_mic_speed = 1.0f;
+
+void audio_bsp_host_set_mic_source(audio_bsp_host_mic_source_t source, void *ctx, float speed)
+{
+    s_mic_ctx = ctx;
+    s_mic_speed = speed;
+    __atomic_store_n(&s_mic_source, source, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 等待到 target_us（单调时钟）
+ */
+static void audio_bsp_sleep_until(int64_t target_us)
+{
+    int64_t wait_us = target_us - esp_timer_get_time();
+    if (wait_us >= 1000) {
+        vTaskDelay(pdMS_TO_TICKS(wait_us / 1000));
+    }
+}
+
+audio_bsp_handle_t audio_bsp_create(const audio_bsp_hw_config_t *config)
+{
+    if (!config) {
+        return NULL;
+    }
+
+    audio_bsp_handle_t handle = (audio_bsp_handle_t)calloc(1, sizeof(struct audio_bsp_s));
+    if (!handle) {
+        ESP_LOGE(TAG, "alloc audio_bsp failed");
+        return NULL;
+    }
+
+    handle->mic_sample_rate = config->mic.sample_rate > 0 ? config->mic.sample_rate : 16000;
+    handle->speaker_sample_rate = config->speaker.sample_rate > 0 ? config->speaker.sample_rate : 16000;
+    handle->mic_channels = config->mic.channels ? config->mic.channels : 1;
+    ESP_LOGI(TAG, "audio BSP (host) ready: mic %d Hz x %d",
+             handle->mic_sample_rate, (int)handle->mic_channels);
+    return handle;
+}
+
+void audio_bsp_destroy(audio_bsp_handle_t handle)
+{
+    free(handle);
+}
+
+esp_err_t audio_bsp_read_mic(audio_bsp_handle_t handle,
+                             int16_t *out_samples,
+                             size_t sample_count,
+                             size_t *out_got)
+{
+    if (!handle || !out_samples || !out_got) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t frame_us = (int64_t)sample_count * 1000000 / handle->mic_sample_rate;
+    audio_bsp_host_mic_source_t source = __atomic_load_n(&s_mic_source, __ATOMIC_ACQUIRE);
+    float speed = s_mic_speed;
+
+    if (speed > 0.0f) {
+        int64_t step_us = (int64_t)((float)frame_us / speed);
+        int64_t now = esp_timer_get_time();
+        // 落后超过一帧（如刚开始读取）时重新对齐，不追赶
+        if (handle->mic_next_us < now - step_us) {
+            handle->mic_next_us = now;
+        }
+        handle->mic_next_us += step_us;
+        audio_bsp_sleep_until(handle->mic_next_us);
+    }
+
+    uint32_t start = AUDIO_METRICS_CYCLES();
+    size_t got = source ? source(out_samples, sample_count, handle->mic_channels, s_mic_ctx) : 0;
+    *out_got = got;
+    if (got == 0) {
+        if (speed <= 0.0f) {
+            vTaskDelay(pdMS_TO_TICKS(frame_us / 1000));
+        }
+        return ESP_ERR_TIMEOUT;
+    }
+
+    audio_stage_stats_add(&handle->stats.mic_read, start);
+    handle->stats.frames_captured++;
+    handle->stats.samples_captured += got;
+    return ESP_OK;
+}
+
+size_t audio_bsp_get_mic_channels(audio_bsp_handle_t handle)
+{
+    return handle ? handle->mic_channels : 0;
+}
+
+esp_err_t audio_bsp_write_speaker(audio_bsp_handle_t handle,
+                                  const int16_t *samples,
+                                  size_t sample_count,
+                                  uint8_t volume)
+{
+    (void)volume;
+    if (!handle || !samples) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 按播放时长阻塞，与 DMA 写入的节拍一致
+    vTaskDelay(pdMS_TO_TICKS((int64_t)sample_count * 1000 / handle->speaker_sample_rate));
+    handle->stats.frames_played++;
+    handle->stats.samples_played += sample_count;
+    return ESP_OK;
+}
+
+i2s_chan_handle_t audio_bsp_get_rx(audio_bsp_handle_t handle)
+{
+    (void)handle;
+    return NULL;
+}
+
+i2s_chan_handle_t audio_bsp_get_tx(audio_bsp_handle_t handle)
+{
+    (void)handle;
+    return NULL;
+}
+
+esp_err_t audio_bsp_get_io_stats(audio_bsp_handle_t handle, audio_io_stats_t *stats)
+{
+    if (!handle || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = handle->stats;
+    return ESP_OK;
+}
+
+void audio_bsp_reset_io_stats(audio_bsp_handle_t handle)
+{
+    if (handle) {
+        memset(&handle->stats, 0, sizeof(handle->stats));
+    }
+}
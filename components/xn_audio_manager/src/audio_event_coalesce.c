@@ -0,0 +1,91 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\src\audio_event_coalesce.c
+ * @Description: 高频事件合并器实现（按纪元分桶，见 audio_event_coalesce.h）
+ */
+#include "audio_event_coalesce.h"
+#include <string.h>
+
+static void audio_coalesce_remove(audio_coalesce_bucket_t *b, uint8_t index)
+{
+    for (uint8_t i = index + 1; i < b->count; i++) {
+        b->items[i - 1] = b->items[i];
+    }
+    b->count--;
+}
+
+void audio_coalesce_init(audio_coalesce_t *c)
+{
+    memset(c, 0, sizeof(*c));
+}
+
+uint32_t audio_coalesce_next_control(audio_coalesce_t *c)
+{
+    return ++c->control_seq;
+}
+
+uint32_t audio_coalesce_post(audio_coalesce_t *c, const audio_coalesce_item_t *item)
+{
+    uint32_t epoch = c->control_seq;
+    // 未处理的控制事件超过桶数时并入最晚的可用桶，避免覆盖尚未取出的纪元
+    if ((int32_t)(epoch - c->drain_epoch) >= AUDIO_EVENT_COALESCE_EPOCHS) {
+        epoch = c->drain_epoch + AUDIO_EVENT_COALESCE_EPOCHS - 1;
+        c->clamped++;
+    }
+    audio_coalesce_bucket_t *b = &c->buckets[epoch % AUDIO_EVENT_COALESCE_EPOCHS];
+
+    if (item->kind == AUDIO_COALESCE_WAKE) {
+        uint32_t dropped = 0;
+        for (uint8_t i = 0; i < b->count; i++) {
+            if (b->items[i].kind == AUDIO_COALESCE_WAKE) {
+                audio_coalesce_remove(b, i);
+                dropped = 1;
+                break;
+            }
+        }
+        b->items[b->count++] = *item;
+        return dropped;
+    }
+
+    // 桶内 VAD 始终交替出现，最多两项
+    int last = -1;
+    uint8_t vad_count = 0;
+    for (uint8_t i = 0; i < b->count; i++) {
+        if (b->items[i].kind != AUDIO_COALESCE_WAKE) {
+            last = i;
+            vad_count++;
+        }
+    }
+    if (last >= 0 && b->items[last].kind == item->kind) {
+        return 1;
+    }
+    if (vad_count == 2) {
+        // [A, B] 再来 A：B/A 成对抵消
+        audio_coalesce_remove(b, (uint8_t)last);
+        return 2;
+    }
+    b->items[b->count++] = *item;
+    return 0;
+}
+
+size_t audio_coalesce_take(audio_coalesce_t *c, uint32_t upto,
+                           audio_coalesce_item_t out[AUDIO_EVENT_COALESCE_BUCKET_MAX])
+{
+    while ((int32_t)(upto - c->drain_epoch) >= 0) {
+        audio_coalesce_bucket_t *b = &c->buckets[c->drain_epoch % AUDIO_EVENT_COALESCE_EPOCHS];
+        size_t n = b->count;
+        memcpy(out, b->items, n * sizeof(b->items[0]));
+        b->count = 0;
+        if (c->drain_epoch == upto) {
+            return n;
+        }
+        c->drain_epoch++;
+        if (n) {
+            return n;
+        }
+    }
+    return 0;
+}
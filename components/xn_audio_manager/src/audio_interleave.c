@@ -0,0 +1,120 @@
+/*
+ * @Author: 星年 && jixingnian@gmail.com
+ * @Date: 2025-12-04
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-04
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\src\audio_interleave.c
+ * @Description: 多通道 PCM 交织/解交织内核实现
+ *
+ * 热点循环按 4 帧展开，并以编译期常量步长实例化常见组合，
+ * 让编译器把地址计算折叠成立即数偏移（Xtensa 上无需额外乘法）。
+ */
+#include "audio_interleave.h"
+#include <string.h>
+
+#define AUDIO_KERNEL_INLINE static inline __attribute__((always_inline))
+
+void audio_convert_s32_to_s16(int16_t *dst, const int32_t *src, size_t count, uint8_t shift)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int32_t a = src[i + 0];
+        int32_t b = src[i + 1];
+        int32_t c = src[i + 2];
+        int32_t d = src[i + 3];
+        dst[i + 0] = (int16_t)(a >> shift);
+        dst[i + 1] = (int16_t)(b >> shift);
+        dst[i + 2] = (int16_t)(c >> shift);
+        dst[i + 3] = (int16_t)(d >> shift);
+    }
+    for (; i < count; i++) {
+        dst[i] = (int16_t)(src[i] >> shift);
+    }
+}
+
+/**
+ * @brief 定步长通道块复制（由调用点以常量实例化）
+ */
+AUDIO_KERNEL_INLINE void interleave_fixed(int16_t *dst, size_t ds, const int16_t *src, size_t ss,
+                                          size_t ch, size_t frames)
+{
+    size_t f = 0;
+    for (; f + 4 <= frames; f += 4) {
+        for (size_t c = 0; c < ch; c++) {
+            int16_t a = src[0 * ss + c];
+            int16_t b = src[1 * ss + c];
+            int16_t d = src[2 * ss + c];
+            int16_t e = src[3 * ss + c];
+            dst[0 * ds + c] = a;
+            dst[1 * ds + c] = b;
+            dst[2 * ds + c] = d;
+            dst[3 * ds + c] = e;
+        }
+        src += 4 * ss;
+        dst += 4 * ds;
+    }
+    for (; f < frames; f++) {
+        for (size_t c = 0; c < ch; c++) {
+            dst[c] = src[c];
+        }
+        src += ss;
+        dst += ds;
+    }
+}
+
+void audio_interleave_s16(int16_t *dst, size_t dst_stride,
+                          const int16_t *src, size_t src_stride,
+                          size_t channels, size_t frames)
+{
+    if (!dst || !src || channels == 0 || frames == 0) {
+        return;
+    }
+
+    // 连续拷贝
+    if (channels == dst_stride && channels == src_stride) {
+        memcpy(dst, src, frames * channels * sizeof(int16_t));
+        return;
+    }
+
+// 常见组合：(通道块, 目标步长, 源步长)
+#define INTERLEAVE_CASE(CH, DS, SS)                                       \
+    if (channels == (CH) && dst_stride == (DS) && src_stride == (SS)) {   \
+        interleave_fixed(dst, (DS), src, (SS), (CH), frames);             \
+        return;                                                           \
+    }
+
+    // 单通道写入 N 通道交织（回采 / 单麦克风）
+    INTERLEAVE_CASE(1, 2, 1)
+    INTERLEAVE_CASE(1, 3, 1)
+    INTERLEAVE_CASE(1, 4, 1)
+    INTERLEAVE_CASE(1, 5, 1)
+    // 多麦克风块写入 N 通道交织（MMR / MMMR / MMMMR）
+    INTERLEAVE_CASE(2, 3, 2)
+    INTERLEAVE_CASE(3, 4, 3)
+    INTERLEAVE_CASE(4, 5, 4)
+    // 解交织：从 N 通道中取出单通道
+    INTERLEAVE_CASE(1, 1, 2)
+    INTERLEAVE_CASE(1, 1, 3)
+    INTERLEAVE_CASE(1, 1, 4)
+    INTERLEAVE_CASE(1, 1, 5)
+#undef INTERLEAVE_CASE
+
+    // 通用路径
+    for (size_t f = 0; f < frames; f++) {
+        for (size_t c = 0; c < channels; c++) {
+            dst[c] = src[c];
+        }
+        src += src_stride;
+        dst += dst_stride;
+    }
+}
+
+void audio_fill_channel_s16(int16_t *dst, size_t dst_stride, int16_t value, size_t frames)
+{
+    if (!dst) {
+        return;
+    }
+    for (size_t f = 0; f < frames; f++) {
+        dst[f * dst_stride] = value;
+    }
+}
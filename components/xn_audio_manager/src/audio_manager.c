@@ -13,10 +13,14 @@
 #include "playback_controller.h"
 #include "button_handler.h"
 #include "afe_wrapper.h"
+#include "audio_event_coalesce.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include <inttypes.h>
 #include <string.h>
 
 static const char *TAG = "AUDIO_MGR";
@@ -40,6 +44,7 @@ typedef struct {
             float volume_db;
         } wakeup;
     } data;
+    uint32_t seq;                           ///< 控制事件序号（audio_coalesce_next_control 分配）
 } audio_mgr_internal_msg_t;
 
 // ============ 音频管理器上下文 ============
@@ -81,8 +86,20 @@ typedef struct {
     void *record_ctx;                        ///< 录音回调的用户上下文
 
     // 调度
-    QueueHandle_t event_queue;
+    QueueHandle_t event_queue;              ///< 控制事件通道（开始/停止/按键），不丢弃
     TaskHandle_t manager_task;
+    portMUX_TYPE event_lock;                ///< 保护控制事件序号与高频事件合并器
+    audio_coalesce_t coalesce;              ///< 唤醒/VAD 合并器（按控制事件分纪元）
+    uint32_t control_handled;               ///< 已处理的最大控制事件序号（仅状态机任务访问）
+
+    // 统计
+    uint32_t event_posted;                  ///< 成功投递的事件数（多生产者，原子更新）
+    uint32_t event_drops;                   ///< 被合并丢弃的高频事件数（原子更新）
+    uint32_t event_queue_high_watermark;    ///< 事件队列历史最高深度（原子 CAS 取最大）
+    TaskHandle_t metrics_task;              ///< 周期上报任务
+    SemaphoreHandle_t metrics_exit_sem;     ///< 上报任务退出前给出，之后任务不再访问上下文
+    volatile uint32_t metrics_period_ms;    ///< 上报周期
+    volatile bool metrics_running;          ///< 上报任务运行标志
 
 } audio_manager_ctx_t;
 
@@ -90,7 +107,12 @@ typedef struct {
  * @brief 音频管理器全局上下文实例
  * 使用静态变量存储，确保全局唯一性
  */
-static audio_manager_ctx_t s_ctx = {0};
+static audio_manager_ctx_t s_ctx = {
+    .event_lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+_Static_assert(AUDIO_EVENT_COALESCE_EPOCHS >= 2 * AUDIO_MANAGER_EVENT_QUEUE_LENGTH,
+               "coalesce epochs must cover queued control events");
 
 static void audio_manager_set_state(audio_mgr_state_t new_state);
 static void audio_manager_refresh_state(void);
@@ -140,18 +162,106 @@ static void audio_manager_notify_event(const audio_mgr_event_t *event)
     s_ctx.config.event_callback(event, s_ctx.config.user_ctx);
 }
 
+/**
+ * @brief 控制事件（开始/停止/按键）走保留通道，不丢弃
+ */
+static bool audio_manager_is_control_event(audio_mgr_internal_event_t type)
+{
+    return type == AUDIO_INT_EVT_START_LISTEN || type == AUDIO_INT_EVT_STOP_LISTEN ||
+           type == AUDIO_INT_EVT_BUTTON_PRESS || type == AUDIO_INT_EVT_BUTTON_RELEASE;
+}
+
+/**
+ * @brief 更新事件队列历史最高深度（多个生产者并发调用，CAS 取最大值）
+ */
+static void audio_manager_update_high_watermark(uint32_t depth)
+{
+    uint32_t cur = __atomic_load_n(&s_ctx.event_queue_high_watermark, __ATOMIC_RELAXED);
+    while (depth > cur &&
+           !__atomic_compare_exchange_n(&s_ctx.event_queue_high_watermark, &cur, depth,
+                                        true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief 投递内部事件
+ *
+ * - 控制事件先分配序号再进入 event_queue，队列满时阻塞等待（不丢弃）；
+ *   在状态机任务自身中调用时不能阻塞，改为非阻塞投递
+ * - 唤醒/VAD 事件进入合并器的当前纪元（两个控制事件之间），通过任务通知唤醒状态机
+ */
 static bool audio_manager_post_event(const audio_mgr_internal_msg_t *msg)
 {
     if (!s_ctx.event_queue || !msg) {
         return false;
     }
-    if (xQueueSend(s_ctx.event_queue, msg, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "event queue full, drop type=%d", msg->type);
-        return false;
+
+    if (audio_manager_is_control_event(msg->type)) {
+        bool in_manager = (xTaskGetCurrentTaskHandle() == s_ctx.manager_task);
+        audio_mgr_internal_msg_t ctrl = *msg;
+        portENTER_CRITICAL(&s_ctx.event_lock);
+        ctrl.seq = audio_coalesce_next_control(&s_ctx.coalesce);
+        portEXIT_CRITICAL(&s_ctx.event_lock);
+        if (xQueueSend(s_ctx.event_queue, &ctrl, in_manager ? 0 : portMAX_DELAY) != pdTRUE) {
+            // 只会发生在状态机任务自身：把丢弃的序号记为已处理，后续纪元照常回放
+            if ((int32_t)(ctrl.seq - s_ctx.control_handled) > 0) {
+                s_ctx.control_handled = ctrl.seq;
+            }
+            __atomic_fetch_add(&s_ctx.event_drops, 1, __ATOMIC_RELAXED);
+            ESP_LOGE(TAG, "control queue full in manager task, drop type=%d", msg->type);
+            return false;
+        }
+        audio_manager_update_high_watermark((uint32_t)uxQueueMessagesWaiting(s_ctx.event_queue));
+    } else {
+        audio_coalesce_item_t item = {
+            .kind = (msg->type == AUDIO_INT_EVT_WAKE_WORD) ? AUDIO_COALESCE_WAKE
+                  : (msg->type == AUDIO_INT_EVT_VAD_START) ? AUDIO_COALESCE_VAD_START
+                                                           : AUDIO_COALESCE_VAD_END,
+            .wake_word_index = msg->data.wakeup.wake_word_index,
+            .volume_db = msg->data.wakeup.volume_db,
+        };
+        portENTER_CRITICAL(&s_ctx.event_lock);
+        uint32_t dropped = audio_coalesce_post(&s_ctx.coalesce, &item);
+        portEXIT_CRITICAL(&s_ctx.event_lock);
+        if (dropped) {
+            __atomic_fetch_add(&s_ctx.event_drops, dropped, __ATOMIC_RELAXED);
+        }
+    }
+
+    __atomic_fetch_add(&s_ctx.event_posted, 1, __ATOMIC_RELAXED);
+    if (s_ctx.manager_task) {
+        xTaskNotifyGive(s_ctx.manager_task);
     }
     return true;
 }
 
+/**
+ * @brief 按到达顺序处理纪元不晚于 upto 的合并事件
+ */
+static void audio_manager_drain_coalesced(uint32_t upto)
+{
+    audio_coalesce_item_t items[AUDIO_EVENT_COALESCE_BUCKET_MAX];
+
+    while (true) {
+        portENTER_CRITICAL(&s_ctx.event_lock);
+        size_t n = audio_coalesce_take(&s_ctx.coalesce, upto, items);
+        portEXIT_CRITICAL(&s_ctx.event_lock);
+        if (n == 0) {
+            break;
+        }
+        for (size_t i = 0; i < n; i++) {
+            audio_mgr_internal_msg_t msg = {
+                .type = (items[i].kind == AUDIO_COALESCE_WAKE)      ? AUDIO_INT_EVT_WAKE_WORD
+                      : (items[i].kind == AUDIO_COALESCE_VAD_START) ? AUDIO_INT_EVT_VAD_START
+                                                                    : AUDIO_INT_EVT_VAD_END,
+            };
+            msg.data.wakeup.wake_word_index = items[i].wake_word_index;
+            msg.data.wakeup.volume_db = items[i].volume_db;
+            audio_manager_handle_internal_event(&msg);
+        }
+    }
+}
+
 static void audio_manager_arm_wake_timer(int duration_ms)
 {
     if (duration_ms <= 0) {
@@ -341,10 +451,19 @@ static void audio_manager_task(void *arg)
     audio_mgr_internal_msg_t msg = {0};
 
     while (true) {
-        if (xQueueReceive(s_ctx.event_queue, &msg, pdMS_TO_TICKS(AUDIO_MANAGER_STEP_INTERVAL_MS)) == pdTRUE) {
+        // 处理控制事件前先回放在它之前到达的合并事件，保持到达顺序
+        while (xQueueReceive(s_ctx.event_queue, &msg, 0) == pdTRUE) {
+            audio_manager_drain_coalesced(msg.seq - 1);
             audio_manager_handle_internal_event(&msg);
+            if ((int32_t)(msg.seq - s_ctx.control_handled) > 0) {
+                s_ctx.control_handled = msg.seq;
+            }
         }
+        // 空闲时只回放到已处理的最大序号：已分配序号但尚在投递途中的控制事件之后的纪元继续等待
+        audio_manager_drain_coalesced(s_ctx.control_handled);
         audio_manager_tick();
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(AUDIO_MANAGER_STEP_INTERVAL_MS));
     }
 }
 
@@ -381,6 +500,8 @@ esp_err_t audio_manager_init(const audio_mgr_config_t *config)
 
     ESP_LOGI(TAG, "======== 初始化音频管理器（模块化状态机）========");
     memset(&s_ctx, 0, sizeof(s_ctx));
+    portMUX_INITIALIZE(&s_ctx.event_lock);      // 全零不是合法的自旋锁状态
+    audio_coalesce_init(&s_ctx.coalesce);
     memcpy(&s_ctx.config, config, sizeof(audio_mgr_config_t));
     s_ctx.volume = AUDIO_MANAGER_DEFAULT_VOLUME;
     s_ctx.state = AUDIO_MGR_STATE_DISABLED;
@@ -468,6 +589,10 @@ esp_err_t audio_manager_init(const audio_mgr_config_t *config)
                 .agc_enabled = s_ctx.config.afe_config.agc_enabled,
                 .afe_mode = s_ctx.config.afe_config.afe_mode,
             },
+            .input_format = s_ctx.config.afe_config.input_format,
+            .engine_type = s_ctx.config.afe_config.engine,
+            .wake_template = s_ctx.config.afe_config.wake_template,
+            .wake_template_frames = s_ctx.config.afe_config.wake_template_frames,
             .event_callback = afe_event_handler,
             .event_ctx = NULL,
             .record_callback = afe_record_handler,
@@ -518,11 +643,21 @@ fail:
  * 按照与初始化相反的顺序销毁各个模块，释放资源。
  * 注意：reference_rb 由播放控制器管理，不需要单独销毁。
  */
-void audio_manager_deinit(void)
+esp_err_t audio_manager_deinit(void)
 {
     // 检查是否已初始化
     if (!s_ctx.initialized && !s_ctx.bsp) {
-        return;
+        return ESP_OK;
+    }
+
+    // 上报任务还在访问上下文时不能清空，等不到它退出就放弃反初始化
+    if (audio_manager_stop_metrics_report() != ESP_OK) {
+        ESP_LOGE(TAG, "统计上报任务未退出，取消反初始化");
+        return ESP_ERR_TIMEOUT;
+    }
+    if (s_ctx.metrics_exit_sem) {
+        vSemaphoreDelete(s_ctx.metrics_exit_sem);
+        s_ctx.metrics_exit_sem = NULL;
     }
 
     // 停止所有运行中的功能
@@ -568,6 +703,7 @@ void audio_manager_deinit(void)
     // 清空上下文
     memset(&s_ctx, 0, sizeof(s_ctx));
     ESP_LOGI(TAG, "音频管理器已销毁");
+    return ESP_OK;
 }
 
 /**
@@ -816,6 +952,53 @@ esp_err_t audio_manager_update_wakeup_config(const audio_mgr_wakeup_config_t *co
     return afe_wrapper_update_wakeup_config(s_ctx.afe_wrapper, &afe_wakeup);
 }
 
+/**
+ * @brief 在线更新 VAD 与 AFE 功能开关
+ * 
+ * 配置在 AFE 的下一个帧边界生效，不重建音频管线。
+ * 
+ * @param vad 新的 VAD 配置（NULL 表示不变）
+ * @param afe 新的 AFE 功能配置（NULL 表示不变）
+ * @return 
+ *     - ESP_OK: 已提交
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 未初始化或未启用 AFE
+ */
+esp_err_t audio_manager_update_afe_config(const audio_mgr_vad_config_t *vad,
+                                          const audio_mgr_afe_config_t *afe)
+{
+    if (!vad && !afe) return ESP_ERR_INVALID_ARG;
+    if (!s_ctx.initialized || !s_ctx.afe_wrapper) return ESP_ERR_INVALID_STATE;
+
+    afe_vad_config_t afe_vad = {0};
+    afe_feature_config_t afe_feature = {0};
+
+    if (vad) {
+        s_ctx.config.vad_config = *vad;
+        afe_vad = (afe_vad_config_t){
+            .enabled = vad->enabled,
+            .vad_mode = vad->vad_mode,
+            .min_speech_ms = vad->min_speech_ms,
+            .min_silence_ms = vad->min_silence_ms,
+        };
+    }
+    if (afe) {
+        s_ctx.config.afe_config.aec_enabled = afe->aec_enabled;
+        s_ctx.config.afe_config.ns_enabled = afe->ns_enabled;
+        s_ctx.config.afe_config.agc_enabled = afe->agc_enabled;
+        afe_feature = (afe_feature_config_t){
+            .aec_enabled = afe->aec_enabled,
+            .ns_enabled = afe->ns_enabled,
+            .agc_enabled = afe->agc_enabled,
+            .afe_mode = s_ctx.config.afe_config.afe_mode,
+        };
+    }
+
+    return afe_wrapper_reconfigure(s_ctx.afe_wrapper, NULL,
+                                   vad ? &afe_vad : NULL,
+                                   afe ? &afe_feature : NULL);
+}
+
 /**
  * @brief 获取唤醒词配置
  * 
@@ -892,3 +1075,225 @@ void audio_manager_set_record_callback(audio_record_callback_t callback, void *u
     s_ctx.record_callback = callback;
     s_ctx.record_ctx = user_ctx;
 }
+
+// ============ 性能统计 ============
+
+static void audio_manager_fill_buffer_metrics(audio_mgr_buffer_metrics_t *out,
+                                              const ring_buffer_stats_t *in)
+{
+    out->size = in->size;
+    out->fill = in->fill;
+    out->high_watermark = in->high_watermark;
+    out->overrun_samples = in->overrun_samples;
+}
+
+/**
+ * @brief 获取音频管线统计快照
+ * 
+ * 汇总 BSP（I2S）、AFE 包装器、事件队列和播放控制器的统计。
+ * 
+ * @param metrics 输出快照
+ * @return 
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 未初始化
+ */
+esp_err_t audio_manager_get_metrics(audio_mgr_metrics_t *metrics)
+{
+    if (!metrics) return ESP_ERR_INVALID_ARG;
+    if (!s_ctx.initialized) return ESP_ERR_INVALID_STATE;
+
+    memset(metrics, 0, sizeof(*metrics));
+
+    audio_io_stats_t io = {0};
+    if (audio_bsp_get_io_stats(s_ctx.bsp, &io) == ESP_OK) {
+        metrics->frames_played = io.frames_played;
+        metrics->samples_played = io.samples_played;
+        metrics->frames_captured = io.frames_captured;
+        metrics->samples_captured = io.samples_captured;
+        metrics->speaker_write = io.speaker_write;
+        metrics->mic_read = io.mic_read;
+    }
+
+    afe_wrapper_stats_t afe = {0};
+    if (s_ctx.afe_wrapper && afe_wrapper_get_stats(s_ctx.afe_wrapper, &afe) == ESP_OK) {
+        metrics->afe_interleave = afe.interleave;
+        metrics->afe_feed = afe.feed;
+        metrics->afe_result = afe.result;
+        metrics->afe_reference_underrun = afe.reference_underrun;
+        metrics->afe_feed_rejected = afe.feed_rejected;
+        metrics->afe_event_latency_us_last = afe.event_latency_us_last;
+        metrics->afe_event_latency_us_max = afe.event_latency_us_max;
+        metrics->afe_reconfig_count = afe.reconfig_count;
+        metrics->afe_reconfig_latency_us_last = afe.reconfig_latency_us_last;
+        metrics->afe_reconfig_latency_us_max = afe.reconfig_latency_us_max;
+        metrics->afe_model_swap_count = afe.model_swap_count;
+        metrics->afe_model_swap_latency_us_last = afe.model_swap_latency_us_last;
+        metrics->afe_model_swap_dropped_frames = afe.model_swap_dropped_frames;
+    }
+
+    metrics->event_posted = __atomic_load_n(&s_ctx.event_posted, __ATOMIC_RELAXED);
+    metrics->event_drops = __atomic_load_n(&s_ctx.event_drops, __ATOMIC_RELAXED);
+    metrics->event_queue_depth = s_ctx.event_queue ? (uint32_t)uxQueueMessagesWaiting(s_ctx.event_queue) : 0;
+    metrics->event_queue_high_watermark = __atomic_load_n(&s_ctx.event_queue_high_watermark, __ATOMIC_RELAXED);
+    metrics->event_queue_length = AUDIO_MANAGER_EVENT_QUEUE_LENGTH;
+
+    ring_buffer_stats_t playback = {0};
+    ring_buffer_stats_t reference = {0};
+    if (playback_controller_get_buffer_stats(s_ctx.playback_ctrl, &playback, &reference) == ESP_OK) {
+        audio_manager_fill_buffer_metrics(&metrics->playback_buffer, &playback);
+        audio_manager_fill_buffer_metrics(&metrics->reference_buffer, &reference);
+    }
+
+    metrics->cpu_freq_mhz = AUDIO_METRICS_CPU_MHZ;
+    return ESP_OK;
+}
+
+/**
+ * @brief 清零音频管线统计
+ */
+void audio_manager_reset_metrics(void)
+{
+    if (!s_ctx.initialized) {
+        return;
+    }
+
+    audio_bsp_reset_io_stats(s_ctx.bsp);
+    afe_wrapper_reset_stats(s_ctx.afe_wrapper);
+    playback_controller_reset_buffer_stats(s_ctx.playback_ctrl);
+    __atomic_store_n(&s_ctx.event_posted, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_ctx.event_drops, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_ctx.event_queue_high_watermark, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 阶段平均耗时（微秒）
+ */
+static uint32_t audio_manager_stage_avg_us(const audio_stage_stats_t *stage, uint32_t mhz)
+{
+    if (stage->count == 0 || mhz == 0) {
+        return 0;
+    }
+    return (uint32_t)(stage->total_cycles / stage->count / mhz);
+}
+
+static void audio_manager_log_metrics(void)
+{
+    audio_mgr_metrics_t m;
+    if (audio_manager_get_metrics(&m) != ESP_OK) {
+        return;
+    }
+
+    uint32_t mhz = m.cpu_freq_mhz;
+    ESP_LOGI(TAG, "📊 play=%" PRIu32 " cap=%" PRIu32 " | spk avg/max=%" PRIu32 "/%" PRIu32 "us"
+             " mic=%" PRIu32 "/%" PRIu32 "us ilv=%" PRIu32 "/%" PRIu32 "us res=%" PRIu32 "/%" PRIu32 "us",
+             m.frames_played, m.frames_captured,
+             audio_manager_stage_avg_us(&m.speaker_write, mhz), m.speaker_write.max_cycles / mhz,
+             audio_manager_stage_avg_us(&m.mic_read, mhz), m.mic_read.max_cycles / mhz,
+             audio_manager_stage_avg_us(&m.afe_interleave, mhz), m.afe_interleave.max_cycles / mhz,
+             audio_manager_stage_avg_us(&m.afe_result, mhz), m.afe_result.max_cycles / mhz);
+    ESP_LOGI(TAG, "📊 evt posted=%" PRIu32 " drop=%" PRIu32 " q=%" PRIu32 "/%" PRIu32 " hwm=%" PRIu32
+             " | pb %u/%u hwm=%u ovr=%" PRIu32 " | ref %u/%u hwm=%u ovr=%" PRIu32 " underrun=%" PRIu32,
+             m.event_posted, m.event_drops, m.event_queue_depth, m.event_queue_length,
+             m.event_queue_high_watermark,
+             (unsigned)m.playback_buffer.fill, (unsigned)m.playback_buffer.size,
+             (unsigned)m.playback_buffer.high_watermark, m.playback_buffer.overrun_samples,
+             (unsigned)m.reference_buffer.fill, (unsigned)m.reference_buffer.size,
+             (unsigned)m.reference_buffer.high_watermark, m.reference_buffer.overrun_samples,
+             m.afe_reference_underrun);
+    ESP_LOGI(TAG, "📊 afe feed avg/max=%" PRIu32 "/%" PRIu32 "us rejected=%" PRIu32
+             " | evt latency last/max=%" PRIu32 "/%" PRIu32 "us"
+             " | reconfig=%" PRIu32 " %" PRIu32 "/%" PRIu32 "us swap=%" PRIu32 " %" PRIu32 "ms drop=%" PRIu32,
+             audio_manager_stage_avg_us(&m.afe_feed, mhz), m.afe_feed.max_cycles / mhz,
+             m.afe_feed_rejected, m.afe_event_latency_us_last, m.afe_event_latency_us_max,
+             m.afe_reconfig_count, m.afe_reconfig_latency_us_last, m.afe_reconfig_latency_us_max,
+             m.afe_model_swap_count, m.afe_model_swap_latency_us_last / 1000,
+             m.afe_model_swap_dropped_frames);
+}
+
+static void audio_manager_metrics_task(void *arg)
+{
+    SemaphoreHandle_t exit_sem = (SemaphoreHandle_t)arg;
+
+    while (s_ctx.metrics_running) {
+        // 等待一个周期，停止时通过任务通知提前唤醒
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(s_ctx.metrics_period_ms));
+        if (!s_ctx.metrics_running) {
+            break;
+        }
+        audio_manager_log_metrics();
+    }
+
+    // 确认退出：之后只删除自身，不再访问 s_ctx（停止方收到后才清除句柄、反初始化才清空上下文）
+    xSemaphoreGive(exit_sem);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 启动周期性统计上报任务
+ * 
+ * @param period_ms 上报周期（毫秒）
+ * @return 
+ *     - ESP_OK: 启动成功
+ *     - ESP_ERR_INVALID_ARG: 周期为 0
+ *     - ESP_ERR_INVALID_STATE: 未初始化
+ *     - ESP_ERR_NO_MEM: 任务创建失败
+ */
+esp_err_t audio_manager_start_metrics_report(uint32_t period_ms)
+{
+    if (period_ms == 0) return ESP_ERR_INVALID_ARG;
+    if (!s_ctx.initialized) return ESP_ERR_INVALID_STATE;
+
+    s_ctx.metrics_period_ms = period_ms;
+    if (s_ctx.metrics_task) {
+        // 上次停止超时、任务尚未退出时不能再启动
+        return s_ctx.metrics_running ? ESP_OK : ESP_ERR_INVALID_STATE;
+    }
+
+    if (!s_ctx.metrics_exit_sem) {
+        s_ctx.metrics_exit_sem = xSemaphoreCreateBinary();
+        if (!s_ctx.metrics_exit_sem) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    s_ctx.metrics_running = true;
+    if (xTaskCreatePinnedToCore(audio_manager_metrics_task,
+                                "audio_metrics",
+                                AUDIO_MANAGER_METRICS_TASK_STACK_SIZE,
+                                s_ctx.metrics_exit_sem,
+                                AUDIO_MANAGER_METRICS_TASK_PRIORITY,
+                                &s_ctx.metrics_task,
+                                0) != pdPASS) {
+        s_ctx.metrics_running = false;
+        s_ctx.metrics_task = NULL;
+        ESP_LOGE(TAG, "统计上报任务创建失败");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "📊 统计上报已启动，周期 %" PRIu32 " ms", period_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief 停止周期性统计上报任务
+ * 
+ * 通知任务退出并等待它给出退出信号量（最多 AUDIO_MANAGER_METRICS_STOP_TIMEOUT_MS）。
+ * 超时时保留任务句柄，调用方不能释放上下文。
+ */
+esp_err_t audio_manager_stop_metrics_report(void)
+{
+    if (!s_ctx.metrics_task) {
+        return ESP_OK;
+    }
+
+    s_ctx.metrics_running = false;
+    xTaskNotifyGive(s_ctx.metrics_task);
+
+    if (xSemaphoreTake(s_ctx.metrics_exit_sem, pdMS_TO_TICKS(AUDIO_MANAGER_METRICS_STOP_TIMEOUT_MS)) != pdTRUE) {
+        ESP_LOGE(TAG, "统计上报任务 %d ms 内未退出", AUDIO_MANAGER_METRICS_STOP_TIMEOUT_MS);
+        return ESP_ERR_TIMEOUT;
+    }
+    s_ctx.metrics_task = NULL;
+    return ESP_OK;
+}
@@ -0,0 +1,43 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_audio_manager\src\button_handler_host.c
+ * @Description: linux 目标的按键处理器：没有 GPIO，按键始终处于松开状态
+ */
+#include "button_handler.h"
+#include "esp_log.h"
+#include <stdlib.h>
+
+static const char *TAG = "BUTTON_HANDLER";
+
+typedef struct button_handler_s {
+    button_handler_config_t config;     ///< 创建时的配置
+} button_handler_t;
+
+button_handler_handle_t button_handler_create(const button_handler_config_t *config)
+{
+    if (!config) {
+        return NULL;
+    }
+
+    button_handler_t *handler = (button_handler_t *)calloc(1, sizeof(button_handler_t));
+    if (!handler) {
+        return NULL;
+    }
+    handler->config = *config;
+    ESP_LOGI(TAG, "host button handler (no GPIO)");
+    return handler;
+}
+
+void button_handler_destroy(button_handler_handle_t handler)
+{
+    free(handler);
+}
+
+bool button_handler_is_pressed(button_handler_handle_t handler)
+{
+    (void)handler;
+    return false;
+}
@@ -9,9 +9,14 @@
  * Copyright (c) 2025 by ${git_name_email}, All Rights Reserved. 
  */
 #include "i2s_hal.h"
+#include "audio_interleave.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
 #include "driver/gpio.h"
+#include "soc/soc_caps.h"
+#if SOC_I2S_SUPPORTS_TDM
+#include "driver/i2s_tdm.h"
+#endif
 #include "freertos/FreeRTOS.h"
 #include <string.h>
 #include <stdlib.h>
@@ -32,10 +37,75 @@ typedef struct i2s_hal_s {
     int16_t *stereo_buffer;         ///< 立体声转换缓冲区（PSRAM），用于单声道到立体声转换
     size_t stereo_buffer_size;      ///< 立体声缓冲区大小（采样点数）
     int32_t *mic_temp_buffer;       ///< 麦克风临时缓冲区（PSRAM），用于32位数据读取
-    size_t mic_temp_buffer_size;    ///< 麦克风临时缓冲区大小（采样点数）
+    size_t mic_temp_buffer_size;    ///< 麦克风临时缓冲区大小（每通道采样点数）
+    size_t mic_channels;            ///< 麦克风通道数
     uint8_t mic_bit_shift;          ///< 32位转16位的右移位数（默认14，可调12-16）
+    audio_io_stats_t stats;         ///< I/O 统计（帧数、转换耗时）
 } i2s_hal_t;
 
+/**
+ * @brief 按通道数初始化 RX 模式
+ * 
+ * - 1 通道：标准 Philips 单声道，取右声道（单声道麦克风通常使用右声道）
+ * - 2 通道：标准 Philips 立体声，左右声道交织输出
+ * - 3~4 通道：TDM 模式（需芯片支持），各时隙按顺序交织输出
+ * 
+ * @param hal I2S HAL 上下文（rx_handle 已创建）
+ * @param mic_config 麦克风配置参数
+ * @return esp_err_t ESP_OK 成功，ESP_ERR_NOT_SUPPORTED 通道数不支持
+ */
+static esp_err_t i2s_hal_init_rx_mode(i2s_hal_t *hal, const i2s_mic_config_t *mic_config)
+{
+    size_t channels = mic_config->channels ? mic_config->channels : 1;
+    if (channels > I2S_HAL_MIC_MAX_CHANNELS) {
+        ESP_LOGE(TAG, "麦克风通道数不支持: %d", (int)channels);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    hal->mic_channels = channels;
+
+    if (channels <= 2) {
+        // 配置 RX 标准模式：32位，Philips 格式
+        i2s_std_config_t rx_std_cfg = {
+            .clk_cfg  = I2S_STD_CLK_DEFAULT_CONFIG(mic_config->sample_rate),  // 时钟配置
+            .slot_cfg = I2S_STD_PHILIP_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT,
+                            channels == 1 ? I2S_SLOT_MODE_MONO : I2S_SLOT_MODE_STEREO),
+            .gpio_cfg = {
+                .mclk = GPIO_NUM_NC,  // 主时钟不使用
+                .bclk = mic_config->bclk_gpio,  // 位时钟 GPIO
+                .ws   = mic_config->lrck_gpio,  // 字选择（左右声道）GPIO
+                .dout = GPIO_NUM_NC,  // 数据输出不使用
+                .din  = mic_config->din_gpio,  // 数据输入 GPIO
+                .invert_flags = { .mclk_inv = false, .bclk_inv = false, .ws_inv = false },  // 不反转信号
+            },
+        };
+        // 单声道接收右声道数据（单声道麦克风通常使用右声道），立体声接收左右声道
+        rx_std_cfg.slot_cfg.slot_mask = channels == 1 ? I2S_STD_SLOT_RIGHT : I2S_STD_SLOT_BOTH;
+
+        return i2s_channel_init_std_mode(hal->rx_handle, &rx_std_cfg);
+    }
+
+#if SOC_I2S_SUPPORTS_TDM
+    // 配置 RX TDM 模式：32位，每个时隙一路麦克风
+    i2s_tdm_config_t rx_tdm_cfg = {
+        .clk_cfg  = I2S_TDM_CLK_DEFAULT_CONFIG(mic_config->sample_rate),
+        .slot_cfg = I2S_TDM_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_STEREO,
+                        (i2s_tdm_slot_mask_t)((1U << channels) - 1)),
+        .gpio_cfg = {
+            .mclk = GPIO_NUM_NC,
+            .bclk = mic_config->bclk_gpio,
+            .ws   = mic_config->lrck_gpio,
+            .dout = GPIO_NUM_NC,
+            .din  = mic_config->din_gpio,
+            .invert_flags = { .mclk_inv = false, .bclk_inv = false, .ws_inv = false },
+        },
+    };
+    return i2s_channel_init_tdm_mode(hal->rx_handle, &rx_tdm_cfg);
+#else
+    ESP_LOGE(TAG, "芯片不支持 TDM，无法采集 %d 通道", (int)channels);
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 /**
  * @brief 创建 I2S HAL 实例
  * 
@@ -127,24 +197,7 @@ i2s_hal_handle_t i2s_hal_create(const i2s_mic_config_t *mic_config,
         return NULL;
     }
 
-    // 配置 RX 标准模式：32位单声道，Philips 格式
-    i2s_std_config_t rx_std_cfg = {
-        .clk_cfg  = I2S_STD_CLK_DEFAULT_CONFIG(mic_config->sample_rate),  // 时钟配置
-        .slot_cfg = I2S_STD_PHILIP_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_MONO),  // 32位单声道
-        .gpio_cfg = {
-            .mclk = GPIO_NUM_NC,  // 主时钟不使用
-            .bclk = mic_config->bclk_gpio,  // 位时钟 GPIO
-            .ws   = mic_config->lrck_gpio,  // 字选择（左右声道）GPIO
-            .dout = GPIO_NUM_NC,  // 数据输出不使用
-            .din  = mic_config->din_gpio,  // 数据输入 GPIO
-            .invert_flags = { .mclk_inv = false, .bclk_inv = false, .ws_inv = false },  // 不反转信号
-        },
-    };
-    // 设置接收右声道数据（单声道麦克风通常使用右声道）
-    rx_std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_RIGHT;
-
-    // 初始化 RX 通道为标准模式
-    ret = i2s_channel_init_std_mode(hal->rx_handle, &rx_std_cfg);
+    ret = i2s_hal_init_rx_mode(hal, mic_config);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "初始化 RX 失败: %s", esp_err_to_name(ret));
         i2s_del_channel(hal->rx_handle);
@@ -165,16 +218,16 @@ i2s_hal_handle_t i2s_hal_create(const i2s_mic_config_t *mic_config,
         return NULL;
     }
 
-    ESP_LOGI(TAG, "I2S RX 初始化成功: 端口%d, BCLK=%d, LRCK=%d, DIN=%d",
+    ESP_LOGI(TAG, "I2S RX 初始化成功: 端口%d, BCLK=%d, LRCK=%d, DIN=%d, 通道=%d",
              mic_config->port, mic_config->bclk_gpio,
-             mic_config->lrck_gpio, mic_config->din_gpio);
+             mic_config->lrck_gpio, mic_config->din_gpio, (int)hal->mic_channels);
 
     // ========== 分配麦克风临时缓冲区（PSRAM）==========
     // 用于存储 32-bit 原始数据，避免频繁 malloc/free
     hal->mic_temp_buffer_size = mic_config->max_frame_samples > 0 ? 
                                  mic_config->max_frame_samples : 512;  // 默认 512
     hal->mic_temp_buffer = (int32_t *)heap_caps_malloc(
-        hal->mic_temp_buffer_size * sizeof(int32_t),
+        hal->mic_temp_buffer_size * hal->mic_channels * sizeof(int32_t),
         MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);  // 使用 PSRAM
     
     if (!hal->mic_temp_buffer) {
@@ -192,9 +245,9 @@ i2s_hal_handle_t i2s_hal_create(const i2s_mic_config_t *mic_config,
     hal->mic_bit_shift = (mic_config->bit_shift >= 12 && mic_config->bit_shift <= 16) ? 
                           mic_config->bit_shift : 14;  // 默认 14
 
-    ESP_LOGI(TAG, "✅ 麦克风临时缓冲区初始化: %d samples (%.1f KB) at PSRAM, 右移 %d 位",
-             hal->mic_temp_buffer_size,
-             (hal->mic_temp_buffer_size * sizeof(int32_t)) / 1024.0f,
+    ESP_LOGI(TAG, "✅ 麦克风临时缓冲区初始化: %d samples × %d ch (%.1f KB) at PSRAM, 右移 %d 位",
+             hal->mic_temp_buffer_size, (int)hal->mic_channels,
+             (hal->mic_temp_buffer_size * hal->mic_channels * sizeof(int32_t)) / 1024.0f,
              hal->mic_bit_shift);
 
     // ========== 分配立体声转换缓冲区（PSRAM）==========
@@ -271,9 +324,9 @@ void i2s_hal_destroy(i2s_hal_handle_t hal)
  * 使用预分配的缓冲区，避免频繁 malloc/free。
  * 
  * @param hal I2S HAL 句柄
- * @param out_samples 输出缓冲区（16位）
- * @param sample_count 期望读取的采样点数
- * @param out_got 实际读取的采样点数（可选）
+ * @param out_samples 输出缓冲区（16位，多通道时按帧交织）
+ * @param sample_count 期望读取的每通道采样点数（帧数）
+ * @param out_got 实际读取的每通道采样点数（可选）
  * @return esp_err_t ESP_OK 成功，其他值表示错误
  * 
  * @note 数据格式转换：32位右移可配置位数（默认14）得到16位数据
@@ -294,8 +347,8 @@ esp_err_t i2s_hal_read_mic(i2s_hal_handle_t hal, int16_t *out_samples,
         return ESP_ERR_INVALID_ARG;
     }
 
-    // 从 I2S RX 通道读取 32 位数据（使用预分配的缓冲区）
-    size_t bytes32 = sample_count * sizeof(int32_t);
+    // 从 I2S RX 通道读取 32 位数据（使用预分配的缓冲区，多通道时硬件已按帧交织）
+    size_t bytes32 = sample_count * hal->mic_channels * sizeof(int32_t);
     size_t bytes_read = 0;
     esp_err_t ret = i2s_channel_read(hal->rx_handle, hal->mic_temp_buffer, 
                                       bytes32, &bytes_read, 100);
@@ -303,15 +356,29 @@ esp_err_t i2s_hal_read_mic(i2s_hal_handle_t hal, int16_t *out_samples,
     // 将 32 位数据转换为 16 位
     // 根据数据手册：24-bit 有效数据 + 8-bit 低位填充
     // 右移位数可配置，以适应不同的音量需求
-    size_t got = bytes_read / sizeof(int32_t);
-    for (size_t i = 0; i < got; i++) {
-        out_samples[i] = (int16_t)(hal->mic_temp_buffer[i] >> hal->mic_bit_shift);
-    }
+    size_t got = bytes_read / (hal->mic_channels * sizeof(int32_t));
+    uint32_t start = AUDIO_METRICS_CYCLES();
+    audio_convert_s32_to_s16(out_samples, hal->mic_temp_buffer, got * hal->mic_channels,
+                             hal->mic_bit_shift);
+    audio_stage_stats_add(&hal->stats.mic_read, start);
+    hal->stats.frames_captured++;
+    hal->stats.samples_captured += got;
 
     if (out_got) *out_got = got;
     return ret;
 }
 
+/**
+ * @brief 获取麦克风通道数
+ * 
+ * @param hal I2S HAL 句柄
+ * @return size_t 通道数，句柄无效返回 0
+ */
+size_t i2s_hal_get_mic_channels(i2s_hal_handle_t hal)
+{
+    return hal ? hal->mic_channels : 0;
+}
+
 /**
  * @brief 向扬声器写入音频数据
  * 
@@ -346,12 +413,14 @@ esp_err_t i2s_hal_write_speaker(i2s_hal_handle_t hal, const int16_t *samples,
 
     // 单声道 -> 立体声转换，并应用音量控制
     // 音量因子：将 0-100 映射到 0.0-1.0
+    uint32_t start = AUDIO_METRICS_CYCLES();
     float factor = (volume > 100 ? 100 : volume) / 100.0f;
     for (size_t i = 0; i < sample_count; i++) {
         int16_t v = (int16_t)(samples[i] * factor);  // 应用音量
         hal->stereo_buffer[i * 2] = v;      // Left 声道
         hal->stereo_buffer[i * 2 + 1] = v;  // Right 声道
     }
+    audio_stage_stats_add(&hal->stats.speaker_write, start);
 
     // 写入 I2S TX 通道
     size_t written = 0;
@@ -370,6 +439,8 @@ esp_err_t i2s_hal_write_speaker(i2s_hal_handle_t hal, const int16_t *samples,
         ESP_LOGW(TAG, "⚠️ I2S 写入不完整: 期望%d, 实际%d", bytes_to_write, written);
     }
 
+    hal->stats.frames_played++;
+    hal->stats.samples_played += written / (2 * sizeof(int16_t));
     return ESP_OK;
 }
 
@@ -395,3 +466,30 @@ i2s_chan_handle_t i2s_hal_get_tx_handle(i2s_hal_handle_t hal)
     return hal ? hal->tx_handle : NULL;
 }
 
+/**
+ * @brief 获取 I/O 统计
+ * 
+ * @param hal I2S HAL 句柄
+ * @param stats 输出统计
+ * @return esp_err_t ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t i2s_hal_get_stats(i2s_hal_handle_t hal, audio_io_stats_t *stats)
+{
+    if (!hal || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = hal->stats;
+    return ESP_OK;
+}
+
+/**
+ * @brief 清零 I/O 统计
+ * 
+ * @param hal I2S HAL 句柄
+ */
+void i2s_hal_reset_stats(i2s_hal_handle_t hal)
+{
+    if (hal) {
+        memset(&hal->stats, 0, sizeof(hal->stats));
+    }
+}
@@ -313,3 +313,42 @@ ring_buffer_handle_t playback_controller_get_reference_buffer(playback_controlle
     return controller ? controller->reference_rb : NULL;
 }
 
+/**
+ * @brief 获取播放/回采缓冲区统计
+ * 
+ * @param controller 播放控制器句柄
+ * @param playback 播放缓冲区统计输出（可为 NULL）
+ * @param reference 回采缓冲区统计输出（可为 NULL）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t playback_controller_get_buffer_stats(playback_controller_handle_t controller,
+                                               ring_buffer_stats_t *playback,
+                                               ring_buffer_stats_t *reference)
+{
+    if (!controller) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    if (playback) {
+        ret = ring_buffer_get_stats(controller->playback_rb, playback);
+    }
+    if (reference && ret == ESP_OK) {
+        ret = ring_buffer_get_stats(controller->reference_rb, reference);
+    }
+    return ret;
+}
+
+/**
+ * @brief 清零播放/回采缓冲区统计
+ * 
+ * @param controller 播放控制器句柄
+ */
+void playback_controller_reset_buffer_stats(playback_controller_handle_t controller)
+{
+    if (!controller) {
+        return;
+    }
+    ring_buffer_reset_stats(controller->playback_rb);
+    ring_buffer_reset_stats(controller->reference_rb);
+}
@@ -32,6 +32,8 @@ typedef struct ring_buffer_s {
     volatile size_t read_pos;     ///< 读位置索引（消费者）
     SemaphoreHandle_t mutex;      ///< 互斥锁，保护读写位置的原子性
     SemaphoreHandle_t data_sem;   ///< 数据可用信号量（可选），用于阻塞读取
+    size_t high_watermark;        ///< 历史最高数据量（写入时更新）
+    uint32_t overrun_samples;     ///< 累计被覆盖的采样点数
 } ring_buffer_t;
 
 /**
@@ -77,6 +79,8 @@ ring_buffer_handle_t ring_buffer_create(size_t samples, bool with_sem)
     rb->size = samples;
     rb->write_pos = 0;
     rb->read_pos = 0;
+    rb->high_watermark = 0;
+    rb->overrun_samples = 0;
 
     // 创建互斥锁（保护并发访问）
     rb->mutex = xSemaphoreCreateMutex();
@@ -181,6 +185,15 @@ size_t ring_buffer_write(ring_buffer_handle_t rb, const int16_t *data, size_t sa
         }
     }
 
+    // 更新高水位（写入后数据量最大）
+    size_t fill = (rb->write_pos >= rb->read_pos)
+                  ? (rb->write_pos - rb->read_pos)
+                  : (rb->size - rb->read_pos + rb->write_pos);
+    if (fill > rb->high_watermark) {
+        rb->high_watermark = fill;
+    }
+    rb->overrun_samples += overrun_count;
+
     xSemaphoreGive(rb->mutex);
 
     // 缓冲区溢出警告（假设 16kHz 采样率）
@@ -335,3 +348,53 @@ size_t ring_buffer_get_size(ring_buffer_handle_t rb)
     }
     return rb->size;
 }
+
+/**
+ * @brief 获取环形缓冲区统计
+ * 
+ * @param rb 环形缓冲区句柄
+ * @param stats 输出统计
+ * @return 
+ *   - ESP_OK: 成功
+ *   - ESP_ERR_INVALID_ARG: 参数无效
+ *   - ESP_ERR_TIMEOUT: 获取互斥锁超时
+ */
+esp_err_t ring_buffer_get_stats(ring_buffer_handle_t rb, ring_buffer_stats_t *stats)
+{
+    if (!rb || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xSemaphoreTake(rb->mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    stats->size = rb->size;
+    stats->fill = (rb->write_pos >= rb->read_pos)
+                  ? (rb->write_pos - rb->read_pos)
+                  : (rb->size - rb->read_pos + rb->write_pos);
+    stats->high_watermark = rb->high_watermark;
+    stats->overrun_samples = rb->overrun_samples;
+
+    xSemaphoreGive(rb->mutex);
+    return ESP_OK;
+}
+
+/**
+ * @brief 清零高水位和溢出计数
+ * 
+ * @param rb 环形缓冲区句柄
+ */
+void ring_buffer_reset_stats(ring_buffer_handle_t rb)
+{
+    if (!rb) {
+        return;
+    }
+
+    if (xSemaphoreTake(rb->mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return;
+    }
+    rb->high_watermark = 0;
+    rb->overrun_samples = 0;
+    xSemaphoreGive(rb->mutex);
+}
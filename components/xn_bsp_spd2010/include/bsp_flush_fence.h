@@ -0,0 +1,75 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_bsp_spd2010\include\bsp_flush_fence.h
+ * @Description: 刷新完成栅栏（DMA 完成计数 + 单等待者任务通知），不依赖 esp_lcd，可在主机上构建
+ *
+ * 提交方记录提交计数作为栅栏，完成中断每完成一次传输调用 bsp_flush_fence_complete_from_isr()。
+ * 完成计数追上栅栏后，栅栏之前提交的所有传输都已读完源缓冲区，缓冲区可以释放或复用。
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 刷新完成栅栏
+ */
+typedef struct {
+    volatile uint32_t done_count;   ///< 已完成的传输次数（回绕递增）
+    uint32_t wait_target;           ///< 等待者的目标计数
+    TaskHandle_t waiter;            ///< 当前等待者（同一时刻最多一个）
+    portMUX_TYPE lock;
+} bsp_flush_fence_t;
+
+/**
+ * @brief 初始化栅栏（计数清零）
+ */
+void bsp_flush_fence_init(bsp_flush_fence_t *fence);
+
+/**
+ * @brief 记录一次传输完成（中断上下文），到达目标时唤醒等待者
+ * @param need_yield 需要在中断退出时切换任务时置为 pdTRUE
+ * @return 本次完成后的完成计数
+ */
+uint32_t bsp_flush_fence_complete_from_isr(bsp_flush_fence_t *fence, BaseType_t *need_yield);
+
+/**
+ * @brief 获取完成计数
+ */
+static inline uint32_t bsp_flush_fence_done_count(const bsp_flush_fence_t *fence)
+{
+    return fence->done_count;
+}
+
+/**
+ * @brief 非阻塞判断完成计数是否已到达 target（不登记为等待者）
+ */
+static inline bool bsp_flush_fence_reached(const bsp_flush_fence_t *fence, uint32_t target)
+{
+    return (int32_t)(fence->done_count - target) >= 0;
+}
+
+/**
+ * @brief 阻塞等待完成计数到达 target
+ *
+ * 通过任务通知（索引 0）唤醒，同一时刻只支持一个等待任务。
+ * 调用任务自身的通知值不能另作他用（例如 LVGL 任务的唤醒位），这类任务应轮询 bsp_flush_fence_reached()。
+ *
+ * @return ESP_OK 已到达；ESP_ERR_TIMEOUT 超时；ESP_ERR_INVALID_STATE 已有其他任务在等待
+ */
+esp_err_t bsp_flush_fence_wait(bsp_flush_fence_t *fence, uint32_t target, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
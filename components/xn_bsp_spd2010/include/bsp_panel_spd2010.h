@@ -32,6 +32,7 @@
 #include "esp_lcd_spd2010.h"
 #include "bsp_touch_spd2010.h"
 #include "bsp_exio_tca9554.h"
+#include "bsp_flush_fence.h"
 
 // LCD显示屏参数定义
 #define EXAMPLE_LCD_WIDTH                   (412)                 // LCD屏幕宽度，单位：像素
@@ -123,3 +124,44 @@ esp_err_t SPD2010_Register_LVGL_Callback(lv_display_t *display);
  * @note 用于LVGL驱动获取面板句柄
  */
 esp_lcd_panel_handle_t SPD2010_Get_Panel_Handle(void);
+
+/**
+ * @brief 获取已完成的刷新DMA传输次数
+ * @return uint32_t 完成计数（回绕递增）
+ * @note 在 notify_lvgl_flush_ready 中断回调中递增，用作刷新完成栅栏
+ */
+uint32_t SPD2010_Get_Flush_Done_Count(void);
+
+/**
+ * @brief 阻塞等待刷新完成计数到达目标值
+ * @param target 目标计数
+ * @param timeout_ms 超时时间（毫秒）
+ * @return esp_err_t ESP_OK 已到达；ESP_ERR_TIMEOUT 超时；ESP_ERR_INVALID_STATE 已有其他任务在等待
+ * @note 同一时刻仅支持一个等待任务，由中断回调通过任务通知唤醒
+ */
+esp_err_t SPD2010_Wait_Flush_Done(uint32_t target, uint32_t timeout_ms);
+
+/**
+ * @brief 刷新完成钩子（在SPI中断上下文中调用）
+ * @param done_count 本次完成后的刷新完成计数（与 SPD2010_Get_Flush_Done_Count() 一致）
+ * @param arg 注册时传入的参数
+ * @return true 需要在中断退出时切换任务
+ */
+typedef bool (*spd2010_flush_done_hook_t)(uint32_t done_count, void *arg);
+
+/**
+ * @brief 设置刷新完成钩子
+ * @param hook 钩子函数，NULL 表示取消（恢复为每次传输完成都调用 lv_display_flush_ready()）
+ * @param arg 钩子参数
+ * @note 设置后中断回调不再直接调用 lv_display_flush_ready()，由钩子在区域最后一块完成时调用，
+ *       用于一个刷新区域拆成多次传输的分块刷新
+ */
+void SPD2010_Set_Flush_Done_Hook(spd2010_flush_done_hook_t hook, void *arg);
+
+/**
+ * @brief 设置刷新完成时通知的任务
+ * @param task 被通知的任务，NULL 表示取消
+ * @param bits 通知值，在中断回调中以 eSetBits 方式发送
+ * @note 用于唤醒等待下一个定时器截止时间的 LVGL 任务
+ */
+void SPD2010_Set_Flush_Notify(TaskHandle_t task, uint32_t bits);
@@ -15,6 +15,8 @@
 #include "esp_err.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 /*********************
  * 触摸屏参数配置
@@ -55,6 +57,14 @@ void      Touch_Deinit_Official(void);
 bool      Touch_Get_xy_Official(uint16_t *touch_x, uint16_t *touch_y, uint16_t *strength,
                                 uint8_t *touch_count, uint8_t max_points);
 
+/**
+ * @brief 触摸中断到来时以任务通知唤醒指定任务
+ * @param task 被通知的任务，NULL 表示取消
+ * @param bits 通知值（eSetBits）
+ * @return ESP_OK 成功；ESP_ERR_NOT_SUPPORTED 未配置 TOUCH_INT_PIN（仍使用轮询）
+ */
+esp_err_t Touch_Set_Int_Notify(TaskHandle_t task, uint32_t bits);
+
 /*********************
  * 兼容性宏定义
  *********************/
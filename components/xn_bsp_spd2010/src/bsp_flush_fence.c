@@ -0,0 +1,66 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_bsp_spd2010\src\bsp_flush_fence.c
+ * @Description: 刷新完成栅栏实现
+ */
+
+#include "bsp_flush_fence.h"
+
+void bsp_flush_fence_init(bsp_flush_fence_t *fence)
+{
+    fence->done_count = 0;
+    fence->wait_target = 0;
+    fence->waiter = NULL;
+    portMUX_INITIALIZE(&fence->lock);
+}
+
+uint32_t bsp_flush_fence_complete_from_isr(bsp_flush_fence_t *fence, BaseType_t *need_yield)
+{
+    portENTER_CRITICAL_ISR(&fence->lock);
+    uint32_t done_count = ++fence->done_count;
+    if (fence->waiter && (int32_t)(done_count - fence->wait_target) >= 0) {
+        vTaskNotifyGiveFromISR(fence->waiter, need_yield);
+        fence->waiter = NULL;
+    }
+    portEXIT_CRITICAL_ISR(&fence->lock);
+    return done_count;
+}
+
+esp_err_t bsp_flush_fence_wait(bsp_flush_fence_t *fence, uint32_t target, uint32_t timeout_ms)
+{
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+
+    while (1) {
+        portENTER_CRITICAL(&fence->lock);
+        if ((int32_t)(fence->done_count - target) >= 0) {
+            portEXIT_CRITICAL(&fence->lock);
+            return ESP_OK;
+        }
+        if (timeout == 0) {
+            // 只查询不等待：不登记为等待者，避免挡住其他任务的等待
+            portEXIT_CRITICAL(&fence->lock);
+            return ESP_ERR_TIMEOUT;
+        }
+        if (fence->waiter && fence->waiter != xTaskGetCurrentTaskHandle()) {
+            portEXIT_CRITICAL(&fence->lock);
+            return ESP_ERR_INVALID_STATE;
+        }
+        fence->wait_target = target;
+        fence->waiter = xTaskGetCurrentTaskHandle();
+        portEXIT_CRITICAL(&fence->lock);
+
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout ||
+            ulTaskNotifyTake(pdTRUE, timeout - elapsed) == 0) {
+            portENTER_CRITICAL(&fence->lock);
+            fence->waiter = NULL;
+            bool done = (int32_t)(fence->done_count - target) >= 0;
+            portEXIT_CRITICAL(&fence->lock);
+            return done ? ESP_OK : ESP_ERR_TIMEOUT;
+        }
+    }
+}
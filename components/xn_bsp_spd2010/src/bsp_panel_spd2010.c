@@ -22,6 +22,20 @@ uint8_t LCD_Backlight = 70;
 // LEDC通道配置结构体
 static ledc_channel_config_t ledc_channel;
 
+// 刷新完成栅栏：每次颜色数据DMA传输完成计数一次
+static bsp_flush_fence_t s_flush_fence = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+static portMUX_TYPE s_flush_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 刷新完成钩子：设置后由钩子决定何时调用 lv_display_flush_ready()（分块刷新）
+static spd2010_flush_done_hook_t s_flush_done_hook = NULL;
+static void *s_flush_done_hook_arg = NULL;
+
+// 刷新完成时唤醒的任务（LVGL 定时器任务），按位设置任务通知
+static TaskHandle_t s_flush_notify_task = NULL;
+static uint32_t s_flush_notify_bits = 0;
+
 /**
  * @brief SPD2010复位函数
  * 通过控制EXIO2引脚实现SPD2010的硬件复位
@@ -239,8 +253,68 @@ static bool notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_
     // 如需调试，可使用 ESP_EARLY_LOGI（无锁，但功能简陋）
 
     lv_display_t *disp = (lv_display_t *)user_ctx;
-    lv_display_flush_ready(disp);
-    return false;
+    BaseType_t need_yield = pdFALSE;
+
+    uint32_t done_count = bsp_flush_fence_complete_from_isr(&s_flush_fence, &need_yield);
+
+    if (s_flush_done_hook) {
+        if (s_flush_done_hook(done_count, s_flush_done_hook_arg)) {
+            need_yield = pdTRUE;
+        }
+    } else {
+        lv_display_flush_ready(disp);
+    }
+    if (s_flush_notify_task) {
+        xTaskNotifyFromISR(s_flush_notify_task, s_flush_notify_bits, eSetBits, &need_yield);
+    }
+    return need_yield == pdTRUE;
+}
+
+/**
+ * @brief 获取已完成的刷新传输次数
+ * @return uint32_t 完成计数（回绕递增）
+ */
+uint32_t SPD2010_Get_Flush_Done_Count(void)
+{
+    return bsp_flush_fence_done_count(&s_flush_fence);
+}
+
+/**
+ * @brief 等待刷新完成计数到达目标值
+ * @param target 目标计数
+ * @param timeout_ms 超时时间（毫秒）
+ * @return esp_err_t ESP_OK 表示已到达，ESP_ERR_TIMEOUT 表示超时，
+ *         ESP_ERR_INVALID_STATE 表示已有其他任务在等待
+ */
+esp_err_t SPD2010_Wait_Flush_Done(uint32_t target, uint32_t timeout_ms)
+{
+    return bsp_flush_fence_wait(&s_flush_fence, target, timeout_ms);
+}
+
+/**
+ * @brief 设置刷新完成钩子
+ * @param hook 中断上下文中调用的钩子，NULL 表示恢复为每次传输完成都通知 LVGL
+ * @param arg 钩子参数
+ */
+void SPD2010_Set_Flush_Done_Hook(spd2010_flush_done_hook_t hook, void *arg)
+{
+    portENTER_CRITICAL(&s_flush_lock);
+    s_flush_done_hook_arg = arg;
+    s_flush_done_hook = hook;
+    portEXIT_CRITICAL(&s_flush_lock);
+}
+
+/**
+ * @brief 设置刷新完成时通知的任务
+ * @param task 被通知的任务，NULL 表示取消
+ * @param bits 通知值（按位或到任务通知值上）
+ */
+void SPD2010_Set_Flush_Notify(TaskHandle_t task, uint32_t bits)
+{
+    portENTER_CRITICAL(&s_flush_lock);
+    s_flush_notify_task = task;
+    s_flush_notify_bits = bits;
+    portEXIT_CRITICAL(&s_flush_lock);
 }
 
 /**
@@ -435,6 +435,66 @@ esp_err_t Touch_Init_Official(void)
     return ESP_OK;
 }
 
+// 触摸中断：通知等待中的任务立即读取触摸数据
+static TaskHandle_t s_int_notify_task = NULL;
+static uint32_t s_int_notify_bits = 0;
+
+static void IRAM_ATTR touch_int_isr(void *arg)
+{
+    BaseType_t need_yield = pdFALSE;
+    if (s_int_notify_task) {
+        xTaskNotifyFromISR(s_int_notify_task, s_int_notify_bits, eSetBits, &need_yield);
+    }
+    if (need_yield == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+esp_err_t Touch_Set_Int_Notify(TaskHandle_t task, uint32_t bits)
+{
+#if TOUCH_INT_PIN >= 0
+    s_int_notify_task = task;
+    s_int_notify_bits = bits;
+
+    static bool s_int_installed = false;
+    if (s_int_installed) {
+        return ESP_OK;
+    }
+
+    const gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << TOUCH_INT_PIN,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,
+    };
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // ISR 服务可能已由其他驱动安装
+    ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        return ret;
+    }
+
+    ret = gpio_isr_handler_add(TOUCH_INT_PIN, touch_int_isr, NULL);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    s_int_installed = true;
+    ESP_LOGI(TAG, "触摸中断已启用: GPIO%d", TOUCH_INT_PIN);
+    return ESP_OK;
+#else
+    (void)task;
+    (void)bits;
+    (void)touch_int_isr;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 void Touch_Deinit_Official(void)
 {
     ESP_LOGI(TAG, "SPD2010触摸驱动暂不需要特殊反初始化");
@@ -0,0 +1,264 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\host_test\bench_cache_switch.c
+ * @Description: 解析缓存命中 / 未命中的切换耗时基准
+ *
+ * 按 anim_configs 播放一段切换序列，走与 lottie_play_slot / lottie_cache_load 相同的缓存路径：
+ * - 命中：lottie_parse_cache_touch
+ * - 未命中：按文件大小预估占用 → LRU 腾出预算 → 读取 lottie_spiffs 中的 JSON 到 PSRAM →
+ *   从缓冲区池分配显示缓冲区 → 放入缓存（放不下时作为临时对象，切走时释放）
+ * 解析后的动画数据用一块 JSON 大小 × LOTTIE_CACHE_PARSED_FACTOR 的 PSRAM 块代替。
+ *
+ * 主机上没有 ThorVG 与 LVGL，未命中耗时不含 JSON 解析与首帧渲染；
+ * 设备上的完整数字见 lottie_manager_get_stats() 的 parse_us_last / hit_switch_us_last / miss_switch_us_last。
+ *
+ *   bench_cache_switch <lottie_spiffs 目录> [轮数]     默认 200 轮
+ */
+#include "lottie_anim_configs.h"
+#include "lottie_parse_cache.h"
+#include "lottie_buffer_pool.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/** 一次切换中的动画对象（代替 lv_lottie 对象） */
+typedef struct {
+    uint8_t *parsed;        ///< 解析后数据的替身
+    size_t parsed_bytes;
+} bench_obj_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} bench_lat_t;
+
+static const char *s_dir;
+static lottie_cache_entry_t s_entries[ANIM_CONFIG_COUNT];
+static lottie_parse_cache_t s_cache;
+static int s_active_slot = -1;
+static bench_obj_t *s_active_obj;
+static uint8_t *s_active_buffer;
+static bench_lat_t s_hit;
+static bench_lat_t s_miss;
+static bench_lat_t s_miss_by_slot[ANIM_CONFIG_COUNT];
+static uint32_t s_transient;
+static size_t s_peak_used;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void lat_add(bench_lat_t *lat, uint64_t ns)
+{
+    lat->count++;
+    lat->total_ns += ns;
+    if (ns > lat->max_ns) {
+        lat->max_ns = ns;
+    }
+}
+
+// 与 lottie_select_format + lottie_render_format_bytes 一致（主机上没有帧包，sprite 动画按实时渲染计算）
+static size_t bench_buffer_bytes(const lottie_anim_config_t *config)
+{
+    size_t count = (size_t)config->width * config->height;
+#if LOTTIE_RENDER_COMPACT
+    if (config->opaque) {
+        return count * 2;
+    }
+    return count * (LOTTIE_RENDER_COMPACT_ALPHA ? 3 : 4);
+#else
+    return count * 4;
+#endif
+}
+
+static void bench_path(char *out, size_t size, const char *file_path)
+{
+    const char *name = strrchr(file_path, '/');
+    snprintf(out, size, "%s/%s", s_dir, name ? name + 1 : file_path);
+}
+
+static void bench_destroy(bench_obj_t *obj, uint8_t *buffer)
+{
+    if (obj) {
+        heap_caps_free(obj->parsed);
+        free(obj);
+    }
+    lottie_buffer_pool_free(buffer);
+}
+
+static void bench_evict_cb(int slot, lottie_cache_entry_t *entry, void *arg)
+{
+    bench_destroy(entry->obj, entry->buffer);
+}
+
+// 与 lottie_load_live_object 相同的读取与分配顺序
+static bench_obj_t *bench_load(const lottie_anim_config_t *config, uint8_t **out_buffer, size_t *out_bytes)
+{
+    char path[256];
+    bench_path(path, sizeof(path), config->file_path);
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        printf("cannot open %s\n", path);
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    size_t file_size = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *file_data = heap_caps_malloc(file_size, MALLOC_CAP_SPIRAM);
+    if (!file_data || fread(file_data, 1, file_size, fp) != file_size) {
+        fclose(fp);
+        heap_caps_free(file_data);
+        return NULL;
+    }
+    fclose(fp);
+
+    size_t buffer_size = bench_buffer_bytes(config);
+    uint8_t *buffer = lottie_buffer_pool_alloc(buffer_size);
+    bench_obj_t *obj = calloc(1, sizeof(*obj));
+    if (obj) {
+        obj->parsed_bytes = file_size * LOTTIE_CACHE_PARSED_FACTOR;
+        obj->parsed = heap_caps_malloc(obj->parsed_bytes, MALLOC_CAP_SPIRAM);
+    }
+    heap_caps_free(file_data);
+    if (!buffer || !obj || !obj->parsed) {
+        bench_destroy(obj, buffer);
+        return NULL;
+    }
+
+    *out_buffer = buffer;
+    *out_bytes = buffer_size + obj->parsed_bytes +
+                 (config->prerender ? LOTTIE_FRAME_CACHE_BUDGET_BYTES : 0);
+    return obj;
+}
+
+static bool bench_switch(int slot)
+{
+    const lottie_anim_config_t *config = &anim_configs[slot];
+    lottie_cache_entry_t *entry = &s_entries[slot];
+    uint64_t start = now_ns();
+    bool hit = entry->obj != NULL;
+    bench_obj_t *old_obj = s_active_obj;
+    uint8_t *old_buffer = s_active_buffer;
+    bool old_cached = s_active_slot >= 0;
+    bench_obj_t *obj;
+    uint8_t *buffer;
+    bool cached = hit;
+
+    if (hit) {
+        obj = entry->obj;
+        buffer = entry->buffer;
+        if (obj == old_obj) {
+            old_obj = NULL;
+        }
+    } else {
+        size_t need = bench_buffer_bytes(config) + (config->prerender ? LOTTIE_FRAME_CACHE_BUDGET_BYTES : 0);
+        char path[256];
+        struct stat st;
+        bench_path(path, sizeof(path), config->file_path);
+        if (stat(path, &st) == 0) {
+            need += (size_t)st.st_size * LOTTIE_CACHE_PARSED_FACTOR;
+        }
+        cached = lottie_parse_cache_reserve(&s_cache, need, s_active_slot);
+        size_t bytes = 0;
+        obj = bench_load(config, &buffer, &bytes);
+        if (!obj) {
+            return false;
+        }
+        if (cached) {
+            lottie_parse_cache_insert(&s_cache, slot, obj, buffer, bytes);
+        } else {
+            s_transient++;
+        }
+    }
+
+    s_active_obj = obj;
+    s_active_buffer = buffer;
+    s_active_slot = cached ? slot : -1;
+    if (cached) {
+        lottie_parse_cache_touch(&s_cache, slot);
+    }
+    if (old_obj && !old_cached) {
+        bench_destroy(old_obj, old_buffer);
+    }
+
+    uint64_t ns = now_ns() - start;
+    if (hit) {
+        lat_add(&s_hit, ns);
+    } else {
+        lat_add(&s_miss, ns);
+        lat_add(&s_miss_by_slot[slot], ns);
+    }
+    if (s_cache.used > s_peak_used) {
+        s_peak_used = s_cache.used;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: %s <lottie_spiffs dir> [rounds]\n", argv[0]);
+        return 2;
+    }
+    s_dir = argv[1];
+    int rounds = (argc > 2) ? atoi(argv[2]) : 200;
+    esp_log_level_set("*", ESP_LOG_WARN);
+
+    lottie_parse_cache_init(&s_cache, s_entries, (int)ANIM_CONFIG_COUNT, LOTTIE_CACHE_BUDGET_BYTES,
+                            bench_evict_cb, NULL);
+    size_t class_sizes[ANIM_CONFIG_COUNT];
+    for (size_t i = 0; i < ANIM_CONFIG_COUNT; i++) {
+        s_entries[i].pinned = anim_configs[i].pinned;
+        class_sizes[i] = bench_buffer_bytes(&anim_configs[i]);
+    }
+    lottie_buffer_pool_init(class_sizes, ANIM_CONFIG_COUNT);
+
+    // 待机 COOL 与 DICE 交替，穿插其它表情 / 加载动画，保证有命中、未命中与淘汰
+    static const int sequence[] = {
+        LOTTIE_ANIM_COOL, LOTTIE_ANIM_DICE, LOTTIE_ANIM_COOL, LOTTIE_ANIM_THINK, LOTTIE_ANIM_SPEAK,
+        LOTTIE_ANIM_COOL, LOTTIE_ANIM_MIC, LOTTIE_ANIM_DICE, LOTTIE_ANIM_WIFI, LOTTIE_ANIM_COOL,
+        LOTTIE_ANIM_LOADING, LOTTIE_ANIM_OTA, LOTTIE_ANIM_THINK, LOTTIE_ANIM_DICE, LOTTIE_ANIM_COOL,
+    };
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < sizeof(sequence) / sizeof(sequence[0]); i++) {
+            if (!bench_switch(sequence[i])) {
+                printf("FAIL: switch to %d failed\n", sequence[i]);
+                return 1;
+            }
+        }
+    }
+
+    printf("switches: %" PRIu32 " hits, %" PRIu32 " misses (%" PRIu32 " transient), %" PRIu32 " evictions\n",
+           s_hit.count, s_miss.count, s_transient, s_cache.evictions);
+    printf("hit  switch: avg %8.2f us, max %8.2f us\n",
+           s_hit.count ? s_hit.total_ns / 1e3 / s_hit.count : 0.0, s_hit.max_ns / 1e3);
+    printf("miss switch: avg %8.2f us, max %8.2f us  (file read + buffers, no ThorVG parse)\n",
+           s_miss.count ? s_miss.total_ns / 1e3 / s_miss.count : 0.0, s_miss.max_ns / 1e3);
+    for (size_t i = 0; i < ANIM_CONFIG_COUNT; i++) {
+        if (s_miss_by_slot[i].count) {
+            printf("  anim %zu %-24s %3ux%-3u miss %4" PRIu32 " x avg %8.2f us\n", i, anim_configs[i].file_path,
+                   anim_configs[i].width, anim_configs[i].height, s_miss_by_slot[i].count,
+                   s_miss_by_slot[i].total_ns / 1e3 / s_miss_by_slot[i].count);
+        }
+    }
+    printf("cache peak %zu / budget %u bytes\n", s_peak_used, (unsigned)LOTTIE_CACHE_BUDGET_BYTES);
+
+    if (!s_hit.count || !s_miss.count || s_peak_used > LOTTIE_CACHE_BUDGET_BYTES) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,227 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\host_test\bench_frame_cache.c
+ * @Description: 帧缓存基准：实时渲染与缓存解压的每帧 CPU 耗时、可达帧率与压缩占用
+ *
+ * 走与 lottie_frame_cache 相同的路径（同一份 lottie_rle.c / lottie_render_format.c）：
+ * - 实时：光栅化一帧 ARGB8888 → lottie_render_convert 到显示缓冲区格式（ARGB8888 为复制）
+ * - 首次播放：lottie_rle_encode_rgb565 / _a8 压缩保存（RGB565 格式不保存 A8，与不透明动画相同）
+ * - 缓存：lottie_rle_decode_frame 解压到显示缓冲区，结果必须与实时路径逐位一致
+ * 每种格式统计压缩后总字节数，以及 LOTTIE_FRAME_CACHE_BUDGET_BYTES 内能缓存的帧数。
+ *
+ * 主机上没有 ThorVG：合成场景由 bench_scene 逐像素光栅化代替，比 ThorVG 简单得多，
+ * 实时耗时只是下限；帧包（tools/lottie_sprite_compiler.py --all 生成，rlottie 的真实帧）
+ * 没有光栅化过程，实时一栏只含格式转换（标 *）。设备上的数字见 lottie_frame_cache_get_stats()
+ * 的 live_us_avg / blit_us_avg。
+ *
+ *   bench_frame_cache [帧包.spr ...]     不带参数时使用合成场景
+ */
+#include "bench_scene.h"
+#include "lottie_rle.h"
+#include "xn_lottie_manager.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DECODE_ROUNDS     5       ///< 缓存解压重复轮数（取平均）
+#define BENCH_FORMATS           3
+
+static const lottie_render_format_t s_formats[BENCH_FORMATS] = {
+    LOTTIE_RENDER_ARGB8888, LOTTIE_RENDER_RGB565A8, LOTTIE_RENDER_RGB565,
+};
+static const char *const s_format_names[BENCH_FORMATS] = {"ARGB8888", "RGB565A8", "RGB565"};
+
+/** 单帧压缩数据（与 lottie_frame_cache.c 的 lottie_frame_t 相同） */
+typedef struct {
+    uint8_t *data;
+    uint32_t rgb_len;
+    uint32_t alpha_len;
+} bench_frame_t;
+
+typedef struct {
+    uint64_t convert_ns;
+    uint64_t store_ns;
+    uint64_t cached_ns;
+    uint64_t bytes;
+    uint32_t frames_in_budget;
+    uint32_t mismatches;
+} bench_result_t;
+
+static inline uint32_t bench_argb(uint16_t c, uint8_t a)
+{
+    uint32_t r = (c >> 11) & 0x1F;
+    uint32_t g = (c >> 5) & 0x3F;
+    uint32_t b = c & 0x1F;
+    return ((uint32_t)a << 24) | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+}
+
+/* 一帧的实时渲染：光栅化到 ARGB8888 暂存区（代替 ThorVG） */
+static bool bench_render(const bench_anim_t *anim, uint32_t frame, uint16_t *rgb, uint8_t *alpha, uint32_t *scratch)
+{
+    size_t count = (size_t)anim->width * anim->height;
+
+    if (!bench_anim_frame(anim, frame, rgb, alpha)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        scratch[i] = bench_argb(rgb[i], alpha[i]);
+    }
+    return true;
+}
+
+static bool bench_run(const bench_anim_t *anim, bench_result_t res[BENCH_FORMATS], uint64_t *raster_ns)
+{
+    size_t count = (size_t)anim->width * anim->height;
+    uint16_t *rgb = malloc(count * sizeof(uint16_t));
+    uint8_t *alpha = malloc(count);
+    uint32_t *scratch = malloc(count * 4);
+    uint8_t *live = malloc(count * 4);
+    uint8_t *cached = malloc(count * 4);
+    bench_frame_t *frames = calloc((size_t)anim->frame_count * BENCH_FORMATS, sizeof(bench_frame_t));
+    bool ok = rgb && alpha && scratch && live && cached && frames;
+
+    memset(res, 0, sizeof(bench_result_t) * BENCH_FORMATS);
+    *raster_ns = 0;
+
+    // 首次播放：实时渲染、转换并压缩保存，同时校验解压结果
+    for (uint32_t f = 0; ok && f < anim->frame_count; f++) {
+        uint64_t t0 = bench_now_ns();
+        if (!bench_render(anim, f, rgb, alpha, scratch)) {
+            printf("%s: frame %" PRIu32 " corrupt\n", anim->name, f);
+            ok = false;
+            break;
+        }
+        *raster_ns += bench_now_ns() - t0;
+
+        for (int k = 0; k < BENCH_FORMATS; k++) {
+            lottie_render_format_t format = s_formats[k];
+            bench_frame_t *fr = &frames[(size_t)f * BENCH_FORMATS + k];
+            bool with_alpha = format != LOTTIE_RENDER_RGB565;
+
+            t0 = bench_now_ns();
+            lottie_render_convert(format, live, scratch, anim->width, anim->height);
+            uint64_t t1 = bench_now_ns();
+            res[k].convert_ns += t1 - t0;
+
+            size_t rgb_len = lottie_rle_encode_rgb565(NULL, scratch, count);
+            size_t alpha_len = with_alpha ? lottie_rle_encode_a8(NULL, scratch, count) : 0;
+            fr->data = malloc(rgb_len + alpha_len);
+            if (!fr->data) {
+                ok = false;
+                break;
+            }
+            lottie_rle_encode_rgb565(fr->data, scratch, count);
+            if (alpha_len) {
+                lottie_rle_encode_a8(fr->data + rgb_len, scratch, count);
+            }
+            fr->rgb_len = (uint32_t)rgb_len;
+            fr->alpha_len = (uint32_t)alpha_len;
+            res[k].store_ns += bench_now_ns() - t1;
+
+            res[k].bytes += rgb_len + alpha_len;
+            if (res[k].bytes <= LOTTIE_FRAME_CACHE_BUDGET_BYTES) {
+                res[k].frames_in_budget++;
+            }
+
+            if (!lottie_rle_decode_frame(format, cached, count, fr->data, rgb_len, alpha_len)) {
+                res[k].mismatches++;
+            }
+#if !LOTTIE_RENDER_DITHER
+            // 抖动开启时实时帧与缓存帧本来就有差异（见 LOTTIE_RENDER_DITHER）
+            else if (memcmp(cached, live, lottie_render_format_bytes(format, anim->width, anim->height)) != 0) {
+                res[k].mismatches++;
+            }
+#endif
+        }
+    }
+
+    // 再次播放：全部从缓存解压
+    for (int k = 0; ok && k < BENCH_FORMATS; k++) {
+        uint64_t t0 = bench_now_ns();
+        for (int r = 0; r < BENCH_DECODE_ROUNDS; r++) {
+            for (uint32_t f = 0; f < anim->frame_count; f++) {
+                const bench_frame_t *fr = &frames[(size_t)f * BENCH_FORMATS + k];
+                if (!lottie_rle_decode_frame(s_formats[k], cached, count, fr->data, fr->rgb_len, fr->alpha_len)) {
+                    res[k].mismatches++;
+                }
+            }
+        }
+        res[k].cached_ns = (bench_now_ns() - t0) / BENCH_DECODE_ROUNDS;
+    }
+
+    if (frames) {
+        for (size_t i = 0; i < (size_t)anim->frame_count * BENCH_FORMATS; i++) {
+            free(frames[i].data);
+        }
+    }
+    free(frames);
+    free(rgb);
+    free(alpha);
+    free(scratch);
+    free(live);
+    free(cached);
+    return ok;
+}
+
+static void bench_print(const bench_anim_t *anim, const bench_result_t res[BENCH_FORMATS], uint64_t raster_ns)
+{
+    uint32_t n = LV_MAX(anim->frame_count, 1u);
+    size_t raw = lottie_render_format_bytes(LOTTIE_RENDER_ARGB8888, anim->width, anim->height);
+    bool raster = anim->synth >= 0;
+
+    for (int k = 0; k < BENCH_FORMATS; k++) {
+        double live_us = ((raster ? raster_ns : 0) + res[k].convert_ns) / 1000.0 / n;
+        double cached_us = res[k].cached_ns / 1000.0 / n;
+        printf("%-22s %-8s %6" PRIu32 " %9.1f%s %9.1f %8.1f %9.1f %6.1fx %8.1f %7.1f%% %6" PRIu32 "/%-4" PRIu32 " %4" PRIu32 "\n",
+               anim->name, s_format_names[k], anim->frame_count, live_us, raster ? " " : "*", cached_us,
+               live_us > 0 ? 1e6 / live_us : 0.0, cached_us > 0 ? 1e6 / cached_us : 0.0,
+               cached_us > 0 ? live_us / cached_us : 0.0, res[k].store_ns / 1000.0 / n,
+               100.0 * res[k].bytes / ((double)raw * n), res[k].frames_in_budget, anim->frame_count,
+               res[k].mismatches);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int failures = 0;
+    int count = argc > 1 ? argc - 1 : BENCH_SYNTH_COUNT;
+
+    printf("frame cache budget %u bytes, decode averaged over %d rounds\n",
+           (unsigned)LOTTIE_FRAME_CACHE_BUDGET_BYTES, BENCH_DECODE_ROUNDS);
+    printf("%-22s %-8s %6s %10s %9s %8s %9s %7s %8s %8s %11s %4s\n", "anim", "format", "frames",
+           "live us/f", "cache us", "live fps", "cache fps", "speedup", "store us", "size", "in budget", "bad");
+
+    for (int i = 0; i < count; i++) {
+        bench_anim_t anim;
+        bench_result_t res[BENCH_FORMATS];
+        uint64_t raster_ns;
+
+        if (argc > 1) {
+            if (!bench_anim_open_sprite(&anim, argv[i + 1])) {
+                printf("%s: not a sprite pack\n", argv[i + 1]);
+                failures++;
+                continue;
+            }
+        } else {
+            bench_anim_open_synth(&anim, (bench_synth_t)i);
+        }
+
+        if (!bench_run(&anim, res, &raster_ns)) {
+            failures++;
+        } else {
+            bench_print(&anim, res, raster_ns);
+            for (int k = 0; k < BENCH_FORMATS; k++) {
+                failures += res[k].mismatches != 0;
+            }
+        }
+        bench_anim_close(&anim);
+    }
+
+    printf("live = raster + convert (* convert only, sprite frames); size relative to ARGB8888 frames\n");
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,313 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\host_test\bench_render_target.c
+ * @Description: 渲染目标格式基准：RGB565 / RGB565A8 与 ARGB8888 的合成耗时及 PSRAM 占用
+ *
+ * 合成：按 anim_configs 的尺寸生成一帧带透明边缘的动画（ARGB8888），用 lottie_render_convert 转成
+ * 三种显示缓冲区格式，再混合到 RGB565 背景上，代替 LVGL 每次重绘动画对象时的图像混合：
+ * - ARGB8888：设备上由 xn_lvgl_blend.h 的钩子接管，即 lvgl_pixel_blend_image_argb8888_to_rgb565
+ * - RGB565A8：LVGL 9.2 把 A8 平面作为遮罩，逐像素 lv_color_16_16_mix（这里按同样算法复刻）
+ * - RGB565：不透明，整行复制
+ * 实时渲染的紧凑格式每渲染一帧还要做一次格式转换（帧包直接解码为紧凑格式，没有这一步），单独列出。
+ * RGB565A8 与 ARGB8888 的混合结果每通道相差不能超过 1 个最低位。
+ *
+ * PSRAM 占用：显示缓冲区经 shim 的模拟 PSRAM 堆实际分配（含分配器开销），按三种策略统计
+ * 常驻（pinned）动画 + 最大的一个非常驻动画 + 共享 ARGB8888 暂存区（有实时紧凑格式动画时）。
+ *
+ * 主机上的缓冲区都在缓存里，设备上显示缓冲区在 PSRAM，读取字节数（每帧读取一栏）对设备耗时影响更大。
+ *
+ *   bench_render_target [轮数]     默认 20 轮
+ */
+#include "lottie_anim_configs.h"
+#include "lottie_render_format.h"
+#include "xn_lvgl_pixel.h"
+#include "lvgl.h"
+#include "esp_heap_caps.h"
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FORMATS   3
+
+static const lottie_render_format_t s_formats[BENCH_FORMATS] = {
+    LOTTIE_RENDER_ARGB8888, LOTTIE_RENDER_RGB565A8, LOTTIE_RENDER_RGB565,
+};
+
+typedef struct {
+    uint64_t blend_ns[BENCH_FORMATS];
+    uint64_t convert_ns[BENCH_FORMATS];
+    uint32_t max_diff;              ///< RGB565A8 与 ARGB8888 混合结果的最大通道差
+} bench_blend_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// 与 lottie_select_format 相同（帧包动画假定帧包存在）
+static lottie_render_format_t bench_select_format(const lottie_anim_config_t *config, bool compact, bool compact_alpha)
+{
+    if (!compact) {
+        return LOTTIE_RENDER_ARGB8888;
+    }
+    if (config->opaque) {
+        return LOTTIE_RENDER_RGB565;
+    }
+    return (config->sprite || compact_alpha) ? LOTTIE_RENDER_RGB565A8 : LOTTIE_RENDER_ARGB8888;
+}
+
+/*********************
+ * 合成耗时
+ *********************/
+
+/* 表情类动画的一帧：圆形主体带 2 像素抗锯齿边缘，外面全透明，内部是渐变与两块深色“眼睛” */
+static void bench_frame(uint32_t *argb, uint16_t width, uint16_t height)
+{
+    float cx = width / 2.0f, cy = height / 2.0f;
+    float r = LV_MIN(width, height) * 0.45f;
+
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            float dx = x + 0.5f - cx, dy = y + 0.5f - cy;
+            float d = sqrtf(dx * dx + dy * dy);
+            uint32_t a = d <= r - 1.0f ? 255 : (d >= r + 1.0f ? 0 : (uint32_t)((r + 1.0f - d) * 127.5f));
+            uint32_t red = 255, green = 160 + (uint32_t)(80.0f * y / height), blue = 40;
+            float ex = fabsf(fabsf(dx) - r * 0.35f), ey = dy + r * 0.2f;
+            if (ex * ex + ey * ey < r * r * 0.01f) {
+                red = green = blue = 30;
+            }
+            argb[(size_t)y * width + x] = (a << 24) | (red << 16) | (green << 8) | blue;
+        }
+    }
+}
+
+static void bench_background(uint16_t *bg, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        bg[i] = (uint16_t)(0x0841 * (i % 24));
+    }
+}
+
+/* LVGL 9.2 lv_draw_sw_blend_to_rgb565.c 的 lv_color_16_16_mix */
+static inline uint16_t lv_color_16_16_mix(uint16_t c1, uint16_t c2, uint8_t mix)
+{
+    if (mix == 255) {
+        return c1;
+    }
+    if (mix == 0) {
+        return c2;
+    }
+    if (c1 == c2) {
+        return c1;
+    }
+    uint32_t m = ((uint32_t)mix + 4) >> 3;
+    uint32_t bg = (c2 | ((uint32_t)c2 << 16)) & 0x7E0F81Fu;
+    uint32_t fg = (c1 | ((uint32_t)c1 << 16)) & 0x7E0F81Fu;
+    uint32_t result = ((((fg - bg) * m) >> 5) + bg) & 0x7E0F81Fu;
+    return (uint16_t)((result >> 16) | result);
+}
+
+/* 把显示缓冲区混合到 dst（行跨度与宽度相同） */
+static void bench_blend(lottie_render_format_t format, uint16_t *dst, const uint8_t *buffer, uint16_t width, uint16_t height)
+{
+    size_t count = (size_t)width * height;
+
+    switch (format) {
+    case LOTTIE_RENDER_ARGB8888:
+        lvgl_pixel_blend_image_argb8888_to_rgb565(dst, width * 2, buffer, width * 4, width, height, 0xFF);
+        break;
+    case LOTTIE_RENDER_RGB565A8: {
+        const uint16_t *rgb = (const uint16_t *)buffer;
+        const uint8_t *mask = buffer + count * 2;
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                size_t i = (size_t)y * width + x;
+                dst[i] = lv_color_16_16_mix(rgb[i], dst[i], mask[i]);
+            }
+        }
+        break;
+    }
+    default:
+        for (uint32_t y = 0; y < height; y++) {
+            memcpy(dst + (size_t)y * width, buffer + (size_t)y * width * 2, (size_t)width * 2);
+        }
+        break;
+    }
+}
+
+static uint32_t max_channel_diff(const uint16_t *a, const uint16_t *b, size_t count)
+{
+    uint32_t worst = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        int dr = abs((a[i] >> 11) - (b[i] >> 11));
+        int dg = abs(((a[i] >> 5) & 0x3F) - ((b[i] >> 5) & 0x3F));
+        int db = abs((a[i] & 0x1F) - (b[i] & 0x1F));
+        worst = LV_MAX(worst, (uint32_t)LV_MAX(dr, LV_MAX(dg, db)));
+    }
+    return worst;
+}
+
+static bool bench_blend_run(uint16_t width, uint16_t height, int rounds, bench_blend_t *res)
+{
+    size_t count = (size_t)width * height;
+    uint32_t *argb = malloc(count * 4);
+    uint16_t *bg = malloc(count * 2);
+    uint16_t *dst = malloc(count * 2);
+    uint16_t *ref = malloc(count * 2);
+    uint8_t *buffers[BENCH_FORMATS];
+    bool ok = argb && bg && dst && ref;
+
+    memset(res, 0, sizeof(*res));
+    for (int k = 0; k < BENCH_FORMATS; k++) {
+        buffers[k] = malloc(lottie_render_format_bytes(s_formats[k], width, height));
+        ok = ok && buffers[k];
+    }
+
+    if (ok) {
+        bench_frame(argb, width, height);
+        bench_background(bg, count);
+        for (int r = 0; r < rounds; r++) {
+            for (int k = 0; k < BENCH_FORMATS; k++) {
+                uint64_t t0 = now_ns();
+                lottie_render_convert(s_formats[k], buffers[k], argb, width, height);
+                uint64_t t1 = now_ns();
+                memcpy(dst, bg, count * 2);
+                uint64_t t2 = now_ns();
+                bench_blend(s_formats[k], dst, buffers[k], width, height);
+                res->blend_ns[k] += now_ns() - t2;
+                res->convert_ns[k] += t1 - t0;
+
+                if (r == 0 && s_formats[k] == LOTTIE_RENDER_ARGB8888) {
+                    memcpy(ref, dst, count * 2);
+                } else if (r == 0 && s_formats[k] == LOTTIE_RENDER_RGB565A8) {
+                    res->max_diff = max_channel_diff(ref, dst, count);
+                }
+            }
+        }
+    }
+
+    for (int k = 0; k < BENCH_FORMATS; k++) {
+        free(buffers[k]);
+    }
+    free(argb);
+    free(bg);
+    free(dst);
+    free(ref);
+    return ok;
+}
+
+/*********************
+ * PSRAM 占用
+ *********************/
+
+typedef struct {
+    const char *name;
+    bool compact;
+    bool compact_alpha;
+} bench_policy_t;
+
+/* 按策略在模拟 PSRAM 上分配常驻动画、最大的非常驻动画与暂存区，返回实际占用 */
+static size_t bench_footprint(const bench_policy_t *policy, size_t *buffers_bytes, bool *scratch)
+{
+    void *blocks[ANIM_CONFIG_COUNT + 2] = {0};
+    size_t largest = 0;
+    int largest_idx = -1;
+    int n = 0;
+
+    *buffers_bytes = 0;
+    *scratch = false;
+    size_t free_before = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+    for (size_t i = 0; i < ANIM_CONFIG_COUNT; i++) {
+        lottie_render_format_t format = bench_select_format(&anim_configs[i], policy->compact, policy->compact_alpha);
+        size_t bytes = lottie_render_format_bytes(format, anim_configs[i].width, anim_configs[i].height);
+        // 实时渲染（非帧包）的紧凑格式需要共享暂存区
+        if (format != LOTTIE_RENDER_ARGB8888 && !anim_configs[i].sprite) {
+            *scratch = true;
+        }
+        if (anim_configs[i].pinned) {
+            blocks[n++] = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+            *buffers_bytes += bytes;
+        } else if (bytes > largest) {
+            largest = bytes;
+            largest_idx = (int)i;
+        }
+    }
+    if (largest_idx >= 0) {
+        blocks[n++] = heap_caps_malloc(largest, MALLOC_CAP_SPIRAM);
+        *buffers_bytes += largest;
+    }
+    if (*scratch) {
+        blocks[n++] = heap_caps_malloc(LOTTIE_RENDER_SCRATCH_BYTES, MALLOC_CAP_SPIRAM);
+    }
+
+    size_t used = free_before - heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    for (int i = 0; i < n; i++) {
+        heap_caps_free(blocks[i]);
+    }
+    return used;
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = (argc > 1) ? atoi(argv[1]) : 20;
+    int failures = 0;
+
+    rounds = LV_MAX(rounds, 1);
+    printf("blend into RGB565, %d rounds per size (us per frame; read = source bytes per frame)\n", rounds);
+    printf("%-26s %9s %9s %9s %9s %9s %9s %9s %5s\n", "anim", "ARGB8888", "RGB565A8", "RGB565",
+           "cvt A8", "cvt 565", "read 8888", "read A8", "diff");
+
+    for (size_t i = 0; i < ANIM_CONFIG_COUNT; i++) {
+        const lottie_anim_config_t *config = &anim_configs[i];
+        bench_blend_t res;
+        char name[40];
+
+        snprintf(name, sizeof(name), "%s %ux%u", strrchr(config->file_path, '/') + 1, config->width, config->height);
+        if (!bench_blend_run(config->width, config->height, rounds, &res)) {
+            printf("%s: out of memory\n", name);
+            failures++;
+            continue;
+        }
+        printf("%-26s %9.1f %9.1f %9.1f %9.1f %9.1f %9zu %9zu %5" PRIu32 "\n", name,
+               res.blend_ns[0] / 1e3 / rounds, res.blend_ns[1] / 1e3 / rounds, res.blend_ns[2] / 1e3 / rounds,
+               res.convert_ns[1] / 1e3 / rounds, res.convert_ns[2] / 1e3 / rounds,
+               lottie_render_format_bytes(LOTTIE_RENDER_ARGB8888, config->width, config->height),
+               lottie_render_format_bytes(LOTTIE_RENDER_RGB565A8, config->width, config->height), res.max_diff);
+        // 两种带透明通道的路径都按 5 位 alpha 混合，只有舍入不同
+        if (res.max_diff > 1) {
+            failures++;
+        }
+    }
+    printf("(cvt = lottie_render_convert per live frame; sprite packs decode straight to the compact format)\n");
+
+    static const bench_policy_t policies[] = {
+        {"ARGB8888 only", false, false},
+        {"default (COMPACT)", LOTTIE_RENDER_COMPACT, LOTTIE_RENDER_COMPACT_ALPHA},
+        {"COMPACT + COMPACT_ALPHA", true, true},
+    };
+    printf("\nPSRAM: pinned + largest transient buffer + shared scratch (%u bytes) when needed\n",
+           (unsigned)LOTTIE_RENDER_SCRATCH_BYTES);
+    printf("%-26s %10s %8s %10s\n", "policy", "buffers", "scratch", "allocated");
+    for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+        size_t buffers;
+        bool scratch;
+        size_t used = bench_footprint(&policies[p], &buffers, &scratch);
+        printf("%-26s %10zu %8s %10zu\n", policies[p].name, buffers, scratch ? "yes" : "no", used);
+        if (used < buffers) {
+            failures++;
+        }
+    }
+
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
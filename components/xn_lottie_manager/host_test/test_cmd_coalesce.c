@@ -0,0 +1,268 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\host_test\test_cmd_coalesce.c
+ * @Description: lottie_cmd_coalesce 测试：连续点击只执行最终状态
+ *
+ * 命令执行用一个状态模型代替（当前动画、位置、隐藏），与 lottie_exec_cmd 的效果一致：
+ * - 连点：100 ms 内投递 50 条播放/停止/位置命令，消费任务与 lottie_task 相同（阻塞取一条，
+ *   再取出已积压的全部命令合并后执行，播放耗时 LOTTIE_TEST_PLAY_MS），结束状态必须等于
+ *   50 条命令逐条执行的结果，且实际执行的播放命令远少于投递数
+ * - 随机批次：大量 1~LOTTIE_CMD_QUEUE_LEN 条的随机批次，合并前后执行结果一致，丢弃计数与条数吻合
+ *
+ *   test_cmd_coalesce [随机批次数]     默认 200000
+ */
+#include "lottie_cmd_coalesce.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOTTIE_TEST_ANIMS       8
+#define LOTTIE_TEST_BURST       50          ///< 连点命令数
+#define LOTTIE_TEST_BURST_MS    100         ///< 连点持续时间
+#define LOTTIE_TEST_PLAY_MS     40          ///< 一次播放（切换动画）的耗时
+
+/** 执行效果模型 */
+typedef struct {
+    int current;                ///< 当前动画，-1 表示无
+    int16_t x;
+    int16_t y;
+    bool hidden;
+    uint32_t plays;             ///< 执行过的播放命令数
+} model_t;
+
+static uint32_t s_rng = 1;
+static QueueHandle_t s_queue;
+static model_t s_model;
+static volatile bool s_producing = true;
+static volatile bool s_consumer_done;
+static uint32_t s_received;
+static uint32_t s_dropped;
+static uint32_t s_batches;
+
+static uint32_t test_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+static void model_exec(model_t *m, const lottie_cmd_t *cmd)
+{
+    switch (cmd->type) {
+    case LOTTIE_CMD_PLAY:
+        m->current = cmd->data.play.anim_type;
+        m->x = 0;
+        m->y = 0;
+        m->hidden = false;
+        m->plays++;
+        break;
+    case LOTTIE_CMD_PLAY_AT_POS:
+        m->current = cmd->data.play_at_pos.anim_type;
+        m->x = cmd->data.play_at_pos.x;
+        m->y = cmd->data.play_at_pos.y;
+        m->hidden = false;
+        m->plays++;
+        break;
+    case LOTTIE_CMD_STOP:
+        if (cmd->data.stop.anim_type == -1 || cmd->data.stop.anim_type == m->current) {
+            m->current = -1;
+        }
+        break;
+    case LOTTIE_CMD_SET_POS:
+        if (m->current >= 0) {
+            m->x = cmd->data.pos.x;
+            m->y = cmd->data.pos.y;
+        }
+        break;
+    case LOTTIE_CMD_HIDE:
+    case LOTTIE_CMD_SHOW:
+        if (m->current >= 0) {
+            m->hidden = cmd->type == LOTTIE_CMD_HIDE;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static bool model_equal(const model_t *a, const model_t *b)
+{
+    if (a->current != b->current) {
+        return false;
+    }
+    return a->current < 0 || (a->x == b->x && a->y == b->y && a->hidden == b->hidden);
+}
+
+static lottie_cmd_t random_cmd(bool with_boundaries)
+{
+    lottie_cmd_t cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    uint32_t r = test_rand() % (with_boundaries ? 10 : 7);
+    int anim = (int)(test_rand() % LOTTIE_TEST_ANIMS);
+
+    if (r < 3) {
+        cmd.type = LOTTIE_CMD_PLAY;
+        cmd.data.play.anim_type = anim;
+    } else if (r < 5) {
+        cmd.type = LOTTIE_CMD_PLAY_AT_POS;
+        cmd.data.play_at_pos.anim_type = anim;
+        cmd.data.play_at_pos.x = (int16_t)(test_rand() % 64);
+        cmd.data.play_at_pos.y = (int16_t)(test_rand() % 64);
+    } else if (r < 7) {
+        cmd.type = LOTTIE_CMD_STOP;
+        cmd.data.stop.anim_type = (test_rand() % 3 == 0) ? -1 : anim;
+    } else if (r == 7) {
+        cmd.type = LOTTIE_CMD_SET_POS;
+        cmd.data.pos.x = (int16_t)(test_rand() % 64);
+        cmd.data.pos.y = (int16_t)(test_rand() % 64);
+    } else {
+        cmd.type = (r == 8) ? LOTTIE_CMD_HIDE : LOTTIE_CMD_SHOW;
+    }
+    return cmd;
+}
+
+// 与 lottie_task 相同的取命令与合并方式
+static void consumer_task(void *arg)
+{
+    lottie_cmd_t cmds[LOTTIE_CMD_QUEUE_LEN];
+
+    while (s_producing || uxQueueMessagesWaiting(s_queue)) {
+        if (xQueueReceive(s_queue, &cmds[0], pdMS_TO_TICKS(10)) != pdTRUE) {
+            continue;
+        }
+        size_t count = 1;
+        while (count < LOTTIE_CMD_QUEUE_LEN && xQueueReceive(s_queue, &cmds[count], 0) == pdTRUE) {
+            count++;
+        }
+
+        uint32_t dropped = 0;
+        size_t n = lottie_cmd_coalesce(cmds, count, &dropped);
+        s_received += count;
+        s_dropped += dropped;
+        s_batches++;
+        for (size_t i = 0; i < n; i++) {
+            bool play = cmds[i].type == LOTTIE_CMD_PLAY || cmds[i].type == LOTTIE_CMD_PLAY_AT_POS;
+            model_exec(&s_model, &cmds[i]);
+            vTaskDelay(pdMS_TO_TICKS(play ? LOTTIE_TEST_PLAY_MS : 1));
+        }
+    }
+    s_consumer_done = true;
+    vTaskDelete(NULL);
+}
+
+static bool test_burst(void)
+{
+    model_t expected = { .current = -1 };
+    s_model = expected;
+    s_queue = xQueueCreate(LOTTIE_CMD_QUEUE_LEN, sizeof(lottie_cmd_t));
+    TaskHandle_t consumer = NULL;
+    xTaskCreate(consumer_task, "lottie_task", 4096, NULL, 5, &consumer);
+
+    // 连点：播放/停止为主，偶尔夹带位置命令；最后一条固定为播放，结束状态可见
+    TickType_t start = xTaskGetTickCount();
+    TickType_t last = start;
+    uint32_t sent = 0;
+    for (int i = 0; i < LOTTIE_TEST_BURST; i++) {
+        lottie_cmd_t cmd = random_cmd(i % 10 == 5);
+        if (i == LOTTIE_TEST_BURST - 1) {
+            cmd.type = LOTTIE_CMD_PLAY_AT_POS;
+            cmd.data.play_at_pos.anim_type = 3;
+            cmd.data.play_at_pos.x = 12;
+            cmd.data.play_at_pos.y = 34;
+        }
+        // 与 lottie_manager_play_anim 相同：队列满时最多等待 100 ms
+        if (xQueueSend(s_queue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
+            model_exec(&expected, &cmd);
+            sent++;
+        }
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(LOTTIE_TEST_BURST_MS / LOTTIE_TEST_BURST));
+    }
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    s_producing = false;
+    while (!s_consumer_done) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+
+    printf("burst: %" PRIu32 " commands every %d ms (%" PRIu32 " ms incl. queue-full waits) -> %" PRIu32 " batches, "
+           "%" PRIu32 " dropped, %" PRIu32 " plays executed (%" PRIu32 " posted)\n",
+           sent, LOTTIE_TEST_BURST_MS / LOTTIE_TEST_BURST, (uint32_t)elapsed, s_batches, s_dropped,
+           s_model.plays, expected.plays);
+    printf("final: anim %d at (%d,%d)%s, expected anim %d at (%d,%d)%s\n",
+           s_model.current, s_model.x, s_model.y, s_model.hidden ? " hidden" : "",
+           expected.current, expected.x, expected.y, expected.hidden ? " hidden" : "");
+
+    bool ok = true;
+    if (sent != LOTTIE_TEST_BURST || s_received != sent) {
+        printf("FAIL: %" PRIu32 " sent, %" PRIu32 " received\n", sent, s_received);
+        ok = false;
+    }
+    if (!model_equal(&s_model, &expected) || s_model.current != 3) {
+        printf("FAIL: final state differs from executing every command\n");
+        ok = false;
+    }
+    if (s_model.plays * 2 > expected.plays) {
+        printf("FAIL: %" PRIu32 " of %" PRIu32 " plays executed, burst was not coalesced\n",
+               s_model.plays, expected.plays);
+        ok = false;
+    }
+    return ok;
+}
+
+static bool test_random(uint32_t batches)
+{
+    uint32_t errors = 0;
+    uint64_t total = 0;
+    uint64_t kept = 0;
+
+    for (uint32_t b = 0; b < batches; b++) {
+        lottie_cmd_t raw[LOTTIE_CMD_QUEUE_LEN];
+        lottie_cmd_t cmds[LOTTIE_CMD_QUEUE_LEN];
+        size_t count = 1 + test_rand() % LOTTIE_CMD_QUEUE_LEN;
+        for (size_t i = 0; i < count; i++) {
+            raw[i] = random_cmd(true);
+        }
+        memcpy(cmds, raw, sizeof(raw[0]) * count);
+
+        model_t a = { .current = (int)(test_rand() % (LOTTIE_TEST_ANIMS + 1)) - 1 };
+        model_t c = a;
+        for (size_t i = 0; i < count; i++) {
+            model_exec(&a, &raw[i]);
+        }
+        uint32_t dropped = 0;
+        size_t n = lottie_cmd_coalesce(cmds, count, &dropped);
+        for (size_t i = 0; i < n; i++) {
+            model_exec(&c, &cmds[i]);
+        }
+
+        total += count;
+        kept += n;
+        if (!model_equal(&a, &c) || n + dropped != count || c.plays > a.plays) {
+            if (errors < 5) {
+                printf("batch %" PRIu32 ": %zu -> %zu commands (%" PRIu32 " dropped), anim %d vs %d\n",
+                       b, count, n, dropped, a.current, c.current);
+            }
+            errors++;
+        }
+    }
+
+    printf("random: %" PRIu32 " batches, %" PRIu64 " commands -> %" PRIu64 " executed, %" PRIu32 " mismatches\n",
+           batches, total, kept, errors);
+    return errors == 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t batches = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 200000;
+
+    bool ok = test_burst();
+    ok = test_random(batches) && ok;
+
+    printf(ok ? "PASS\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}
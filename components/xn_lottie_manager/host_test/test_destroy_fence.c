@@ -0,0 +1,169 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\host_test\test_destroy_fence.c
+ * @Description: lottie_destroy_object 释放顺序的浸泡测试：刷新栅栏之后才归还显示缓冲区
+ *
+ * lottie_destroy_object 的顺序：隐藏并 lv_refr_now（仍可能提交读取旧缓冲区的传输）→ 删除对象 →
+ * 记录提交计数作为栅栏 → 等待栅栏 → lottie_buffer_pool_free。本测试用真实的 bsp_flush_fence 与
+ * lottie_buffer_pool 重放这一顺序，渲染内容与 LVGL 对象由填充图案代替：
+ * - 模拟 DMA 任务异步、分段读取已提交的传输，逐字节检查缓冲区仍是提交时的图案，完成后调用
+ *   bsp_flush_fence_complete_from_isr
+ * - 销毁后立即按下一个动画尺寸分配（缓冲区池会复用同一块）并写入新图案，
+ *   如果缓冲区在传输完成前被归还，DMA 会读到新图案
+ *
+ *   test_destroy_fence [轮数] [--no-fence]     --no-fence 跳过栅栏等待（对照组，应检测到错误）
+ */
+#include "lottie_anim_configs.h"
+#include "lottie_buffer_pool.h"
+#include "bsp_flush_fence.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DMA_QUEUE_LEN           8
+#define DMA_CHUNK_BYTES         4096
+#define DESTROY_FENCE_MS        LOTTIE_FLUSH_FENCE_TIMEOUT_MS
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    uint8_t pattern;                ///< 提交时缓冲区的内容
+} dma_txn_t;
+
+static bsp_flush_fence_t s_fence;
+static QueueHandle_t s_dma_queue;
+static uint32_t s_submit_count;
+static volatile uint32_t s_corrupt_txns;
+static volatile bool s_dma_stop;
+
+static void sleep_us(uint32_t us)
+{
+    struct timespec ts = { .tv_sec = 0, .tv_nsec = (long)us * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+// 模拟 SPI DMA：按块读取源缓冲区，块之间让出 CPU，模拟传输耗时
+static void dma_task(void *arg)
+{
+    dma_txn_t txn;
+    uint32_t rng = 1;
+
+    while (!s_dma_stop || uxQueueMessagesWaiting(s_dma_queue)) {
+        if (xQueueReceive(s_dma_queue, &txn, pdMS_TO_TICKS(10)) != pdTRUE) {
+            continue;
+        }
+        bool corrupt = false;
+        for (size_t off = 0; off < txn.len; off += DMA_CHUNK_BYTES) {
+            size_t n = (txn.len - off < DMA_CHUNK_BYTES) ? txn.len - off : DMA_CHUNK_BYTES;
+            for (size_t i = 0; i < n; i++) {
+                if (((volatile const uint8_t *)txn.buf)[off + i] != txn.pattern) {
+                    corrupt = true;
+                    break;
+                }
+            }
+            rng = rng * 1103515245u + 12345u;
+            if ((rng >> 16) % 4 == 0) {
+                sleep_us(20);
+            }
+        }
+        if (corrupt) {
+            s_corrupt_txns++;
+        }
+        BaseType_t need_yield = pdFALSE;
+        bsp_flush_fence_complete_from_isr(&s_fence, &need_yield);
+    }
+    vTaskDelete(NULL);
+}
+
+// 与 flush_cb 相同：提交计数先递增，再把传输交给 DMA
+static void submit(const uint8_t *buf, size_t len, uint8_t pattern)
+{
+    dma_txn_t txn = { .buf = buf, .len = len, .pattern = pattern };
+    s_submit_count++;
+    xQueueSend(s_dma_queue, &txn, portMAX_DELAY);
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = 3000;
+    bool use_fence = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-fence") == 0) {
+            use_fence = false;
+        } else {
+            rounds = atoi(argv[i]);
+        }
+    }
+    esp_log_level_set("*", ESP_LOG_WARN);
+
+    size_t class_sizes[ANIM_CONFIG_COUNT];
+    for (size_t i = 0; i < ANIM_CONFIG_COUNT; i++) {
+        class_sizes[i] = (size_t)anim_configs[i].width * anim_configs[i].height * 3;
+    }
+    lottie_buffer_pool_init(class_sizes, ANIM_CONFIG_COUNT);
+    bsp_flush_fence_init(&s_fence);
+    s_dma_queue = xQueueCreate(DMA_QUEUE_LEN, sizeof(dma_txn_t));
+    TaskHandle_t dma = NULL;
+    xTaskCreate(dma_task, "dma", 4096, NULL, 6, &dma);
+
+    uint32_t timeouts = 0;
+    uint32_t reuses = 0;
+    uint8_t *prev = NULL;
+    for (int r = 0; r < rounds; r++) {
+        const lottie_anim_config_t *config = &anim_configs[r % ANIM_CONFIG_COUNT];
+        size_t size = (size_t)config->width * config->height * 3;
+        uint8_t pattern = (uint8_t)(r * 37 + 1);
+
+        uint8_t *buffer = lottie_buffer_pool_alloc(size);
+        if (!buffer) {
+            printf("FAIL: alloc %zu failed at round %d\n", size, r);
+            return 1;
+        }
+        reuses += (buffer == prev);
+        memset(buffer, pattern, size);
+
+        // 播放期间的几次区域刷新 + 销毁时 lv_refr_now 提交的最后一帧
+        int flushes = 1 + r % 3;
+        for (int f = 0; f < flushes; f++) {
+            size_t part = size / flushes;
+            submit(buffer + part * f, part, pattern);
+        }
+        submit(buffer, size / 4, pattern);
+
+        // lottie_destroy_object：栅栏取最后一次提交的计数，等待完成后再归还缓冲区
+        uint32_t fence = s_submit_count;
+        if (use_fence && bsp_flush_fence_wait(&s_fence, fence, DESTROY_FENCE_MS) != ESP_OK) {
+            timeouts++;
+        }
+        lottie_buffer_pool_free(buffer);
+        prev = buffer;
+    }
+
+    s_dma_stop = true;
+    while (!bsp_flush_fence_reached(&s_fence, s_submit_count)) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+
+    xn_lottie_pool_stats_t pool;
+    lottie_buffer_pool_get_stats(&pool);
+    printf("%d destroys (%s), %" PRIu32 " transfers, buffer reused %" PRIu32 " times, "
+           "pool in use %zu bytes, fence timeouts %" PRIu32 ", transfers that read a recycled buffer %" PRIu32 "\n",
+           rounds, use_fence ? "fence" : "no fence", s_submit_count, reuses, pool.in_use_bytes,
+           timeouts, (uint32_t)s_corrupt_txns);
+
+    if (s_corrupt_txns || timeouts || pool.in_use_bytes) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
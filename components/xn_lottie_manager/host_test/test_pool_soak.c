@@ -0,0 +1,245 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\host_test\test_pool_soak.c
+ * @Description: 显示缓冲区池浸泡测试：反复切换全部 anim_configs，跟踪 PSRAM 最大空闲块
+ *
+ * 每轮按随机顺序播放全部动画，分配顺序与 lottie_load_live_object 相同：
+ * JSON 文件数据 → 显示缓冲区 → 解析后数据（随机大小的若干块）→ 释放文件数据。
+ * pinned 动画常驻，其余动画切走时释放；另有一些跨越多次切换的小块（LVGL 对象、字体缓存等的替身），
+ * 用来制造与显示缓冲区交错的空洞。
+ *
+ * 同一序列分别用缓冲区池与直接 heap_caps_malloc 跑一遍，每次切换后记录 PSRAM 最大空闲块。
+ * 池中保留的空闲块也能满足显示缓冲区分配，因此池模式另外记录“可用最大块”：
+ * 堆的最大空闲块与池中最大空闲块两者取大。
+ * 通过条件：池模式下没有分配失败，可用最大块始终不小于最大的显示缓冲区，结束时池内无使用中的块；
+ * 另外检查有缓冲区在使用时 lottie_buffer_pool_init 拒绝重新初始化。
+ *
+ *   test_pool_soak [轮数] [可用 PSRAM 字节]     默认 5000 轮、SOAK_PSRAM_AVAILABLE
+ */
+#include "lottie_anim_configs.h"
+#include "lottie_buffer_pool.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SOAK_PARSED_CHUNKS      4           ///< 每个对象的解析后数据块数
+#define SOAK_SMALL_SLOTS        24          ///< 跨切换存活的小块数
+#define SOAK_PSRAM_AVAILABLE    LOTTIE_CACHE_BUDGET_BYTES   ///< 留给动画的 PSRAM，其余先占住（音频、LVGL 等）
+
+typedef struct {
+    uint8_t *buffer;
+    uint8_t *parsed[SOAK_PARSED_CHUNKS];
+} soak_obj_t;
+
+typedef struct {
+    uint32_t switches;
+    uint32_t failures;
+    size_t min_largest;             ///< 堆的最大空闲块最小值
+    size_t min_usable;              ///< 可用最大块（含池中空闲块）最小值
+    size_t min_free;
+} soak_result_t;
+
+static bool s_use_pool;
+static uint32_t s_rng;
+
+static uint32_t soak_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+// 与 lottie_select_format 一致（主机上没有帧包，按实时渲染计算）
+static size_t soak_buffer_bytes(const lottie_anim_config_t *config)
+{
+    size_t count = (size_t)config->width * config->height;
+#if LOTTIE_RENDER_COMPACT
+    if (config->opaque) {
+        return count * 2;
+    }
+    return count * (LOTTIE_RENDER_COMPACT_ALPHA ? 3 : 4);
+#else
+    return count * 4;
+#endif
+}
+
+static uint8_t *soak_buffer_alloc(size_t size)
+{
+    return s_use_pool ? lottie_buffer_pool_alloc(size) : heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+}
+
+static void soak_buffer_free(uint8_t *buffer)
+{
+    if (s_use_pool) {
+        lottie_buffer_pool_free(buffer);
+    } else {
+        heap_caps_free(buffer);
+    }
+}
+
+static void soak_destroy(soak_obj_t *obj)
+{
+    for (int i = 0; i < SOAK_PARSED_CHUNKS; i++) {
+        heap_caps_free(obj->parsed[i]);
+        obj->parsed[i] = NULL;
+    }
+    soak_buffer_free(obj->buffer);
+    obj->buffer = NULL;
+}
+
+static bool soak_load(const lottie_anim_config_t *config, soak_obj_t *obj)
+{
+    size_t json = 8 * 1024 + soak_rand() % (32 * 1024);
+    uint8_t *file_data = heap_caps_malloc(json, MALLOC_CAP_SPIRAM);
+    obj->buffer = soak_buffer_alloc(soak_buffer_bytes(config));
+    for (int i = 0; i < SOAK_PARSED_CHUNKS; i++) {
+        obj->parsed[i] = heap_caps_malloc(json * LOTTIE_CACHE_PARSED_FACTOR / SOAK_PARSED_CHUNKS +
+                                          soak_rand() % 4096, MALLOC_CAP_SPIRAM);
+    }
+    heap_caps_free(file_data);
+
+    bool ok = file_data && obj->buffer;
+    for (int i = 0; i < SOAK_PARSED_CHUNKS; i++) {
+        ok = ok && obj->parsed[i];
+    }
+    if (!ok) {
+        soak_destroy(obj);
+    }
+    return ok;
+}
+
+static soak_result_t soak_run(bool use_pool, int rounds, size_t *class_sizes)
+{
+    soak_obj_t resident[ANIM_CONFIG_COUNT] = { 0 };
+    soak_obj_t active = { 0 };
+    uint8_t *small[SOAK_SMALL_SLOTS] = { 0 };
+    soak_result_t res = { .min_largest = SIZE_MAX, .min_usable = SIZE_MAX, .min_free = SIZE_MAX };
+
+    s_use_pool = use_pool;
+    s_rng = 1;
+    if (use_pool) {
+        lottie_buffer_pool_init(class_sizes, ANIM_CONFIG_COUNT);
+    }
+
+    for (int r = 0; r < rounds; r++) {
+        int order[ANIM_CONFIG_COUNT];
+        for (int i = 0; i < (int)ANIM_CONFIG_COUNT; i++) {
+            order[i] = i;
+        }
+        for (int i = (int)ANIM_CONFIG_COUNT - 1; i > 0; i--) {
+            int j = (int)(soak_rand() % (uint32_t)(i + 1));
+            int t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+
+        for (int i = 0; i < (int)ANIM_CONFIG_COUNT; i++) {
+            const lottie_anim_config_t *config = &anim_configs[order[i]];
+            soak_obj_t *obj = config->pinned ? &resident[order[i]] : &active;
+
+            // 切走上一个临时对象，常驻对象已存在时直接复用
+            if (active.buffer) {
+                soak_destroy(&active);
+            }
+            if (!obj->buffer && !soak_load(config, obj)) {
+                res.failures++;
+            }
+
+            int k = (int)(soak_rand() % SOAK_SMALL_SLOTS);
+            heap_caps_free(small[k]);
+            small[k] = heap_caps_malloc(256 + soak_rand() % (16 * 1024), MALLOC_CAP_SPIRAM);
+
+            size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+            size_t free_bytes = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+            size_t usable = largest;
+            if (use_pool) {
+                xn_lottie_pool_stats_t stats;
+                lottie_buffer_pool_get_stats(&stats);
+                for (int c = 0; c < stats.class_count; c++) {
+                    if (stats.classes[c].free && stats.classes[c].block_size > usable) {
+                        usable = stats.classes[c].block_size;
+                    }
+                }
+            }
+            if (largest < res.min_largest) {
+                res.min_largest = largest;
+            }
+            if (usable < res.min_usable) {
+                res.min_usable = usable;
+            }
+            if (free_bytes < res.min_free) {
+                res.min_free = free_bytes;
+            }
+            res.switches++;
+        }
+    }
+
+    soak_destroy(&active);
+    for (size_t i = 0; i < ANIM_CONFIG_COUNT; i++) {
+        soak_destroy(&resident[i]);
+    }
+    for (int k = 0; k < SOAK_SMALL_SLOTS; k++) {
+        heap_caps_free(small[k]);
+    }
+    return res;
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = (argc > 1) ? atoi(argv[1]) : 5000;
+    size_t available = (argc > 2) ? (size_t)strtoul(argv[2], NULL, 10) : SOAK_PSRAM_AVAILABLE;
+    esp_log_level_set("*", ESP_LOG_WARN);
+
+    size_t total = heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+    size_t free_now = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    uint8_t *reserved = (free_now > available) ?
+                        heap_caps_malloc(free_now - available, MALLOC_CAP_SPIRAM) : NULL;
+
+    size_t class_sizes[ANIM_CONFIG_COUNT];
+    size_t max_buffer = 0;
+    for (size_t i = 0; i < ANIM_CONFIG_COUNT; i++) {
+        class_sizes[i] = soak_buffer_bytes(&anim_configs[i]);
+        if (class_sizes[i] > max_buffer) {
+            max_buffer = class_sizes[i];
+        }
+    }
+
+    // 有缓冲区在使用时必须拒绝重新初始化
+    bool reinit_ok = lottie_buffer_pool_init(class_sizes, ANIM_CONFIG_COUNT) == ESP_OK;
+    uint8_t *held = lottie_buffer_pool_alloc(class_sizes[0]);
+    reinit_ok = reinit_ok && held &&
+                lottie_buffer_pool_init(class_sizes, ANIM_CONFIG_COUNT) == ESP_ERR_INVALID_STATE;
+    lottie_buffer_pool_free(held);
+    reinit_ok = reinit_ok && lottie_buffer_pool_init(class_sizes, ANIM_CONFIG_COUNT) == ESP_OK;
+
+    soak_result_t heap = soak_run(false, rounds, class_sizes);
+    soak_result_t pool = soak_run(true, rounds, class_sizes);
+    xn_lottie_pool_stats_t stats;
+    lottie_buffer_pool_get_stats(&stats);
+
+    printf("%d rounds x %u anims, PSRAM %zu bytes (%zu available), largest display buffer %zu bytes\n",
+           rounds, (unsigned)ANIM_CONFIG_COUNT, total, available, max_buffer);
+    printf("heap_caps_malloc: %" PRIu32 " switches, %" PRIu32 " failures, min largest free block %zu, min free %zu\n",
+           heap.switches, heap.failures, heap.min_largest, heap.min_free);
+    printf("buffer pool     : %" PRIu32 " switches, %" PRIu32 " failures, min largest free block %zu, min free %zu, "
+           "min usable block (incl. pooled) %zu\n",
+           pool.switches, pool.failures, pool.min_largest, pool.min_free, pool.min_usable);
+    printf("pool: %u classes, in use %zu bytes, oversize %" PRIu32 ", trims %" PRIu32 ", alloc failures %" PRIu32
+           ", re-init guard %s\n", stats.class_count, stats.in_use_bytes, stats.oversize_allocs, stats.trims,
+           stats.alloc_failures, reinit_ok ? "ok" : "BROKEN");
+
+    heap_caps_free(reserved);
+
+    if (!reinit_ok || pool.failures || stats.alloc_failures || stats.in_use_bytes ||
+        pool.min_usable < max_buffer) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\host_test\test_rle_roundtrip.c
+ * @Description: lottie_rle 测试：编码后解码与直接格式转换逐位一致，损坏数据被拒绝且不越界
+ *
+ * - 边界长度：0、1、127~129、256/257 个元素的纯色、噪声与交替图案（数据包按 128 个元素切分）
+ * - 随机图像：随机长度的连续段与噪声混合，ARGB 不同但 RGB565 相同的像素也要合并成连续段
+ * - 每张图像解码到 ARGB8888 / RGB565A8 / RGB565 三种显示缓冲区，与逐像素转换结果比较；
+ *   压缩长度不超过最坏情况，只计算长度的调用与实际写入一致
+ * - 损坏数据：截断、多余字节、随机翻转字节必须返回 false 或得到合法长度的结果，
+ *   解码缓冲区之后的保护区不能被写到
+ *
+ *   test_rle_roundtrip [随机图像数]     默认 2000
+ */
+#include "lottie_rle.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_MAX_PIXELS     (64 * 1024)
+#define TEST_GUARD_BYTES    64
+#define TEST_GUARD          0xA5
+
+static uint32_t s_rng = 1;
+static uint32_t s_src[TEST_MAX_PIXELS];
+static uint8_t s_stream[TEST_MAX_PIXELS * 3 + TEST_MAX_PIXELS / 64 + 16];
+static uint8_t s_dst[TEST_MAX_PIXELS * 4 + TEST_GUARD_BYTES];
+static uint8_t s_expect[TEST_MAX_PIXELS * 4];
+
+static uint32_t test_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+static inline uint16_t ref_rgb565(uint32_t p)
+{
+    return (uint16_t)(((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F));
+}
+
+static inline uint32_t ref_argb(uint16_t v, uint8_t a)
+{
+    uint32_t r = (v >> 11) & 0x1F;
+    uint32_t g = (v >> 5) & 0x3F;
+    uint32_t b = v & 0x1F;
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+    return ((uint32_t)a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// 解码结果的期望值：与 lottie_render_convert 的不抖动转换相同
+static size_t expect_frame(lottie_render_format_t format, const uint32_t *src, size_t count, bool with_alpha)
+{
+    uint16_t *rgb = (uint16_t *)s_expect;
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t a = with_alpha ? (uint8_t)(src[i] >> 24) : 0xFF;
+        switch (format) {
+        case LOTTIE_RENDER_RGB565:
+            rgb[i] = ref_rgb565(src[i]);
+            break;
+        case LOTTIE_RENDER_RGB565A8:
+            rgb[i] = ref_rgb565(src[i]);
+            s_expect[count * 2 + i] = a;
+            break;
+        default:
+            ((uint32_t *)s_expect)[i] = ref_argb(ref_rgb565(src[i]), a);
+            break;
+        }
+    }
+    return format == LOTTIE_RENDER_RGB565 ? count * 2 : (format == LOTTIE_RENDER_RGB565A8 ? count * 3 : count * 4);
+}
+
+static bool guard_intact(size_t bytes)
+{
+    for (size_t i = 0; i < TEST_GUARD_BYTES; i++) {
+        if (s_dst[bytes + i] != TEST_GUARD) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 编码一张图像并按三种格式解码比较，packed 输出压缩后总字节数
+static bool roundtrip(const char *name, const uint32_t *src, size_t count, bool with_alpha, size_t *packed)
+{
+    size_t rgb_len = lottie_rle_encode_rgb565(NULL, src, count);
+    size_t alpha_len = with_alpha ? lottie_rle_encode_a8(NULL, src, count) : 0;
+    // 原样包之后总跟着至少 2 个元素的重复包（或数据结束），最坏每 3 个元素多 1 个头字节
+    size_t worst_rgb = count * 2 + (count + 2) / 3 + 1;
+    size_t worst_alpha = with_alpha ? count + (count + 2) / 3 + 1 : 0;
+
+    if (rgb_len > worst_rgb || alpha_len > worst_alpha) {
+        printf("%s: %zu+%zu bytes exceeds worst case %zu+%zu\n", name, rgb_len, alpha_len, worst_rgb, worst_alpha);
+        return false;
+    }
+
+    memset(s_stream, 0, rgb_len + alpha_len);
+    if (lottie_rle_encode_rgb565(s_stream, src, count) != rgb_len ||
+        (with_alpha && lottie_rle_encode_a8(s_stream + rgb_len, src, count) != alpha_len)) {
+        printf("%s: length-only pass differs from written length\n", name);
+        return false;
+    }
+
+    static const lottie_render_format_t formats[] = {
+        LOTTIE_RENDER_ARGB8888, LOTTIE_RENDER_RGB565A8, LOTTIE_RENDER_RGB565,
+    };
+    static const char *const format_names[] = {"ARGB8888", "RGB565A8", "RGB565"};
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        size_t bytes = expect_frame(formats[f], src, count, with_alpha);
+        memset(s_dst, TEST_GUARD, bytes + TEST_GUARD_BYTES);
+        if (!lottie_rle_decode_frame(formats[f], s_dst, count, s_stream, rgb_len, alpha_len)) {
+            printf("%s: %s decode rejected a valid stream\n", name, format_names[f]);
+            return false;
+        }
+        if (memcmp(s_dst, s_expect, bytes) != 0 || !guard_intact(bytes)) {
+            printf("%s: %s decode differs from direct conversion\n", name, format_names[f]);
+            return false;
+        }
+    }
+    *packed = rgb_len + alpha_len;
+    return true;
+}
+
+// 损坏的数据流：不能越界写，截断与多余字节必须被拒绝
+static bool corrupt(const char *name, const uint32_t *src, size_t count)
+{
+    if (count == 0) {
+        return true;
+    }
+
+    size_t rgb_len = lottie_rle_encode_rgb565(s_stream, src, count);
+    size_t alpha_len = lottie_rle_encode_a8(s_stream + rgb_len, src, count);
+    size_t bytes = count * 4;
+
+    memset(s_dst, TEST_GUARD, bytes + TEST_GUARD_BYTES);
+    if (lottie_rle_decode_frame(LOTTIE_RENDER_ARGB8888, s_dst, count, s_stream, rgb_len - 1, 0) ||
+        lottie_rle_decode_frame(LOTTIE_RENDER_RGB565A8, s_dst, count, s_stream, rgb_len, alpha_len - 1)) {
+        printf("%s: truncated stream accepted\n", name);
+        return false;
+    }
+    s_stream[rgb_len + alpha_len] = 0;
+    if (lottie_rle_decode_frame(LOTTIE_RENDER_RGB565, s_dst, count, s_stream, rgb_len + 1, 0) ||
+        lottie_rle_decode_frame(LOTTIE_RENDER_ARGB8888, s_dst, count, s_stream, rgb_len, alpha_len + 1)) {
+        printf("%s: trailing byte accepted\n", name);
+        return false;
+    }
+
+    for (int k = 0; k < 8; k++) {
+        s_stream[test_rand() % (rgb_len + alpha_len)] ^= (uint8_t)(1u << (test_rand() % 8));
+    }
+    lottie_rle_decode_frame(LOTTIE_RENDER_ARGB8888, s_dst, count, s_stream, rgb_len, alpha_len);
+    lottie_rle_decode_frame(LOTTIE_RENDER_RGB565A8, s_dst, count, s_stream, rgb_len, alpha_len);
+    lottie_rle_decode_frame(LOTTIE_RENDER_RGB565, s_dst, count, s_stream, rgb_len, 0);
+    if (!guard_intact(bytes)) {
+        printf("%s: corrupt stream wrote past the buffer\n", name);
+        return false;
+    }
+    return true;
+}
+
+static uint32_t random_pixel(void)
+{
+    return test_rand() ^ (test_rand() << 24);
+}
+
+// 随机图像：连续段与噪声混合，部分连续段只在 RGB565 丢弃的低位上不同
+static size_t random_image(uint32_t *dst, size_t max)
+{
+    size_t count = 1 + test_rand() % max;
+    size_t i = 0;
+
+    while (i < count) {
+        size_t len = 1 + test_rand() % (test_rand() % 4 == 0 ? 400 : 6);
+        uint32_t base = random_pixel();
+        uint32_t kind = test_rand() % 4;
+        for (size_t k = 0; k < len && i < count; k++, i++) {
+            switch (kind) {
+            case 0:
+                dst[i] = random_pixel();
+                break;
+            case 1:
+                dst[i] = base ^ (test_rand() & 0x00070307);
+                break;
+            default:
+                dst[i] = base;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t images = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 2000;
+    static const size_t edge_counts[] = {0, 1, 2, 127, 128, 129, 255, 256, 257, 1000};
+    int failures = 0;
+    char name[64];
+
+    for (size_t c = 0; c < sizeof(edge_counts) / sizeof(edge_counts[0]); c++) {
+        size_t count = edge_counts[c];
+        for (int pattern = 0; pattern < 4; pattern++) {
+            for (size_t i = 0; i < count; i++) {
+                switch (pattern) {
+                case 0:
+                    s_src[i] = 0x80FF8000u;
+                    break;
+                case 1:
+                    s_src[i] = random_pixel();
+                    break;
+                case 2:
+                    s_src[i] = (i % 3 == 2) ? 0xFF0000FFu : 0x00FFFFFFu;
+                    break;
+                default:
+                    s_src[i] = (i & 1) ? 0xFF123456u : 0xFF654321u;
+                    break;
+                }
+            }
+            snprintf(name, sizeof(name), "edge %zu/%d", count, pattern);
+            for (int with_alpha = 0; with_alpha < 2; with_alpha++) {
+                size_t packed;
+                failures += !roundtrip(name, s_src, count, with_alpha, &packed);
+            }
+            failures += !corrupt(name, s_src, count);
+        }
+    }
+
+    uint64_t raw_bytes = 0;
+    uint64_t packed_bytes = 0;
+    for (uint32_t n = 0; n < images; n++) {
+        size_t count = random_image(s_src, n % 16 == 0 ? TEST_MAX_PIXELS : 4096);
+        bool with_alpha = n & 1;
+        snprintf(name, sizeof(name), "image %" PRIu32, n);
+        size_t packed = 0;
+        failures += !roundtrip(name, s_src, count, with_alpha, &packed);
+        failures += !corrupt(name, s_src, count);
+        raw_bytes += count * (with_alpha ? 3 : 2);
+        packed_bytes += packed;
+    }
+
+    printf("%" PRIu32 " random images: %" PRIu64 " -> %" PRIu64 " bytes (%.1f%%), %d failures\n",
+           images, raw_bytes, packed_bytes, raw_bytes ? 100.0 * packed_bytes / raw_bytes : 0.0, failures);
+    printf(failures ? "FAIL\n" : "PASS\n");
+    return failures ? 1 : 0;
+}
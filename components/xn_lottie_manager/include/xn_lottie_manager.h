@@ -14,7 +14,6 @@
 extern "C" {
 #endif
 
-#include "lvgl.h"
 #include "esp_err.h"
 #include <stdint.h>
 #include <stdbool.h>
@@ -31,12 +30,161 @@ extern "C" {
 
 // 可以继续添加更多动画类型...
 
+// 解析缓存预算（字节）：缓存中已解析动画对象与渲染缓冲区的总占用上限
+#ifndef LOTTIE_CACHE_BUDGET_BYTES
+#define LOTTIE_CACHE_BUDGET_BYTES   (4 * 1024 * 1024)
+#endif
+
+// 解析后动画数据相对 JSON 文件大小的估算倍数（用于缓存预算）
+#ifndef LOTTIE_CACHE_PARSED_FACTOR
+#define LOTTIE_CACHE_PARSED_FACTOR  3
+#endif
+
+// 单个动画预渲染帧缓存（RGB565+A8 RLE 压缩帧）的预算（字节），超出后剩余帧保持实时渲染
+#ifndef LOTTIE_FRAME_CACHE_BUDGET_BYTES
+#define LOTTIE_FRAME_CACHE_BUDGET_BYTES  (1024 * 1024)
+#endif
+
+// 等待刷新栅栏（在途DMA完成）的超时时间（毫秒）
+#ifndef LOTTIE_FLUSH_FENCE_TIMEOUT_MS
+#define LOTTIE_FLUSH_FENCE_TIMEOUT_MS  200
+#endif
+
+// 动画显示缓冲区使用紧凑格式（RGB565 / RGB565+A8）；设为 0 全部保持 ARGB8888。
+// 帧包动画直接解码为紧凑格式，每个对象省 25%（RGB565+A8）或 50%（不透明 RGB565）。
+// 实时渲染的紧凑格式需要 ThorVG 先渲染到共享 ARGB8888 暂存区（LOTTIE_RENDER_SCRATCH_BYTES，首次使用后常驻），
+// 实际占用 = 暂存区 + 各对象缓冲区：一个 400x400 RGB565+A8 动画为 640000 + 480000 字节，
+// 而 ARGB8888 只需 640000 字节。因此默认只有不透明（anim_configs 的 opaque）实时动画使用 RGB565
+#ifndef LOTTIE_RENDER_COMPACT
+#define LOTTIE_RENDER_COMPACT  1
+#endif
+
+// 带透明通道的实时动画也使用 RGB565+A8（共用暂存区）。同时驻留的这类动画总像素数超过
+// LOTTIE_RENDER_SCRATCH_BYTES 时才省内存，默认关闭
+#ifndef LOTTIE_RENDER_COMPACT_ALPHA
+#define LOTTIE_RENDER_COMPACT_ALPHA  0
+#endif
+
+// 紧凑格式转换 RGB565 时使用 4x4 有序抖动，减少渐变色带；帧缓存仍按截断编码，
+// 开启后实时渲染帧与缓存回放帧会有轻微差异，默认关闭
+#ifndef LOTTIE_RENDER_DITHER
+#define LOTTIE_RENDER_DITHER  0
+#endif
+
+// 共享 ARGB8888 暂存区大小（字节），需不小于最大动画的 宽 × 高 × 4，更大的动画退回 ARGB8888
+#ifndef LOTTIE_RENDER_SCRATCH_BYTES
+#define LOTTIE_RENDER_SCRATCH_BYTES  (400 * 400 * 4)
+#endif
+
+// 实时渲染帧率调节：未配置上限的动画默认帧率上限与最低帧率
+#ifndef LOTTIE_GOV_DEFAULT_CAP_FPS
+#define LOTTIE_GOV_DEFAULT_CAP_FPS  30
+#endif
+
+#ifndef LOTTIE_GOV_MIN_FPS
+#define LOTTIE_GOV_MIN_FPS  4
+#endif
+
+// 帧率调节窗口（渲染帧数）：每个窗口按平均渲染耗时评估一次
+#ifndef LOTTIE_GOV_WINDOW_FRAMES
+#define LOTTIE_GOV_WINDOW_FRAMES  8
+#endif
+
+// 渲染负载（渲染耗时 × 帧率，%）高于此值时降帧率，提升后仍低于 LOW 时升帧率
+#ifndef LOTTIE_GOV_LOAD_HIGH_PCT
+#define LOTTIE_GOV_LOAD_HIGH_PCT  60
+#endif
+
+#ifndef LOTTIE_GOV_LOAD_LOW_PCT
+#define LOTTIE_GOV_LOAD_LOW_PCT   35
+#endif
+
+// 显示缓冲区池最多的尺寸级别数（级别取自 anim_configs 中各动画的缓冲区大小）
+#ifndef LOTTIE_POOL_MAX_CLASSES
+#define LOTTIE_POOL_MAX_CLASSES  8
+#endif
+
+// 显示缓冲区池最多保留的空闲块总字节数，超出部分还给堆
+#ifndef LOTTIE_POOL_RETAIN_BYTES
+#define LOTTIE_POOL_RETAIN_BYTES  (1024 * 1024)
+#endif
+
 // Lottie 管理器初始化配置（预留多屏兼容等扩展使用）
 typedef struct {
     uint16_t screen_width;   // 屏幕宽度
     uint16_t screen_height;  // 屏幕高度
 } xn_lottie_app_config_t;
 
+// Lottie 管理器统计（解析缓存与切换延迟）
+typedef struct {
+    uint32_t hits;                  // 缓存命中次数（仅重新绑定已解析对象）
+    uint32_t misses;                // 未命中次数（读取并解析 JSON）
+    uint32_t evictions;             // LRU 淘汰次数
+    uint32_t hit_switch_us_last;    // 最近一次命中切换耗时（微秒）
+    uint32_t miss_switch_us_last;   // 最近一次未命中切换耗时（微秒）
+    size_t used_bytes;              // 缓存当前估算占用（字节）
+    size_t budget_bytes;            // 缓存预算（字节）
+    uint8_t entries;                // 缓存中的动画数量
+    uint32_t first_frame_us_last;   // 最近一次播放请求到首帧刷新完成的耗时（微秒）
+    uint32_t first_frame_us_max;    // 播放请求到首帧刷新完成的最大耗时（微秒）
+    uint32_t fence_wait_us_last;    // 最近一次删除动画时等待刷新栅栏的耗时（微秒）
+    uint32_t gap_frames_last;       // 最近一次切换中新旧动画都不可见的帧数（双缓冲切换时为 0）
+    uint32_t gap_frames_max;        // 切换空白帧数最大值
+    size_t switch_psram_peak_bytes; // 最近一次切换期间新旧动画同时驻留的 PSRAM 增量（字节）
+    uint32_t preloads;              // 预加载完成次数
+    uint32_t cmd_received;          // lottie_task 收到的命令数
+    uint32_t cmd_dropped;           // 被后续命令覆盖而丢弃的命令数（连续播放/停止合并）
+    bool frame_cache_enabled;       // 当前动画是否启用预渲染帧缓存
+    uint32_t frame_cache_frames;    // 当前动画已缓存帧数
+    uint32_t frame_total_frames;    // 当前动画总帧数
+    size_t frame_cache_bytes;       // 当前动画压缩帧占用（字节）
+    uint32_t frame_live_us_avg;     // 当前动画实时渲染每帧平均耗时（微秒）
+    uint32_t frame_blit_us_avg;     // 当前动画解压贴图每帧平均耗时（微秒）
+    uint32_t load_us_last;          // 最近一次创建动画对象的耗时（读取文件 + 解析/校验，微秒）
+    size_t load_bytes_last;         // 最近一次创建的动画对象估算占用（字节）
+    uint32_t parse_us_last;         // 最近一次实时渲染动画的 JSON 解析耗时（微秒）
+    size_t parse_heap_bytes_last;   // 最近一次 JSON 解析后驻留的堆内存（内部 RAM + PSRAM，字节）
+    bool sprite_enabled;            // 当前动画是否由预编译帧包播放（不运行 ThorVG）
+    uint32_t sprite_frames;         // 当前帧包帧数
+    size_t sprite_pack_bytes;       // 当前帧包大小（Flash 与 PSRAM 占用相同，字节）
+    uint32_t sprite_decode_us_avg;  // 当前帧包每帧解压平均耗时（微秒）
+    uint8_t render_format_last;     // 最近一次创建的动画对象的显示缓冲区格式（0 ARGB8888，1 RGB565+A8，2 RGB565）
+    size_t render_buffer_bytes_last;// 最近一次创建的动画对象的显示缓冲区大小（字节）
+    size_t render_scratch_bytes;    // 共享 ARGB8888 渲染暂存区大小（字节，未分配为 0）
+    uint32_t render_convert_us_avg; // 当前动画每帧 ARGB8888 -> 紧凑格式转换平均耗时（微秒）
+    uint8_t gov_fps;                // 当前动画的有效渲染帧率（帧率调节器选定）
+    uint8_t gov_fps_cap;            // 当前动画的渲染帧率上限
+    uint16_t gov_achieved_fps_x10;  // 当前动画最近一秒实际渲染帧率 × 10
+    uint32_t gov_rendered_frames;   // 当前动画实际渲染帧数
+    uint32_t gov_skipped_frames;    // 当前动画被调节器跳过的帧数
+    uint32_t render_us_p50;         // 当前动画最近 64 帧渲染耗时中位数（含格式转换，微秒）
+    uint32_t render_us_p90;         // 渲染耗时 P90（微秒）
+    uint32_t render_us_p99;         // 渲染耗时 P99（微秒）
+} xn_lottie_stats_t;
+
+// 显示缓冲区池单个尺寸级别的统计
+typedef struct {
+    size_t block_size;              // 块大小（字节）
+    uint16_t in_use;                // 使用中的块数
+    uint16_t free;                  // 池中空闲块数
+    uint32_t allocs;                // 分配次数
+    uint32_t reuses;                // 复用空闲块的次数
+} xn_lottie_pool_class_stats_t;
+
+// 显示缓冲区池占用与 PSRAM 碎片统计
+typedef struct {
+    xn_lottie_pool_class_stats_t classes[LOTTIE_POOL_MAX_CLASSES];
+    uint8_t class_count;            // 尺寸级别数
+    size_t in_use_bytes;            // 使用中的缓冲区总字节数
+    size_t free_bytes;              // 池中保留的空闲块总字节数
+    uint32_t oversize_allocs;       // 没有合适级别、直接走堆的分配次数
+    uint32_t trims;                 // 分配失败后归还空闲块重试的次数
+    uint32_t alloc_failures;        // 分配失败次数
+    size_t psram_free_bytes;        // PSRAM 空闲总量（字节）
+    size_t psram_largest_free_block;// PSRAM 最大连续空闲块（字节）
+    uint8_t psram_fragmentation_pct;// PSRAM 碎片率：100 - 最大空闲块 / 空闲总量（%）
+} xn_lottie_pool_stats_t;
+
 /**
  * @brief 初始化 Lottie 管理器（包含底层 LVGL / 屏幕 / SPIFFS / 管理器）
  *
@@ -69,6 +217,8 @@ bool lottie_manager_play_at_pos(const char *file_path, uint16_t width, uint16_t
 
 /**
  * @brief 停止当前动画
+ *
+ * 已缓存的动画仅隐藏并保留解析结果，未缓存的临时动画会被删除。
  */
 void lottie_manager_stop(void);
 
@@ -110,6 +260,17 @@ bool lottie_manager_play_anim(int anim_type);
  */
 bool lottie_manager_play_anim_at_pos(int anim_type, int16_t x, int16_t y);
 
+/**
+ * @brief 预加载指定类型的动画到解析缓存（简单API）
+ *
+ * 在后台解析并保持隐藏，之后播放该动画时只需交换可见性，例如在 COOL 待机时预先准备 DICE。
+ * 缓存预算不足时预加载会被放弃。
+ *
+ * @param anim_type 动画类型宏（如LOTTIE_ANIM_DICE）
+ * @return true 命令已发送，false 失败
+ */
+bool lottie_manager_preload_anim(int anim_type);
+
 /**
  * @brief 停止指定类型的动画（简单API）
  * @param anim_type 动画类型宏，-1表示停止当前所有动画
@@ -126,6 +287,40 @@ bool lottie_manager_show_image(const char *img_path, uint16_t width, uint16_t he
  */
 void lottie_manager_hide_image(void);
 
+/**
+ * @brief 设置动画是否常驻解析缓存（常驻动画不参与 LRU 淘汰）
+ * @param anim_type 动画类型宏
+ * @param pinned true 常驻，false 取消常驻
+ * @return
+ *      - ESP_OK: 成功
+ *      - ESP_ERR_INVALID_ARG: 动画类型无效
+ *      - ESP_ERR_INVALID_STATE: 管理器未初始化
+ *      - ESP_ERR_TIMEOUT: 获取互斥锁超时
+ */
+esp_err_t lottie_manager_cache_pin(int anim_type, bool pinned);
+
+/**
+ * @brief 获取管理器统计（解析缓存、请求到首帧延迟等）
+ * @param stats 输出统计
+ * @return
+ *      - ESP_OK: 成功
+ *      - ESP_ERR_INVALID_ARG: 参数为空
+ *      - ESP_ERR_INVALID_STATE: 管理器未初始化
+ *      - ESP_ERR_TIMEOUT: 获取互斥锁超时
+ */
+esp_err_t lottie_manager_get_stats(xn_lottie_stats_t *stats);
+
+/**
+ * @brief 获取显示缓冲区池的占用与 PSRAM 碎片统计
+ * @param stats 输出统计
+ * @return
+ *      - ESP_OK: 成功
+ *      - ESP_ERR_INVALID_ARG: 参数为空
+ *      - ESP_ERR_INVALID_STATE: 管理器未初始化
+ *      - ESP_ERR_TIMEOUT: 获取互斥锁超时
+ */
+esp_err_t lottie_manager_get_pool_stats(xn_lottie_pool_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
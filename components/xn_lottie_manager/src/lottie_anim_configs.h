@@ -0,0 +1,42 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_anim_configs.h
+ * @Description: 动画配置表（xn_lottie_manager.c 与主机测试共用；构建时 lottie_sprite_compiler.py 也解析此文件）
+ */
+
+#pragma once
+
+#include "xn_lottie_manager.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// 动画配置结构
+typedef struct {
+    const char *file_path;
+    uint16_t width;
+    uint16_t height;
+    bool pinned;        // 常驻解析缓存（不参与LRU淘汰）
+    bool prerender;     // 启用预渲染帧缓存（短循环动画）
+    bool sprite;        // 优先播放构建时生成的帧包（缺失时回退到实时渲染）
+    bool opaque;        // 内容完全不透明（整个画布都有不透明像素），显示缓冲区使用 RGB565
+    uint8_t max_fps;    // 实时渲染帧率上限，0 表示 LOTTIE_GOV_DEFAULT_CAP_FPS（待机动画可调低以省电）
+} lottie_anim_config_t;
+
+// 动画配置表 - 全屏显示配置（屏幕尺寸：412x412）
+// 现有动画都带透明背景（dice.json 中的纯色层是遮罩），opaque 均为 false
+static const lottie_anim_config_t anim_configs[] = {
+    [LOTTIE_ANIM_WIFI]    = {"/lottie/loading.json",        256, 256, false, false, false, false, 10},  // WiFi加载
+    [LOTTIE_ANIM_MIC]     = {"/lottie/emoji_kaixin.json",   128, 128, false, false, false, false, 0},   // mic
+    [LOTTIE_ANIM_SPEAK]   = {"/lottie/speak.json",          400, 277, false, false, false, false, 0},   // 说话
+    [LOTTIE_ANIM_THINK]   = {"/lottie/emoji_think.json",    400, 400, false, false, false, false, 0},   // 思考
+    [LOTTIE_ANIM_COOL]    = {"/lottie/emoji_cool.json",     400, 400, true,  true,  false, false, 8},   // 酷（待机常驻）
+    [LOTTIE_ANIM_LOADING] = {"/lottie/loading.json",        200, 200, false, false, false, false, 10},  // 通用加载
+    [LOTTIE_ANIM_OTA]     = {"/lottie/loading.json",        400, 400, false, false, false, false, 10},  // OTA升级动画
+    [LOTTIE_ANIM_DICE]    = {"/lottie/dice.json",           260, 260, true,  true,  true,  false, 0},   // 骰子动画（常驻，帧包）
+    // 可以继续添加更多动画配置...
+};
+
+#define ANIM_CONFIG_COUNT (sizeof(anim_configs) / sizeof(anim_configs[0]))
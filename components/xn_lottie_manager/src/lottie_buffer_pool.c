@@ -0,0 +1,249 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-04 10:05:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-04 10:05:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_buffer_pool.c
+ * @Description: Lottie 显示缓冲区池实现
+ *
+ * 每次播放都按动画尺寸 malloc/free 64 KB~640 KB 的块，长时间运行后 PSRAM 会被切碎。
+ * 池把块大小固定为少数几个级别，并保留一部分空闲块，切换动画时直接复用同一块内存。
+ */
+
+#include "lottie_buffer_pool.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "LOTTIE_POOL";
+
+#define POOL_BLOCK_MAGIC    0x4C504F4Fu     // "LPOO"
+#define POOL_CLASS_NONE     (-1)            // 未匹配级别，直接走堆
+
+/** 块头（位于返回给调用方的指针之前） */
+typedef struct lottie_pool_block_s {
+    uint32_t magic;
+    int32_t cls;                            ///< 所属级别，POOL_CLASS_NONE 表示堆分配
+    size_t size;                            ///< 可用字节数
+    struct lottie_pool_block_s *next;       ///< 空闲链表
+} lottie_pool_block_t;
+
+// 块头按 16 字节对齐，保证缓冲区本身的对齐与 malloc 一致
+#define POOL_HDR_SIZE       ((sizeof(lottie_pool_block_t) + 15) & ~(size_t)15)
+
+/** 尺寸级别 */
+typedef struct {
+    size_t block_size;
+    lottie_pool_block_t *free_list;
+    uint16_t in_use;
+    uint16_t free;
+    uint32_t allocs;
+    uint32_t reuses;
+} lottie_pool_class_t;
+
+static lottie_pool_class_t s_classes[LOTTIE_POOL_MAX_CLASSES];
+static uint8_t s_class_count = 0;
+static size_t s_in_use_bytes = 0;
+static size_t s_free_bytes = 0;
+static uint32_t s_oversize_allocs = 0;
+static uint32_t s_trims = 0;
+static uint32_t s_alloc_failures = 0;
+
+static inline lottie_pool_block_t *pool_block_of(uint8_t *buffer)
+{
+    return (lottie_pool_block_t *)(buffer - POOL_HDR_SIZE);
+}
+
+static inline uint8_t *pool_buffer_of(lottie_pool_block_t *block)
+{
+    return (uint8_t *)block + POOL_HDR_SIZE;
+}
+
+esp_err_t lottie_buffer_pool_init(const size_t *class_sizes, size_t count)
+{
+    if (s_in_use_bytes != 0) {
+        ESP_LOGE(TAG, "仍有 %zu 字节缓冲区在使用，不能重新初始化", s_in_use_bytes);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    lottie_buffer_pool_trim();
+    memset(s_classes, 0, sizeof(s_classes));
+    s_class_count = 0;
+
+    // 插入排序并去重，级别按块大小升序排列
+    for (size_t i = 0; i < count && s_class_count < LOTTIE_POOL_MAX_CLASSES; i++) {
+        size_t size = (class_sizes[i] + 63) & ~(size_t)63;
+        int pos = s_class_count;
+        bool dup = false;
+        for (int k = 0; k < s_class_count; k++) {
+            if (s_classes[k].block_size == size) {
+                dup = true;
+                break;
+            }
+            if (s_classes[k].block_size > size) {
+                pos = k;
+                break;
+            }
+        }
+        if (dup || size == 0) {
+            continue;
+        }
+        memmove(&s_classes[pos + 1], &s_classes[pos], (s_class_count - pos) * sizeof(s_classes[0]));
+        memset(&s_classes[pos], 0, sizeof(s_classes[0]));
+        s_classes[pos].block_size = size;
+        s_class_count++;
+    }
+
+    for (int k = 0; k < s_class_count; k++) {
+        ESP_LOGI(TAG, "级别 %d: %zu 字节", k, s_classes[k].block_size);
+    }
+    return ESP_OK;
+}
+
+// 选择能容纳 size 的最小级别；浪费超过 1/4 时不使用池
+static int pool_find_class(size_t size)
+{
+    for (int k = 0; k < s_class_count; k++) {
+        size_t block = s_classes[k].block_size;
+        if (block >= size) {
+            return (block - size <= block / 4) ? k : POOL_CLASS_NONE;
+        }
+    }
+    return POOL_CLASS_NONE;
+}
+
+static lottie_pool_block_t *pool_heap_alloc(size_t size)
+{
+    return heap_caps_malloc(POOL_HDR_SIZE + size, MALLOC_CAP_SPIRAM);
+}
+
+// 把级别的一个空闲块还给堆
+static void pool_release_free(lottie_pool_class_t *c)
+{
+    lottie_pool_block_t *block = c->free_list;
+    c->free_list = block->next;
+    c->free--;
+    s_free_bytes -= c->block_size;
+    block->magic = 0;
+    heap_caps_free(block);
+}
+
+uint8_t *lottie_buffer_pool_alloc(size_t size)
+{
+    int cls = pool_find_class(size);
+    lottie_pool_block_t *block = NULL;
+
+    if (cls != POOL_CLASS_NONE) {
+        lottie_pool_class_t *c = &s_classes[cls];
+        c->allocs++;
+        if (c->free_list) {
+            block = c->free_list;
+            c->free_list = block->next;
+            c->free--;
+            c->reuses++;
+            s_free_bytes -= c->block_size;
+        } else {
+            size = c->block_size;
+        }
+    } else {
+        s_oversize_allocs++;
+    }
+
+    if (!block) {
+        block = pool_heap_alloc(size);
+        if (!block && s_free_bytes > 0) {
+            // 空闲块可能挡住了大块的连续空间，全部归还后再试
+            ESP_LOGW(TAG, "分配 %zu 字节失败，归还 %zu 字节空闲块后重试", size, s_free_bytes);
+            lottie_buffer_pool_trim();
+            s_trims++;
+            block = pool_heap_alloc(size);
+        }
+        if (!block) {
+            s_alloc_failures++;
+            return NULL;
+        }
+        block->magic = POOL_BLOCK_MAGIC;
+        block->cls = cls;
+        block->size = size;
+    }
+
+    block->next = NULL;
+    if (block->cls != POOL_CLASS_NONE) {
+        s_classes[block->cls].in_use++;
+    }
+    s_in_use_bytes += block->size;
+    return pool_buffer_of(block);
+}
+
+void lottie_buffer_pool_free(uint8_t *buffer)
+{
+    if (!buffer) {
+        return;
+    }
+
+    lottie_pool_block_t *block = pool_block_of(buffer);
+    if (block->magic != POOL_BLOCK_MAGIC) {
+        ESP_LOGE(TAG, "释放了不属于缓冲区池的指针 %p", buffer);
+        return;
+    }
+
+    s_in_use_bytes -= block->size;
+    if (block->cls == POOL_CLASS_NONE) {
+        block->magic = 0;
+        heap_caps_free(block);
+        return;
+    }
+
+    lottie_pool_class_t *c = &s_classes[block->cls];
+    c->in_use--;
+
+    // 保留额度不足时优先让出更小级别的空闲块：大块最难重新分配到连续空间
+    for (int k = 0; k < block->cls && s_free_bytes + block->size > LOTTIE_POOL_RETAIN_BYTES; k++) {
+        while (s_classes[k].free_list && s_free_bytes + block->size > LOTTIE_POOL_RETAIN_BYTES) {
+            pool_release_free(&s_classes[k]);
+        }
+    }
+    if (s_free_bytes + block->size > LOTTIE_POOL_RETAIN_BYTES) {
+        block->magic = 0;
+        heap_caps_free(block);
+        return;
+    }
+
+    block->next = c->free_list;
+    c->free_list = block;
+    c->free++;
+    s_free_bytes += block->size;
+}
+
+void lottie_buffer_pool_trim(void)
+{
+    for (int k = 0; k < s_class_count; k++) {
+        while (s_classes[k].free_list) {
+            pool_release_free(&s_classes[k]);
+        }
+    }
+}
+
+void lottie_buffer_pool_get_stats(xn_lottie_pool_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    stats->class_count = s_class_count;
+    for (int k = 0; k < s_class_count; k++) {
+        stats->classes[k].block_size = s_classes[k].block_size;
+        stats->classes[k].in_use = s_classes[k].in_use;
+        stats->classes[k].free = s_classes[k].free;
+        stats->classes[k].allocs = s_classes[k].allocs;
+        stats->classes[k].reuses = s_classes[k].reuses;
+    }
+    stats->in_use_bytes = s_in_use_bytes;
+    stats->free_bytes = s_free_bytes;
+    stats->oversize_allocs = s_oversize_allocs;
+    stats->trims = s_trims;
+    stats->alloc_failures = s_alloc_failures;
+
+    stats->psram_free_bytes = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    stats->psram_largest_free_block = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    stats->psram_fragmentation_pct = stats->psram_free_bytes ?
+        (uint8_t)(100 - (uint64_t)stats->psram_largest_free_block * 100 / stats->psram_free_bytes) : 0;
+}
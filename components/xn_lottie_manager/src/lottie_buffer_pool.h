@@ -0,0 +1,64 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-04 10:05:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-04 10:05:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_buffer_pool.h
+ * @Description: Lottie 显示缓冲区池（按尺寸分级复用 PSRAM 块）
+ */
+
+#pragma once
+
+#include "xn_lottie_manager.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 初始化缓冲区池
+ *
+ * 尺寸级别通常取 anim_configs 中各动画的显示缓冲区大小，重复值自动合并。
+ * 只在 lottie_task 持有 g_anim_mutex 时使用，模块本身不加锁。
+ * 重新初始化会重建级别表，仍有缓冲区在使用时拒绝（块头里的级别下标会失效）。
+ *
+ * @param class_sizes 各级别块大小（字节）
+ * @param count 级别数，超出 LOTTIE_POOL_MAX_CLASSES 的部分忽略
+ * @return ESP_OK 成功；ESP_ERR_INVALID_STATE 仍有缓冲区未归还
+ */
+esp_err_t lottie_buffer_pool_init(const size_t *class_sizes, size_t count);
+
+/**
+ * @brief 分配缓冲区
+ *
+ * 优先复用空闲块；没有空闲块时按级别大小新分配。没有合适级别（浪费超过 1/4）
+ * 的请求直接走堆分配。分配失败时先归还池中空闲块再重试一次。
+ *
+ * @param size 需要的字节数
+ * @return 缓冲区指针，失败返回 NULL
+ */
+uint8_t *lottie_buffer_pool_alloc(size_t size);
+
+/**
+ * @brief 归还缓冲区（NULL 时无操作）
+ *
+ * 空闲块在 LOTTIE_POOL_RETAIN_BYTES 范围内留在池中供下次复用，超出部分还给堆。
+ */
+void lottie_buffer_pool_free(uint8_t *buffer);
+
+/**
+ * @brief 把池中所有空闲块还给堆
+ */
+void lottie_buffer_pool_trim(void);
+
+/**
+ * @brief 获取池占用与 PSRAM 碎片统计
+ */
+void lottie_buffer_pool_get_stats(xn_lottie_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_cmd_coalesce.c
+ * @Description: lottie_task 命令批量合并实现
+ */
+
+#include "lottie_cmd_coalesce.h"
+
+static inline bool lottie_cmd_is_play(const lottie_cmd_t *cmd)
+{
+    return cmd->type == LOTTIE_CMD_PLAY || cmd->type == LOTTIE_CMD_PLAY_AT_POS;
+}
+
+// 播放命令的动画类型（PLAY 与 PLAY_AT_POS 的 union 成员不同）
+static inline int lottie_cmd_play_type(const lottie_cmd_t *cmd)
+{
+    return cmd->type == LOTTIE_CMD_PLAY ? cmd->data.play.anim_type : cmd->data.play_at_pos.anim_type;
+}
+
+// 批量合并，规则见 lottie_cmd_coalesce.h
+size_t lottie_cmd_coalesce(lottie_cmd_t *cmds, size_t count, uint32_t *dropped)
+{
+    size_t out = 0;
+    int play = -1;      // 待执行的播放命令下标
+    int stop = -1;      // 待执行的停止命令下标
+
+    for (size_t i = 0; i <= count; i++) {
+        const lottie_cmd_t *cmd = i < count ? &cmds[i] : NULL;
+
+        if (cmd && lottie_cmd_is_play(cmd)) {
+            *dropped += (play >= 0) + (stop >= 0);
+            play = i;
+            stop = -1;
+            continue;
+        }
+
+        if (cmd && cmd->type == LOTTIE_CMD_STOP) {
+            int type = cmd->data.stop.anim_type;
+            if (play >= 0) {
+                if (type != -1 && type != lottie_cmd_play_type(&cmds[play])) {
+                    (*dropped)++;
+                    continue;
+                }
+                // 先播放再停止：等价于停止当前任何动画
+                (*dropped)++;
+                play = -1;
+                stop = i;
+                cmds[i].data.stop.anim_type = -1;
+                continue;
+            }
+            if (stop >= 0) {
+                int pending = cmds[stop].data.stop.anim_type;
+                if (pending == -1 || pending == type) {
+                    (*dropped)++;
+                    continue;
+                }
+                // 两个不同类型的 STOP 无法合并，先写出前一个
+                cmds[out++] = cmds[stop];
+            }
+            stop = i;
+            continue;
+        }
+
+        // 分界：写出待执行的停止/播放命令，再写出当前命令
+        if (stop >= 0) {
+            cmds[out++] = cmds[stop];
+            stop = -1;
+        }
+        if (play >= 0) {
+            cmds[out++] = cmds[play];
+            play = -1;
+        }
+        if (cmd) {
+            cmds[out++] = *cmd;
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,83 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_cmd_coalesce.h
+ * @Description: lottie_task 命令定义与批量合并（不依赖 LVGL）
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 动画命令类型
+typedef enum {
+    LOTTIE_CMD_PLAY,
+    LOTTIE_CMD_PLAY_AT_POS,
+    LOTTIE_CMD_STOP,
+    LOTTIE_CMD_HIDE,
+    LOTTIE_CMD_SHOW,
+    LOTTIE_CMD_SET_POS,
+    LOTTIE_CMD_CENTER,
+    LOTTIE_CMD_SHOW_IMAGE,
+    LOTTIE_CMD_HIDE_IMAGE,
+    LOTTIE_CMD_PRELOAD
+} lottie_cmd_type_t;
+
+// 动画命令结构
+typedef struct {
+    lottie_cmd_type_t type;
+    int64_t request_us;      // 请求时间戳（用于统计请求到首帧的延迟）
+    union {
+        struct {
+            int anim_type;
+        } play;
+        struct {
+            int anim_type;
+            int16_t x;
+            int16_t y;
+        } play_at_pos;
+        struct {
+            int anim_type;
+        } stop;
+        struct {
+            int16_t x;
+            int16_t y;
+        } pos;
+        struct {
+            char path[64];
+            uint16_t width;
+            uint16_t height;
+        } image;
+    } data;
+} lottie_cmd_t;
+
+// 命令队列长度，也是 lottie_task 单次合并的最大命令数
+#define LOTTIE_CMD_QUEUE_LEN 10
+
+/**
+ * @brief 合并一批命令，返回合并后的命令数（原地写回 cmds）
+ *
+ * 连续的 PLAY / PLAY_AT_POS / STOP 只保留最终效果：
+ *   - 只有最后一个播放命令生效，之前的播放命令被覆盖；
+ *   - STOP 之后紧跟播放命令时 STOP 丢弃，由播放命令直接切换；
+ *   - 播放 X 之后的 STOP X / STOP -1 把播放命令一起抵消，只保留一次 STOP -1；
+ *   - 播放 X 之后的 STOP Y（Y != X）不会生效，直接丢弃。
+ * 其他命令（显示/隐藏/位置/图片/预加载）作用于当前对象，作为分界保持原有顺序。
+ *
+ * @param cmds 命令数组（按入队顺序）
+ * @param count 命令数
+ * @param dropped 累加被合并掉的命令数
+ */
+size_t lottie_cmd_coalesce(lottie_cmd_t *cmds, size_t count, uint32_t *dropped);
+
+#ifdef __cplusplus
+}
+#endif
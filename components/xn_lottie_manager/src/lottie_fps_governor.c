@@ -0,0 +1,116 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-04 16:30:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-04 16:30:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_fps_governor.c
+ * @Description: Lottie 自适应帧率调节实现
+ *
+ * 渲染负载 = 窗口平均渲染耗时 × 有效帧率，即渲染占用的 CPU 时间比例。
+ * 负载高于 LOTTIE_GOV_LOAD_HIGH_PCT 时降低帧率（跳过更多帧），
+ * 按提升后的帧率估算负载仍低于 LOTTIE_GOV_LOAD_LOW_PCT 时逐步提高帧率，直到上限。
+ */
+
+#include "lottie_fps_governor.h"
+#include "xn_lottie_manager.h"
+#include "lvgl.h"
+#include <string.h>
+
+void lottie_fps_governor_init(lottie_fps_governor_t *gov, uint8_t cap_fps)
+{
+    memset(gov, 0, sizeof(*gov));
+    gov->cap_fps = cap_fps ? cap_fps : LOTTIE_GOV_DEFAULT_CAP_FPS;
+    if (gov->cap_fps < LOTTIE_GOV_MIN_FPS) {
+        gov->cap_fps = LOTTIE_GOV_MIN_FPS;
+    }
+    gov->fps = gov->cap_fps;
+    gov->last_slot = -1;
+}
+
+bool lottie_fps_governor_should_render(lottie_fps_governor_t *gov, uint32_t now_ms)
+{
+    int32_t slot = (int32_t)(((uint64_t)now_ms * gov->fps / 1000) & 0x7FFFFFFF);
+
+    if (slot == gov->last_slot) {
+        gov->skipped++;
+        return false;
+    }
+    gov->last_slot = slot;
+    return true;
+}
+
+// 渲染负载（%）：平均耗时 avg_us 的帧以 fps 帧率渲染时占用的时间比例
+static inline uint32_t gov_load_pct(uint64_t avg_us, uint32_t fps)
+{
+    return (uint32_t)(avg_us * fps / 10000);
+}
+
+void lottie_fps_governor_record(lottie_fps_governor_t *gov, uint32_t now_ms, uint32_t render_us)
+{
+    gov->rendered++;
+    gov->samples[gov->sample_count % LOTTIE_GOV_SAMPLES] = render_us;
+    gov->sample_count++;
+
+    // 实际帧率：每秒更新一次
+    if (gov->rate_frames == 0) {
+        gov->rate_start_ms = now_ms;
+    }
+    gov->rate_frames++;
+    uint32_t elapsed_ms = now_ms - gov->rate_start_ms;
+    if (elapsed_ms >= 1000) {
+        gov->achieved_fps_x10 = (uint16_t)((gov->rate_frames - 1) * 10000u / elapsed_ms);
+        gov->rate_start_ms = now_ms;
+        gov->rate_frames = 1;
+    }
+
+    gov->window_frames++;
+    gov->window_us += render_us;
+    if (gov->window_frames < LOTTIE_GOV_WINDOW_FRAMES) {
+        return;
+    }
+
+    uint64_t avg_us = gov->window_us / gov->window_frames;
+    gov->window_frames = 0;
+    gov->window_us = 0;
+
+    if (gov_load_pct(avg_us, gov->fps) > LOTTIE_GOV_LOAD_HIGH_PCT && gov->fps > LOTTIE_GOV_MIN_FPS) {
+        uint32_t fps = gov->fps * 3 / 4;
+        gov->fps = (uint8_t)LV_MAX(LOTTIE_GOV_MIN_FPS, LV_MIN(fps, gov->fps - 1u));
+    } else if (gov->fps < gov->cap_fps) {
+        uint32_t fps = LV_MIN((uint32_t)gov->cap_fps, gov->fps + LV_MAX(1u, gov->fps / 4u));
+        if (gov_load_pct(avg_us, fps) < LOTTIE_GOV_LOAD_LOW_PCT) {
+            gov->fps = (uint8_t)fps;
+        }
+    }
+}
+
+void lottie_fps_governor_get_stats(const lottie_fps_governor_t *gov, lottie_fps_governor_stats_t *stats)
+{
+    uint32_t sorted[LOTTIE_GOV_SAMPLES];
+    uint32_t n = LV_MIN(gov->sample_count, (uint32_t)LOTTIE_GOV_SAMPLES);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->fps = gov->fps;
+    stats->cap_fps = gov->cap_fps;
+    stats->achieved_fps_x10 = gov->achieved_fps_x10;
+    stats->rendered = gov->rendered;
+    stats->skipped = gov->skipped;
+    if (n == 0) {
+        return;
+    }
+
+    // 插入排序（最多 64 个样本）
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = gov->samples[i];
+        uint32_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+
+    stats->render_us_p50 = sorted[(n - 1) * 50 / 100];
+    stats->render_us_p90 = sorted[(n - 1) * 90 / 100];
+    stats->render_us_p99 = sorted[(n - 1) * 99 / 100];
+}
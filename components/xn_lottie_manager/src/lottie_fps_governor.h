@@ -0,0 +1,81 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-04 16:30:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-04 16:30:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_fps_governor.h
+ * @Description: Lottie 自适应帧率调节（按渲染耗时选择有效帧率并确定性跳帧）
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOTTIE_GOV_SAMPLES  64      ///< 渲染耗时环形记录长度（用于百分位）
+
+/** 帧率调节器状态 */
+typedef struct {
+    uint8_t cap_fps;                ///< 帧率上限
+    uint8_t fps;                    ///< 当前有效帧率
+    int32_t last_slot;              ///< 最近一次渲染所在的时间片
+    uint32_t window_frames;         ///< 调节窗口内已渲染帧数
+    uint64_t window_us;             ///< 调节窗口内渲染耗时总和
+    uint32_t rate_start_ms;         ///< 实际帧率统计起点
+    uint32_t rate_frames;           ///< 统计起点以来渲染帧数
+    uint16_t achieved_fps_x10;      ///< 最近一秒的实际帧率 × 10
+    uint32_t rendered;              ///< 累计渲染帧数
+    uint32_t skipped;               ///< 累计跳过帧数
+    uint32_t samples[LOTTIE_GOV_SAMPLES];
+    uint32_t sample_count;
+} lottie_fps_governor_t;
+
+/** 帧率调节统计 */
+typedef struct {
+    uint8_t fps;                    ///< 当前有效帧率
+    uint8_t cap_fps;                ///< 帧率上限
+    uint16_t achieved_fps_x10;      ///< 实际帧率 × 10
+    uint32_t rendered;              ///< 累计渲染帧数
+    uint32_t skipped;               ///< 累计跳过帧数
+    uint32_t render_us_p50;         ///< 最近 LOTTIE_GOV_SAMPLES 帧渲染耗时中位数（微秒）
+    uint32_t render_us_p90;
+    uint32_t render_us_p99;
+} lottie_fps_governor_stats_t;
+
+/**
+ * @brief 初始化调节器
+ * @param gov 调节器
+ * @param cap_fps 帧率上限，0 表示使用 LOTTIE_GOV_DEFAULT_CAP_FPS
+ */
+void lottie_fps_governor_init(lottie_fps_governor_t *gov, uint8_t cap_fps);
+
+/**
+ * @brief 判断当前时刻是否渲染新帧
+ *
+ * 按有效帧率把时间划分为固定时间片，每个时间片只渲染一次，
+ * 其余动画回调直接跳过（保留上一帧画面），结果只取决于时间戳。
+ *
+ * @param now_ms 当前时间（毫秒）
+ * @return true 渲染，false 跳过
+ */
+bool lottie_fps_governor_should_render(lottie_fps_governor_t *gov, uint32_t now_ms);
+
+/**
+ * @brief 记录一帧的渲染耗时并按窗口调整有效帧率
+ * @param now_ms 当前时间（毫秒）
+ * @param render_us 渲染耗时（微秒）
+ */
+void lottie_fps_governor_record(lottie_fps_governor_t *gov, uint32_t now_ms, uint32_t render_us);
+
+/**
+ * @brief 获取统计（百分位在调用时计算）
+ */
+void lottie_fps_governor_get_stats(const lottie_fps_governor_t *gov, lottie_fps_governor_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,235 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-02 14:10:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-02 14:10:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_frame_cache.c
+ * @Description: Lottie 预渲染帧缓存实现
+ *
+ * 帧按 lottie_rle.h 的格式压缩保存，每帧数据为 [RGB565 流][A8 流]，不透明动画省略 A8 流。
+ */
+
+#include "lottie_frame_cache.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <string.h>
+
+// lv_anim_t 的成员定义在新版本 LVGL 中移入了私有头文件
+#if defined(__has_include)
+#if __has_include("misc/lv_anim_private.h")
+#include "misc/lv_anim_private.h"
+#endif
+#endif
+
+static const char *TAG = "LOTTIE_FRAMES";
+
+#define LOTTIE_FRAME_CACHE_MAX_FRAMES   1024    // 支持缓存的最大帧数
+
+/** 单帧压缩数据 */
+typedef struct {
+    uint8_t *data;          ///< [RGB565 流][A8 流]
+    uint32_t rgb_len;       ///< RGB565 流长度
+    uint32_t alpha_len;     ///< A8 流长度（不透明时为 0）
+} lottie_frame_t;
+
+struct lottie_frame_cache_s {
+    lv_obj_t *obj;                  ///< 所属 lv_lottie 对象
+    uint32_t *pixels;               ///< ThorVG 的 ARGB8888 渲染缓冲区
+    uint8_t *buffer;                ///< 对象的显示缓冲区
+    lottie_render_format_t format;  ///< 显示缓冲区格式
+    uint16_t width;
+    uint16_t height;
+    bool with_alpha;                ///< 是否保存 A8 平面
+    lv_anim_exec_xcb_t live_exec;   ///< lv_lottie 原始的实时渲染回调
+    int32_t first_frame;            ///< 动画起始帧号
+    uint32_t frame_count;           ///< 动画总帧数
+    lottie_frame_t *frames;         ///< 按帧号索引的压缩帧
+    uint32_t frames_cached;
+    size_t used_bytes;
+    size_t budget_bytes;
+    bool overflow;                  ///< 超出预算后不再缓存新帧
+    uint32_t live_frames;
+    uint32_t blit_frames;
+    uint64_t live_us_total;
+    uint64_t blit_us_total;
+};
+
+// 压缩保存渲染缓冲区中的当前帧
+static void lottie_frame_cache_store(lottie_frame_cache_t *fc, lottie_frame_t *frame)
+{
+    size_t count = (size_t)fc->width * fc->height;
+    size_t rgb_len = lottie_rle_encode_rgb565(NULL, fc->pixels, count);
+    size_t alpha_len = fc->with_alpha ? lottie_rle_encode_a8(NULL, fc->pixels, count) : 0;
+    size_t total = rgb_len + alpha_len;
+
+    if (fc->used_bytes + total > fc->budget_bytes) {
+        fc->overflow = true;
+        ESP_LOGW(TAG, "帧缓存超出预算 (%zu/%zu 字节)，剩余帧保持实时渲染",
+                 fc->used_bytes, fc->budget_bytes);
+        return;
+    }
+
+    uint8_t *data = heap_caps_malloc(total, MALLOC_CAP_SPIRAM);
+    if (!data) {
+        fc->overflow = true;
+        ESP_LOGW(TAG, "帧缓存分配失败 (需要 %zu 字节)，剩余帧保持实时渲染", total);
+        return;
+    }
+
+    lottie_rle_encode_rgb565(data, fc->pixels, count);
+    if (alpha_len) {
+        lottie_rle_encode_a8(data + rgb_len, fc->pixels, count);
+    }
+
+    frame->data = data;
+    frame->rgb_len = (uint32_t)rgb_len;
+    frame->alpha_len = (uint32_t)alpha_len;
+    fc->used_bytes += total;
+    fc->frames_cached++;
+}
+
+// 解压缓存帧到显示缓冲区
+static bool lottie_frame_cache_load(lottie_frame_cache_t *fc, const lottie_frame_t *frame)
+{
+    return lottie_rle_decode_frame(fc->format, fc->buffer, (size_t)fc->width * fc->height,
+                                   frame->data, frame->rgb_len, frame->alpha_len);
+}
+
+// 替换 lv_lottie 的动画回调：命中缓存时解压贴图，否则实时渲染并缓存
+static void lottie_frame_cache_exec_cb(void *var, int32_t v)
+{
+    lv_obj_t *obj = (lv_obj_t *)var;
+    lottie_frame_cache_t *fc = (lottie_frame_cache_t *)lv_obj_get_user_data(obj);
+    int32_t idx = v - fc->first_frame;
+
+    // 不可见时 lv_lottie 不会真正渲染，缓冲区内容不可缓存
+    if (idx < 0 || (uint32_t)idx >= fc->frame_count || !lv_obj_is_visible(obj)) {
+        fc->live_exec(var, v);
+        return;
+    }
+
+    lottie_frame_t *frame = &fc->frames[idx];
+    int64_t start_us = esp_timer_get_time();
+
+    if (frame->data && lottie_frame_cache_load(fc, frame)) {
+        lv_image_cache_drop(lv_image_get_src(obj));
+        lv_obj_invalidate(obj);
+        fc->blit_frames++;
+        fc->blit_us_total += (uint64_t)(esp_timer_get_time() - start_us);
+        return;
+    }
+
+    uint32_t rendered = lottie_render_target_rendered(obj);
+    fc->live_exec(var, v);
+    if (lottie_render_target_rendered(obj) == rendered) {
+        return;  // 帧率调节器跳过了本帧，缓冲区仍是旧帧
+    }
+    fc->live_frames++;
+    fc->live_us_total += (uint64_t)(esp_timer_get_time() - start_us);
+
+    if (!frame->data && !fc->overflow) {
+        lottie_frame_cache_store(fc, frame);
+    }
+}
+
+lottie_frame_cache_t *lottie_frame_cache_attach(lv_obj_t *obj, uint8_t *pixels, uint8_t *buffer,
+                                                lottie_render_format_t format,
+                                                uint16_t width, uint16_t height,
+                                                bool with_alpha, size_t budget_bytes)
+{
+    if (!obj || !pixels || !buffer || width == 0 || height == 0) {
+        return NULL;
+    }
+
+    lv_anim_t *anim = lv_lottie_get_anim(obj);
+    if (!anim || !anim->exec_cb || lv_obj_get_user_data(obj)) {
+        return NULL;
+    }
+
+    int32_t first = LV_MIN(anim->start_value, anim->end_value);
+    uint32_t frame_count = (uint32_t)LV_ABS(anim->end_value - anim->start_value) + 1;
+    if (frame_count > LOTTIE_FRAME_CACHE_MAX_FRAMES) {
+        ESP_LOGW(TAG, "动画帧数 %lu 过多，不启用帧缓存", (unsigned long)frame_count);
+        return NULL;
+    }
+
+    lottie_frame_cache_t *fc = heap_caps_calloc(1, sizeof(*fc), MALLOC_CAP_8BIT);
+    if (!fc) {
+        return NULL;
+    }
+
+    fc->frames = heap_caps_calloc(frame_count, sizeof(lottie_frame_t), MALLOC_CAP_SPIRAM);
+    if (!fc->frames) {
+        heap_caps_free(fc);
+        return NULL;
+    }
+
+    fc->obj = obj;
+    fc->pixels = (uint32_t *)pixels;
+    fc->buffer = buffer;
+    fc->format = format;
+    fc->width = width;
+    fc->height = height;
+    fc->with_alpha = with_alpha;
+    fc->first_frame = first;
+    fc->frame_count = frame_count;
+    fc->budget_bytes = budget_bytes;
+    fc->live_exec = anim->exec_cb;
+
+    anim->exec_cb = lottie_frame_cache_exec_cb;
+    lv_obj_set_user_data(obj, fc);
+
+    ESP_LOGI(TAG, "帧缓存已启用: %ux%u, %lu 帧, %s, 预算 %zu 字节",
+             width, height, (unsigned long)frame_count,
+             with_alpha ? "RGB565+A8" : "RGB565", budget_bytes);
+    return fc;
+}
+
+// 只有 lv_lottie 对象的 user_data 保存帧缓存句柄（帧包播放对象另作他用）
+static lottie_frame_cache_t *lottie_frame_cache_get(lv_obj_t *obj)
+{
+    if (!obj || !lv_obj_check_type(obj, &lv_lottie_class)) {
+        return NULL;
+    }
+    return (lottie_frame_cache_t *)lv_obj_get_user_data(obj);
+}
+
+void lottie_frame_cache_release(lv_obj_t *obj)
+{
+    lottie_frame_cache_t *fc = lottie_frame_cache_get(obj);
+    if (!fc) {
+        return;
+    }
+
+    lv_anim_t *anim = lv_lottie_get_anim(obj);
+    if (anim && anim->exec_cb == lottie_frame_cache_exec_cb) {
+        anim->exec_cb = fc->live_exec;
+    }
+    lv_obj_set_user_data(obj, NULL);
+
+    for (uint32_t i = 0; i < fc->frame_count; i++) {
+        heap_caps_free(fc->frames[i].data);
+    }
+    heap_caps_free(fc->frames);
+    heap_caps_free(fc);
+}
+
+bool lottie_frame_cache_get_stats(lv_obj_t *obj, lottie_frame_cache_stats_t *stats)
+{
+    lottie_frame_cache_t *fc = lottie_frame_cache_get(obj);
+    if (!fc || !stats) {
+        return false;
+    }
+
+    stats->frame_count = fc->frame_count;
+    stats->frames_cached = fc->frames_cached;
+    stats->used_bytes = fc->used_bytes;
+    stats->budget_bytes = fc->budget_bytes;
+    stats->overflow = fc->overflow;
+    stats->live_frames = fc->live_frames;
+    stats->blit_frames = fc->blit_frames;
+    stats->live_us_avg = fc->live_frames ? (uint32_t)(fc->live_us_total / fc->live_frames) : 0;
+    stats->blit_us_avg = fc->blit_frames ? (uint32_t)(fc->blit_us_total / fc->blit_frames) : 0;
+    return true;
+}
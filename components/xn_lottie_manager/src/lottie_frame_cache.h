@@ -0,0 +1,79 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-02 14:10:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-02 14:10:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_frame_cache.h
+ * @Description: Lottie 预渲染帧缓存（RGB565 + 可选 A8，RLE 压缩）
+ */
+
+#pragma once
+
+#include "lvgl.h"
+#include "lottie_render_target.h"
+#include "lottie_rle.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 帧缓存句柄 */
+typedef struct lottie_frame_cache_s lottie_frame_cache_t;
+
+/** 帧缓存统计 */
+typedef struct {
+    uint32_t frame_count;       ///< 动画总帧数
+    uint32_t frames_cached;     ///< 已缓存帧数
+    size_t used_bytes;          ///< 压缩帧占用（字节）
+    size_t budget_bytes;        ///< 预算（字节）
+    bool overflow;              ///< 已超出预算，剩余帧保持实时渲染
+    uint32_t live_frames;       ///< 实时渲染帧数
+    uint32_t blit_frames;       ///< 解压贴图帧数
+    uint32_t live_us_avg;       ///< 实时渲染平均耗时（微秒）
+    uint32_t blit_us_avg;       ///< 解压贴图平均耗时（微秒）
+} lottie_frame_cache_stats_t;
+
+/**
+ * @brief 为 lv_lottie 对象挂接预渲染帧缓存
+ *
+ * 接管动画的 exec 回调：首次播放到某一帧时仍由 ThorVG 实时渲染，
+ * 随后把该帧压缩保存；之后再播放到该帧时直接解压到显示缓冲区。
+ * 需在 lv_lock() 内、lv_lottie_set_src_data() 及 lottie_render_target_attach() 之后调用。
+ *
+ * @param obj lv_lottie 对象
+ * @param pixels ThorVG 的 ARGB8888 渲染缓冲区（压缩来源）
+ * @param buffer 对象的显示缓冲区（解压目标，ARGB8888 格式时与 pixels 相同）
+ * @param format 显示缓冲区格式
+ * @param width 宽度
+ * @param height 高度
+ * @param with_alpha 是否保存 A8 透明度平面（不透明内容可关闭）
+ * @param budget_bytes 压缩帧内存预算
+ * @return 帧缓存句柄，失败返回 NULL（对象保持实时渲染）
+ */
+lottie_frame_cache_t *lottie_frame_cache_attach(lv_obj_t *obj, uint8_t *pixels, uint8_t *buffer,
+                                                lottie_render_format_t format,
+                                                uint16_t width, uint16_t height,
+                                                bool with_alpha, size_t budget_bytes);
+
+/**
+ * @brief 释放对象上挂接的帧缓存（未挂接时无操作）
+ * @param obj lv_lottie 对象
+ * @note 需在 lv_lock() 内、删除对象之前调用
+ */
+void lottie_frame_cache_release(lv_obj_t *obj);
+
+/**
+ * @brief 获取对象上挂接的帧缓存统计
+ * @param obj lv_lottie 对象
+ * @param stats 输出统计
+ * @return true 已挂接帧缓存，false 未挂接
+ * @note 需在 lv_lock() 内调用
+ */
+bool lottie_frame_cache_get_stats(lv_obj_t *obj, lottie_frame_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,75 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_parse_cache.c
+ * @Description: Lottie 解析缓存的 LRU 记账实现
+ */
+
+#include "lottie_parse_cache.h"
+#include <string.h>
+
+void lottie_parse_cache_init(lottie_parse_cache_t *cache, lottie_cache_entry_t *entries, int count,
+                             size_t budget, lottie_cache_evict_cb_t evict_cb, void *evict_arg)
+{
+    memset(entries, 0, (size_t)count * sizeof(entries[0]));
+    memset(cache, 0, sizeof(*cache));
+    cache->entries = entries;
+    cache->count = count;
+    cache->budget = budget;
+    cache->evict_cb = evict_cb;
+    cache->evict_arg = evict_arg;
+}
+
+bool lottie_parse_cache_reserve(lottie_parse_cache_t *cache, size_t need, int active_slot)
+{
+    while (cache->used + need > cache->budget) {
+        int victim = -1;
+        for (int i = 0; i < cache->count; i++) {
+            const lottie_cache_entry_t *e = &cache->entries[i];
+            if (!e->obj || e->pinned || i == active_slot) {
+                continue;
+            }
+            if (victim < 0 || e->last_used < cache->entries[victim].last_used) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            return false;
+        }
+        lottie_parse_cache_evict(cache, victim);
+    }
+    return true;
+}
+
+void lottie_parse_cache_insert(lottie_parse_cache_t *cache, int slot, void *obj, uint8_t *buffer, size_t bytes)
+{
+    lottie_cache_entry_t *entry = &cache->entries[slot];
+    entry->obj = obj;
+    entry->buffer = buffer;
+    entry->bytes = bytes;
+    entry->last_used = ++cache->tick;
+    cache->used += bytes;
+}
+
+void lottie_parse_cache_touch(lottie_parse_cache_t *cache, int slot)
+{
+    cache->entries[slot].last_used = ++cache->tick;
+}
+
+void lottie_parse_cache_evict(lottie_parse_cache_t *cache, int slot)
+{
+    lottie_cache_entry_t *entry = &cache->entries[slot];
+    if (!entry->obj) {
+        return;
+    }
+    if (cache->evict_cb) {
+        cache->evict_cb(slot, entry, cache->evict_arg);
+    }
+    cache->used -= entry->bytes;
+    entry->obj = NULL;
+    entry->buffer = NULL;
+    entry->bytes = 0;
+    cache->evictions++;
+}
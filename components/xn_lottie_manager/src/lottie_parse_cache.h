@@ -0,0 +1,76 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_parse_cache.h
+ * @Description: Lottie 解析缓存的 LRU 记账（按 anim_configs 下标分槽，不依赖 LVGL）
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 缓存条目（按 anim_configs 下标索引） */
+typedef struct {
+    void *obj;              ///< 已解析的动画对象（未激活时隐藏），NULL 表示空槽
+    uint8_t *buffer;        ///< 渲染缓冲区
+    size_t bytes;           ///< 估算占用：渲染缓冲区 + 解析后的动画数据
+    uint32_t last_used;     ///< LRU 时间戳
+    bool pinned;            ///< 是否常驻
+} lottie_cache_entry_t;
+
+/**
+ * @brief 淘汰回调：销毁条目中的对象与缓冲区（记账由缓存完成）
+ */
+typedef void (*lottie_cache_evict_cb_t)(int slot, lottie_cache_entry_t *entry, void *arg);
+
+/** 解析缓存 */
+typedef struct {
+    lottie_cache_entry_t *entries;
+    int count;
+    size_t budget;                  ///< 预算（字节）
+    size_t used;                    ///< 已用字节
+    uint32_t tick;                  ///< LRU 计数
+    uint32_t evictions;             ///< 累计淘汰次数
+    lottie_cache_evict_cb_t evict_cb;
+    void *evict_arg;
+} lottie_parse_cache_t;
+
+/**
+ * @brief 初始化缓存（清空全部条目，常驻标记由调用方随后设置）
+ */
+void lottie_parse_cache_init(lottie_parse_cache_t *cache, lottie_cache_entry_t *entries, int count,
+                             size_t budget, lottie_cache_evict_cb_t evict_cb, void *evict_arg);
+
+/**
+ * @brief 按 LRU 淘汰非常驻、非当前的条目，直到能再容纳 need 字节
+ * @param active_slot 当前显示中的槽（不淘汰），-1 表示无
+ * @return 能容纳返回 true；可淘汰的条目用尽仍放不下返回 false
+ */
+bool lottie_parse_cache_reserve(lottie_parse_cache_t *cache, size_t need, int active_slot);
+
+/**
+ * @brief 把已解析的对象放入槽并计入占用
+ */
+void lottie_parse_cache_insert(lottie_parse_cache_t *cache, int slot, void *obj, uint8_t *buffer, size_t bytes);
+
+/**
+ * @brief 标记槽最近使用
+ */
+void lottie_parse_cache_touch(lottie_parse_cache_t *cache, int slot);
+
+/**
+ * @brief 淘汰指定槽（调用淘汰回调并清空条目）
+ */
+void lottie_parse_cache_evict(lottie_parse_cache_t *cache, int slot);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,51 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_render_format.c
+ * @Description: Lottie 显示缓冲区格式与 ARGB8888 转换
+ */
+
+#include "lottie_render_format.h"
+#include "xn_lottie_manager.h"
+#include "xn_lvgl_pixel.h"
+#include <string.h>
+
+size_t lottie_render_format_bytes(lottie_render_format_t format, uint16_t width, uint16_t height)
+{
+    size_t count = (size_t)width * height;
+
+    switch (format) {
+    case LOTTIE_RENDER_RGB565A8:
+        return count * 3;
+    case LOTTIE_RENDER_RGB565:
+        return count * 2;
+    default:
+        return count * 4;
+    }
+}
+
+void lottie_render_convert(lottie_render_format_t format, uint8_t *dst, const uint32_t *src,
+                           uint16_t width, uint16_t height)
+{
+    size_t count = (size_t)width * height;
+
+    if (format == LOTTIE_RENDER_ARGB8888) {
+        memcpy(dst, src, count * 4);
+        return;
+    }
+
+#if LOTTIE_RENDER_DITHER
+    lvgl_pixel_argb8888_to_rgb565_dither((uint16_t *)dst, src, width, height);
+#else
+    lvgl_pixel_argb8888_to_rgb565((uint16_t *)dst, src, (uint32_t)count);
+#endif
+
+    if (format == LOTTIE_RENDER_RGB565A8) {
+        uint8_t *alpha = dst + count * 2;
+        for (size_t i = 0; i < count; i++) {
+            alpha[i] = (uint8_t)(src[i] >> 24);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_render_format.h
+ * @Description: Lottie 显示缓冲区格式与 ARGB8888 转换（不依赖 LVGL，帧缓存编解码与主机测试共用）
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 动画对象显示缓冲区格式 */
+typedef enum {
+    LOTTIE_RENDER_ARGB8888 = 0,     ///< ThorVG 直接渲染到对象缓冲区（4 字节/像素）
+    LOTTIE_RENDER_RGB565A8,         ///< RGB565 平面 + A8 平面（3 字节/像素）
+    LOTTIE_RENDER_RGB565,           ///< 不透明内容（2 字节/像素）
+} lottie_render_format_t;
+
+/**
+ * @brief 显示缓冲区字节数
+ */
+size_t lottie_render_format_bytes(lottie_render_format_t format, uint16_t width, uint16_t height);
+
+/**
+ * @brief 将 ARGB8888 像素转换为显示缓冲区格式
+ * @param format 目标格式
+ * @param dst 显示缓冲区
+ * @param src ARGB8888 像素
+ * @param width 宽度
+ * @param height 高度
+ * @note LOTTIE_RENDER_DITHER 为 1 时 RGB565 平面使用 4x4 有序抖动
+ */
+void lottie_render_convert(lottie_render_format_t format, uint8_t *dst, const uint32_t *src,
+                           uint16_t width, uint16_t height);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,211 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-03 15:40:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03 15:40:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_render_target.c
+ * @Description: Lottie 渲染目标实现
+ *
+ * ThorVG 只能输出 ARGB8888。紧凑格式的动画共用一块 ARGB8888 暂存区渲染，
+ * 每帧渲染后转换到对象自己的 RGB565(+A8) 显示缓冲区，LVGL 合成时只需处理 2~3 字节/像素。
+ * 每次渲染前由帧率调节器决定是否跳过本帧，渲染耗时（含格式转换）反馈给调节器。
+ */
+
+#include "lottie_render_target.h"
+#include "xn_lottie_manager.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <string.h>
+
+// lv_anim_t 的成员定义在新版本 LVGL 中移入了私有头文件
+#if defined(__has_include)
+#if __has_include("misc/lv_anim_private.h")
+#include "misc/lv_anim_private.h"
+#endif
+#endif
+
+static const char *TAG = "LOTTIE_TARGET";
+
+/** 渲染目标（保存在动画的 user_data 中，对象的 user_data 留给帧缓存） */
+typedef struct {
+    lv_obj_t *obj;
+    lottie_render_format_t format;
+    lv_draw_buf_t draw_buf;         ///< 显示缓冲区描述（对象的图像源）
+    uint8_t *buffer;
+    uint16_t width;
+    uint16_t height;
+    lv_anim_exec_xcb_t live_exec;   ///< lv_lottie 原始的实时渲染回调
+    uint32_t converted_frames;
+    uint64_t convert_us_total;
+    lottie_fps_governor_t gov;      ///< 帧率调节器
+} lottie_render_target_t;
+
+static uint8_t *s_scratch = NULL;   // 共享 ARGB8888 暂存区，分配后常驻
+
+lv_color_format_t lottie_render_format_cf(lottie_render_format_t format)
+{
+    switch (format) {
+    case LOTTIE_RENDER_RGB565A8:
+        return LV_COLOR_FORMAT_RGB565A8;
+    case LOTTIE_RENDER_RGB565:
+        return LV_COLOR_FORMAT_RGB565;
+    default:
+        return LV_COLOR_FORMAT_ARGB8888;
+    }
+}
+
+uint8_t *lottie_render_scratch_get(size_t bytes)
+{
+    if (bytes > LOTTIE_RENDER_SCRATCH_BYTES) {
+        return NULL;
+    }
+
+    if (!s_scratch) {
+        s_scratch = heap_caps_malloc(LOTTIE_RENDER_SCRATCH_BYTES, MALLOC_CAP_SPIRAM);
+        if (!s_scratch) {
+            ESP_LOGE(TAG, "渲染暂存区分配失败 (需要 %u 字节)", (unsigned)LOTTIE_RENDER_SCRATCH_BYTES);
+            return NULL;
+        }
+        ESP_LOGI(TAG, "共享渲染暂存区: %u 字节", (unsigned)LOTTIE_RENDER_SCRATCH_BYTES);
+    }
+    return s_scratch;
+}
+
+size_t lottie_render_scratch_bytes(void)
+{
+    return s_scratch ? LOTTIE_RENDER_SCRATCH_BYTES : 0;
+}
+
+static lottie_render_target_t *lottie_render_target_get(lv_obj_t *obj)
+{
+    if (!obj || !lv_obj_check_type(obj, &lv_lottie_class)) {
+        return NULL;
+    }
+    lv_anim_t *anim = lv_lottie_get_anim(obj);
+    lottie_render_target_t *rt = anim ? (lottie_render_target_t *)anim->user_data : NULL;
+    return (rt && rt->obj == obj) ? rt : NULL;
+}
+
+// 替换 lv_lottie 的动画回调：按调节器的节奏实时渲染，紧凑格式再转换到显示缓冲区
+static void lottie_render_target_exec_cb(void *var, int32_t v)
+{
+    lv_obj_t *obj = (lv_obj_t *)var;
+    lottie_render_target_t *rt = lottie_render_target_get(obj);
+
+    // 不可见时 lv_lottie 不会渲染，暂存区内容属于其他动画
+    if (!lv_obj_is_visible(obj)) {
+        rt->live_exec(var, v);
+        return;
+    }
+
+    uint32_t now_ms = lv_tick_get();
+    if (!lottie_fps_governor_should_render(&rt->gov, now_ms)) {
+        return;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    rt->live_exec(var, v);
+
+    if (rt->format != LOTTIE_RENDER_ARGB8888) {
+        int64_t convert_us = esp_timer_get_time();
+        lottie_render_convert(rt->format, rt->buffer, (const uint32_t *)s_scratch, rt->width, rt->height);
+        lv_image_cache_drop(&rt->draw_buf);
+        lv_obj_invalidate(obj);
+        rt->converted_frames++;
+        rt->convert_us_total += (uint64_t)(esp_timer_get_time() - convert_us);
+    }
+
+    lottie_fps_governor_record(&rt->gov, now_ms, (uint32_t)(esp_timer_get_time() - start_us));
+}
+
+bool lottie_render_target_attach(lv_obj_t *obj, lottie_render_format_t format, uint8_t *buffer,
+                                 uint16_t width, uint16_t height, uint8_t cap_fps)
+{
+    bool compact = format != LOTTIE_RENDER_ARGB8888;
+    if (!obj || !buffer || (compact && !s_scratch)) {
+        return false;
+    }
+
+    lv_anim_t *anim = lv_lottie_get_anim(obj);
+    if (!anim || !anim->exec_cb || anim->user_data) {
+        return false;
+    }
+
+    lottie_render_target_t *rt = heap_caps_calloc(1, sizeof(*rt), MALLOC_CAP_8BIT);
+    if (!rt) {
+        return false;
+    }
+
+    size_t bytes = lottie_render_format_bytes(format, width, height);
+    if (compact) {
+        if (lv_draw_buf_init(&rt->draw_buf, width, height, lottie_render_format_cf(format),
+                             width * 2, buffer, bytes) != LV_RESULT_OK) {
+            heap_caps_free(rt);
+            return false;
+        }
+
+        // 首帧转换前保持透明（RGB565 为黑色）
+        memset(buffer, 0, bytes);
+    }
+
+    rt->obj = obj;
+    rt->format = format;
+    rt->buffer = buffer;
+    rt->width = width;
+    rt->height = height;
+    rt->live_exec = anim->exec_cb;
+    lottie_fps_governor_init(&rt->gov, cap_fps);
+
+    anim->exec_cb = lottie_render_target_exec_cb;
+    anim->user_data = rt;
+    if (compact) {
+        lv_image_set_src(obj, &rt->draw_buf);
+    }
+
+    ESP_LOGI(TAG, "渲染目标: %ux%u %s, 显示缓冲区 %zu 字节（ARGB8888 需 %zu 字节），帧率上限 %u",
+             width, height,
+             format == LOTTIE_RENDER_RGB565 ? "RGB565" : (compact ? "RGB565+A8" : "ARGB8888"),
+             bytes, lottie_render_format_bytes(LOTTIE_RENDER_ARGB8888, width, height), rt->gov.cap_fps);
+    return true;
+}
+
+void lottie_render_target_release(lv_obj_t *obj)
+{
+    lottie_render_target_t *rt = lottie_render_target_get(obj);
+    if (!rt) {
+        return;
+    }
+
+    lv_anim_t *anim = lv_lottie_get_anim(obj);
+    if (anim->exec_cb == lottie_render_target_exec_cb) {
+        anim->exec_cb = rt->live_exec;
+    }
+    anim->user_data = NULL;
+    if (rt->format != LOTTIE_RENDER_ARGB8888) {
+        lv_image_cache_drop(&rt->draw_buf);
+        lv_image_set_src(obj, lv_canvas_get_draw_buf(obj));
+    }
+    heap_caps_free(rt);
+}
+
+bool lottie_render_target_get_stats(lv_obj_t *obj, lottie_render_target_stats_t *stats)
+{
+    lottie_render_target_t *rt = lottie_render_target_get(obj);
+    if (!rt || !stats) {
+        return false;
+    }
+
+    stats->format = rt->format;
+    stats->converted_frames = rt->converted_frames;
+    stats->convert_us_avg = rt->converted_frames ?
+                            (uint32_t)(rt->convert_us_total / rt->converted_frames) : 0;
+    lottie_fps_governor_get_stats(&rt->gov, &stats->gov);
+    return true;
+}
+
+uint32_t lottie_render_target_rendered(lv_obj_t *obj)
+{
+    lottie_render_target_t *rt = lottie_render_target_get(obj);
+    return rt ? rt->gov.rendered : 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-03 15:40:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03 15:40:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_render_target.h
+ * @Description: Lottie 渲染目标（ARGB8888 / RGB565 / RGB565+A8）与渲染帧率调节
+ */
+
+#pragma once
+
+#include "lvgl.h"
+#include "lottie_render_format.h"
+#include "lottie_fps_governor.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 渲染目标统计 */
+typedef struct {
+    lottie_render_format_t format;  ///< 显示缓冲区格式
+    uint32_t converted_frames;      ///< 已转换帧数
+    uint32_t convert_us_avg;        ///< 单帧格式转换平均耗时（微秒）
+    lottie_fps_governor_stats_t gov;///< 帧率调节与渲染耗时统计
+} lottie_render_target_stats_t;
+
+/**
+ * @brief 对应的 LVGL 颜色格式
+ */
+lv_color_format_t lottie_render_format_cf(lottie_render_format_t format);
+
+/**
+ * @brief 获取共享的 ARGB8888 渲染暂存区
+ *
+ * ThorVG 只能输出 32 位颜色，紧凑格式的动画都渲染到这块暂存区，
+ * 再转换到各自的显示缓冲区。只有可见动画会渲染，因此所有对象可共用一块。
+ *
+ * @param bytes 所需字节数（width * height * 4）
+ * @return 暂存区指针，超出 LOTTIE_RENDER_SCRATCH_BYTES 或分配失败返回 NULL
+ */
+uint8_t *lottie_render_scratch_get(size_t bytes);
+
+/**
+ * @brief 共享暂存区当前占用字节数（未分配时为 0）
+ */
+size_t lottie_render_scratch_bytes(void);
+
+/**
+ * @brief 为 lv_lottie 对象挂接渲染目标
+ *
+ * 接管动画的 exec 回调：由帧率调节器决定是否渲染本帧，并测量渲染耗时。
+ * 紧凑格式时对象需已用 lv_lottie_set_buffer() 指向共享暂存区，ThorVG 渲染到暂存区后
+ * 立即转换为 RGB565 / RGB565+A8 写入 buffer，对象显示的图像源随之改为 buffer；
+ * ARGB8888 时 ThorVG 直接渲染到 buffer。需在 lv_lock() 内、lv_lottie_set_src_data() 之后调用。
+ *
+ * @param obj lv_lottie 对象
+ * @param format 显示缓冲区格式
+ * @param buffer lottie_render_format_bytes() 字节的显示缓冲区
+ * @param width 宽度
+ * @param height 高度
+ * @param cap_fps 渲染帧率上限，0 表示 LOTTIE_GOV_DEFAULT_CAP_FPS
+ * @return true 成功，false 失败（对象保持原样）
+ */
+bool lottie_render_target_attach(lv_obj_t *obj, lottie_render_format_t format, uint8_t *buffer,
+                                 uint16_t width, uint16_t height, uint8_t cap_fps);
+
+/**
+ * @brief 对象累计实际渲染的帧数（帧率调节器跳过的帧不计入）
+ * @return 帧数，未挂接时返回 0
+ */
+uint32_t lottie_render_target_rendered(lv_obj_t *obj);
+
+/**
+ * @brief 释放对象上挂接的渲染目标（未挂接时无操作）
+ * @note 需在 lv_lock() 内、lottie_frame_cache_release() 之后、删除对象之前调用
+ */
+void lottie_render_target_release(lv_obj_t *obj);
+
+/**
+ * @brief 获取渲染目标统计
+ * @return true 已挂接，false 未挂接（对象不是 lv_lottie）
+ * @note 需在 lv_lock() 内调用
+ */
+bool lottie_render_target_get_stats(lv_obj_t *obj, lottie_render_target_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
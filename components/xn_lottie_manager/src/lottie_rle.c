@@ -0,0 +1,212 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_rle.c
+ * @Description: 帧缓存与帧包共用的 RLE 编解码
+ *
+ * 压缩格式（RLE，按元素编码，RGB565 元素 2 字节小端，A8 元素 1 字节）：
+ *   头字节 h 的最高位为 1：后跟 1 个元素，重复 (h & 0x7F) + 1 次
+ *   头字节 h 的最高位为 0：后跟 h + 1 个原样元素
+ * 每帧数据为 [RGB565 流][A8 流]，不透明动画省略 A8 流。
+ * 不依赖 LVGL，主机测试直接编译本文件。
+ */
+
+#include "lottie_rle.h"
+#include <string.h>
+
+#define RLE_MAX_PACKET  128     // 单个数据包最多元素数
+
+static inline uint16_t argb_to_rgb565(uint32_t p)
+{
+    return (uint16_t)(((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F));
+}
+
+static inline uint32_t rgb565_to_argb(uint16_t v)
+{
+    uint32_t r = (v >> 11) & 0x1F;
+    uint32_t g = (v >> 5) & 0x3F;
+    uint32_t b = v & 0x1F;
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+    return 0xFF000000u | (r << 16) | (g << 8) | b;
+}
+
+static inline uint32_t rle_elem(const uint32_t *src, size_t i, bool alpha)
+{
+    return alpha ? (src[i] >> 24) : argb_to_rgb565(src[i]);
+}
+
+static inline size_t rle_put(uint8_t *dst, size_t pos, uint32_t v, bool alpha)
+{
+    if (dst) {
+        dst[pos] = (uint8_t)v;
+        if (!alpha) {
+            dst[pos + 1] = (uint8_t)(v >> 8);
+        }
+    }
+    return pos + (alpha ? 1 : 2);
+}
+
+static inline size_t rle_encode(uint8_t *dst, const uint32_t *src, size_t count, bool alpha)
+{
+    size_t pos = 0;
+    size_t i = 0;
+
+    while (i < count) {
+        uint32_t v = rle_elem(src, i, alpha);
+        size_t run = 1;
+        while (i + run < count && run < RLE_MAX_PACKET && rle_elem(src, i + run, alpha) == v) {
+            run++;
+        }
+
+        if (run >= 2) {
+            if (dst) {
+                dst[pos] = (uint8_t)(0x80 | (run - 1));
+            }
+            pos = rle_put(dst, pos + 1, v, alpha);
+            i += run;
+            continue;
+        }
+
+        // 原样数据包：直到出现连续重复元素为止
+        size_t header = pos++;
+        size_t len = 0;
+        while (i < count && len < RLE_MAX_PACKET) {
+            uint32_t cur = rle_elem(src, i, alpha);
+            if (len > 0 && i + 1 < count && rle_elem(src, i + 1, alpha) == cur) {
+                break;
+            }
+            pos = rle_put(dst, pos, cur, alpha);
+            i++;
+            len++;
+        }
+        if (dst) {
+            dst[header] = (uint8_t)(len - 1);
+        }
+    }
+
+    return pos;
+}
+
+static inline bool rle_decode(uint32_t *dst, size_t count, const uint8_t *src, size_t len, bool alpha)
+{
+    size_t esize = alpha ? 1 : 2;
+    size_t pos = 0;
+    size_t i = 0;
+
+    while (i < count) {
+        if (pos >= len) {
+            return false;
+        }
+        uint8_t h = src[pos++];
+        size_t n = (size_t)(h & 0x7F) + 1;
+        bool repeat = (h & 0x80) != 0;
+        if (i + n > count || pos + (repeat ? esize : n * esize) > len) {
+            return false;
+        }
+
+        if (alpha) {
+            for (size_t k = 0; k < n; k++) {
+                uint32_t a = repeat ? src[pos] : src[pos + k];
+                dst[i + k] = (dst[i + k] & 0x00FFFFFFu) | (a << 24);
+            }
+        } else if (repeat) {
+            uint32_t px = rgb565_to_argb((uint16_t)(src[pos] | (src[pos + 1] << 8)));
+            for (size_t k = 0; k < n; k++) {
+                dst[i + k] = px;
+            }
+        } else {
+            const uint8_t *p = src + pos;
+            for (size_t k = 0; k < n; k++, p += 2) {
+                dst[i + k] = rgb565_to_argb((uint16_t)(p[0] | (p[1] << 8)));
+            }
+        }
+
+        pos += repeat ? esize : n * esize;
+        i += n;
+    }
+
+    return pos == len;
+}
+
+size_t lottie_rle_encode_rgb565(uint8_t *dst, const uint32_t *src, size_t count)
+{
+    return rle_encode(dst, src, count, false);
+}
+
+size_t lottie_rle_encode_a8(uint8_t *dst, const uint32_t *src, size_t count)
+{
+    return rle_encode(dst, src, count, true);
+}
+
+bool lottie_rle_decode_rgb565(uint32_t *dst, size_t count, const uint8_t *src, size_t len)
+{
+    return rle_decode(dst, count, src, len, false);
+}
+
+bool lottie_rle_decode_a8(uint32_t *dst, size_t count, const uint8_t *src, size_t len)
+{
+    return rle_decode(dst, count, src, len, true);
+}
+
+// 解压到原生格式平面：元素按存储字节原样写入（RGB565 小端与 ESP32 内存序一致）
+static bool rle_decode_plane(uint8_t *dst, size_t count, const uint8_t *src, size_t len, size_t esize)
+{
+    size_t pos = 0;
+    size_t i = 0;
+
+    while (i < count) {
+        if (pos >= len) {
+            return false;
+        }
+        uint8_t h = src[pos++];
+        size_t n = (size_t)(h & 0x7F) + 1;
+        bool repeat = (h & 0x80) != 0;
+        if (i + n > count || pos + (repeat ? esize : n * esize) > len) {
+            return false;
+        }
+
+        uint8_t *out = dst + i * esize;
+        if (!repeat) {
+            memcpy(out, src + pos, n * esize);
+        } else if (esize == 1) {
+            memset(out, src[pos], n);
+        } else {
+            for (size_t k = 0; k < n; k++, out += 2) {
+                out[0] = src[pos];
+                out[1] = src[pos + 1];
+            }
+        }
+
+        pos += repeat ? esize : n * esize;
+        i += n;
+    }
+
+    return pos == len;
+}
+
+bool lottie_rle_decode_frame(lottie_render_format_t format, uint8_t *dst, size_t count,
+                             const uint8_t *data, size_t rgb_len, size_t alpha_len)
+{
+    switch (format) {
+    case LOTTIE_RENDER_RGB565:
+        return rle_decode_plane(dst, count, data, rgb_len, 2);
+    case LOTTIE_RENDER_RGB565A8:
+        if (!rle_decode_plane(dst, count, data, rgb_len, 2)) {
+            return false;
+        }
+        if (!alpha_len) {
+            memset(dst + count * 2, 0xFF, count);
+            return true;
+        }
+        return rle_decode_plane(dst + count * 2, count, data + rgb_len, alpha_len, 1);
+    default:
+        if (!lottie_rle_decode_rgb565((uint32_t *)dst, count, data, rgb_len)) {
+            return false;
+        }
+        return !alpha_len || lottie_rle_decode_a8((uint32_t *)dst, count, data + rgb_len, alpha_len);
+    }
+}
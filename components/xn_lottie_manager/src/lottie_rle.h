@@ -0,0 +1,66 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_rle.h
+ * @Description: 帧缓存与帧包共用的 RLE 编解码（RGB565 + 可选 A8）
+ */
+
+#pragma once
+
+#include "lottie_render_format.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 将 ARGB8888 图像的 RGB 部分按 RGB565 做 RLE 压缩
+ * @param dst 输出缓冲区，为 NULL 时只计算压缩后长度
+ * @param src ARGB8888 像素
+ * @param count 像素数
+ * @return 压缩后字节数
+ */
+size_t lottie_rle_encode_rgb565(uint8_t *dst, const uint32_t *src, size_t count);
+
+/**
+ * @brief 将 ARGB8888 图像的 A 通道做 RLE 压缩
+ * @param dst 输出缓冲区，为 NULL 时只计算压缩后长度
+ * @param src ARGB8888 像素
+ * @param count 像素数
+ * @return 压缩后字节数
+ */
+size_t lottie_rle_encode_a8(uint8_t *dst, const uint32_t *src, size_t count);
+
+/**
+ * @brief 解压 RGB565 数据流到 ARGB8888 缓冲区（A 通道置为 0xFF）
+ * @return true 成功，false 数据损坏
+ */
+bool lottie_rle_decode_rgb565(uint32_t *dst, size_t count, const uint8_t *src, size_t len);
+
+/**
+ * @brief 解压 A8 数据流并写入 ARGB8888 缓冲区的 A 通道
+ * @return true 成功，false 数据损坏
+ */
+bool lottie_rle_decode_a8(uint32_t *dst, size_t count, const uint8_t *src, size_t len);
+
+/**
+ * @brief 解压一帧 [RGB565 流][A8 流] 到指定格式的显示缓冲区
+ * @param format 显示缓冲区格式（RGB565 忽略 A8 流，缺少 A8 流时视为不透明）
+ * @param dst 显示缓冲区
+ * @param count 像素数
+ * @param data 帧数据
+ * @param rgb_len RGB565 流长度
+ * @param alpha_len A8 流长度，可为 0
+ * @return true 成功，false 数据损坏
+ */
+bool lottie_rle_decode_frame(lottie_render_format_t format, uint8_t *dst, size_t count,
+                             const uint8_t *data, size_t rgb_len, size_t alpha_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,279 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-03 09:20:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03 09:20:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_sprite_player.c
+ * @Description: 预编译帧包（sprite）播放器实现
+ */
+
+#include "lottie_sprite_player.h"
+#include "lottie_rle.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <string.h>
+#include <stdio.h>
+
+static const char *TAG = "LOTTIE_SPRITE";
+
+struct lottie_sprite_pack_s {
+    uint8_t *data;                          ///< 整个帧包文件（PSRAM）
+    size_t size;
+    const lottie_sprite_header_t *header;
+    const lottie_sprite_index_t *index;
+    const uint8_t *frames;                  ///< 帧数据起始位置
+};
+
+/** 播放器上下文（保存在对象 user_data 中） */
+typedef struct {
+    lv_obj_t *obj;
+    lottie_sprite_pack_t *pack;
+    uint8_t *buffer;            ///< 对象的显示缓冲区
+    lottie_render_format_t format;
+    lv_timer_t *timer;
+    uint32_t start_tick;        ///< 第一帧对应的 lv_tick
+    int32_t shown_frame;        ///< 缓冲区中当前帧号，-1 表示无效
+    uint32_t decoded_frames;
+    uint64_t decode_us_total;
+} lottie_sprite_ctx_t;
+
+bool lottie_sprite_make_path(char *out, size_t out_size, const char *json_path,
+                             uint16_t width, uint16_t height)
+{
+    const char *ext = strrchr(json_path, '.');
+    if (!ext || strcmp(ext, ".json") != 0) {
+        return false;
+    }
+
+    int n = snprintf(out, out_size, "%.*s_%ux%u.spr", (int)(ext - json_path), json_path, width, height);
+    return n > 0 && (size_t)n < out_size;
+}
+
+// 校验文件头与帧索引，防止损坏的帧包越界访问
+static bool lottie_sprite_pack_validate(lottie_sprite_pack_t *pack, uint16_t width, uint16_t height)
+{
+    if (pack->size < sizeof(lottie_sprite_header_t)) {
+        return false;
+    }
+
+    const lottie_sprite_header_t *hdr = (const lottie_sprite_header_t *)pack->data;
+    if (hdr->magic != LOTTIE_SPRITE_MAGIC || hdr->version != LOTTIE_SPRITE_VERSION ||
+        hdr->width != width || hdr->height != height || hdr->frame_count == 0 || hdr->fps_x100 == 0) {
+        return false;
+    }
+
+    size_t index_end = sizeof(*hdr) + (size_t)hdr->frame_count * sizeof(lottie_sprite_index_t);
+    if (pack->size < index_end) {
+        return false;
+    }
+
+    const lottie_sprite_index_t *index = (const lottie_sprite_index_t *)(pack->data + sizeof(*hdr));
+    size_t data_size = pack->size - index_end;
+    bool with_alpha = (hdr->flags & LOTTIE_SPRITE_FLAG_ALPHA) != 0;
+    for (uint32_t i = 0; i < hdr->frame_count; i++) {
+        size_t len = (size_t)index[i].rgb_len + index[i].alpha_len;
+        if (index[i].rgb_len == 0 || (with_alpha && index[i].alpha_len == 0) ||
+            index[i].offset > data_size || len > data_size - index[i].offset) {
+            return false;
+        }
+    }
+
+    pack->header = hdr;
+    pack->index = index;
+    pack->frames = pack->data + index_end;
+    return true;
+}
+
+lottie_sprite_pack_t *lottie_sprite_pack_open(const char *path, uint16_t width, uint16_t height)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size_t file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    lottie_sprite_pack_t *pack = heap_caps_calloc(1, sizeof(*pack), MALLOC_CAP_8BIT);
+    uint8_t *data = heap_caps_malloc(file_size, MALLOC_CAP_SPIRAM);
+    if (!pack || !data) {
+        ESP_LOGE(TAG, "帧包缓冲区分配失败 (需要 %zu 字节)", file_size);
+        heap_caps_free(pack);
+        heap_caps_free(data);
+        fclose(fp);
+        return NULL;
+    }
+
+    size_t read_size = fread(data, 1, file_size, fp);
+    fclose(fp);
+
+    pack->data = data;
+    pack->size = file_size;
+    if (read_size != file_size || !lottie_sprite_pack_validate(pack, width, height)) {
+        ESP_LOGE(TAG, "帧包无效: %s", path);
+        lottie_sprite_pack_close(pack);
+        return NULL;
+    }
+
+    ESP_LOGI(TAG, "帧包: %s, %ux%u, %u 帧 @ %u.%02u fps, %zu 字节",
+             path, width, height, pack->header->frame_count,
+             pack->header->fps_x100 / 100, pack->header->fps_x100 % 100, file_size);
+    return pack;
+}
+
+void lottie_sprite_pack_close(lottie_sprite_pack_t *pack)
+{
+    if (pack) {
+        heap_caps_free(pack->data);
+        heap_caps_free(pack);
+    }
+}
+
+size_t lottie_sprite_pack_size(const lottie_sprite_pack_t *pack)
+{
+    return pack ? pack->size : 0;
+}
+
+static lottie_sprite_ctx_t *lottie_sprite_get_ctx(lv_obj_t *obj)
+{
+    if (!obj || !lv_obj_check_type(obj, &lv_canvas_class)) {
+        return NULL;
+    }
+    lottie_sprite_ctx_t *ctx = (lottie_sprite_ctx_t *)lv_obj_get_user_data(obj);
+    return (ctx && ctx->obj == obj) ? ctx : NULL;
+}
+
+// 解压指定帧到显示缓冲区
+static bool lottie_sprite_decode(lottie_sprite_ctx_t *ctx, uint32_t frame)
+{
+    const lottie_sprite_pack_t *pack = ctx->pack;
+    const lottie_sprite_index_t *idx = &pack->index[frame];
+
+    return lottie_rle_decode_frame(ctx->format, ctx->buffer,
+                                   (size_t)pack->header->width * pack->header->height,
+                                   pack->frames + idx->offset, idx->rgb_len, idx->alpha_len);
+}
+
+// 按经过时间推进帧号，只在帧号变化且对象可见时解压
+static void lottie_sprite_timer_cb(lv_timer_t *timer)
+{
+    lottie_sprite_ctx_t *ctx = (lottie_sprite_ctx_t *)lv_timer_get_user_data(timer);
+    const lottie_sprite_header_t *hdr = ctx->pack->header;
+
+    if (!lv_obj_is_visible(ctx->obj)) {
+        return;
+    }
+
+    uint64_t elapsed_ms = lv_tick_elaps(ctx->start_tick);
+    int32_t frame = (int32_t)((elapsed_ms * hdr->fps_x100 / 100000) % hdr->frame_count);
+    if (frame == ctx->shown_frame) {
+        return;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    if (!lottie_sprite_decode(ctx, (uint32_t)frame)) {
+        ESP_LOGE(TAG, "第 %ld 帧解压失败", (long)frame);
+        ctx->shown_frame = -1;
+        return;
+    }
+
+    ctx->shown_frame = frame;
+    lv_image_cache_drop(lv_image_get_src(ctx->obj));
+    lv_obj_invalidate(ctx->obj);
+    ctx->decoded_frames++;
+    ctx->decode_us_total += (uint64_t)(esp_timer_get_time() - start_us);
+}
+
+lv_obj_t *lottie_sprite_create(lv_obj_t *parent, lottie_sprite_pack_t *pack, uint8_t *buffer,
+                               lottie_render_format_t format)
+{
+    if (!pack || !buffer) {
+        return NULL;
+    }
+
+    lottie_sprite_ctx_t *ctx = heap_caps_calloc(1, sizeof(*ctx), MALLOC_CAP_8BIT);
+    if (!ctx) {
+        return NULL;
+    }
+
+    lv_obj_t *obj = lv_canvas_create(parent);
+    if (!obj) {
+        heap_caps_free(ctx);
+        return NULL;
+    }
+
+    const lottie_sprite_header_t *hdr = pack->header;
+    uint32_t period_ms = LV_MAX(1, 100000u / hdr->fps_x100);
+    ctx->timer = lv_timer_create(lottie_sprite_timer_cb, period_ms, ctx);
+    if (!ctx->timer) {
+        lv_obj_del(obj);
+        heap_caps_free(ctx);
+        return NULL;
+    }
+
+    ctx->obj = obj;
+    ctx->pack = pack;
+    ctx->buffer = buffer;
+    ctx->format = format;
+    ctx->start_tick = lv_tick_get();
+    ctx->shown_frame = -1;
+
+    lv_canvas_set_buffer(obj, buffer, hdr->width, hdr->height, lottie_render_format_cf(format));
+    lv_obj_set_user_data(obj, ctx);
+
+    // 先解压第一帧，保证首次显示时缓冲区已有内容
+    if (lottie_sprite_decode(ctx, 0)) {
+        ctx->shown_frame = 0;
+    }
+    return obj;
+}
+
+bool lottie_sprite_is(lv_obj_t *obj)
+{
+    return lottie_sprite_get_ctx(obj) != NULL;
+}
+
+void lottie_sprite_rewind(lv_obj_t *obj)
+{
+    lottie_sprite_ctx_t *ctx = lottie_sprite_get_ctx(obj);
+    if (!ctx) {
+        return;
+    }
+
+    ctx->start_tick = lv_tick_get();
+    if (ctx->shown_frame != 0) {
+        ctx->shown_frame = lottie_sprite_decode(ctx, 0) ? 0 : -1;
+        lv_image_cache_drop(lv_image_get_src(obj));
+        lv_obj_invalidate(obj);
+    }
+}
+
+void lottie_sprite_release(lv_obj_t *obj)
+{
+    lottie_sprite_ctx_t *ctx = lottie_sprite_get_ctx(obj);
+    if (!ctx) {
+        return;
+    }
+
+    lv_timer_delete(ctx->timer);
+    lv_obj_set_user_data(obj, NULL);
+    lottie_sprite_pack_close(ctx->pack);
+    heap_caps_free(ctx);
+}
+
+bool lottie_sprite_get_stats(lv_obj_t *obj, lottie_sprite_stats_t *stats)
+{
+    lottie_sprite_ctx_t *ctx = lottie_sprite_get_ctx(obj);
+    if (!ctx || !stats) {
+        return false;
+    }
+
+    stats->frame_count = ctx->pack->header->frame_count;
+    stats->pack_bytes = (uint32_t)ctx->pack->size;
+    stats->decoded_frames = ctx->decoded_frames;
+    stats->decode_us_avg = ctx->decoded_frames ?
+                           (uint32_t)(ctx->decode_us_total / ctx->decoded_frames) : 0;
+    return true;
+}
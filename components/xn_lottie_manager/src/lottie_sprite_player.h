@@ -0,0 +1,133 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-03 09:20:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-03 09:20:00
+ * @FilePath: \xn_esp32_dice\components\xn_lottie_manager\src\lottie_sprite_player.h
+ * @Description: 预编译帧包（sprite）播放器，无需在设备上运行 ThorVG
+ */
+
+#pragma once
+
+#include "lvgl.h"
+#include "lottie_render_target.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 帧包文件格式（由 tools/lottie_sprite_compiler.py 在构建时生成，小端）：
+ *   lottie_sprite_header_t
+ *   lottie_sprite_index_t × frame_count
+ *   帧数据：每帧 [RGB565 流][A8 流]，RLE 编码见 lottie_rle.h
+ */
+
+#define LOTTIE_SPRITE_MAGIC         0x52505358u     ///< "XSPR"
+#define LOTTIE_SPRITE_VERSION       1
+#define LOTTIE_SPRITE_FLAG_ALPHA    0x0001          ///< 帧数据包含 A8 流
+
+/** 帧包文件头 */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;         ///< LOTTIE_SPRITE_MAGIC
+    uint16_t version;       ///< LOTTIE_SPRITE_VERSION
+    uint16_t flags;         ///< LOTTIE_SPRITE_FLAG_*
+    uint16_t width;         ///< 帧宽度
+    uint16_t height;        ///< 帧高度
+    uint16_t frame_count;   ///< 帧数
+    uint16_t fps_x100;      ///< 帧率 × 100
+} lottie_sprite_header_t;
+
+/** 帧索引（offset 相对于帧数据起始位置） */
+typedef struct __attribute__((packed)) {
+    uint32_t offset;
+    uint32_t rgb_len;
+    uint32_t alpha_len;
+} lottie_sprite_index_t;
+
+/** 帧包句柄 */
+typedef struct lottie_sprite_pack_s lottie_sprite_pack_t;
+
+/** 播放统计 */
+typedef struct {
+    uint32_t frame_count;       ///< 帧包帧数
+    uint32_t pack_bytes;        ///< 帧包大小（Flash 与 PSRAM 占用相同）
+    uint32_t decoded_frames;    ///< 已解压帧数
+    uint32_t decode_us_avg;     ///< 单帧解压平均耗时（微秒）
+} lottie_sprite_stats_t;
+
+/**
+ * @brief 根据 JSON 路径和尺寸生成帧包路径
+ *
+ * 例如 "/lottie/dice.json" 260x260 -> "/lottie/dice_260x260.spr"
+ *
+ * @return true 成功，false 路径过长或不是 .json
+ */
+bool lottie_sprite_make_path(char *out, size_t out_size, const char *json_path,
+                             uint16_t width, uint16_t height);
+
+/**
+ * @brief 读取并校验帧包（整体载入 PSRAM，锁外调用）
+ * @param path 帧包路径
+ * @param width 期望宽度
+ * @param height 期望高度
+ * @return 帧包句柄，文件不存在或格式/尺寸不符时返回 NULL
+ */
+lottie_sprite_pack_t *lottie_sprite_pack_open(const char *path, uint16_t width, uint16_t height);
+
+/**
+ * @brief 释放未交给播放器的帧包
+ */
+void lottie_sprite_pack_close(lottie_sprite_pack_t *pack);
+
+/**
+ * @brief 帧包占用字节数
+ */
+size_t lottie_sprite_pack_size(const lottie_sprite_pack_t *pack);
+
+/**
+ * @brief 创建帧包播放对象（lv_canvas，帧直接解压为显示缓冲区格式）
+ *
+ * 帧号按经过时间计算，由 lv_timer 驱动；对象隐藏时不解压。
+ * 成功后帧包归对象所有，随 lottie_sprite_release() 释放。
+ * 需在 lv_lock() 内调用。
+ *
+ * @param parent 父对象
+ * @param pack 帧包
+ * @param buffer lottie_render_format_bytes() 字节的显示缓冲区
+ * @param format 显示缓冲区格式
+ * @return 播放对象，失败返回 NULL（帧包仍归调用方）
+ */
+lv_obj_t *lottie_sprite_create(lv_obj_t *parent, lottie_sprite_pack_t *pack, uint8_t *buffer,
+                               lottie_render_format_t format);
+
+/**
+ * @brief 判断对象是否为帧包播放对象
+ */
+bool lottie_sprite_is(lv_obj_t *obj);
+
+/**
+ * @brief 从第一帧重新播放
+ * @note 需在 lv_lock() 内调用
+ */
+void lottie_sprite_rewind(lv_obj_t *obj);
+
+/**
+ * @brief 停止播放并释放帧包（非帧包对象时无操作）
+ * @note 需在 lv_lock() 内、删除对象之前调用
+ */
+void lottie_sprite_release(lv_obj_t *obj);
+
+/**
+ * @brief 获取播放统计
+ * @return true 是帧包对象，false 不是
+ * @note 需在 lv_lock() 内调用
+ */
+bool lottie_sprite_get_stats(lv_obj_t *obj, lottie_sprite_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
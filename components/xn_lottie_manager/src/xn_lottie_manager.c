@@ -9,6 +9,13 @@
 
  #include "xn_lottie_manager.h"
  #include "xn_lvgl.h"
+ #include "lottie_frame_cache.h"
+ #include "lottie_sprite_player.h"
+ #include "lottie_render_target.h"
+ #include "lottie_buffer_pool.h"
+ #include "lottie_parse_cache.h"
+ #include "lottie_anim_configs.h"
+ #include "lottie_cmd_coalesce.h"
  #include "esp_log.h"
  #include "esp_heap_caps.h"
  #include "esp_task_wdt.h"
@@ -16,72 +23,19 @@
  #include "freertos/task.h"
  #include "freertos/queue.h"
  #include "esp_spiffs.h"
+ #include "esp_timer.h"
  #include <string.h>
  #include <stdio.h>
+ #include <sys/stat.h>
  
- static const char *TAG = "LOTTIE_MANAGER";
+ // lv_anim_t 的成员定义在新版本 LVGL 中移入了私有头文件
+ #if defined(__has_include)
+ #if __has_include("misc/lv_anim_private.h")
+ #include "misc/lv_anim_private.h"
+ #endif
+ #endif
  
- // 动画命令类型
- typedef enum {
-     LOTTIE_CMD_PLAY,
-     LOTTIE_CMD_PLAY_AT_POS,
-     LOTTIE_CMD_STOP,
-     LOTTIE_CMD_HIDE,
-     LOTTIE_CMD_SHOW,
-     LOTTIE_CMD_SET_POS,
-     LOTTIE_CMD_CENTER,
-     LOTTIE_CMD_SHOW_IMAGE,
-     LOTTIE_CMD_HIDE_IMAGE
- } lottie_cmd_type_t;
- 
- // 动画命令结构
- typedef struct {
-     lottie_cmd_type_t type;
-     union {
-         struct {
-             int anim_type;
-         } play;
-         struct {
-             int anim_type;
-             int16_t x;
-             int16_t y;
-         } play_at_pos;
-         struct {
-             int anim_type;
-         } stop;
-         struct {
-             int16_t x;
-             int16_t y;
-         } pos;
-         struct {
-             char path[64];
-             uint16_t width;
-             uint16_t height;
-         } image;
-     } data;
- } lottie_cmd_t;
- 
- // 动画配置结构
- typedef struct {
-     const char *file_path;
-     uint16_t width;
-     uint16_t height;
- } lottie_anim_config_t;
- 
- // 动画配置表 - 全屏显示配置（屏幕尺寸：412x412）
- static const lottie_anim_config_t anim_configs[] = {
-     [LOTTIE_ANIM_WIFI]    = {"/lottie/loading.json",        256, 256},  // WiFi加载
-     [LOTTIE_ANIM_MIC]     = {"/lottie/emoji_kaixin.json",   128, 128},  // mic
-     [LOTTIE_ANIM_SPEAK]   = {"/lottie/speak.json",          400, 277},  // 说话
-     [LOTTIE_ANIM_THINK]   = {"/lottie/emoji_think.json",    400, 400},  // 思考
-     [LOTTIE_ANIM_COOL]    = {"/lottie/emoji_cool.json",     400, 400},  // 酷
-     [LOTTIE_ANIM_LOADING] = {"/lottie/loading.json",        200, 200},  // 通用加载
-     [LOTTIE_ANIM_OTA]     = {"/lottie/loading.json",        400, 400},  // OTA升级动画
-     [LOTTIE_ANIM_DICE]    = {"/lottie/dice.json",           260, 260},  // 骰子动画
-     // 可以继续添加更多动画配置...
- };
- 
- #define ANIM_CONFIG_COUNT (sizeof(anim_configs) / sizeof(anim_configs[0]))
+ static const char *TAG = "LOTTIE_MANAGER";
  
  // 静态任务相关 - 参考main.c的实现
  #define LOTTIE_TASK_STACK_SIZE (1024*350/sizeof(StackType_t))  // 8KB栈
@@ -99,8 +53,22 @@
  static volatile bool g_anim_busy = false;      // 动画是否正在操作中
  static lv_obj_t *g_image_obj = NULL;          // 图片对象
  
+ // 解析缓存
+ static lottie_cache_entry_t g_cache_entries[ANIM_CONFIG_COUNT];
+ static lottie_parse_cache_t g_cache;           // 按 anim_configs 下标分槽的 LRU 缓存
+ static int g_active_slot = -1;                 // 当前对象所属缓存槽，-1 表示未缓存的临时对象
+ static xn_lottie_stats_t g_stats;              // 缓存与切换延迟统计
+ 
+ static bool lottie_op_begin(void);
+ static lottie_render_format_t lottie_select_format(bool opaque, bool sprite);
+ static void lottie_op_end(void);
+ static bool lottie_preload_slot(int slot);
+ static void lottie_cache_evict_cb(int slot, lottie_cache_entry_t *entry, void *arg);
+ static bool lottie_play_slot(int slot, const char *file_path, uint16_t width, uint16_t height,
+                              bool align, int16_t x, int16_t y, int64_t request_us);
+ 
  // 实际执行动画播放的内部函数
- static bool _lottie_play_internal(int anim_type)
+ static bool _lottie_play_internal(int anim_type, int64_t request_us)
  {
      if (anim_type < 0 || anim_type >= ANIM_CONFIG_COUNT) {
          ESP_LOGE(TAG, "无效的动画类型: %d", anim_type);
@@ -115,8 +83,14 @@
  
      ESP_LOGI(TAG, "播放动画类型: %d", anim_type);
  
-     // 直接使用现有的lottie_manager_play函数
-     bool result = lottie_manager_play(config->file_path, config->width, config->height);
+     if (!lottie_op_begin()) {
+         return false;
+     }
+ 
+     bool result = lottie_play_slot(anim_type, config->file_path, config->width, config->height,
+                                    false, 0, 0, request_us);
+     lottie_op_end();
+ 
      if (result) {
          g_current_anim_type = anim_type;
      }
@@ -125,7 +99,7 @@
  }
  
  // 实际执行动画播放并设置位置的内部函数
- static bool _lottie_play_at_pos_internal(int anim_type, int16_t x, int16_t y)
+ static bool _lottie_play_at_pos_internal(int anim_type, int16_t x, int16_t y, int64_t request_us)
  {
      if (anim_type < 0 || anim_type >= ANIM_CONFIG_COUNT) {
          ESP_LOGE(TAG, "无效的动画类型: %d", anim_type);
@@ -140,8 +114,14 @@
  
      ESP_LOGI(TAG, "播放动画类型: %d，中心偏移: (%d, %d)", anim_type, x, y);
  
-     // 直接使用新的lottie_manager_play_at_pos函数
-     bool result = lottie_manager_play_at_pos(config->file_path, config->width, config->height, x, y);
+     if (!lottie_op_begin()) {
+         return false;
+     }
+ 
+     bool result = lottie_play_slot(anim_type, config->file_path, config->width, config->height,
+                                    true, x, y, request_us);
+     lottie_op_end();
+ 
      if (result) {
          g_current_anim_type = anim_type;
      }
@@ -164,112 +144,147 @@
      }
  }
  
+ // 执行单条命令
+ static void lottie_exec_cmd(const lottie_cmd_t *cmd)
+ {
+     switch (cmd->type) {
+     case LOTTIE_CMD_PLAY:
+         _lottie_play_internal(cmd->data.play.anim_type, cmd->request_us);
+         break;
+ 
+     case LOTTIE_CMD_PLAY_AT_POS:
+         _lottie_play_at_pos_internal(cmd->data.play_at_pos.anim_type,
+                                      cmd->data.play_at_pos.x,
+                                      cmd->data.play_at_pos.y,
+                                      cmd->request_us);
+         break;
+ 
+     case LOTTIE_CMD_STOP:
+         _lottie_stop_internal(cmd->data.stop.anim_type);
+         break;
+ 
+     case LOTTIE_CMD_HIDE:
+         if (g_lottie_obj) {
+             lv_lock();
+             lv_obj_add_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
+             lv_unlock();
+         }
+         break;
+ 
+     case LOTTIE_CMD_SHOW:
+         if (g_lottie_obj) {
+             lv_lock();
+             lv_obj_clear_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
+             lv_unlock();
+         }
+         break;
+ 
+     case LOTTIE_CMD_SET_POS:
+         if (g_lottie_obj) {
+             lv_lock();
+             lv_obj_set_pos(g_lottie_obj, cmd->data.pos.x, cmd->data.pos.y);
+             lv_unlock();
+         }
+         break;
+ 
+     case LOTTIE_CMD_CENTER:
+         if (g_lottie_obj) {
+             lv_lock();
+             lv_obj_center(g_lottie_obj);
+             lv_unlock();
+         }
+         break;
+ 
+     case LOTTIE_CMD_SHOW_IMAGE:
+         ESP_LOGI(TAG, "处理显示图片命令: %s (%dx%d)", 
+                  cmd->data.image.path, cmd->data.image.width, cmd->data.image.height);
+         
+         lv_lock();
+         if (g_lottie_obj) {
+             lv_obj_add_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
+             ESP_LOGI(TAG, "已隐藏Lottie动画");
+         }
+         if (g_image_obj) {
+             lv_obj_delete(g_image_obj);
+             g_image_obj = NULL;
+             ESP_LOGI(TAG, "已删除旧图片");
+         }
+         
+         g_image_obj = lv_image_create(lv_screen_active());
+         if (g_image_obj) {
+             ESP_LOGI(TAG, "图片对象创建成功");
+             lv_image_set_src(g_image_obj, cmd->data.image.path);
+             if (cmd->data.image.width > 0 && cmd->data.image.height > 0) {
+                 lv_obj_set_size(g_image_obj, cmd->data.image.width, cmd->data.image.height);
+             }
+             lv_obj_center(g_image_obj);
+             ESP_LOGI(TAG, "✅ 图片显示成功: %s", cmd->data.image.path);
+         } else {
+             ESP_LOGE(TAG, "❌ 创建图片对象失败");
+         }
+         lv_unlock();
+         break;
+ 
+     case LOTTIE_CMD_HIDE_IMAGE:
+         ESP_LOGI(TAG, "处理隐藏图片命令");
+         lv_lock();
+         if (g_image_obj) {
+             lv_obj_delete(g_image_obj);
+             g_image_obj = NULL;
+             ESP_LOGI(TAG, "图片已删除");
+         }
+         if (g_lottie_obj) {
+             lv_obj_clear_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
+             ESP_LOGI(TAG, "已恢复Lottie动画");
+         }
+         lv_unlock();
+         break;
+ 
+     case LOTTIE_CMD_PRELOAD:
+         if (lottie_op_begin()) {
+             lottie_preload_slot(cmd->data.play.anim_type);
+             lottie_op_end();
+         }
+         break;
+ 
+     default:
+         ESP_LOGW(TAG, "未知命令类型: %d", cmd->type);
+         break;
+     }
+ }
+ 
  // 动画处理静态任务 - 参考main.c的lvgl_timer_task
+ // 每次取出队列中已积压的全部命令合并后再执行，连续点击时只执行最终状态
  static void lottie_task(void *pvParameters)
  {
-     lottie_cmd_t cmd;
+     lottie_cmd_t cmds[LOTTIE_CMD_QUEUE_LEN];
  
      ESP_LOGI(TAG, "动画处理任务启动");
  
      while (1) {
-         if (xQueueReceive(g_cmd_queue, &cmd, portMAX_DELAY) == pdTRUE) {
-             switch (cmd.type) {
-             case LOTTIE_CMD_PLAY:
-                 _lottie_play_internal(cmd.data.play.anim_type);
-                 break;
- 
-             case LOTTIE_CMD_PLAY_AT_POS:
-                 _lottie_play_at_pos_internal(cmd.data.play_at_pos.anim_type,
-                                              cmd.data.play_at_pos.x,
-                                              cmd.data.play_at_pos.y);
-                 break;
- 
-             case LOTTIE_CMD_STOP:
-                 _lottie_stop_internal(cmd.data.stop.anim_type);
-                 break;
- 
-             case LOTTIE_CMD_HIDE:
-                 if (g_lottie_obj) {
-                     lv_lock();
-                     lv_obj_add_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
-                     lv_unlock();
-                 }
-                 break;
- 
-             case LOTTIE_CMD_SHOW:
-                 if (g_lottie_obj) {
-                     lv_lock();
-                     lv_obj_clear_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
-                     lv_unlock();
-                 }
-                 break;
- 
-             case LOTTIE_CMD_SET_POS:
-                 if (g_lottie_obj) {
-                     lv_lock();
-                     lv_obj_set_pos(g_lottie_obj, cmd.data.pos.x, cmd.data.pos.y);
-                     lv_unlock();
-                 }
-                 break;
- 
-             case LOTTIE_CMD_CENTER:
-                 if (g_lottie_obj) {
-                     lv_lock();
-                     lv_obj_center(g_lottie_obj);
-                     lv_unlock();
-                 }
-                 break;
- 
-             case LOTTIE_CMD_SHOW_IMAGE:
-                 ESP_LOGI(TAG, "处理显示图片命令: %s (%dx%d)", 
-                          cmd.data.image.path, cmd.data.image.width, cmd.data.image.height);
-                 
-                 lv_lock();
-                 if (g_lottie_obj) {
-                     lv_obj_add_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
-                     ESP_LOGI(TAG, "已隐藏Lottie动画");
-                 }
-                 if (g_image_obj) {
-                     lv_obj_delete(g_image_obj);
-                     g_image_obj = NULL;
-                     ESP_LOGI(TAG, "已删除旧图片");
-                 }
-                 
-                 g_image_obj = lv_image_create(lv_screen_active());
-                 if (g_image_obj) {
-                     ESP_LOGI(TAG, "图片对象创建成功");
-                     lv_image_set_src(g_image_obj, cmd.data.image.path);
-                     if (cmd.data.image.width > 0 && cmd.data.image.height > 0) {
-                         lv_obj_set_size(g_image_obj, cmd.data.image.width, cmd.data.image.height);
-                     }
-                     lv_obj_center(g_image_obj);
-                     ESP_LOGI(TAG, "✅ 图片显示成功: %s", cmd.data.image.path);
-                 } else {
-                     ESP_LOGE(TAG, "❌ 创建图片对象失败");
-                 }
-                 lv_unlock();
-                 break;
- 
-             case LOTTIE_CMD_HIDE_IMAGE:
-                 ESP_LOGI(TAG, "处理隐藏图片命令");
-                 lv_lock();
-                 if (g_image_obj) {
-                     lv_obj_delete(g_image_obj);
-                     g_image_obj = NULL;
-                     ESP_LOGI(TAG, "图片已删除");
-                 }
-                 if (g_lottie_obj) {
-                     lv_obj_clear_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
-                     ESP_LOGI(TAG, "已恢复Lottie动画");
-                 }
-                 lv_unlock();
-                 break;
- 
-             default:
-                 ESP_LOGW(TAG, "未知命令类型: %d", cmd.type);
-                 break;
-             }
+         if (xQueueReceive(g_cmd_queue, &cmds[0], portMAX_DELAY) != pdTRUE) {
+             continue;
+         }
+ 
+         size_t count = 1;
+         while (count < LOTTIE_CMD_QUEUE_LEN && xQueueReceive(g_cmd_queue, &cmds[count], 0) == pdTRUE) {
+             count++;
          }
+ 
+         uint32_t dropped = 0;
+         size_t n = lottie_cmd_coalesce(cmds, count, &dropped);
+         g_stats.cmd_received += count;
+         g_stats.cmd_dropped += dropped;
+         if (dropped) {
+             ESP_LOGI(TAG, "合并命令: %u 条 -> %u 条", (unsigned)count, (unsigned)n);
+         }
+ 
+         for (size_t i = 0; i < n; i++) {
+             lottie_exec_cmd(&cmds[i]);
+         }
+ 
+         // 界面已变化，唤醒 LVGL 任务立即刷新，不必等到下一个刷新周期
+         lvgl_driver_wake();
      }
  }
  
@@ -296,6 +311,25 @@
      lv_obj_set_style_bg_grad_dir(screen, LV_GRAD_DIR_VER, LV_PART_MAIN);
      lv_unlock();
  
+     // 初始化解析缓存（常驻标记来自配置表）
+     lottie_parse_cache_init(&g_cache, g_cache_entries, (int)ANIM_CONFIG_COUNT, LOTTIE_CACHE_BUDGET_BYTES,
+                             lottie_cache_evict_cb, NULL);
+     memset(&g_stats, 0, sizeof(g_stats));
+     for (int i = 0; i < ANIM_CONFIG_COUNT; i++) {
+         g_cache_entries[i].pinned = anim_configs[i].pinned;
+     }
+ 
+     // 显示缓冲区池按各动画的缓冲区大小分级
+     size_t class_sizes[ANIM_CONFIG_COUNT];
+     for (int i = 0; i < ANIM_CONFIG_COUNT; i++) {
+         class_sizes[i] = lottie_render_format_bytes(lottie_select_format(anim_configs[i].opaque, anim_configs[i].sprite),
+                                                     anim_configs[i].width, anim_configs[i].height);
+     }
+     if (lottie_buffer_pool_init(class_sizes, ANIM_CONFIG_COUNT) != ESP_OK) {
+         ESP_LOGE(TAG, "缓冲区池初始化失败");
+         return false;
+     }
+ 
      // 创建互斥锁
      g_anim_mutex = xSemaphoreCreateMutex();
      if (!g_anim_mutex) {
@@ -304,7 +338,7 @@
      }
  
      // 创建命令队列
-     g_cmd_queue = xQueueCreate(10, sizeof(lottie_cmd_t));
+     g_cmd_queue = xQueueCreate(LOTTIE_CMD_QUEUE_LEN, sizeof(lottie_cmd_t));
      if (!g_cmd_queue) {
          ESP_LOGE(TAG, "创建命令队列失败");
          vSemaphoreDelete(g_anim_mutex);
@@ -334,68 +368,94 @@
      return true;
  }
  
- bool lottie_manager_play(const char *file_path, uint16_t width, uint16_t height)
+ // 按路径和尺寸查找动画配置下标，未找到返回 -1
+ static int lottie_find_slot(const char *file_path, uint16_t width, uint16_t height)
  {
-     if (!g_initialized) {
-         ESP_LOGE(TAG, "管理器未初始化");
-         return false;
+     for (int i = 0; i < ANIM_CONFIG_COUNT; i++) {
+         if (anim_configs[i].file_path && anim_configs[i].width == width &&
+             anim_configs[i].height == height && strcmp(anim_configs[i].file_path, file_path) == 0) {
+             return i;
+         }
      }
+     return -1;
+ }
  
-     if (!file_path) {
-         ESP_LOGE(TAG, "文件路径无效");
-         return false;
+ // 将动画重置到第一帧（缓存命中时从头播放）
+ static void lottie_rewind(lv_obj_t *obj)
+ {
+     if (lottie_sprite_is(obj)) {
+         lottie_sprite_rewind(obj);
+         return;
      }
  
-     // 获取互斥锁，确保同一时间只有一个动画操作
-     if (xSemaphoreTake(g_anim_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-         ESP_LOGE(TAG, "获取互斥锁超时");
-         return false;
+     lv_anim_t *anim = lv_lottie_get_anim(obj);
+     if (anim) {
+         anim->act_time = 0;
      }
+ }
  
-     // 等待之前的操作完全完成
-     uint32_t wait_count = 0;
-     while (g_anim_busy && wait_count < 100) {
-         vTaskDelay(pdMS_TO_TICKS(10));
-         wait_count++;
+ // 读取帧包并创建隐藏的帧包播放对象（整个帧包常驻 PSRAM，播放时逐帧解压）
+ static bool lottie_load_sprite_object(const char *sprite_path, uint16_t width, uint16_t height,
+                                       lottie_render_format_t format,
+                                       lv_obj_t **out_obj, uint8_t **out_buffer, size_t *out_bytes)
+ {
+     lottie_sprite_pack_t *pack = lottie_sprite_pack_open(sprite_path, width, height);
+     if (!pack) {
+         return false;
      }
+     size_t pack_size = lottie_sprite_pack_size(pack);
  
-     if (g_anim_busy) {
-         ESP_LOGE(TAG, "等待动画操作完成超时");
-         xSemaphoreGive(g_anim_mutex);
+     size_t buffer_size = lottie_render_format_bytes(format, width, height);
+     uint8_t *buffer = lottie_buffer_pool_alloc(buffer_size);
+     if (!buffer) {
+         ESP_LOGE(TAG, "PSRAM缓冲区分配失败 (需要 %zu 字节)", buffer_size);
+         lottie_sprite_pack_close(pack);
          return false;
      }
  
-     g_anim_busy = true;
- 
-     ESP_LOGI(TAG, "播放动画: %s (%dx%d), 当前动画: %d", file_path, width, height, g_current_anim_type);
+     lv_lock();
+     lv_obj_t *obj = lottie_sprite_create(lv_screen_active(), pack, buffer, format);
+     if (obj) {
+         lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+     }
+     lv_unlock();
  
-     // 先清理之前的动画（包含同步等待）
-     lottie_manager_stop();
+     if (!obj) {
+         ESP_LOGE(TAG, "创建帧包播放对象失败");
+         lottie_sprite_pack_close(pack);
+         lottie_buffer_pool_free(buffer);
+         return false;
+     }
  
-     // 等待确保LVGL完全处理完删除操作和内存释放
-     // 增加延迟以避免SPI传输队列冲突
-     vTaskDelay(pdMS_TO_TICKS(100));
+     g_stats.render_format_last = format;
+     g_stats.render_buffer_bytes_last = buffer_size;
+     *out_obj = obj;
+     *out_buffer = buffer;
+     *out_bytes = buffer_size + pack_size;
+     return true;
+ }
  
+ // 读取 JSON 并创建隐藏的 lv_lottie 对象（ThorVG 在 set_src_data 时完成解析）
+ static bool lottie_load_live_object(const char *file_path, uint16_t width, uint16_t height, bool prerender,
+                                     lottie_render_format_t format, uint8_t cap_fps,
+                                     lv_obj_t **out_obj, uint8_t **out_buffer, size_t *out_bytes)
+ {
      // 第一步：在锁外读取文件到内存（耗时操作）
      FILE *fp = fopen(file_path, "rb");
      if (!fp) {
          ESP_LOGE(TAG, "无法打开文件: %s", file_path);
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
          return false;
      }
  
      fseek(fp, 0, SEEK_END);
      size_t file_size = ftell(fp);
      fseek(fp, 0, SEEK_SET);
-
-    ESP_LOGI(TAG, "Lottie JSON 文件: %s, 大小: %u 字节", file_path, (unsigned)file_size);
+ 
+     ESP_LOGI(TAG, "Lottie JSON 文件: %s, 大小: %u 字节", file_path, (unsigned)file_size);
      uint8_t *file_data = (uint8_t *)heap_caps_malloc(file_size, MALLOC_CAP_SPIRAM);
      if (!file_data) {
          ESP_LOGE(TAG, "文件缓冲区分配失败 (需要 %zu 字节)", file_size);
          fclose(fp);
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
          return false;
      }
  
@@ -405,67 +465,353 @@
      if (read_size != file_size) {
          ESP_LOGE(TAG, "文件读取失败");
          heap_caps_free(file_data);
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
+         return false;
+     }
+ 
+     // 紧凑格式由 ThorVG 渲染到共享暂存区再转换；暂存区放不下时退回 ARGB8888
+     uint8_t *scratch = NULL;
+     if (format != LOTTIE_RENDER_ARGB8888) {
+         scratch = lottie_render_scratch_get(lottie_render_format_bytes(LOTTIE_RENDER_ARGB8888, width, height));
+         if (!scratch) {
+             format = LOTTIE_RENDER_ARGB8888;
+         }
+     }
+ 
+     // 分配显示缓冲区
+     size_t buffer_size = lottie_render_format_bytes(format, width, height);
+     uint8_t *buffer = lottie_buffer_pool_alloc(buffer_size);
+     if (!buffer) {
+         ESP_LOGE(TAG, "PSRAM缓冲区分配失败 (需要 %zu 字节)", buffer_size);
+         heap_caps_free(file_data);
          return false;
      }
  
      // 第二步：在锁内操作LVGL对象（快速操作）
      lv_lock();
  
-     g_lottie_obj = lv_lottie_create(lv_screen_active());
-     if (!g_lottie_obj) {
+     lv_obj_t *obj = lv_lottie_create(lv_screen_active());
+     if (!obj) {
          lv_unlock();
          ESP_LOGE(TAG, "创建 Lottie 对象失败");
+         lottie_buffer_pool_free(buffer);
          heap_caps_free(file_data);
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
          return false;
      }
  
-     // 分配渲染缓冲区
-     size_t buffer_size = width * height * 4; // ARGB8888
-     g_lottie_buffer = heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
-     if (!g_lottie_buffer) {
-         ESP_LOGE(TAG, "PSRAM缓冲区分配失败 (需要 %zu 字节)", buffer_size);
-         lv_obj_del(g_lottie_obj);
+     // 先隐藏，由调用方定位后再显示
+     lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+ 
+     // 设置缓冲区和数据源（使用内存数据，避免文件IO）
+     uint8_t *render_buf = scratch ? scratch : buffer;
+     lv_lottie_set_buffer(obj, width, height, render_buf);
+     // 记录 ThorVG 解析耗时与解析后驻留的堆内存，用于比较 JSON 预处理前后的效果
+     size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+     int64_t parse_start_us = esp_timer_get_time();
+     lv_lottie_set_src_data(obj, file_data, file_size);
+     g_stats.parse_us_last = (uint32_t)(esp_timer_get_time() - parse_start_us);
+     size_t heap_after = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+     g_stats.parse_heap_bytes_last = heap_before > heap_after ? heap_before - heap_after : 0;
+ 
+     if (!lottie_render_target_attach(obj, format, buffer, width, height, cap_fps)) {
+         lv_obj_del(obj);
          lv_unlock();
+         ESP_LOGE(TAG, "挂接渲染目标失败");
+         lottie_buffer_pool_free(buffer);
          heap_caps_free(file_data);
-         g_lottie_obj = NULL;
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
          return false;
      }
  
-     // 设置缓冲区和数据源（使用内存数据，避免文件IO）
-     lv_lottie_set_buffer(g_lottie_obj, width, height, g_lottie_buffer);
-     lv_lottie_set_src_data(g_lottie_obj, file_data, file_size);
-     lv_obj_center(g_lottie_obj);
+     // 短循环动画：首轮实时渲染并压缩缓存，之后各轮解压贴图
+     bool frames_cached = prerender &&
+                          lottie_frame_cache_attach(obj, render_buf, buffer, format, width, height,
+                                                    format != LOTTIE_RENDER_RGB565,
+                                                    LOTTIE_FRAME_CACHE_BUDGET_BYTES) != NULL;
  
      lv_unlock();
  
      // 释放文件数据（已被ThorVG解析）
      heap_caps_free(file_data);
  
-     ESP_LOGI(TAG, "动画播放成功");
+     g_stats.render_format_last = format;
+     g_stats.render_buffer_bytes_last = buffer_size;
+     *out_obj = obj;
+     *out_buffer = buffer;
+     *out_bytes = buffer_size + file_size * LOTTIE_CACHE_PARSED_FACTOR +
+                  (frames_cached ? LOTTIE_FRAME_CACHE_BUDGET_BYTES : 0);
+     return true;
+ }
  
-     g_anim_busy = false;
-     xSemaphoreGive(g_anim_mutex);
+ // 按配置选择显示缓冲区格式（关闭 LOTTIE_RENDER_COMPACT 时保持 ThorVG 原生 ARGB8888）
+ // 帧包直接解码到显示缓冲区，紧凑格式没有额外开销；实时渲染的紧凑格式需要常驻暂存区，
+ // 只有不透明内容（省一半）默认使用，带透明通道的实时动画由 LOTTIE_RENDER_COMPACT_ALPHA 决定
+ static lottie_render_format_t lottie_select_format(bool opaque, bool sprite)
+ {
+ #if LOTTIE_RENDER_COMPACT
+     if (opaque) {
+         return LOTTIE_RENDER_RGB565;
+     }
+     return (sprite || LOTTIE_RENDER_COMPACT_ALPHA) ? LOTTIE_RENDER_RGB565A8 : LOTTIE_RENDER_ARGB8888;
+ #else
+     (void)opaque;
+     (void)sprite;
+     return LOTTIE_RENDER_ARGB8888;
+ #endif
+ }
+ 
+ // 创建隐藏的动画对象：有帧包时直接播放帧包，否则（或帧包无效时）实时渲染 JSON
+ static bool lottie_load_object(const char *file_path, const char *sprite_path, uint16_t width, uint16_t height,
+                                bool prerender, lottie_render_format_t format, uint8_t cap_fps,
+                                lv_obj_t **out_obj, uint8_t **out_buffer, size_t *out_bytes)
+ {
+     int64_t start_us = esp_timer_get_time();
+     bool ok = false;
+ 
+     if (sprite_path) {
+         ok = lottie_load_sprite_object(sprite_path, width, height, format, out_obj, out_buffer, out_bytes);
+         if (!ok) {
+             ESP_LOGW(TAG, "帧包不可用，回退到实时渲染: %s", file_path);
+         }
+     }
+     if (!ok) {
+         // 帧包的格式不一定适合实时渲染，按实时渲染重新选择（RGB565 即不透明）
+         format = lottie_select_format(format == LOTTIE_RENDER_RGB565, false);
+         ok = lottie_load_live_object(file_path, width, height, prerender, format, cap_fps,
+                                      out_obj, out_buffer, out_bytes);
+     }
+ 
+     if (ok) {
+         g_stats.load_us_last = (uint32_t)(esp_timer_get_time() - start_us);
+         g_stats.load_bytes_last = *out_bytes;
+         ESP_LOGI(TAG, "动画对象创建耗时 %lu us，估算占用 %zu 字节 (%s)",
+                  (unsigned long)g_stats.load_us_last, *out_bytes, lottie_sprite_is(*out_obj) ? "帧包" : "实时渲染");
+     }
+     return ok;
+ }
+ 
+ // 安全删除 lv_lottie 对象并释放其渲染缓冲区
+ // 隐藏后立即刷新一帧并删除对象，再以刷新栅栏等待此前提交的DMA全部完成后释放缓冲区
+ static void lottie_destroy_object(lv_obj_t *obj, uint8_t *buffer)
+ {
+     int64_t start_us = esp_timer_get_time();
+     uint32_t fence;
+ 
+     lv_lock();
+     if (obj) {
+         lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+         lv_refr_now(NULL);
+         lottie_frame_cache_release(obj);
+         lottie_render_target_release(obj);
+         lottie_sprite_release(obj);
+         lv_obj_del(obj);
+     }
+     fence = lvgl_driver_flush_fence();
+     lv_unlock();
+ 
+     if (lvgl_driver_flush_wait(fence, LOTTIE_FLUSH_FENCE_TIMEOUT_MS) != ESP_OK) {
+         ESP_LOGW(TAG, "等待刷新完成超时，强制释放");
+     }
+ 
+     lottie_buffer_pool_free(buffer);
+ 
+     g_stats.fence_wait_us_last = (uint32_t)(esp_timer_get_time() - start_us);
+ }
+ 
+ // 缓存淘汰回调：销毁对象并释放缓冲区（占用由 lottie_parse_cache 记账）
+ static void lottie_cache_evict_cb(int slot, lottie_cache_entry_t *entry, void *arg)
+ {
+     ESP_LOGI(TAG, "淘汰缓存动画: %d (%zu 字节)", slot, entry->bytes);
+     lottie_destroy_object(entry->obj, entry->buffer);
+     g_stats.evictions++;
+ }
+ 
+ // 解析动画并放入缓存槽（隐藏状态）；预算不足时 *cached 为 false，对象需由调用方作为临时对象管理
+ static bool lottie_cache_load(int slot, const char *file_path, uint16_t width, uint16_t height,
+                               lv_obj_t **out_obj, uint8_t **out_buffer, bool *cached)
+ {
+     lottie_cache_entry_t *entry = (slot >= 0) ? &g_cache_entries[slot] : NULL;
+     bool prerender = entry && anim_configs[slot].prerender;
+     char sprite_buf[96];
+     const char *sprite_path = NULL;
+     struct stat st;
+     size_t need = 0;
+ 
+     // 按文件大小预估占用，先腾出空间再解析，避免PSRAM峰值叠加
+     if (entry && anim_configs[slot].sprite &&
+         lottie_sprite_make_path(sprite_buf, sizeof(sprite_buf), file_path, width, height) &&
+         stat(sprite_buf, &st) == 0) {
+         sprite_path = sprite_buf;
+         need += (size_t)st.st_size;
+     } else {
+         need += prerender ? LOTTIE_FRAME_CACHE_BUDGET_BYTES : 0;
+         if (stat(file_path, &st) == 0) {
+             need += (size_t)st.st_size * LOTTIE_CACHE_PARSED_FACTOR;
+         }
+     }
+     lottie_render_format_t format = lottie_select_format(entry && anim_configs[slot].opaque, sprite_path != NULL);
+     need += lottie_render_format_bytes(format, width, height);
+     *cached = entry && lottie_parse_cache_reserve(&g_cache, need, g_active_slot);
+ 
+     size_t bytes = 0;
+     if (!lottie_load_object(file_path, sprite_path, width, height, prerender, format,
+                             entry ? anim_configs[slot].max_fps : 0, out_obj, out_buffer, &bytes)) {
+         return false;
+     }
+ 
+     if (*cached) {
+         lottie_parse_cache_insert(&g_cache, slot, *out_obj, *out_buffer, bytes);
+     } else if (entry) {
+         ESP_LOGW(TAG, "缓存预算不足，动画 %d 以临时对象播放", slot);
+     }
      return true;
  }
  
- bool lottie_manager_play_at_pos(const char *file_path, uint16_t width, uint16_t height, int16_t x, int16_t y)
+ // 预加载动画到解析缓存（保持隐藏），调用方需已持有 g_anim_mutex
+ static bool lottie_preload_slot(int slot)
  {
-     if (!g_initialized) {
-         ESP_LOGE(TAG, "管理器未初始化");
+     const lottie_anim_config_t *config = &anim_configs[slot];
+     lottie_cache_entry_t *entry = &g_cache_entries[slot];
+ 
+     if (entry->obj) {
+         lottie_parse_cache_touch(&g_cache, slot);
+         return true;
+     }
+ 
+     lv_obj_t *obj;
+     uint8_t *buffer;
+     bool cached;
+     if (!lottie_cache_load(slot, config->file_path, config->width, config->height,
+                            &obj, &buffer, &cached)) {
          return false;
      }
  
-     if (!file_path) {
-         ESP_LOGE(TAG, "文件路径无效");
+     if (!cached) {
+         // 预加载只对缓存有意义，放不下就直接丢弃
+         lottie_destroy_object(obj, buffer);
          return false;
      }
  
+     g_stats.preloads++;
+     ESP_LOGI(TAG, "动画 %d 预加载完成，缓存占用 %zu/%u 字节",
+              slot, g_cache.used, (unsigned)LOTTIE_CACHE_BUDGET_BYTES);
+     return true;
+ }
+ 
+ // 播放动画（双缓冲切换）：新动画在隐藏状态下准备好，再与旧动画在同一次刷新中交换可见性，
+ // 最后退役旧动画（缓存对象保持隐藏，临时对象删除）
+ // 调用方需已持有 g_anim_mutex；slot 为 -1 表示不走缓存
+ static bool lottie_play_slot(int slot, const char *file_path, uint16_t width, uint16_t height,
+                              bool align, int16_t x, int16_t y, int64_t request_us)
+ {
+     int64_t start_us = esp_timer_get_time();
+     size_t psram_free_start = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+     lottie_cache_entry_t *entry = (slot >= 0) ? &g_cache_entries[slot] : NULL;
+     bool hit = entry && entry->obj;
+ 
+     ESP_LOGI(TAG, "播放动画: %s (%dx%d), 当前动画: %d, 缓存%s",
+              file_path, width, height, g_current_anim_type, hit ? "命中" : "未命中");
+ 
+     // 旧动画在新动画可见之前保持显示
+     lv_obj_t *old_obj = g_lottie_obj;
+     uint8_t *old_buffer = g_lottie_buffer;
+     bool old_cached = g_active_slot >= 0;
+     bool old_gone = false;
+     uint32_t old_gone_frame = 0;
+ 
+     lv_obj_t *obj;
+     uint8_t *buffer;
+     bool cached = hit;
+ 
+     if (hit) {
+         obj = entry->obj;
+         buffer = entry->buffer;
+         if (obj == old_obj) {
+             old_obj = NULL;  // 重播当前动画，无需交换
+         }
+     } else if (!lottie_cache_load(slot, file_path, width, height, &obj, &buffer, &cached)) {
+         if (!old_obj || old_cached) {
+             return false;
+         }
+ 
+         // PSRAM 不足以同时容纳新旧动画：先退役旧的临时对象再重试（此时会出现空白帧）
+         ESP_LOGW(TAG, "新旧动画无法同时驻留，先释放旧动画");
+         lottie_manager_stop();
+         old_obj = NULL;
+         old_gone = true;
+         old_gone_frame = lvgl_driver_get_frame_count();
+         if (!lottie_cache_load(slot, file_path, width, height, &obj, &buffer, &cached)) {
+             return false;
+         }
+     }
+ 
+     size_t psram_free_now = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+     g_stats.switch_psram_peak_bytes = psram_free_start > psram_free_now ?
+                                       psram_free_start - psram_free_now : 0;
+ 
+     lv_lock();
+     if (align) {
+         lv_obj_align(obj, LV_ALIGN_CENTER, x, y);
+     } else {
+         lv_obj_center(obj);
+     }
+     if (hit) {
+         lottie_rewind(obj);
+     }
+     lv_obj_move_foreground(obj);
+ 
+     // 在同一次刷新中隐藏旧动画、显示新动画；lv_refr_now 先推进动画再绘制，首帧在显示前已渲染好
+     uint32_t gap_frames = old_gone ? lvgl_driver_get_frame_count() - old_gone_frame : 0;
+     if (old_obj) {
+         lv_obj_add_flag(old_obj, LV_OBJ_FLAG_HIDDEN);
+     }
+     lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+     lv_refr_now(NULL);
+     uint32_t fence = lvgl_driver_flush_fence();
+     lv_unlock();
+ 
+     g_lottie_obj = obj;
+     g_lottie_buffer = buffer;
+     g_active_slot = cached ? slot : -1;
+     if (cached) {
+         lottie_parse_cache_touch(&g_cache, slot);
+     }
+ 
+     // 首帧DMA完成即为请求到首帧的延迟终点
+     if (lvgl_driver_flush_wait(fence, LOTTIE_FLUSH_FENCE_TIMEOUT_MS) == ESP_OK) {
+         uint32_t first_frame_us = (uint32_t)(esp_timer_get_time() - request_us);
+         g_stats.first_frame_us_last = first_frame_us;
+         if (first_frame_us > g_stats.first_frame_us_max) {
+             g_stats.first_frame_us_max = first_frame_us;
+         }
+     }
+ 
+     // 退役旧动画
+     if (old_obj && !old_cached) {
+         lottie_destroy_object(old_obj, old_buffer);
+     }
+ 
+     g_stats.gap_frames_last = gap_frames;
+     if (gap_frames > g_stats.gap_frames_max) {
+         g_stats.gap_frames_max = gap_frames;
+     }
+ 
+     uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+     if (hit) {
+         g_stats.hits++;
+         g_stats.hit_switch_us_last = elapsed_us;
+     } else {
+         g_stats.misses++;
+         g_stats.miss_switch_us_last = elapsed_us;
+     }
+ 
+     ESP_LOGI(TAG, "动画播放成功，切换耗时 %lu us，请求到首帧 %lu us，空白帧 %lu，PSRAM峰值增量 %zu 字节",
+              (unsigned long)elapsed_us, (unsigned long)g_stats.first_frame_us_last,
+              (unsigned long)gap_frames, g_stats.switch_psram_peak_bytes);
+     return true;
+ }
+ 
+ // 获取动画互斥锁并等待之前的操作完全完成
+ static bool lottie_op_begin(void)
+ {
      // 获取互斥锁，确保同一时间只有一个动画操作
      if (xSemaphoreTake(g_anim_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
          ESP_LOGE(TAG, "获取互斥锁超时");
@@ -486,152 +832,82 @@
      }
  
      g_anim_busy = true;
+     return true;
+ }
  
-     ESP_LOGI(TAG, "播放动画: %s (%dx%d) 中心偏移: (%d, %d), 当前动画: %d",
-              file_path, width, height, x, y, g_current_anim_type);
- 
-     // 先清理之前的动画（包含同步等待）
-     lottie_manager_stop();
- 
-     // 等待确保LVGL完全处理完删除操作和内存释放
-     // 增加延迟以避免SPI传输队列冲突
-     vTaskDelay(pdMS_TO_TICKS(100));
+ static void lottie_op_end(void)
+ {
+     g_anim_busy = false;
+     xSemaphoreGive(g_anim_mutex);
+ }
  
-     // 第一步：在锁外读取文件到内存（耗时操作）
-     FILE *fp = fopen(file_path, "rb");
-     if (!fp) {
-         ESP_LOGE(TAG, "无法打开文件: %s", file_path);
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
+ bool lottie_manager_play(const char *file_path, uint16_t width, uint16_t height)
+ {
+     if (!g_initialized) {
+         ESP_LOGE(TAG, "管理器未初始化");
          return false;
      }
  
-     fseek(fp, 0, SEEK_END);
-     size_t file_size = ftell(fp);
-     fseek(fp, 0, SEEK_SET);
- 
-     uint8_t *file_data = (uint8_t *)heap_caps_malloc(file_size, MALLOC_CAP_SPIRAM);
-     if (!file_data) {
-         ESP_LOGE(TAG, "文件缓冲区分配失败 (需要 %zu 字节)", file_size);
-         fclose(fp);
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
+     if (!file_path) {
+         ESP_LOGE(TAG, "文件路径无效");
          return false;
      }
  
-     size_t read_size = fread(file_data, 1, file_size, fp);
-     fclose(fp);
- 
-     if (read_size != file_size) {
-         ESP_LOGE(TAG, "文件读取失败");
-         heap_caps_free(file_data);
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
+     if (!lottie_op_begin()) {
          return false;
      }
  
-     // 第二步：在锁内操作LVGL对象（快速操作）
-     lv_lock();
+     bool result = lottie_play_slot(lottie_find_slot(file_path, width, height),
+                                    file_path, width, height, false, 0, 0, esp_timer_get_time());
  
-     g_lottie_obj = lv_lottie_create(lv_screen_active());
-     if (!g_lottie_obj) {
-         lv_unlock();
-         ESP_LOGE(TAG, "创建 Lottie 对象失败");
-         heap_caps_free(file_data);
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
+     lottie_op_end();
+     return result;
+ }
+ 
+ bool lottie_manager_play_at_pos(const char *file_path, uint16_t width, uint16_t height, int16_t x, int16_t y)
+ {
+     if (!g_initialized) {
+         ESP_LOGE(TAG, "管理器未初始化");
          return false;
      }
  
-     // 分配渲染缓冲区
-     size_t buffer_size = width * height * 4; // ARGB8888
-     g_lottie_buffer = heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
-     if (!g_lottie_buffer) {
-         ESP_LOGE(TAG, "PSRAM缓冲区分配失败 (需要 %zu 字节)", buffer_size);
-         lv_obj_del(g_lottie_obj);
-         lv_unlock();
-         heap_caps_free(file_data);
-         g_lottie_obj = NULL;
-         g_anim_busy = false;
-         xSemaphoreGive(g_anim_mutex);
+     if (!file_path) {
+         ESP_LOGE(TAG, "文件路径无效");
          return false;
      }
  
-     // 设置缓冲区和数据源（使用内存数据，避免文件IO）
-     lv_lottie_set_buffer(g_lottie_obj, width, height, g_lottie_buffer);
-     lv_lottie_set_src_data(g_lottie_obj, file_data, file_size);
-     lv_obj_align(g_lottie_obj, LV_ALIGN_CENTER, x, y);
- 
-     lv_unlock();
- 
-     // 释放文件数据（已被ThorVG解析）
-     heap_caps_free(file_data);
+     if (!lottie_op_begin()) {
+         return false;
+     }
  
-     ESP_LOGI(TAG, "动画播放成功，中心对齐偏移: (%d, %d)", x, y);
+     bool result = lottie_play_slot(lottie_find_slot(file_path, width, height),
+                                    file_path, width, height, true, x, y, esp_timer_get_time());
  
-     g_anim_busy = false;
-     xSemaphoreGive(g_anim_mutex);
-     return true;
+     lottie_op_end();
+     return result;
  }
  
  void lottie_manager_stop(void)
  {
-     if (g_lottie_obj) {
-         ESP_LOGI(TAG, "停止动画");
- 
-         // 先隐藏对象，避免在删除过程中继续渲染
-         lv_lock();
-         lv_obj_add_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
-         lv_obj_invalidate(g_lottie_obj);  // 标记需要重绘
-         lv_unlock();
- 
-         // 【关键修复】等待所有LVGL刷新和DMA传输完成
-         // 这样可以确保在删除对象前，所有屏幕刷新的DMA都已完成
-         lv_display_t *disp = lv_display_get_default();
-         if (disp) {
-             uint32_t wait_count = 0;
-             const uint32_t max_wait_ms = 500;  // 最多等待500ms
-             const uint32_t check_interval_ms = 10;
- 
-             // 循环等待直到显示器空闲（无刷新活动）
-             while (wait_count < max_wait_ms) {
-                 vTaskDelay(pdMS_TO_TICKS(check_interval_ms));
- 
-                 uint32_t inactive_time = lv_display_get_inactive_time(disp);
-                 // ⚠️ 增加空闲阈值到500ms，更保守地删除对象
-                 if (inactive_time > 500) {
-                     ESP_LOGI(TAG, "LVGL显示已空闲 %lu ms，安全删除", inactive_time);
-                     break;
-                 }
- 
-                 wait_count += check_interval_ms;
-             }
+     if (!g_lottie_obj) {
+         return;
+     }
  
-             if (wait_count >= max_wait_ms) {
-                 ESP_LOGW(TAG, "等待LVGL空闲超时，强制删除");
-             }
-         } else {
-             // 后备方案：如果无法获取display，使用固定延迟
-             vTaskDelay(pdMS_TO_TICKS(200));
-         }
+     ESP_LOGI(TAG, "停止动画");
  
-         // 安全删除LVGL对象（增加延迟避免释放后使用）
+     if (g_active_slot >= 0) {
+         // 缓存对象：仅隐藏，保留解析结果以便下次直接重新绑定
+         // （lv_lottie 对不可见对象只推进帧号，不进行渲染）
          lv_lock();
-         lv_obj_del(g_lottie_obj);
+         lv_obj_add_flag(g_lottie_obj, LV_OBJ_FLAG_HIDDEN);
          lv_unlock();
-         g_lottie_obj = NULL;
- 
-         // 增加等待时间，确保LVGL主循环完全处理完删除操作
-         vTaskDelay(pdMS_TO_TICKS(300));
+     } else {
+         lottie_destroy_object(g_lottie_obj, g_lottie_buffer);
      }
  
-     if (g_lottie_buffer) {
-         heap_caps_free(g_lottie_buffer);
-         g_lottie_buffer = NULL;
- 
-         // 等待内存完全释放
-         vTaskDelay(pdMS_TO_TICKS(50));
-     }
+     g_lottie_obj = NULL;
+     g_lottie_buffer = NULL;
+     g_active_slot = -1;
  }
  
  void lottie_manager_hide(void)
@@ -684,6 +960,7 @@
  
      lottie_cmd_t cmd;
      cmd.type = LOTTIE_CMD_PLAY;
+     cmd.request_us = esp_timer_get_time();
      cmd.data.play.anim_type = anim_type;
  
      if (xQueueSend(g_cmd_queue, &cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
@@ -709,6 +986,7 @@
  
      lottie_cmd_t cmd;
      cmd.type = LOTTIE_CMD_PLAY_AT_POS;
+     cmd.request_us = esp_timer_get_time();
      cmd.data.play_at_pos.anim_type = anim_type;
      cmd.data.play_at_pos.x = x;
      cmd.data.play_at_pos.y = y;
@@ -722,6 +1000,32 @@
      return true;
  }
  
+ bool lottie_manager_preload_anim(int anim_type)
+ {
+     if (!g_initialized || !g_cmd_queue) {
+         ESP_LOGE(TAG, "管理器未初始化");
+         return false;
+     }
+ 
+     if (anim_type < 0 || anim_type >= ANIM_CONFIG_COUNT) {
+         ESP_LOGE(TAG, "无效的动画类型: %d", anim_type);
+         return false;
+     }
+ 
+     lottie_cmd_t cmd;
+     cmd.type = LOTTIE_CMD_PRELOAD;
+     cmd.request_us = esp_timer_get_time();
+     cmd.data.play.anim_type = anim_type;
+ 
+     if (xQueueSend(g_cmd_queue, &cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+         ESP_LOGE(TAG, "发送预加载命令失败，动画类型: %d", anim_type);
+         return false;
+     }
+ 
+     ESP_LOGI(TAG, "预加载命令已发送，动画类型: %d", anim_type);
+     return true;
+ }
+ 
  void lottie_manager_stop_anim(int anim_type)
  {
      if (!g_initialized || !g_cmd_queue) {
@@ -787,6 +1091,100 @@
          ESP_LOGE(TAG, "发送隐藏图片命令失败");
      }
  }
+ 
+ esp_err_t lottie_manager_cache_pin(int anim_type, bool pinned)
+ {
+     if (!g_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+ 
+     if (anim_type < 0 || anim_type >= ANIM_CONFIG_COUNT) {
+         return ESP_ERR_INVALID_ARG;
+     }
+ 
+     if (xSemaphoreTake(g_anim_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+         return ESP_ERR_TIMEOUT;
+     }
+     g_cache_entries[anim_type].pinned = pinned;
+     xSemaphoreGive(g_anim_mutex);
+ 
+     ESP_LOGI(TAG, "动画 %d %s", anim_type, pinned ? "已常驻缓存" : "取消常驻");
+     return ESP_OK;
+ }
+ 
+ esp_err_t lottie_manager_get_stats(xn_lottie_stats_t *stats)
+ {
+     if (!stats) {
+         return ESP_ERR_INVALID_ARG;
+     }
+ 
+     if (!g_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+ 
+     if (xSemaphoreTake(g_anim_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+         return ESP_ERR_TIMEOUT;
+     }
+ 
+     *stats = g_stats;
+     stats->used_bytes = g_cache.used;
+ 
+     // 当前动画的预渲染帧缓存 / 帧包
+     lottie_frame_cache_stats_t frames = {0};
+     lottie_sprite_stats_t sprite = {0};
+     lottie_render_target_stats_t target = {0};
+     lv_lock();
+     stats->frame_cache_enabled = lottie_frame_cache_get_stats(g_lottie_obj, &frames);
+     stats->sprite_enabled = lottie_sprite_get_stats(g_lottie_obj, &sprite);
+     lottie_render_target_get_stats(g_lottie_obj, &target);
+     lv_unlock();
+     stats->render_convert_us_avg = target.convert_us_avg;
+     stats->gov_fps = target.gov.fps;
+     stats->gov_fps_cap = target.gov.cap_fps;
+     stats->gov_achieved_fps_x10 = target.gov.achieved_fps_x10;
+     stats->gov_rendered_frames = target.gov.rendered;
+     stats->gov_skipped_frames = target.gov.skipped;
+     stats->render_us_p50 = target.gov.render_us_p50;
+     stats->render_us_p90 = target.gov.render_us_p90;
+     stats->render_us_p99 = target.gov.render_us_p99;
+     stats->render_scratch_bytes = lottie_render_scratch_bytes();
+     stats->sprite_frames = sprite.frame_count;
+     stats->sprite_pack_bytes = sprite.pack_bytes;
+     stats->sprite_decode_us_avg = sprite.decode_us_avg;
+     stats->frame_cache_frames = frames.frames_cached;
+     stats->frame_total_frames = frames.frame_count;
+     stats->frame_cache_bytes = frames.used_bytes;
+     stats->frame_live_us_avg = frames.live_us_avg;
+     stats->frame_blit_us_avg = frames.blit_us_avg;
+     stats->budget_bytes = LOTTIE_CACHE_BUDGET_BYTES;
+     stats->entries = 0;
+     for (int i = 0; i < ANIM_CONFIG_COUNT; i++) {
+         if (g_cache_entries[i].obj) {
+             stats->entries++;
+         }
+     }
+ 
+     xSemaphoreGive(g_anim_mutex);
+     return ESP_OK;
+ }
+ 
+ esp_err_t lottie_manager_get_pool_stats(xn_lottie_pool_stats_t *stats)
+ {
+     if (!stats) {
+         return ESP_ERR_INVALID_ARG;
+     }
+ 
+     if (!g_initialized) {
+         return ESP_ERR_INVALID_STATE;
+     }
+ 
+     if (xSemaphoreTake(g_anim_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+         return ESP_ERR_TIMEOUT;
+     }
+     lottie_buffer_pool_get_stats(stats);
+     xSemaphoreGive(g_anim_mutex);
+     return ESP_OK;
+ }
 
 // ---------------- Lottie 应用初始化封装 ----------------
 
@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Lottie JSON 预处理
+
+构建时由 xn_lottie_manager/CMakeLists.txt 在帧包编译之前调用，把 lottie_spiffs/ 下的
+JSON 处理后写入中间目录（其他文件原样复制）：
+  1. 删除编辑器元数据（meta、nm、mn 等）和取默认值的字段，输出紧凑 JSON；
+  2. 删除隐藏（hd）的图层/形状、根合成时间范围之外的图层、未被引用的资源；
+  3. 把关键帧数值按精度取整（坐标 --precision 位小数，颜色/时间/缓动曲线更高精度）；
+  4. 有 rlottie-python 时逐帧渲染原文件与处理后文件，最大像素误差超过
+     --max-pixel-error 时提高精度重试，仍超出则只做无损处理；
+  5. 打印每个文件的大小变化以及主机端解析耗时与峰值内存。
+
+没有 rlottie-python 时无法验证画面，只做无损处理（1、2 步），构建不会失败。
+设备端解析耗时与堆占用见 lottie_manager_get_stats() 的 parse_us_last / parse_heap_bytes_last。
+"""
+
+import argparse
+import array
+import json
+import os
+import shutil
+import sys
+import time
+import tracemalloc
+
+# 只有编辑器/表达式使用、ThorVG 渲染不读取的字段
+META_KEYS = ('meta', 'nm', 'mn', 'cl', 'ln', 'tg')
+# 值等于默认值时可以省略的字段
+DEFAULT_KEYS = {'ddd': 0, 'ao': 0, 'bm': 0, 'sr': 1, 'hd': False}
+# 按高精度取整的字段：时间、颜色、渐变
+TIME_KEYS = ('t', 'ip', 'op', 'st', 'fr', 'tm')
+COLOR_KEYS = ('c', 'g', 'sc', 'fc')
+
+MAX_PRECISION = 4
+
+
+def log(msg):
+    print('[lottie_json] ' + msg)
+
+
+def strip_meta(node):
+    """删除元数据与默认值字段（文本图层内容、标记名称保持原样）"""
+    if isinstance(node, list):
+        return [strip_meta(v) for v in node]
+    if not isinstance(node, dict):
+        return node
+
+    out = {}
+    for key, value in node.items():
+        if key in META_KEYS:
+            continue
+        if key in DEFAULT_KEYS and value == DEFAULT_KEYS[key] and type(value) is type(DEFAULT_KEYS[key]):
+            continue
+        # 动画属性上的 "l"（表达式维度）与 "ix"（表达式索引）
+        if key in ('l', 'ix') and 'k' in node:
+            continue
+        out[key] = value if key == 't' and isinstance(value, dict) else strip_meta(value)
+    return out
+
+
+def prune_shapes(shapes):
+    kept = []
+    for shape in shapes:
+        if shape.get('hd') is True:
+            continue
+        if shape.get('ty') == 'gr' and isinstance(shape.get('it'), list):
+            shape['it'] = prune_shapes(shape['it'])
+        kept.append(shape)
+    return kept
+
+
+def prune_layers(layers, comp_ip=None, comp_op=None):
+    """删除隐藏图层与时间范围外的图层；被 parent 引用或作为遮罩源的图层保留"""
+    referenced = set(l.get('parent') for l in layers if 'parent' in l)
+    kept = []
+    removed = 0
+    for i, layer in enumerate(layers):
+        needed = layer.get('ind') in referenced or layer.get('td', 0) != 0
+        # 遮罩源（td）由下一个带 tt 的图层使用，遮罩源本身即使隐藏也要保留
+        hidden = layer.get('hd') is True
+        out_of_range = (comp_ip is not None and 'ip' in layer and 'op' in layer and
+                        (layer['op'] <= comp_ip or layer['ip'] >= comp_op or layer['ip'] >= layer['op']))
+        if not needed and (hidden or out_of_range):
+            removed += 1
+            continue
+        if isinstance(layer.get('shapes'), list):
+            layer['shapes'] = prune_shapes(layer['shapes'])
+        kept.append(layer)
+    return kept, removed
+
+
+def collect_refs(node, refs):
+    if isinstance(node, dict):
+        if isinstance(node.get('refId'), str):
+            refs.add(node['refId'])
+        for value in node.values():
+            collect_refs(value, refs)
+    elif isinstance(node, list):
+        for value in node:
+            collect_refs(value, refs)
+
+
+def prune(doc):
+    """返回删除的图层数与资源数"""
+    removed_layers = 0
+    # 预合成内部的时间会被 st / tm 重映射，只按根合成的时间范围裁剪根图层
+    doc['layers'], n = prune_layers(doc.get('layers', []), doc.get('ip'), doc.get('op'))
+    removed_layers += n
+    for asset in doc.get('assets', []):
+        if isinstance(asset.get('layers'), list):
+            asset['layers'], n = prune_layers(asset['layers'])
+            removed_layers += n
+
+    # 资源可以被其他资源引用，反复收集直到稳定
+    assets = doc.get('assets', [])
+    removed_assets = 0
+    while True:
+        refs = set()
+        collect_refs(doc.get('layers', []), refs)
+        for asset in assets:
+            collect_refs(asset.get('layers', []), refs)
+        kept = [a for a in assets if a.get('id') in refs]
+        if len(kept) == len(assets):
+            break
+        removed_assets += len(assets) - len(kept)
+        assets = kept
+    if 'assets' in doc:
+        doc['assets'] = assets
+    return removed_layers, removed_assets
+
+
+def round_number(value, digits):
+    rounded = round(value, digits)
+    if rounded == int(rounded):
+        return int(rounded)
+    return rounded
+
+
+def quantize(node, precision, fine_precision, key=None):
+    """数值取整：时间、颜色、缓动曲线使用 fine_precision，其余使用 precision"""
+    if isinstance(node, float):
+        fine = key in TIME_KEYS or key in COLOR_KEYS or key == 'easing'
+        return round_number(node, fine_precision if fine else precision)
+    if isinstance(node, list):
+        return [quantize(v, precision, fine_precision, key) for v in node]
+    if isinstance(node, dict):
+        out = {}
+        for k, v in node.items():
+            if k in ('i', 'o') and isinstance(v, dict):
+                child_key = 'easing'   # 关键帧缓动控制点（0~1）
+            elif key in COLOR_KEYS and k == 'k':
+                child_key = key        # 颜色/渐变属性的值
+            elif key in COLOR_KEYS or key == 'easing':
+                child_key = key
+            else:
+                child_key = k
+            out[k] = quantize(v, precision, fine_precision, child_key)
+        return out
+    return node
+
+
+def dump(doc):
+    return json.dumps(doc, separators=(',', ':'), ensure_ascii=False).encode('utf-8')
+
+
+def parse_cost(data, runs=5):
+    """主机端解析耗时（微秒，取多次最小值）与峰值内存（字节）"""
+    best = None
+    for _ in range(runs):
+        start = time.perf_counter()
+        json.loads(data)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+
+    tracemalloc.start()
+    json.loads(data)
+    _, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+    return int(best * 1e6), peak
+
+
+def rlottie_load_us(renderer, data):
+    if renderer is None:
+        return None
+    start = time.perf_counter()
+    renderer.from_data(data.decode('utf-8'))
+    return int((time.perf_counter() - start) * 1e6)
+
+
+def render_frames(renderer, data, size, frames):
+    anim = renderer.from_data(data.decode('utf-8'))
+    total = anim.lottie_animation_get_totalframe()
+    w, h = anim.lottie_animation_get_size()
+    scale = min(1.0, float(size) / max(w, h))
+    width, height = max(1, int(w * scale)), max(1, int(h * scale))
+    out = []
+    for i in range(frames):
+        frame = min(total - 1, i * total // frames)
+        out.append(anim.lottie_animation_render(frame_num=frame, width=width, height=height))
+    return out
+
+
+def max_pixel_error(renderer, original, candidate, size, frames):
+    """逐帧逐通道比较，返回最大差值（0~255）"""
+    a = render_frames(renderer, original, size, frames)
+    b = render_frames(renderer, candidate, size, frames)
+    worst = 0
+    for fa, fb in zip(a, b):
+        if len(fa) != len(fb):
+            return 255
+        if fa == fb:
+            continue
+        xa, xb = array.array('B', fa), array.array('B', fb)
+        worst = max(worst, max(abs(x - y) for x, y in zip(xa, xb)))
+    return worst
+
+
+def optimize(data, args, renderer):
+    """返回 (输出数据, 说明)"""
+    doc = strip_meta(json.loads(data))
+    layers, assets = prune(doc)
+    lossless = dump(doc)
+    note = 'pruned %d layers %d assets' % (layers, assets)
+
+    if renderer is None:
+        return lossless, note + ', lossless (no rlottie to verify quantization)'
+
+    for precision in range(args.precision, MAX_PRECISION + 1):
+        fine = max(precision + 1, args.fine_precision)
+        candidate = dump(quantize(doc, precision, fine))
+        err = max_pixel_error(renderer, data, candidate, args.check_size, args.check_frames)
+        if err <= args.max_pixel_error:
+            return candidate, note + ', precision %d/%d, max err %d' % (precision, fine, err)
+        log('  precision %d: max pixel error %d > %d, retrying' % (precision, err, args.max_pixel_error))
+    return lossless, note + ', lossless (quantization exceeds pixel error)'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Minify, prune and quantize Lottie JSON files')
+    parser.add_argument('--src', required=True, help='lottie_spiffs source directory')
+    parser.add_argument('--out', required=True, help='output directory (recreated)')
+    parser.add_argument('--precision', type=int, default=2, help='decimal places for coordinates/values')
+    parser.add_argument('--fine-precision', type=int, default=3, help='decimal places for time, color and easing')
+    parser.add_argument('--max-pixel-error', type=int, default=8, help='max per-channel difference (0-255)')
+    parser.add_argument('--check-size', type=int, default=200, help='render size used for the visual check')
+    parser.add_argument('--check-frames', type=int, default=12, help='frames sampled for the visual check')
+    args = parser.parse_args()
+
+    try:
+        from rlottie_python import LottieAnimation as renderer
+    except ImportError:
+        renderer = None
+        log('warning: rlottie-python not installed, quantization disabled')
+
+    if os.path.isdir(args.out):
+        shutil.rmtree(args.out)
+    os.makedirs(args.out)
+
+    total_before = total_after = 0
+    log('%-20s %7s %7s %6s %12s %14s %12s' % ('file', 'before', 'after', 'saved', 'parse_us', 'peak_bytes', 'rlottie_us'))
+    for name in sorted(os.listdir(args.src)):
+        src_path = os.path.join(args.src, name)
+        dst_path = os.path.join(args.out, name)
+        if not name.endswith('.json') or not os.path.isfile(src_path):
+            if os.path.isfile(src_path):
+                shutil.copyfile(src_path, dst_path)
+            continue
+
+        with open(src_path, 'rb') as f:
+            data = f.read()
+        try:
+            result, note = optimize(data, args, renderer)
+        except Exception as e:  # 单个文件失败时原样复制
+            log('warning: %s failed: %s, copied unchanged' % (name, e))
+            result, note = data, 'unchanged'
+
+        with open(dst_path, 'wb') as f:
+            f.write(result)
+
+        before_us, before_peak = parse_cost(data)
+        after_us, after_peak = parse_cost(result)
+        before_rl, after_rl = rlottie_load_us(renderer, data), rlottie_load_us(renderer, result)
+        saved = 100 - len(result) * 100 // max(1, len(data))
+        log('%-20s %7d %7d %5d%% %12s %14s %12s' % (
+            name, len(data), len(result), saved, '%d->%d' % (before_us, after_us),
+            '%d->%d' % (before_peak, after_peak),
+            '-' if before_rl is None else '%d->%d' % (before_rl, after_rl)))
+        log('  ' + note)
+        total_before += len(data)
+        total_after += len(result)
+
+    if total_before:
+        log('total: %d -> %d bytes (-%d%%)' % (total_before, total_after,
+                                                100 - total_after * 100 // total_before))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
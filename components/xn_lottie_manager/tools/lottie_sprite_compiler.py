@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Lottie 帧包（sprite）编译器
+
+构建时由 xn_lottie_manager/CMakeLists.txt 调用：
+  1. 把 --src 目录（lottie_json_optimizer.py 处理后的 lottie_spiffs/）下的所有文件复制到 SPIFFS 镜像目录；
+  2. 解析 src/lottie_anim_configs.h 中的 anim_configs 表，对 sprite 字段为 true 的动画
+     按其宽高光栅化为帧包 <name>_<w>x<h>.spr，格式见 src/lottie_sprite_player.h；
+  3. 打印 JSON 与帧包的 Flash 占用对比。
+
+--all 为表中每个动画生成帧包（不论 sprite 字段），供主机基准（xn_lvgl_driver/host_test 的
+bench_tile_skip 等）回放真实动画帧，输出目录不要打包进 SPIFFS 镜像。
+
+光栅化依赖 rlottie-python（pip install rlottie-python）。未安装时只复制 JSON，
+设备端找不到帧包会自动回退到实时渲染，构建不会失败。
+"""
+
+import argparse
+import array
+import math
+import os
+import re
+import shutil
+import struct
+import sys
+
+SPRITE_MAGIC = 0x52505358  # "XSPR"
+SPRITE_VERSION = 1
+SPRITE_FLAG_ALPHA = 0x0001
+RLE_MAX_PACKET = 128
+
+# anim_configs 表项：[LOTTIE_ANIM_X] = {"/lottie/a.json", w, h, pinned, prerender, sprite, ...},
+CONFIG_RE = re.compile(
+    r'\[\s*(LOTTIE_ANIM_\w+)\s*\]\s*=\s*\{\s*"/lottie/([^"]+)"\s*,\s*(\d+)\s*,\s*(\d+)\s*,'
+    r'\s*(true|false)\s*,\s*(true|false)\s*,\s*(true|false)\s*[,}]')
+# 所有 [LOTTIE_ANIM_X] = 初始化项，用于校验 CONFIG_RE 没有漏项
+INITIALIZER_RE = re.compile(r'\[\s*(LOTTIE_ANIM_\w+)\s*\]\s*=')
+
+
+def log(msg):
+    print('[lottie_sprite] ' + msg)
+
+
+def parse_anim_configs(source, all_entries=False):
+    """返回需要编译帧包的 (json 文件名, 宽, 高) 列表，按表顺序去重；all_entries 为真时不看 sprite 字段
+
+    表项格式变化导致 CONFIG_RE 漏匹配时抛出 ValueError，避免帧包被静默跳过
+    """
+    with open(source, 'r', encoding='utf-8') as f:
+        text = f.read()
+
+    matches = list(CONFIG_RE.finditer(text))
+    initializers = INITIALIZER_RE.findall(text)
+    if not initializers:
+        raise ValueError('%s: no [LOTTIE_ANIM_*] initializers found' % source)
+    if len(matches) != len(initializers):
+        matched = set(m.group(1) for m in matches)
+        missing = [name for name in initializers if name not in matched]
+        raise ValueError('%s: parsed %d of %d anim_configs entries, unrecognized: %s'
+                         % (source, len(matches), len(initializers), ', '.join(missing) or '?'))
+
+    targets = []
+    for m in matches:
+        name, json_name, w, h, sprite = m.group(1), m.group(2), int(m.group(3)), int(m.group(4)), m.group(7)
+        if sprite != 'true' and not all_entries:
+            continue
+        target = (json_name, w, h)
+        if target not in targets:
+            targets.append(target)
+            log('%s -> %s %dx%d' % (name, json_name, w, h))
+    return targets
+
+
+def rgb565(p):
+    return ((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F)
+
+
+def rle_encode(values, elem_bytes):
+    """与 lottie_rle.c 的 rle_encode() 一致"""
+    out = bytearray()
+    fmt = '<H' if elem_bytes == 2 else '<B'
+    count = len(values)
+    i = 0
+    while i < count:
+        v = values[i]
+        run = 1
+        while i + run < count and run < RLE_MAX_PACKET and values[i + run] == v:
+            run += 1
+        if run >= 2:
+            out.append(0x80 | (run - 1))
+            out += struct.pack(fmt, v)
+            i += run
+            continue
+
+        header = len(out)
+        out.append(0)
+        length = 0
+        while i < count and length < RLE_MAX_PACKET:
+            cur = values[i]
+            if length > 0 and i + 1 < count and values[i + 1] == cur:
+                break
+            out += struct.pack(fmt, cur)
+            i += 1
+            length += 1
+        out[header] = length - 1
+    return bytes(out)
+
+
+def encode_frame(argb):
+    rgb = rle_encode([rgb565(p) for p in argb], 2)
+    alpha_values = [p >> 24 for p in argb]
+    alpha = b'' if all(a == 0xFF for a in alpha_values) else rle_encode(alpha_values, 1)
+    return rgb, alpha
+
+
+def compile_sprite(renderer, json_path, width, height, max_fps):
+    anim = renderer.from_file(json_path)
+    total = anim.lottie_animation_get_totalframe()
+    src_fps = anim.lottie_animation_get_framerate()
+    if total <= 0 or src_fps <= 0:
+        raise ValueError('invalid frame count / frame rate')
+
+    # 屏幕刷新率有限，按 max_fps 抽帧以控制帧包大小
+    fps = min(src_fps, max_fps)
+    frame_count = max(1, int(math.floor(total * fps / src_fps)))
+    if frame_count > 0xFFFF:
+        raise ValueError('too many frames')
+
+    frames = []
+    for i in range(frame_count):
+        src_frame = min(total - 1, int(round(i * src_fps / fps)))
+        # rlottie 输出预乘 ARGB32（小端内存顺序 BGRA），与 ThorVG 输出到 lv_lottie 缓冲区的格式一致
+        data = anim.lottie_animation_render(frame_num=src_frame, width=width, height=height)
+        pixels = array.array('I', data)
+        if sys.byteorder != 'little':
+            pixels.byteswap()
+        frames.append(encode_frame(pixels))
+
+    with_alpha = any(alpha for _, alpha in frames)
+    index = bytearray()
+    body = bytearray()
+    for rgb, alpha in frames:
+        if with_alpha and not alpha:
+            alpha = rle_encode([0xFF] * (width * height), 1)
+        index += struct.pack('<III', len(body), len(rgb), len(alpha))
+        body += rgb + alpha
+
+    header = struct.pack('<IHHHHHH', SPRITE_MAGIC, SPRITE_VERSION,
+                         SPRITE_FLAG_ALPHA if with_alpha else 0,
+                         width, height, frame_count, int(round(fps * 100)))
+    return header + bytes(index) + bytes(body), frame_count, fps
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile Lottie JSON into sprite frame packs')
+    parser.add_argument('--src', required=True, help='lottie_spiffs source directory')
+    parser.add_argument('--out', required=True, help='SPIFFS image staging directory')
+    parser.add_argument('--configs', required=True, help='lottie_anim_configs.h containing anim_configs')
+    parser.add_argument('--budget', type=int, default=0, help='total bytes allowed for sprite packs (0 = unlimited)')
+    parser.add_argument('--max-fps', type=float, default=20.0, help='frame rate cap for sprite packs')
+    parser.add_argument('--all', action='store_true', help='compile every anim_configs entry (host benchmarks)')
+    args = parser.parse_args()
+
+    if os.path.isdir(args.out):
+        shutil.rmtree(args.out)
+    shutil.copytree(args.src, args.out)
+
+    try:
+        targets = parse_anim_configs(args.configs, args.all)
+    except ValueError as e:
+        log('error: %s' % e)
+        return 1
+    if not targets:
+        return 0
+
+    try:
+        from rlottie_python import LottieAnimation
+    except ImportError:
+        log('warning: rlottie-python not installed, sprite packs skipped (devices fall back to live Lottie)')
+        return 0
+
+    used = 0
+    log('%-28s %10s %10s %8s' % ('sprite', 'json', 'pack', 'frames'))
+    for json_name, width, height in targets:
+        json_path = os.path.join(args.src, json_name)
+        sprite_name = '%s_%dx%d.spr' % (os.path.splitext(json_name)[0], width, height)
+        try:
+            pack, frame_count, fps = compile_sprite(LottieAnimation, json_path, width, height, args.max_fps)
+        except Exception as e:  # 单个动画失败不影响其他动画
+            log('warning: %s failed: %s' % (sprite_name, e))
+            continue
+
+        if args.budget and used + len(pack) > args.budget:
+            log('warning: %s (%d bytes) exceeds sprite budget %d/%d, skipped'
+                % (sprite_name, len(pack), used, args.budget))
+            continue
+
+        with open(os.path.join(args.out, sprite_name), 'wb') as f:
+            f.write(pack)
+        used += len(pack)
+        log('%-28s %10d %10d %5d@%.2f' % (sprite_name, os.path.getsize(json_path), len(pack), frame_count, fps))
+
+    log('sprite packs total: %d bytes' % used)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
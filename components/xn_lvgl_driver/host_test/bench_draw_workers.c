@@ -0,0 +1,299 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\bench_draw_workers.c
+ * @Description: 分块并行绘制基准：同一页面用 1~N 个绘制任务渲染，输出帧时间与加速比
+ *
+ * 与设备端绘制单元（xn_lvgl_draw.c）使用同一套拆分规则（xn_lvgl_draw.h）：绘制区域够大时按行分成
+ * 最多 N 块，交给各绘制任务（FreeRTOS shim 上的线程）同时执行，最后完成的一块通知等待方；
+ * 不值得拆分的任务在调用方直接执行（相当于 LVGL 软件绘制单元）。绘制函数用驱动的像素内核代替
+ * lv_draw_sw：填充逐像素写颜色，图像用 LVGL 混合钩子 lvgl_pixel_blend_image_argb8888_to_rgb565。
+ * 页面：
+ * - lottie：整屏背景填充 + 400×400 ARGB8888 Lottie 帧（合成场景的表情）
+ * - dice_result：整屏背景填充 + 6 个 90×90 骰子方块 + 点数（18×18，太小不拆分）
+ * 每个页面分别按局部渲染（LVGL_BUFFER_SIZE 条带，每条 16 行，最多拆成 2 块）与直接渲染（整屏一次）执行。
+ * 各个工作任务数的结果必须与 1 个（不拆分）逐像素一致。
+ *
+ *   bench_draw_workers [最大任务数] [帧数]     默认 4 个、20 帧
+ *
+ * 加速比是本机的：shim 不设置核心亲和性，与 ESP32-S3 双核的 LVGL_DRAW_TILE_CORES 绑定不同，
+ * 设备上的收益要用 lvgl_driver_get_frame_timing() 的渲染耗时确认。
+ */
+#include "bench_scene.h"
+#include "xn_lvgl_draw.h"
+#include "xn_lvgl_pixel.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SCREEN_PIXELS       (EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT)
+#define BENCH_MAX_WORKERS   16
+#define BENCH_MAX_JOBS      64
+#define LOTTIE_SIZE         400
+#define DICE_SIZE           90
+#define DICE_GAP            18
+#define PIP_SIZE            18
+
+/** 绘制任务（填充或图像），坐标为屏幕坐标 */
+typedef struct {
+    bool image;
+    lv_area_t area;
+    uint16_t color;
+    const uint32_t *src;        // ARGB8888，行跨度为区域宽度
+} bench_job_t;
+
+typedef struct {
+    const char *name;
+    bench_job_t jobs[BENCH_MAX_JOBS];
+    int count;
+} bench_page_t;
+
+/** 绘制目标：层缓冲区及其屏幕区域 */
+typedef struct {
+    uint16_t *buf;
+    lv_area_t area;
+    int32_t stride;             // 像素
+} bench_layer_t;
+
+typedef struct {
+    TaskHandle_t handle;
+    lv_area_t clip;
+} bench_worker_t;
+
+static bench_worker_t s_workers[BENCH_MAX_WORKERS];
+static const bench_job_t *volatile s_job;
+static const bench_layer_t *volatile s_layer;
+static uint32_t s_pending;
+static uint32_t s_bands;            // 拆分出的块数（累计）
+static SemaphoreHandle_t s_done;
+
+static uint16_t s_screen[SCREEN_PIXELS];
+static uint16_t s_reference[SCREEN_PIXELS];
+static uint16_t s_strip[LVGL_BUFFER_SIZE];
+static uint32_t s_lottie[LOTTIE_SIZE * LOTTIE_SIZE];
+
+/* 在裁剪区域内执行一个绘制任务 */
+static void job_run(const bench_job_t *job, const bench_layer_t *layer, const lv_area_t *clip)
+{
+    lv_area_t a = {
+        .x1 = LV_MAX(job->area.x1, clip->x1), .y1 = LV_MAX(job->area.y1, clip->y1),
+        .x2 = LV_MIN(job->area.x2, clip->x2), .y2 = LV_MIN(job->area.y2, clip->y2),
+    };
+    if (a.x1 > a.x2 || a.y1 > a.y2) {
+        return;
+    }
+
+    int32_t w = lv_area_get_width(&a);
+    uint16_t *dst = layer->buf + (size_t)(a.y1 - layer->area.y1) * layer->stride + (a.x1 - layer->area.x1);
+    if (job->image) {
+        int32_t src_w = lv_area_get_width(&job->area);
+        const uint32_t *src = job->src + (size_t)(a.y1 - job->area.y1) * src_w + (a.x1 - job->area.x1);
+        lvgl_pixel_blend_image_argb8888_to_rgb565(dst, layer->stride * 2, src, src_w * 4,
+                                                  w, lv_area_get_height(&a), 255);
+        return;
+    }
+    for (int32_t y = a.y1; y <= a.y2; y++, dst += layer->stride) {
+        for (int32_t x = 0; x < w; x++) {
+            dst[x] = job->color;
+        }
+    }
+}
+
+/* 与设备端绘制任务相同：等通知，执行自己的块，最后一块完成时通知 */
+static void worker_task(void *arg)
+{
+    bench_worker_t *w = arg;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        job_run(s_job, s_layer, &w->clip);
+        if (__atomic_sub_fetch(&s_pending, 1, __ATOMIC_ACQ_REL) == 0) {
+            xSemaphoreGive(s_done);
+        }
+    }
+}
+
+/* 渲染层缓冲区：可拆分的任务分给 workers 个绘制任务，返回拆分的任务数 */
+static uint32_t layer_render(const bench_page_t *page, const bench_layer_t *layer, int32_t workers)
+{
+    uint32_t split = 0;
+
+    for (int i = 0; i < page->count; i++) {
+        const bench_job_t *job = &page->jobs[i];
+        lv_area_t area = {
+            .x1 = LV_MAX(job->area.x1, layer->area.x1), .y1 = LV_MAX(job->area.y1, layer->area.y1),
+            .x2 = LV_MIN(job->area.x2, layer->area.x2), .y2 = LV_MIN(job->area.y2, layer->area.y2),
+        };
+        if (area.x1 > area.x2 || area.y1 > area.y2) {
+            continue;
+        }
+        int32_t n = workers > 1 && lvgl_draw_tile_splittable(&area) ? lvgl_draw_tile_band_count(&area, workers) : 1;
+        if (n == 1) {
+            job_run(job, layer, &area);
+            continue;
+        }
+
+        s_job = job;
+        s_layer = layer;
+        __atomic_store_n(&s_pending, (uint32_t)n, __ATOMIC_RELEASE);
+        for (int32_t b = 0; b < n; b++) {
+            s_workers[b].clip = lvgl_draw_tile_band(&area, n, b);
+            xTaskNotifyGive(s_workers[b].handle);
+        }
+        xSemaphoreTake(s_done, portMAX_DELAY);
+        split++;
+        s_bands += (uint32_t)n;
+    }
+    return split;
+}
+
+/* 渲染一帧到 s_screen：局部渲染逐条带渲染后复制，直接渲染整屏一次 */
+static uint32_t frame_render(const bench_page_t *page, bool direct, int32_t workers)
+{
+    if (direct) {
+        bench_layer_t layer = {s_screen, {0, 0, EXAMPLE_LCD_WIDTH - 1, EXAMPLE_LCD_HEIGHT - 1}, EXAMPLE_LCD_WIDTH};
+        return layer_render(page, &layer, workers);
+    }
+
+    uint32_t split = 0;
+    int32_t rows = bench_strip_rows(EXAMPLE_LCD_WIDTH);
+    for (int32_t y = 0; y < EXAMPLE_LCD_HEIGHT; y += rows) {
+        bench_layer_t layer = {s_strip, {0, y, EXAMPLE_LCD_WIDTH - 1, LV_MIN(y + rows, EXAMPLE_LCD_HEIGHT) - 1},
+                               EXAMPLE_LCD_WIDTH};
+        split += layer_render(page, &layer, workers);
+        memcpy(&s_screen[y * EXAMPLE_LCD_WIDTH], s_strip,
+               (size_t)lv_area_get_height(&layer.area) * EXAMPLE_LCD_WIDTH * 2);
+    }
+    return split;
+}
+
+static void page_add(bench_page_t *page, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color, const uint32_t *src)
+{
+    bench_job_t *job = &page->jobs[page->count++];
+    job->image = src != NULL;
+    job->area = (lv_area_t){x, y, x + w - 1, y + h - 1};
+    job->color = color;
+    job->src = src;
+}
+
+/* Lottie 帧：合成场景表情的第一帧转成 ARGB8888（LVGL 图像为非预乘，这里直接取预乘颜色，只影响颜色不影响耗时） */
+static void lottie_frame_init(void)
+{
+    bench_anim_t anim;
+    uint16_t *rgb = malloc(LOTTIE_SIZE * LOTTIE_SIZE * sizeof(uint16_t));
+    uint8_t *alpha = malloc(LOTTIE_SIZE * LOTTIE_SIZE);
+
+    bench_anim_open_synth(&anim, BENCH_SYNTH_FACE);
+    bench_anim_frame(&anim, 0, rgb, alpha);
+    for (int i = 0; i < LOTTIE_SIZE * LOTTIE_SIZE; i++) {
+        uint32_t r = (rgb[i] >> 11) << 3, g = ((rgb[i] >> 5) & 0x3F) << 2, b = (rgb[i] & 0x1F) << 3;
+        s_lottie[i] = ((uint32_t)alpha[i] << 24) | (r << 16) | (g << 8) | b;
+    }
+    bench_anim_close(&anim);
+    free(rgb);
+    free(alpha);
+}
+
+static void pages_init(bench_page_t *lottie, bench_page_t *dice)
+{
+    // 骰子点数位置（相对方块中心，单位为点距 24 像素）
+    static const int8_t pips[6][6][2] = {
+        {{0, 0}},
+        {{-1, -1}, {1, 1}},
+        {{-1, -1}, {0, 0}, {1, 1}},
+        {{-1, -1}, {1, -1}, {-1, 1}, {1, 1}},
+        {{-1, -1}, {1, -1}, {0, 0}, {-1, 1}, {1, 1}},
+        {{-1, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {1, 1}},
+    };
+
+    lottie->name = "lottie";
+    page_add(lottie, 0, 0, EXAMPLE_LCD_WIDTH, EXAMPLE_LCD_HEIGHT, 0x1082, NULL);
+    page_add(lottie, (EXAMPLE_LCD_WIDTH - LOTTIE_SIZE) / 2, (EXAMPLE_LCD_HEIGHT - LOTTIE_SIZE) / 2,
+             LOTTIE_SIZE, LOTTIE_SIZE, 0, s_lottie);
+
+    dice->name = "dice_result";
+    page_add(dice, 0, 0, EXAMPLE_LCD_WIDTH, EXAMPLE_LCD_HEIGHT, 0x1082, NULL);
+    int32_t x0 = (EXAMPLE_LCD_WIDTH - 3 * DICE_SIZE - 2 * DICE_GAP) / 2;
+    int32_t y0 = (EXAMPLE_LCD_HEIGHT - 2 * DICE_SIZE - DICE_GAP) / 2;
+    for (int d = 0; d < 6; d++) {
+        int32_t x = x0 + (d % 3) * (DICE_SIZE + DICE_GAP);
+        int32_t y = y0 + (d / 3) * (DICE_SIZE + DICE_GAP);
+        page_add(dice, x, y, DICE_SIZE, DICE_SIZE, 0xFFFF, NULL);
+        for (int p = 0; p <= d; p++) {
+            page_add(dice, x + DICE_SIZE / 2 + pips[d][p][0] * 24 - PIP_SIZE / 2,
+                     y + DICE_SIZE / 2 + pips[d][p][1] * 24 - PIP_SIZE / 2, PIP_SIZE, PIP_SIZE, 0x2104, NULL);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int32_t max_workers = argc > 1 ? atoi(argv[1]) : 4;
+    uint32_t frames = argc > 2 ? (uint32_t)atoi(argv[2]) : 20;
+    static const BaseType_t cores[] = LVGL_DRAW_TILE_CORES;
+    bench_page_t pages[2] = {0};
+    int failures = 0;
+
+    max_workers = LV_CLAMP(1, max_workers, BENCH_MAX_WORKERS);
+    frames = LV_MAX(frames, 1u);
+
+    s_done = xSemaphoreCreateBinary();
+    for (int32_t i = 0; i < max_workers; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "lvgl_draw%d", (int)i);
+        // 设备端按 LVGL_DRAW_TILE_CORES 绑核，shim 忽略核心编号
+        BaseType_t core = cores[i % (sizeof(cores) / sizeof(cores[0]))];
+        if (xTaskCreatePinnedToCore(worker_task, name, LVGL_DRAW_TILE_STACK_SIZE, &s_workers[i],
+                                    LVGL_DRAW_TILE_PRIORITY, &s_workers[i].handle, core) != pdPASS) {
+            printf("failed to create worker %d\n", (int)i);
+            return 1;
+        }
+    }
+
+    lottie_frame_init();
+    pages_init(&pages[0], &pages[1]);
+
+    printf("host cpus %ld, %" PRIu32 " frames, min split %d px / %d rows, strip rows %" PRId32 "\n",
+           sysconf(_SC_NPROCESSORS_ONLN), frames, LVGL_DRAW_TILE_MIN_PIXELS, LVGL_DRAW_TILE_MIN_ROWS * 2,
+           bench_strip_rows(EXAMPLE_LCD_WIDTH));
+    printf("%-12s %-8s %7s %8s %6s %9s %8s\n", "page", "mode", "workers", "split/f", "bands", "ms/frame", "speedup");
+
+    for (int p = 0; p < 2; p++) {
+        for (int direct = 0; direct < 2; direct++) {
+            double base_ms = 0;
+            for (int32_t w = 1; w <= max_workers; w++) {
+                uint32_t split = 0;
+                s_bands = 0;
+                uint64_t t0 = bench_now_ns();
+                for (uint32_t f = 0; f < frames; f++) {
+                    split += frame_render(&pages[p], direct, w);
+                }
+                double ms = (bench_now_ns() - t0) / 1e6 / frames;
+
+                if (w == 1) {
+                    base_ms = ms;
+                    memcpy(s_reference, s_screen, sizeof(s_screen));
+                } else if (memcmp(s_reference, s_screen, sizeof(s_screen)) != 0) {
+                    printf("%s %s: %d workers differ from serial rendering\n", pages[p].name,
+                           direct ? "direct" : "partial", (int)w);
+                    failures++;
+                }
+                printf("%-12s %-8s %7d %8.1f %6.2f %9.3f %7.2fx\n", w == 1 ? pages[p].name : "",
+                       w == 1 ? (direct ? "direct" : "partial") : "", (int)w, (double)split / frames,
+                       split ? (double)s_bands / split : 1.0, ms,
+                       ms > 0 ? base_ms / ms : 0.0);
+            }
+        }
+    }
+
+    printf("speedup measured on this host; core affinity not applied\n");
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,341 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\bench_inval_trace.c
+ * @Description: 失效区域轨迹回放：同一份轨迹按矩形、圆形裁剪、圆形裁剪 + 区域合并发送，输出每帧 QSPI 字节数与传输次数
+ *
+ * 轨迹每行一帧，为对齐回调收到的原始区域（格式见 data/dice_ui.trace）。每帧按 LVGL 的流程处理：
+ * 裁到屏幕，经对齐回调，丢弃被已有区域覆盖的区域（满 LV_INV_BUF_SIZE 个时改为整屏），渲染前合并
+ * 重叠且合并后面积更小的区域，再按局部渲染的条带行数切分发送。
+ * - 矩形：对齐回调只做 4 像素与图块对齐（LVGL_ROUND_MASK 为 0 时的行为），条带整块发送
+ * - 圆形裁剪：对齐回调为 lvgl_area_round()（与设备端同一份源码），每个条带只发送可见跨度
+ * - 合并：圆形裁剪，并在 LVGL 合并重叠区域之前调用 lvgl_area_merge()（与 LV_EVENT_REFR_START 回调相同）
+ * 传输次数与时间按主机后端的模型估算（bench_transfer_us），与 bench_tile_skip 相同；不做图块跳过，
+ * 只比较裁剪与合并本身。每帧裁剪后的字节数不能多于矩形，整条轨迹必须更少；合并后按 lvgl_area_cost()
+ * 估算的开销不能增加。
+ *
+ *   bench_inval_trace <轨迹文件> [-v]     -v 时逐帧输出
+ */
+#include "bench_scene.h"
+#include "xn_lvgl_area.h"
+#include "xn_lvgl_tile.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef LV_INV_BUF_SIZE
+#define LV_INV_BUF_SIZE 32          // 与 LVGL 的失效区域数组长度相同
+#endif
+
+#define TRACE_LINE_MAX  4096
+#define TRACE_AREAS_MAX 64          // 一帧中原始区域数上限（超过 LV_INV_BUF_SIZE 时 LVGL 改为整屏）
+
+/** 发送方式 */
+typedef enum {
+    TRACE_RECT = 0,
+    TRACE_MASK,
+    TRACE_MERGE,
+    TRACE_MODE_COUNT,
+} trace_mode_t;
+
+/** 一帧的发送统计 */
+typedef struct {
+    uint32_t areas;             // 渲染的区域数
+    uint32_t txns;
+    uint32_t bytes;
+    uint32_t bus_us;
+} trace_cost_t;
+
+/** 一个场景（或整条轨迹）的累计 */
+typedef struct {
+    char name[32];
+    uint32_t frames;
+    uint64_t areas[TRACE_MODE_COUNT];   // 按 trace_mode_t 索引，下同
+    uint64_t txns[TRACE_MODE_COUNT];
+    uint64_t bytes[TRACE_MODE_COUNT];
+    uint64_t bus_us[TRACE_MODE_COUNT];
+} trace_sum_t;
+
+static inline int64_t area_size(const lv_area_t *a)
+{
+    return (int64_t)lv_area_get_width(a) * lv_area_get_height(a);
+}
+
+static inline bool area_is_on(const lv_area_t *a, const lv_area_t *b)
+{
+    return a->x1 <= b->x2 && b->x1 <= a->x2 && a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+static inline bool area_contains(const lv_area_t *outer, const lv_area_t *inner)
+{
+    return inner->x1 >= outer->x1 && inner->y1 >= outer->y1 &&
+           inner->x2 <= outer->x2 && inner->y2 <= outer->y2;
+}
+
+/* 不裁剪时的对齐回调：x 扩展到 4 像素边界，再扩展到图块边界 */
+static bool round_rect(lv_area_t *area)
+{
+    area->x1 = (area->x1 >> 2) << 2;
+    area->x2 = ((area->x2 >> 2) << 2) + 3;
+    lvgl_tile_align(area);
+    return true;
+}
+
+/* 与 lv_inv_area() 相同：裁到屏幕、对齐，被已有区域覆盖时丢弃，数组满时改为整屏 */
+static void inv_add(lv_area_t *inv, uint32_t *n, const lv_area_t *raw, bool mask)
+{
+    lv_area_t area = {
+        LV_MAX(raw->x1, 0), LV_MAX(raw->y1, 0),
+        LV_MIN(raw->x2, EXAMPLE_LCD_WIDTH - 1), LV_MIN(raw->y2, EXAMPLE_LCD_HEIGHT - 1),
+    };
+
+    if (area.x1 > area.x2 || area.y1 > area.y2) {
+        return;
+    }
+    if (mask) {
+        lvgl_area_round(&area);
+    } else {
+        round_rect(&area);
+    }
+    for (uint32_t i = 0; i < *n; i++) {
+        if (area_contains(&inv[i], &area)) {
+            return;
+        }
+    }
+    if (*n >= LV_INV_BUF_SIZE) {
+        lv_area_t screen = {0, 0, EXAMPLE_LCD_WIDTH - 1, EXAMPLE_LCD_HEIGHT - 1};
+        *n = 0;
+        inv_add(inv, n, &screen, mask);
+        return;
+    }
+    inv[(*n)++] = area;
+}
+
+/* 与 lv_refr_join_area() 相同：重叠且合并后面积小于两者之和的区域合并，返回剩余区域数 */
+static uint32_t inv_join(lv_area_t *inv, uint32_t n)
+{
+    bool joined[LV_INV_BUF_SIZE] = {0};
+    uint32_t out = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (joined[i]) {
+            continue;
+        }
+        for (uint32_t j = 0; j < n; j++) {
+            if (j == i || joined[j] || !area_is_on(&inv[i], &inv[j])) {
+                continue;
+            }
+            lv_area_t u = {
+                LV_MIN(inv[i].x1, inv[j].x1), LV_MIN(inv[i].y1, inv[j].y1),
+                LV_MAX(inv[i].x2, inv[j].x2), LV_MAX(inv[i].y2, inv[j].y2),
+            };
+            if (area_size(&u) < area_size(&inv[i]) + area_size(&inv[j])) {
+                inv[i] = u;
+                joined[j] = true;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (!joined[i]) {
+            inv[out++] = inv[i];
+        }
+    }
+    return out;
+}
+
+/* 按局部渲染的条带发送各区域；整块不可见的条带不发送（刷新回调直接通知完成） */
+static void flush_areas(const lv_area_t *inv, uint32_t n, bool mask, trace_cost_t *cost)
+{
+    memset(cost, 0, sizeof(*cost));
+    cost->areas = n;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const lv_area_t *area = &inv[i];
+        int32_t rows = bench_strip_rows(lv_area_get_width(area));
+
+        for (int32_t y = area->y1; y <= area->y2; y += rows) {
+            lv_area_t strip = {area->x1, y, area->x2, LV_MIN(y + rows - 1, area->y2)};
+            uint32_t bytes = mask ? bench_masked_bytes(&strip) : (uint32_t)area_size(&strip) * 2;
+            uint32_t txns;
+
+            if (bytes == 0) {
+                continue;
+            }
+            cost->bus_us += bench_transfer_us(lv_area_get_width(&strip), lv_area_get_height(&strip), bytes, &txns);
+            cost->txns += txns;
+            cost->bytes += bytes;
+        }
+    }
+}
+
+/* 解析一帧 "x1 y1 x2 y2; ..."，返回区域数，格式错误返回 -1 */
+static int parse_frame(const char *line, lv_area_t *raw)
+{
+    int n = 0;
+    const char *p = line;
+
+    while (1) {
+        char *end;
+        long v[4];
+
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '\0' || *p == '\n' || *p == '\r') {
+            return n;
+        }
+        for (int k = 0; k < 4; k++) {
+            v[k] = strtol(p, &end, 10);
+            if (end == p) {
+                return -1;
+            }
+            p = end;
+        }
+        if (n >= TRACE_AREAS_MAX || v[0] > v[2] || v[1] > v[3]) {
+            return -1;
+        }
+        raw[n++] = (lv_area_t){(int32_t)v[0], (int32_t)v[1], (int32_t)v[2], (int32_t)v[3]};
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == ';') {
+            p++;
+        }
+    }
+}
+
+static void sum_add(trace_sum_t *s, const trace_cost_t cost[TRACE_MODE_COUNT])
+{
+    s->frames++;
+    for (int m = 0; m < TRACE_MODE_COUNT; m++) {
+        s->areas[m] += cost[m].areas;
+        s->txns[m] += cost[m].txns;
+        s->bytes[m] += cost[m].bytes;
+        s->bus_us[m] += cost[m].bus_us;
+    }
+}
+
+static void sum_print(const trace_sum_t *s)
+{
+    uint32_t n = LV_MAX(s->frames, 1u);
+
+    printf("%-14s %6" PRIu32 " %5.1f %5.1f %5.1f %9" PRIu64 " %9" PRIu64 " %9" PRIu64 " %6.1f%% %6.1f %6.1f %6.1f"
+           " %7.2f %7.2f %7.2f\n",
+           s->name, s->frames, (double)s->areas[TRACE_RECT] / n, (double)s->areas[TRACE_MASK] / n,
+           (double)s->areas[TRACE_MERGE] / n, s->bytes[TRACE_RECT] / n, s->bytes[TRACE_MASK] / n,
+           s->bytes[TRACE_MERGE] / n,
+           s->bytes[TRACE_RECT] ?
+               100.0 * (double)(s->bytes[TRACE_RECT] - s->bytes[TRACE_MASK]) / s->bytes[TRACE_RECT] : 0.0,
+           (double)s->txns[TRACE_RECT] / n, (double)s->txns[TRACE_MASK] / n, (double)s->txns[TRACE_MERGE] / n,
+           s->bus_us[TRACE_RECT] / 1000.0 / n, s->bus_us[TRACE_MASK] / 1000.0 / n, s->bus_us[TRACE_MERGE] / 1000.0 / n);
+}
+
+int main(int argc, char **argv)
+{
+    static char line[TRACE_LINE_MAX];
+    lv_area_t raw[TRACE_AREAS_MAX];
+    trace_sum_t scene = {.name = "-"};
+    trace_sum_t total = {.name = "total"};
+    uint32_t line_no = 0;
+    int failures = 0;
+    bool verbose = argc > 2 && strcmp(argv[2], "-v") == 0;
+
+    if (argc < 2) {
+        printf("usage: bench_inval_trace <trace> [-v]\n");
+        return 1;
+    }
+    FILE *f = fopen(argv[1], "r");
+    if (!f) {
+        printf("%s: cannot open\n", argv[1]);
+        return 1;
+    }
+
+    lvgl_area_round_init();
+    printf("strip rows %" PRId32 " at full width, bus %u B/s + %u us/txn, no tile skip\n",
+           bench_strip_rows(EXAMPLE_LCD_WIDTH), (unsigned)LVGL_HOST_BUS_BYTES_PER_SEC,
+           (unsigned)LVGL_HOST_TXN_OVERHEAD_US);
+    printf("%-14s %6s %5s %5s %5s %9s %9s %9s %7s %6s %6s %6s %7s %7s %7s\n", "scene", "frames", "areas", "area'",
+           "area\"", "B/f rect", "B/f mask", "B/f merg", "saved", "txn", "txn'", "txn\"",
+           "bus ms", "bus ms'", "bus ms\"");
+
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        if (line[0] == '@') {
+            if (scene.frames) {
+                sum_print(&scene);
+            }
+            memset(&scene, 0, sizeof(scene));
+            sscanf(line + 1, "%31s", scene.name);
+            continue;
+        }
+
+        int n = parse_frame(line, raw);
+        if (n < 0) {
+            printf("%s:%" PRIu32 ": bad frame\n", argv[1], line_no);
+            failures++;
+            continue;
+        }
+
+        trace_cost_t cost[TRACE_MODE_COUNT];
+        for (int m = 0; m < TRACE_MODE_COUNT; m++) {
+            lv_area_t inv[LV_INV_BUF_SIZE];
+            uint32_t inv_n = 0;
+            for (int i = 0; i < n; i++) {
+                inv_add(inv, &inv_n, &raw[i], m != TRACE_RECT);
+            }
+            if (m == TRACE_MERGE) {
+                // 设备端有弹跳缓冲区时按分块流水线估算开销
+                int64_t cost_in = 0, cost_out = 0;
+                for (uint32_t i = 0; i < inv_n; i++) {
+                    cost_in += lvgl_area_cost(&inv[i], LVGL_FLUSH_CHUNK_BYTES);
+                }
+                inv_n = lvgl_area_merge(inv, inv_n, LVGL_FLUSH_CHUNK_BYTES);
+                for (uint32_t i = 0; i < inv_n; i++) {
+                    cost_out += lvgl_area_cost(&inv[i], LVGL_FLUSH_CHUNK_BYTES);
+                }
+                if (cost_out > cost_in) {
+                    printf("%s:%" PRIu32 ": merge cost %" PRId64 " > %" PRId64 "\n", argv[1], line_no,
+                           cost_out, cost_in);
+                    failures++;
+                }
+            }
+            inv_n = inv_join(inv, inv_n);
+            flush_areas(inv, inv_n, m != TRACE_RECT, &cost[m]);
+        }
+        sum_add(&scene, cost);
+        sum_add(&total, cost);
+
+        if (verbose) {
+            printf("  %5" PRIu32 " %-14s areas %2" PRIu32 "/%2" PRIu32 "/%2" PRIu32 " bytes %7" PRIu32 "/%7" PRIu32
+                   "/%7" PRIu32 " txns %3" PRIu32 "/%3" PRIu32 "/%3" PRIu32 "\n", total.frames, scene.name,
+                   cost[TRACE_RECT].areas, cost[TRACE_MASK].areas, cost[TRACE_MERGE].areas, cost[TRACE_RECT].bytes,
+                   cost[TRACE_MASK].bytes, cost[TRACE_MERGE].bytes, cost[TRACE_RECT].txns, cost[TRACE_MASK].txns,
+                   cost[TRACE_MERGE].txns);
+        }
+        // 裁剪只会减少发送的字节
+        if (cost[TRACE_MASK].bytes > cost[TRACE_RECT].bytes) {
+            printf("%s:%" PRIu32 ": masked %" PRIu32 " > rect %" PRIu32 " bytes\n", argv[1], line_no,
+                   cost[TRACE_MASK].bytes, cost[TRACE_RECT].bytes);
+            failures++;
+        }
+    }
+    fclose(f);
+
+    if (scene.frames) {
+        sum_print(&scene);
+    }
+    sum_print(&total);
+    if (total.frames == 0 || total.bytes[TRACE_MASK] >= total.bytes[TRACE_RECT]) {
+        failures++;
+    }
+
+    printf("(') with round mask, (\") round mask + area merge; per frame averages, bus time modelled\n");
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
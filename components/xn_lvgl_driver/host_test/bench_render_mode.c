@@ -0,0 +1,265 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\bench_render_mode.c
+ * @Description: 渲染模式基准：同一动画分别按局部渲染（PARTIAL）与直接渲染（DIRECT）回放，对比帧时间与内存
+ *
+ * 两种模式都与设备端一致：失效包围盒经对齐回调（lvgl_area_round），刷新时逐行把可见跨度交换字节序
+ * 复制到弹跳缓冲区（lvgl_pixel_rgb565_swap），传输时间按主机后端的模型估算。
+ * - PARTIAL：两块 LVGL_BUFFER_SIZE 的条带缓冲区，区域按条带渲染、刷新；渲染第 k+1 条时第 k 条在传输
+ * - DIRECT：两块整屏帧缓冲，区域渲染一次、刷新一次；交换缓冲后先把上一帧失效、本帧未覆盖的部分从前缓冲
+ *   复制过来（LVGL 的同步），本帧的渲染与上一帧的传输重叠
+ * 帧时间 = 本机实测的渲染与复制耗时 + 模型估算的传输时间，按上面的重叠方式组合。渲染用背景填充加
+ * 动画帧混合代替 LVGL 绘制，LVGL 每个条带重新遍历对象、创建绘制任务的开销没有计入，这部分要在设备上
+ * 用 lvgl_driver_get_frame_timing() 对比。两种模式最终送到面板的内容必须逐像素一致。
+ *
+ *   bench_render_mode [帧包.spr ...]     不带参数时使用合成场景
+ */
+#include "bench_scene.h"
+#include "xn_lvgl_area.h"
+#include "xn_lvgl_pixel.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCREEN_PIXELS   (EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT)
+#define MODE_COUNT      2
+
+typedef struct {
+    uint32_t frames;
+    uint64_t flushes;
+    uint64_t txns;
+    uint64_t bytes;
+    uint64_t bus_us;
+    uint64_t render_ns;         // 渲染（含直接模式的同步复制）
+    uint64_t copy_ns;           // 交换字节序复制到弹跳缓冲区
+    uint64_t sync_bytes;
+    uint64_t frame_ns;
+} mode_result_t;
+
+static const char *const s_mode_name[MODE_COUNT] = {"partial", "direct"};
+static const size_t s_mode_buf_bytes[MODE_COUNT] = {
+    2 * LVGL_BUFFER_SIZE * 2,
+    2 * SCREEN_PIXELS * 2,
+};
+
+static uint16_t s_background[SCREEN_PIXELS];
+static uint16_t s_strip[2][LVGL_BUFFER_SIZE];
+static uint16_t s_fb[2][SCREEN_PIXELS];
+static uint16_t s_panel[MODE_COUNT][SCREEN_PIXELS];
+static uint16_t s_bounce[EXAMPLE_LCD_WIDTH];
+
+/* 刷新一个区域：可见跨度逐行交换字节序复制到弹跳缓冲区（计时），同时写入面板（不计时），返回传输时间 */
+static uint64_t flush_area(uint16_t *panel, const uint16_t *src, int32_t stride, const lv_area_t *area,
+                           mode_result_t *res)
+{
+    uint32_t bytes = bench_masked_bytes(area);
+    uint32_t txns;
+    uint64_t bus_us = bench_transfer_us(lv_area_get_width(area), lv_area_get_height(area), bytes, &txns);
+    int32_t x1, x2;
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        if (!lvgl_area_row_span(y, area, &x1, &x2)) {
+            continue;
+        }
+        const uint16_t *row = src + (size_t)(y - area->y1) * stride + (x1 - area->x1);
+        uint64_t t0 = bench_now_ns();
+        lvgl_pixel_rgb565_swap(s_bounce, row, (uint32_t)(x2 - x1 + 1));
+        res->copy_ns += bench_now_ns() - t0;
+        memcpy(&panel[y * EXAMPLE_LCD_WIDTH + x1], row, (size_t)(x2 - x1 + 1) * 2);
+    }
+    res->flushes++;
+    res->txns += txns;
+    res->bytes += bytes;
+    res->bus_us += bus_us;
+    return bus_us * 1000;
+}
+
+/* 局部渲染：条带 k 渲染与复制时条带 k-1 在传输 */
+static void frame_partial(const lv_area_t *area, const lv_area_t *box, const uint16_t *rgb, const uint8_t *alpha,
+                          mode_result_t *res)
+{
+    int32_t w = lv_area_get_width(area);
+    int32_t rows = bench_strip_rows(w);
+    uint64_t frame_ns = 0, prev_bus_ns = 0;
+    int k = 0;
+
+    for (int32_t y = area->y1; y <= area->y2; y += rows, k++) {
+        lv_area_t strip = {area->x1, y, area->x2, LV_MIN(y + rows - 1, area->y2)};
+        uint16_t *buf = s_strip[k & 1];
+        uint64_t copy_before = res->copy_ns;
+
+        uint64_t t0 = bench_now_ns();
+        bench_scene_render(buf, w, &strip, s_background, box, rgb, alpha);
+        uint64_t render_ns = bench_now_ns() - t0;
+        res->render_ns += render_ns;
+        uint64_t bus_ns = flush_area(s_panel[0], buf, w, &strip, res);
+
+        uint64_t cpu_ns = render_ns + (res->copy_ns - copy_before);
+        frame_ns += LV_MAX(cpu_ns, prev_bus_ns);
+        prev_bus_ns = bus_ns;
+    }
+    res->frame_ns += frame_ns + prev_bus_ns;
+}
+
+/* 上一帧失效、本帧未覆盖的部分从前缓冲复制到后缓冲 */
+static uint32_t sync_areas(uint16_t *back, const uint16_t *front, const lv_area_t *prev, const lv_area_t *cur)
+{
+    uint32_t bytes = 0;
+
+    for (int32_t y = prev->y1; y <= prev->y2; y++) {
+        int32_t spans[2][2] = {{prev->x1, prev->x2}, {1, 0}};
+        if (y >= cur->y1 && y <= cur->y2) {
+            spans[0][1] = LV_MIN(prev->x2, cur->x1 - 1);
+            spans[1][0] = LV_MAX(prev->x1, cur->x2 + 1);
+            spans[1][1] = prev->x2;
+        }
+        for (int i = 0; i < 2; i++) {
+            if (spans[i][0] <= spans[i][1]) {
+                size_t n = (size_t)(spans[i][1] - spans[i][0] + 1);
+                memcpy(&back[y * EXAMPLE_LCD_WIDTH + spans[i][0]], &front[y * EXAMPLE_LCD_WIDTH + spans[i][0]], n * 2);
+                bytes += (uint32_t)n * 2;
+            }
+        }
+    }
+    return bytes;
+}
+
+/* 直接渲染：同步 + 渲染整个区域，再刷新一次；稳定后帧时间取 CPU 与传输中较长的一个 */
+static void frame_direct(uint32_t frame, const lv_area_t *area, const lv_area_t *prev, const lv_area_t *box,
+                         const uint16_t *rgb, const uint8_t *alpha, mode_result_t *res)
+{
+    uint16_t *back = s_fb[frame & 1];
+    const uint16_t *front = s_fb[(frame + 1) & 1];
+    uint64_t copy_before = res->copy_ns;
+
+    uint64_t t0 = bench_now_ns();
+    if (prev) {
+        res->sync_bytes += sync_areas(back, front, prev, area);
+    }
+    bench_scene_render(&back[area->y1 * EXAMPLE_LCD_WIDTH + area->x1], EXAMPLE_LCD_WIDTH, area,
+                       s_background, box, rgb, alpha);
+    uint64_t render_ns = bench_now_ns() - t0;
+    res->render_ns += render_ns;
+    uint64_t bus_ns = flush_area(s_panel[1], &back[area->y1 * EXAMPLE_LCD_WIDTH + area->x1],
+                                 EXAMPLE_LCD_WIDTH, area, res);
+
+    uint64_t cpu_ns = render_ns + (res->copy_ns - copy_before);
+    res->frame_ns += LV_MAX(cpu_ns, bus_ns);
+}
+
+static bool bench_run(const bench_anim_t *anim, mode_result_t res[MODE_COUNT])
+{
+    size_t count = (size_t)anim->width * anim->height;
+    uint16_t *rgb = malloc(count * sizeof(uint16_t));
+    uint8_t *alpha = malloc(count);
+    bool ok = rgb && alpha;
+    lv_area_t box = bench_anim_box(anim);
+    lv_area_t prev = {0};
+    bool have_prev = false;
+
+    memset(res, 0, sizeof(mode_result_t) * MODE_COUNT);
+
+    // 面板与两块帧缓冲都从背景开始（相当于初始整屏刷新）
+    bench_scene_background(s_background);
+    for (int m = 0; m < MODE_COUNT; m++) {
+        memcpy(s_panel[m], s_background, sizeof(s_background));
+        memcpy(s_fb[m], s_background, sizeof(s_background));
+    }
+
+    for (uint32_t f = 0; ok && f < anim->frame_count; f++) {
+        if (!bench_anim_frame(anim, f, rgb, alpha)) {
+            printf("%s: frame %" PRIu32 " corrupt\n", anim->name, f);
+            ok = false;
+            break;
+        }
+        lv_area_t area = box;
+        if (lvgl_area_round(&area)) {
+            frame_partial(&area, &box, rgb, alpha, &res[0]);
+            frame_direct(f, &area, have_prev ? &prev : NULL, &box, rgb, alpha, &res[1]);
+            prev = area;
+            have_prev = true;
+        }
+        res[0].frames++;
+        res[1].frames++;
+    }
+
+    free(rgb);
+    free(alpha);
+    return ok;
+}
+
+/* 两种模式送到面板的可见像素必须一致 */
+static uint64_t panel_mismatches(void)
+{
+    lv_area_t screen = {0, 0, EXAMPLE_LCD_WIDTH - 1, EXAMPLE_LCD_HEIGHT - 1};
+    uint64_t bad = 0;
+    int32_t x1, x2;
+
+    for (int32_t y = 0; y < EXAMPLE_LCD_HEIGHT; y++) {
+        if (lvgl_area_row_span(y, &screen, &x1, &x2)) {
+            for (int32_t x = x1; x <= x2; x++) {
+                bad += s_panel[0][y * EXAMPLE_LCD_WIDTH + x] != s_panel[1][y * EXAMPLE_LCD_WIDTH + x];
+            }
+        }
+    }
+    return bad;
+}
+
+static void bench_print(const char *name, const mode_result_t res[MODE_COUNT])
+{
+    for (int m = 0; m < MODE_COUNT; m++) {
+        const mode_result_t *r = &res[m];
+        uint32_t n = LV_MAX(r->frames, 1u);
+        printf("%-22s %-8s %8zu %6.1f %6.1f %8" PRIu64 " %7.2f %7.3f %7.3f %7" PRIu64 " %7.2f\n",
+               m == 0 ? name : "", s_mode_name[m], s_mode_buf_bytes[m] / 1024,
+               (double)r->flushes / n, (double)r->txns / n, r->bytes / n, r->bus_us / 1000.0 / n,
+               r->render_ns / 1e6 / n, r->copy_ns / 1e6 / n, r->sync_bytes / n, r->frame_ns / 1e6 / n);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int failures = 0;
+    int count = argc > 1 ? argc - 1 : BENCH_SYNTH_COUNT;
+    mode_result_t res[MODE_COUNT];
+
+    lvgl_area_round_init();
+    printf("draw buffers: partial 2 x %u px strips (%" PRId32 " rows at full width), direct 2 x %dx%d framebuffers\n",
+           (unsigned)LVGL_BUFFER_SIZE, bench_strip_rows(EXAMPLE_LCD_WIDTH), EXAMPLE_LCD_WIDTH, EXAMPLE_LCD_HEIGHT);
+    printf("%-22s %-8s %8s %6s %6s %8s %7s %7s %7s %7s %7s\n", "anim", "mode", "buf KB", "flush", "txn",
+           "B/frame", "bus ms", "rend ms", "copy ms", "sync B", "frame ms");
+
+    for (int i = 0; i < count; i++) {
+        bench_anim_t anim;
+
+        if (argc > 1) {
+            if (!bench_anim_open_sprite(&anim, argv[i + 1])) {
+                printf("%s: not a sprite pack\n", argv[i + 1]);
+                failures++;
+                continue;
+            }
+        } else {
+            bench_anim_open_synth(&anim, (bench_synth_t)i);
+        }
+
+        if (!bench_run(&anim, res)) {
+            failures++;
+        } else {
+            bench_print(anim.name, res);
+            uint64_t bad = panel_mismatches();
+            if (bad) {
+                printf("%s: %" PRIu64 " pixels differ between partial and direct\n", anim.name, bad);
+                failures++;
+            }
+        }
+        bench_anim_close(&anim);
+    }
+
+    printf("bus time modelled; render/copy measured on this host (LVGL per-strip overhead not included)\n");
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,356 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\bench_scene.c
+ * @Description: 主机基准的画面来源：帧包回放与合成场景，及与主机后端一致的传输模型
+ */
+
+#include "bench_scene.h"
+#include "xn_lvgl_area.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// 与 lottie_sprite_player.h 相同的帧包格式（小端、紧凑）
+#define BENCH_SPRITE_MAGIC          0x52505358u
+#define BENCH_SPRITE_VERSION        1
+#define BENCH_SPRITE_FLAG_ALPHA     0x0001
+#define BENCH_SPRITE_HEADER_BYTES   16
+#define BENCH_SPRITE_INDEX_BYTES    12
+
+#define BENCH_PI                    3.14159265f
+
+static const struct {
+    const char *name;
+    uint16_t size;
+    uint32_t frames;
+} s_synth[BENCH_SYNTH_COUNT] = {
+    [BENCH_SYNTH_FACE]    = {"synth_face_400", 400, 48},
+    [BENCH_SYNTH_SPINNER] = {"synth_spinner_200", 200, 30},
+    [BENCH_SYNTH_DICE]    = {"synth_dice_260", 260, 30},
+};
+
+static inline uint32_t rd16(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static inline uint32_t rd32(const uint8_t *p)
+{
+    return rd16(p) | (rd16(p + 2) << 16);
+}
+
+static inline uint16_t rgb565(uint32_t r, uint32_t g, uint32_t b)
+{
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+/*********************
+ * 帧来源
+ *********************/
+
+bool bench_anim_open_sprite(bench_anim_t *anim, const char *path)
+{
+    memset(anim, 0, sizeof(*anim));
+    anim->synth = -1;
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < BENCH_SPRITE_HEADER_BYTES || !(anim->pack = malloc((size_t)size)) ||
+        fread(anim->pack, 1, (size_t)size, f) != (size_t)size) {
+        fclose(f);
+        bench_anim_close(anim);
+        return false;
+    }
+    fclose(f);
+    anim->pack_size = (size_t)size;
+
+    const uint8_t *hdr = anim->pack;
+    anim->width = (uint16_t)rd16(hdr + 8);
+    anim->height = (uint16_t)rd16(hdr + 10);
+    anim->frame_count = rd16(hdr + 12);
+    anim->fps_x100 = rd16(hdr + 14);
+    anim->pack_alpha = (rd16(hdr + 6) & BENCH_SPRITE_FLAG_ALPHA) != 0;
+    size_t body = BENCH_SPRITE_HEADER_BYTES + (size_t)anim->frame_count * BENCH_SPRITE_INDEX_BYTES;
+    if (rd32(hdr) != BENCH_SPRITE_MAGIC || rd16(hdr + 4) != BENCH_SPRITE_VERSION ||
+        anim->width == 0 || anim->height == 0 || anim->frame_count == 0 ||
+        anim->width > EXAMPLE_LCD_WIDTH || anim->height > EXAMPLE_LCD_HEIGHT || body > anim->pack_size) {
+        bench_anim_close(anim);
+        return false;
+    }
+
+    const char *base = strrchr(path, '/');
+    snprintf(anim->name, sizeof(anim->name), "%s", base ? base + 1 : path);
+    return true;
+}
+
+void bench_anim_open_synth(bench_anim_t *anim, bench_synth_t synth)
+{
+    memset(anim, 0, sizeof(*anim));
+    snprintf(anim->name, sizeof(anim->name), "%s", s_synth[synth].name);
+    anim->width = s_synth[synth].size;
+    anim->height = s_synth[synth].size;
+    anim->frame_count = s_synth[synth].frames;
+    anim->fps_x100 = 2000;
+    anim->synth = synth;
+}
+
+void bench_anim_close(bench_anim_t *anim)
+{
+    free(anim->pack);
+    anim->pack = NULL;
+    anim->pack_size = 0;
+}
+
+/* 与 lottie_rle.c 相同的 RLE：头字节最高位为 1 时下一元素重复 (h & 0x7F) + 1 次，否则 h + 1 个原样元素 */
+static bool bench_rle_decode(const uint8_t *src, size_t len, void *dst, size_t count, int elem_bytes)
+{
+    size_t in = 0, out = 0;
+
+    while (out < count) {
+        if (in >= len) {
+            return false;
+        }
+        uint8_t h = src[in++];
+        size_t n = (size_t)(h & 0x7F) + 1;
+        bool run = (h & 0x80) != 0;
+        if (out + n > count || in + (run ? 1 : n) * (size_t)elem_bytes > len) {
+            return false;
+        }
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t *e = src + in + (run ? 0 : i * (size_t)elem_bytes);
+            if (elem_bytes == 2) {
+                ((uint16_t *)dst)[out + i] = (uint16_t)rd16(e);
+            } else {
+                ((uint8_t *)dst)[out + i] = e[0];
+            }
+        }
+        in += (run ? 1 : n) * (size_t)elem_bytes;
+        out += n;
+    }
+    return in == len;
+}
+
+static bool bench_sprite_frame(const bench_anim_t *anim, uint32_t frame, uint16_t *rgb, uint8_t *alpha)
+{
+    size_t count = (size_t)anim->width * anim->height;
+    const uint8_t *idx = anim->pack + BENCH_SPRITE_HEADER_BYTES + (size_t)frame * BENCH_SPRITE_INDEX_BYTES;
+    size_t body = BENCH_SPRITE_HEADER_BYTES + (size_t)anim->frame_count * BENCH_SPRITE_INDEX_BYTES;
+    size_t offset = rd32(idx), rgb_len = rd32(idx + 4), alpha_len = rd32(idx + 8);
+
+    if (body + offset + rgb_len + alpha_len > anim->pack_size) {
+        return false;
+    }
+    const uint8_t *data = anim->pack + body + offset;
+    if (!bench_rle_decode(data, rgb_len, rgb, count, 2)) {
+        return false;
+    }
+    if (!anim->pack_alpha) {
+        memset(alpha, 0xFF, count);
+        return true;
+    }
+    return bench_rle_decode(data + rgb_len, alpha_len, alpha, count, 1);
+}
+
+/* 合成场景逐像素光栅化（无抗锯齿），输出预乘颜色与不透明度 */
+static void bench_synth_pixel(int synth, uint32_t frame, uint32_t frames, float x, float y,
+                              uint16_t *rgb, uint8_t *alpha)
+{
+    float t = (float)frame / (float)frames;
+    *rgb = 0;
+    *alpha = 0;
+
+    switch (synth) {
+    case BENCH_SYNTH_FACE: {
+        // 静止的脸与嘴，眼睛左右摆动
+        float dx = x - 200.0f, dy = y - 200.0f;
+        if (dx * dx + dy * dy > 190.0f * 190.0f) {
+            return;
+        }
+        *alpha = 0xFF;
+        *rgb = rgb565(0xFF, 0xCC, 0x30);
+        float eye = 24.0f * sinf(2.0f * BENCH_PI * t);
+        for (int i = 0; i < 2; i++) {
+            float ex = x - (130.0f + 140.0f * i + eye), ey = y - 160.0f;
+            if (ex * ex + ey * ey <= 26.0f * 26.0f) {
+                *rgb = rgb565(0x20, 0x20, 0x20);
+            }
+        }
+        if (y >= 270.0f && y <= 290.0f && x >= 140.0f && x <= 260.0f) {
+            *rgb = rgb565(0x80, 0x30, 0x10);
+        }
+        return;
+    }
+    case BENCH_SYNTH_SPINNER:
+        // 一圈 8 个圆点匀速旋转，亮度依次递减
+        for (int k = 0; k < 8; k++) {
+            float a = 2.0f * BENCH_PI * ((float)k + t) / 8.0f;
+            float px = x - (100.0f + 70.0f * cosf(a)), py = y - (100.0f + 70.0f * sinf(a));
+            if (px * px + py * py <= 13.0f * 13.0f) {
+                uint32_t level = 255 - (uint32_t)k * 28;
+                *alpha = (uint8_t)level;
+                *rgb = rgb565(level, level, level);   // 白色按不透明度预乘
+                return;
+            }
+        }
+        return;
+    case BENCH_SYNTH_DICE: {
+        // 五点面的圆角方块每个循环转 90°（首尾衔接）
+        float a = 0.5f * BENCH_PI * t;
+        float dx = x - 130.0f, dy = y - 130.0f;
+        float u = dx * cosf(a) + dy * sinf(a), v = -dx * sinf(a) + dy * cosf(a);
+        float cu = fmaxf(fabsf(u) - 60.0f, 0.0f), cv = fmaxf(fabsf(v) - 60.0f, 0.0f);
+        if (fabsf(u) > 80.0f || fabsf(v) > 80.0f || cu * cu + cv * cv > 20.0f * 20.0f) {
+            return;
+        }
+        *alpha = 0xFF;
+        *rgb = rgb565(0xF8, 0xF8, 0xF8);
+        static const float pips[5][2] = {{-45, -45}, {45, -45}, {0, 0}, {-45, 45}, {45, 45}};
+        for (int i = 0; i < 5; i++) {
+            float pu = u - pips[i][0], pv = v - pips[i][1];
+            if (pu * pu + pv * pv <= 14.0f * 14.0f) {
+                *rgb = rgb565(0x18, 0x18, 0x18);
+            }
+        }
+        return;
+    }
+    default:
+        return;
+    }
+}
+
+bool bench_anim_frame(const bench_anim_t *anim, uint32_t frame, uint16_t *rgb, uint8_t *alpha)
+{
+    frame %= anim->frame_count;
+    if (anim->synth < 0) {
+        return bench_sprite_frame(anim, frame, rgb, alpha);
+    }
+    for (uint32_t y = 0; y < anim->height; y++) {
+        for (uint32_t x = 0; x < anim->width; x++) {
+            size_t i = (size_t)y * anim->width + x;
+            bench_synth_pixel(anim->synth, frame, anim->frame_count, x + 0.5f, y + 0.5f, &rgb[i], &alpha[i]);
+        }
+    }
+    return true;
+}
+
+/*********************
+ * 屏幕合成
+ *********************/
+
+lv_area_t bench_anim_box(const bench_anim_t *anim)
+{
+    lv_area_t box;
+    box.x1 = (EXAMPLE_LCD_WIDTH - anim->width) / 2;
+    box.y1 = (EXAMPLE_LCD_HEIGHT - anim->height) / 2;
+    box.x2 = box.x1 + anim->width - 1;
+    box.y2 = box.y1 + anim->height - 1;
+    return box;
+}
+
+void bench_scene_background(uint16_t *screen)
+{
+    for (int32_t y = 0; y < EXAMPLE_LCD_HEIGHT; y++) {
+        uint16_t c = rgb565(0x10, 0x18 + (uint32_t)y * 0x40 / EXAMPLE_LCD_HEIGHT, 0x40 + (uint32_t)y * 0x60 / EXAMPLE_LCD_HEIGHT);
+        for (int32_t x = 0; x < EXAMPLE_LCD_WIDTH; x++) {
+            screen[y * EXAMPLE_LCD_WIDTH + x] = c;
+        }
+    }
+}
+
+/* 预乘混合：out = fg + bg × (255 - a) / 255，各通道分别计算 */
+static inline uint16_t bench_blend(uint16_t fg, uint8_t a, uint16_t bg)
+{
+    uint32_t inv = 255u - a;
+    uint32_t r = (fg >> 11) + ((bg >> 11) * inv + 127) / 255;
+    uint32_t g = ((fg >> 5) & 0x3F) + (((bg >> 5) & 0x3F) * inv + 127) / 255;
+    uint32_t b = (fg & 0x1F) + ((bg & 0x1F) * inv + 127) / 255;
+    return (uint16_t)((LV_MIN(r, 0x1Fu) << 11) | (LV_MIN(g, 0x3Fu) << 5) | LV_MIN(b, 0x1Fu));
+}
+
+void bench_scene_render(uint16_t *dst, int32_t stride, const lv_area_t *area, const uint16_t *background,
+                        const lv_area_t *box, const uint16_t *rgb, const uint8_t *alpha)
+{
+    int32_t w = lv_area_get_width(area);
+    int32_t bw = lv_area_get_width(box);
+    int32_t x1 = LV_MAX(area->x1, box->x1);
+    int32_t x2 = LV_MIN(area->x2, box->x2);
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        uint16_t *row = dst + (size_t)(y - area->y1) * stride;
+        const uint16_t *bg = &background[y * EXAMPLE_LCD_WIDTH + area->x1];
+
+        // 先填背景，再在与包围盒相交的部分混合动画帧
+        memcpy(row, bg, (size_t)w * 2);
+        if (y < box->y1 || y > box->y2 || x1 > x2) {
+            continue;
+        }
+        const uint16_t *fg = &rgb[(y - box->y1) * bw + (x1 - box->x1)];
+        const uint8_t *fa = &alpha[(y - box->y1) * bw + (x1 - box->x1)];
+        for (int32_t x = 0; x <= x2 - x1; x++) {
+            row[x1 - area->x1 + x] = bench_blend(fg[x], fa[x], bg[x1 - area->x1 + x]);
+        }
+    }
+}
+
+void bench_scene_compose(uint16_t *screen, const uint16_t *background, const lv_area_t *box,
+                         const uint16_t *rgb, const uint8_t *alpha)
+{
+    bench_scene_render(&screen[box->y1 * EXAMPLE_LCD_WIDTH + box->x1], EXAMPLE_LCD_WIDTH, box,
+                       background, box, rgb, alpha);
+}
+
+/*********************
+ * 刷新模型
+ *********************/
+
+int32_t bench_strip_rows(int32_t width)
+{
+    int32_t rows = LV_MAX(1, LVGL_BUFFER_SIZE / width);
+#if LVGL_TILE_SKIP
+    if (rows >= LVGL_TILE_SIZE) {
+        rows = rows / LVGL_TILE_SIZE * LVGL_TILE_SIZE;
+    }
+#endif
+    return rows;
+}
+
+uint32_t bench_transfer_us(int32_t width, int32_t height, uint32_t bytes, uint32_t *txns)
+{
+    if (LVGL_FLUSH_PIPELINE && width * 2 <= LVGL_FLUSH_CHUNK_BYTES) {
+        int32_t rows = LVGL_FLUSH_CHUNK_BYTES / (width * 2);
+        *txns = (uint32_t)((height + rows - 1) / rows);
+    } else {
+        *txns = 1;
+    }
+    return *txns * LVGL_HOST_TXN_OVERHEAD_US + (uint32_t)((uint64_t)bytes * 1000000 / LVGL_HOST_BUS_BYTES_PER_SEC);
+}
+
+uint32_t bench_masked_bytes(const lv_area_t *area)
+{
+    uint32_t bytes = 0;
+    int32_t x1, x2;
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        if (lvgl_area_row_span(y, area, &x1, &x2)) {
+            bytes += (uint32_t)(x2 - x1 + 1) * 2;
+        }
+    }
+    return bytes;
+}
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,114 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\bench_scene.h
+ * @Description: 主机基准的画面来源：帧包回放与合成场景，及与主机后端一致的传输模型
+ *
+ * 主机测试不编译 LVGL 与 ThorVG，动画帧来自：
+ * - 帧包（.spr）：tools/lottie_sprite_compiler.py 用 rlottie 光栅化的真实动画帧，格式见 lottie_sprite_player.h；
+ *   加 --all 时为 anim_configs 中的每个动画生成帧包
+ * - 合成场景：没有帧包时使用，静止部分与变化部分的比例模仿待机表情、加载动画与骰子旋转
+ * 动画按 LVGL 对象居中放在屏幕上，每帧与背景合成后失效整个包围盒（与 lv_lottie 相同）。
+ */
+#pragma once
+
+#include "xn_lvgl.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 合成场景 */
+typedef enum {
+    BENCH_SYNTH_FACE = 0,       ///< 400×400 表情：静止的脸，只有眼睛左右移动（模仿 emoji_cool）
+    BENCH_SYNTH_SPINNER,        ///< 200×200 加载动画：一圈圆点轮流变亮（模仿 loading）
+    BENCH_SYNTH_DICE,           ///< 260×260 骰子：带点的圆角方块整体旋转（模仿 dice）
+    BENCH_SYNTH_COUNT,
+} bench_synth_t;
+
+/** 动画帧来源 */
+typedef struct {
+    char name[64];
+    uint16_t width;
+    uint16_t height;
+    uint32_t frame_count;
+    uint32_t fps_x100;
+    int synth;                  ///< bench_synth_t，帧包时为 -1
+    uint8_t *pack;              ///< 帧包文件内容
+    size_t pack_size;
+    bool pack_alpha;
+} bench_anim_t;
+
+/**
+ * @brief 读取帧包
+ * @return false 文件不存在或格式不符
+ */
+bool bench_anim_open_sprite(bench_anim_t *anim, const char *path);
+
+/**
+ * @brief 使用合成场景
+ */
+void bench_anim_open_synth(bench_anim_t *anim, bench_synth_t synth);
+
+void bench_anim_close(bench_anim_t *anim);
+
+/**
+ * @brief 取一帧：预乘 RGB565 与 A8 平面（各 width × height 个元素）
+ * @return false 帧数据损坏
+ */
+bool bench_anim_frame(const bench_anim_t *anim, uint32_t frame, uint16_t *rgb, uint8_t *alpha);
+
+/**
+ * @brief 动画在屏幕上的包围盒（居中）
+ */
+lv_area_t bench_anim_box(const bench_anim_t *anim);
+
+/**
+ * @brief 整屏背景（竖直渐变，代替屏幕背景样式）
+ * @param screen EXAMPLE_LCD_WIDTH × EXAMPLE_LCD_HEIGHT 个 RGB565 像素
+ */
+void bench_scene_background(uint16_t *screen);
+
+/**
+ * @brief 包围盒内先恢复背景，再混合动画帧
+ */
+void bench_scene_compose(uint16_t *screen, const uint16_t *background, const lv_area_t *box,
+                         const uint16_t *rgb, const uint8_t *alpha);
+
+/**
+ * @brief 把屏幕区域 area 的内容（背景 + 包围盒 box 内的动画帧）渲染到 dst，代替 LVGL 绘制一个条带或区域
+ * @param dst 区域首个像素
+ * @param stride 行跨度（像素），局部渲染为区域宽度，直接渲染为屏幕宽度
+ */
+void bench_scene_render(uint16_t *dst, int32_t stride, const lv_area_t *area, const uint16_t *background,
+                        const lv_area_t *box, const uint16_t *rgb, const uint8_t *alpha);
+
+/**
+ * @brief LVGL 局部渲染每次渲染的行数：显示缓冲区容纳的行数，对齐回调扩展到图块边界后向下取整
+ */
+int32_t bench_strip_rows(int32_t width);
+
+/**
+ * @brief 与主机后端 lvgl_host_transfer_us 相同的传输模型（默认带宽与每次传输开销）
+ * @param bytes 圆形裁剪后实际发送的字节数
+ */
+uint32_t bench_transfer_us(int32_t width, int32_t height, uint32_t bytes, uint32_t *txns);
+
+/**
+ * @brief 区域内圆形裁剪后需要发送的字节数
+ */
+uint32_t bench_masked_bytes(const lv_area_t *area);
+
+/**
+ * @brief 单调时钟（纳秒）
+ */
+uint64_t bench_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
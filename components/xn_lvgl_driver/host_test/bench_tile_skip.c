@@ -0,0 +1,202 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\bench_tile_skip.c
+ * @Description: 图块哈希跳过基准：逐帧回放动画，统计跳过的图块、发送字节与传输时间
+ *
+ * 与设备端刷新路径使用同一份 xn_lvgl_area.c / xn_lvgl_tile.c：每帧失效动画包围盒，经对齐回调
+ * （lvgl_area_round）后按局部渲染的条带行数切分，每个条带交给图块迭代器，只发送内容变化的片段。
+ * 对照组整条发送。传输时间按主机后端的模型（LVGL_HOST_BUS_BYTES_PER_SEC、LVGL_HOST_TXN_OVERHEAD_US）
+ * 估算，哈希耗时为本机实测（设备端见 lvgl_driver_get_stats 的 tile_hash_us_last）。
+ * 另有一块“面板”只接收实际发送的片段，每帧与屏幕内容逐像素比较，确认跳过不会漏发变化。
+ *
+ *   bench_tile_skip [帧包.spr ...]     不带参数时使用合成场景
+ *
+ * 真实动画的帧包用 tools/lottie_sprite_compiler.py --all 生成（需要 rlottie-python）。
+ */
+#include "bench_scene.h"
+#include "xn_lvgl_area.h"
+#include "xn_lvgl_tile.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCREEN_PIXELS   (EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT)
+
+typedef struct {
+    uint32_t frames;
+    lvgl_tile_counters_t tiles;
+    uint64_t bytes_full;        // 整条发送
+    uint64_t bytes_sent;        // 图块跳过后
+    uint64_t txns_full;
+    uint64_t txns_sent;
+    uint64_t bus_us_full;
+    uint64_t bus_us_sent;
+    uint64_t hash_ns;
+    uint64_t mismatched_pixels;
+} bench_result_t;
+
+static uint16_t s_background[SCREEN_PIXELS];
+static uint16_t s_screen[SCREEN_PIXELS];
+static uint16_t s_panel[SCREEN_PIXELS];
+
+/* 片段中可见的行跨度写到面板 */
+static void panel_write(const lv_area_t *part)
+{
+    int32_t x1, x2;
+
+    for (int32_t y = part->y1; y <= part->y2; y++) {
+        if (lvgl_area_row_span(y, part, &x1, &x2)) {
+            memcpy(&s_panel[y * EXAMPLE_LCD_WIDTH + x1], &s_screen[y * EXAMPLE_LCD_WIDTH + x1],
+                   (size_t)(x2 - x1 + 1) * 2);
+        }
+    }
+}
+
+/* 按条带刷新一个区域，同时累计整条发送（对照组）与图块跳过后的开销 */
+static void flush_area(const lv_area_t *area, bench_result_t *res)
+{
+    int32_t rows = bench_strip_rows(lv_area_get_width(area));
+
+    for (int32_t y = area->y1; y <= area->y2; y += rows) {
+        lv_area_t strip = {area->x1, y, area->x2, LV_MIN(y + rows - 1, area->y2)};
+        uint32_t txns;
+        uint32_t bytes = bench_masked_bytes(&strip);
+
+        res->bytes_full += bytes;
+        res->bus_us_full += bench_transfer_us(lv_area_get_width(&strip), lv_area_get_height(&strip), bytes, &txns);
+        res->txns_full += txns;
+
+        // 局部渲染时条带在显示缓冲区内连续存放，这里直接从整屏取，内容相同
+        lvgl_tile_iter_t it;
+        lv_area_t part;
+        uint64_t t0 = bench_now_ns();
+        lvgl_tile_iter_init(&it, &strip, (const uint8_t *)&s_screen[strip.y1 * EXAMPLE_LCD_WIDTH + strip.x1],
+                            EXAMPLE_LCD_WIDTH * 2, &res->tiles);
+        while (lvgl_tile_iter_next(&it, &part)) {
+            res->hash_ns += bench_now_ns() - t0;
+            bytes = bench_masked_bytes(&part);
+            res->bytes_sent += bytes;
+            res->bus_us_sent += bench_transfer_us(lv_area_get_width(&part), lv_area_get_height(&part), bytes, &txns);
+            res->txns_sent += txns;
+            panel_write(&part);
+            t0 = bench_now_ns();
+        }
+        res->hash_ns += bench_now_ns() - t0;
+    }
+}
+
+static uint64_t panel_mismatches(const lv_area_t *area)
+{
+    uint64_t bad = 0;
+    int32_t x1, x2;
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        if (!lvgl_area_row_span(y, area, &x1, &x2)) {
+            continue;
+        }
+        for (int32_t x = x1; x <= x2; x++) {
+            bad += s_panel[y * EXAMPLE_LCD_WIDTH + x] != s_screen[y * EXAMPLE_LCD_WIDTH + x];
+        }
+    }
+    return bad;
+}
+
+static bool bench_run(const bench_anim_t *anim, bench_result_t *res)
+{
+    size_t count = (size_t)anim->width * anim->height;
+    uint16_t *rgb = malloc(count * sizeof(uint16_t));
+    uint8_t *alpha = malloc(count);
+    bool ok = rgb && alpha;
+    lv_area_t screen = {0, 0, EXAMPLE_LCD_WIDTH - 1, EXAMPLE_LCD_HEIGHT - 1};
+    lv_area_t box = bench_anim_box(anim);
+
+    memset(res, 0, sizeof(*res));
+
+    // 初始整屏刷新：面板与图块哈希同步到背景，不计入结果
+    bench_scene_background(s_background);
+    memcpy(s_screen, s_background, sizeof(s_screen));
+    memset(s_panel, 0, sizeof(s_panel));
+    lvgl_tile_reset();
+    bench_result_t sync = {0};
+    flush_area(&screen, &sync);
+
+    for (uint32_t f = 0; ok && f < anim->frame_count; f++) {
+        if (!bench_anim_frame(anim, f, rgb, alpha)) {
+            printf("%s: frame %" PRIu32 " corrupt\n", anim->name, f);
+            ok = false;
+            break;
+        }
+        bench_scene_compose(s_screen, s_background, &box, rgb, alpha);
+
+        lv_area_t area = box;
+        if (lvgl_area_round(&area)) {
+            flush_area(&area, res);
+            res->mismatched_pixels += panel_mismatches(&area);
+        }
+        res->frames++;
+    }
+
+    free(rgb);
+    free(alpha);
+    return ok;
+}
+
+static void bench_print(const char *name, const bench_result_t *r)
+{
+    uint32_t n = LV_MAX(r->frames, 1u);
+
+    printf("%-22s %6" PRIu32 " %7" PRIu32 " %6.1f%% %8" PRIu64 " %8" PRIu64 " %5.1f %5.1f %7.2f %7.2f %7.1f %8" PRIu64 "\n",
+           name, r->frames, r->tiles.checked / n,
+           r->tiles.checked ? 100.0 * r->tiles.skipped / r->tiles.checked : 0.0,
+           r->bytes_full / n, r->bytes_sent / n,
+           (double)r->txns_full / n, (double)r->txns_sent / n,
+           r->bus_us_full / 1000.0 / n, r->bus_us_sent / 1000.0 / n,
+           r->hash_ns / 1000.0 / n, r->mismatched_pixels);
+}
+
+int main(int argc, char **argv)
+{
+    int failures = 0;
+    int count = argc > 1 ? argc - 1 : BENCH_SYNTH_COUNT;
+
+    lvgl_area_round_init();
+    printf("tile %dx%d, strip rows %" PRId32 " at full width, bus %u B/s + %u us/txn\n",
+           LVGL_TILE_SIZE, LVGL_TILE_SIZE, bench_strip_rows(EXAMPLE_LCD_WIDTH),
+           (unsigned)LVGL_HOST_BUS_BYTES_PER_SEC, (unsigned)LVGL_HOST_TXN_OVERHEAD_US);
+    printf("%-22s %6s %7s %7s %8s %8s %5s %5s %7s %7s %7s %8s\n", "anim", "frames", "tiles/f", "skip",
+           "B/f full", "B/f sent", "txn", "txn'", "bus ms", "bus ms'", "hash us", "mismatch");
+
+    for (int i = 0; i < count; i++) {
+        bench_anim_t anim;
+        bench_result_t res;
+
+        if (argc > 1) {
+            if (!bench_anim_open_sprite(&anim, argv[i + 1])) {
+                printf("%s: not a sprite pack\n", argv[i + 1]);
+                failures++;
+                continue;
+            }
+        } else {
+            bench_anim_open_synth(&anim, (bench_synth_t)i);
+        }
+
+        if (!bench_run(&anim, &res)) {
+            failures++;
+        } else {
+            bench_print(anim.name, &res);
+            // 跳过不能漏发变化；静止为主的表情场景至少跳过一半图块，否则哈希或对齐出了问题
+            if (res.mismatched_pixels || (anim.synth == BENCH_SYNTH_FACE && res.tiles.skipped * 2 < res.tiles.checked)) {
+                failures++;
+            }
+        }
+        bench_anim_close(&anim);
+    }
+
+    printf("(') with tile skip; bus time modelled, hash time measured on this host\n");
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
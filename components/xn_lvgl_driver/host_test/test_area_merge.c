@@ -0,0 +1,264 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\test_area_merge.c
+ * @Description: xn_lvgl_area 测试：圆形裁剪与失效区域合并
+ *
+ * 与设备端、主机后端使用同一份 xn_lvgl_area.c / xn_lvgl_tile.c：
+ * - 可见跨度：上下、左右对称，按 4 像素对齐，中间一行覆盖整屏宽度
+ * - 对齐回调：随机失效区域经 lvgl_area_round 后 x 按 4 像素、xy 按图块对齐，原区域中每个可见像素仍在结果内；
+ *   完全不可见时返回 false；LVGL 的行数探测区域不被裁剪
+ * - 合并：随机帧（若干小区域，Lottie 包围盒与骰子阴影的替身）合并后区域数不增加、总开销不增加，
+ *   输入区域的每个可见像素都被某个输出区域覆盖；输出合并前后的区域数、传输次数与开销
+ *
+ *   test_area_merge [帧数]     默认 20000
+ */
+#include "xn_lvgl_area.h"
+#include "xn_lvgl_tile.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_CHUNK_BYTES    (LVGL_FLUSH_PIPELINE ? LVGL_FLUSH_CHUNK_BYTES : 0)
+#define TEST_MAX_AREAS      32          ///< LVGL 默认的失效区域数组长度（LV_INV_BUF_SIZE）
+
+static uint32_t s_rng = 1;
+static uint8_t s_cover[EXAMPLE_LCD_HEIGHT][EXAMPLE_LCD_WIDTH];
+
+static uint32_t test_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+static lv_area_t random_area(int32_t max_size)
+{
+    int32_t w = 1 + (int32_t)(test_rand() % (uint32_t)max_size);
+    int32_t h = 1 + (int32_t)(test_rand() % (uint32_t)max_size);
+    lv_area_t a;
+    a.x1 = (int32_t)(test_rand() % (EXAMPLE_LCD_WIDTH - w + 1));
+    a.y1 = (int32_t)(test_rand() % (EXAMPLE_LCD_HEIGHT - h + 1));
+    a.x2 = a.x1 + w - 1;
+    a.y2 = a.y1 + h - 1;
+    return a;
+}
+
+static bool test_spans(void)
+{
+    bool ok = true;
+    int32_t full = 0;
+
+    for (int32_t y = 0; y < EXAMPLE_LCD_HEIGHT; y++) {
+        int16_t x1 = lvgl_area_round_x1[y];
+        int16_t x2 = lvgl_area_round_x2[y];
+        int16_t mx1 = lvgl_area_round_x1[EXAMPLE_LCD_HEIGHT - 1 - y];
+        int16_t mx2 = lvgl_area_round_x2[EXAMPLE_LCD_HEIGHT - 1 - y];
+        if (x1 > x2) {
+            continue;
+        }
+        if (x1 % 4 || (x2 + 1) % 4 || x1 != mx1 || x2 != mx2 || x1 != EXAMPLE_LCD_WIDTH - 1 - x2) {
+            printf("row %" PRId32 ": span %d..%d (mirror %d..%d)\n", y, x1, x2, mx1, mx2);
+            ok = false;
+        }
+        full += (x1 == 0 && x2 == EXAMPLE_LCD_WIDTH - 1);
+    }
+    if (lvgl_area_round_x1[EXAMPLE_LCD_HEIGHT / 2] != 0 ||
+        lvgl_area_round_x2[EXAMPLE_LCD_HEIGHT / 2] != EXAMPLE_LCD_WIDTH - 1) {
+        ok = false;
+    }
+
+    uint32_t visible = 0;
+    for (int32_t y = 0; y < EXAMPLE_LCD_HEIGHT; y++) {
+        if (lvgl_area_round_x1[y] <= lvgl_area_round_x2[y]) {
+            visible += (uint32_t)(lvgl_area_round_x2[y] - lvgl_area_round_x1[y] + 1);
+        }
+    }
+    printf("spans: %" PRId32 " full-width rows, %" PRIu32 " of %d pixels sent (%.1f%% masked)\n", full, visible,
+           EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT,
+           100.0 * (1.0 - (double)visible / (EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT)));
+    return ok;
+}
+
+/* 原区域（对齐前）的每个可见像素必须仍在结果内 */
+static bool visible_kept(const lv_area_t *orig, const lv_area_t *out)
+{
+    int32_t x1, x2;
+
+    for (int32_t y = orig->y1; y <= orig->y2; y++) {
+        if (!lvgl_area_row_span(y, orig, &x1, &x2)) {
+            continue;
+        }
+        if (y < out->y1 || y > out->y2 || x1 < out->x1 || x2 > out->x2) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool has_visible(const lv_area_t *a)
+{
+    int32_t x1, x2;
+
+    for (int32_t y = a->y1; y <= a->y2; y++) {
+        if (lvgl_area_row_span(y, a, &x1, &x2)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool test_round(uint32_t count)
+{
+    uint32_t errors = 0;
+    uint32_t invisible = 0;
+    uint64_t in_pixels = 0;
+    uint64_t out_pixels = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        lv_area_t orig = random_area(1 + (int32_t)(test_rand() % 160));
+        lv_area_t a = orig;
+        bool visible = lvgl_area_round(&a);
+        bool ok;
+
+        if (!visible) {
+            invisible++;
+            ok = !has_visible(&orig);
+        } else {
+            ok = a.x1 % LVGL_TILE_SIZE == 0 && a.y1 % LVGL_TILE_SIZE == 0 &&
+                 ((a.x2 + 1) % LVGL_TILE_SIZE == 0 || a.x2 == EXAMPLE_LCD_WIDTH - 1) &&
+                 ((a.y2 + 1) % LVGL_TILE_SIZE == 0 || a.y2 == EXAMPLE_LCD_HEIGHT - 1) &&
+                 visible_kept(&orig, &a);
+            in_pixels += (uint64_t)lv_area_get_width(&orig) * lv_area_get_height(&orig);
+            out_pixels += (uint64_t)lv_area_get_width(&a) * lv_area_get_height(&a);
+        }
+        if (!ok) {
+            if (errors < 5) {
+                printf("area (%" PRId32 ",%" PRId32 ")-(%" PRId32 ",%" PRId32 ") -> (%" PRId32 ",%" PRId32
+                       ")-(%" PRId32 ",%" PRId32 ") %s\n", orig.x1, orig.y1, orig.x2, orig.y2,
+                       a.x1, a.y1, a.x2, a.y2, visible ? "visible" : "invisible");
+            }
+            errors++;
+        }
+    }
+
+    // LVGL 用 (0,0)-(0,h-1) 探测每次渲染的最大行数，只对齐不裁剪
+    lv_area_t probe = { 0, 0, 0, 99 };
+    if (!lvgl_area_round(&probe) || probe.y2 < 99 || probe.x1 != 0) {
+        printf("probe area was clipped to (%" PRId32 ",%" PRId32 ")-(%" PRId32 ",%" PRId32 ")\n",
+               probe.x1, probe.y1, probe.x2, probe.y2);
+        errors++;
+    }
+
+    printf("round: %" PRIu32 " areas, %" PRIu32 " fully invisible, visible ones %.2fx pixels after alignment, "
+           "%" PRIu32 " errors\n", count, invisible, in_pixels ? (double)out_pixels / in_pixels : 0.0, errors);
+    return errors == 0;
+}
+
+static uint32_t area_txns(const lv_area_t *a)
+{
+    return (uint32_t)((lvgl_area_cost(a, TEST_CHUNK_BYTES) - lv_area_get_width(a) * lv_area_get_height(a) * 2) /
+                      LVGL_MERGE_TXN_COST);
+}
+
+static bool test_merge(uint32_t frames)
+{
+    uint32_t errors = 0;
+    uint64_t areas_in = 0, areas_out = 0;
+    uint64_t txns_in = 0, txns_out = 0;
+    uint64_t cost_in = 0, cost_out = 0;
+
+    for (uint32_t f = 0; f < frames; f++) {
+        lv_area_t in[TEST_MAX_AREAS];
+        lv_area_t out[TEST_MAX_AREAS];
+        uint32_t n = 0;
+        uint32_t want = 2 + test_rand() % 14;
+
+        // 几个相邻的小区域（同一动画的多个图层）加上零散的小区域
+        int32_t cx = 60 + (int32_t)(test_rand() % 290);
+        int32_t cy = 60 + (int32_t)(test_rand() % 290);
+        while (n < want) {
+            lv_area_t a = random_area(48);
+            if (test_rand() % 3) {
+                int32_t w = lv_area_get_width(&a);
+                int32_t h = lv_area_get_height(&a);
+                a.x1 = LV_CLAMP(0, cx + (int32_t)(test_rand() % 80) - 40, EXAMPLE_LCD_WIDTH - w);
+                a.y1 = LV_CLAMP(0, cy + (int32_t)(test_rand() % 80) - 40, EXAMPLE_LCD_HEIGHT - h);
+                a.x2 = a.x1 + w - 1;
+                a.y2 = a.y1 + h - 1;
+            }
+            if (lvgl_area_round(&a)) {
+                in[n++] = a;
+            }
+        }
+
+        memcpy(out, in, sizeof(in[0]) * n);
+        uint32_t m = lvgl_area_merge(out, n, TEST_CHUNK_BYTES);
+
+        int64_t c_in = 0, c_out = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            c_in += lvgl_area_cost(&in[i], TEST_CHUNK_BYTES);
+            txns_in += area_txns(&in[i]);
+        }
+        for (uint32_t i = 0; i < m; i++) {
+            c_out += lvgl_area_cost(&out[i], TEST_CHUNK_BYTES);
+            txns_out += area_txns(&out[i]);
+        }
+
+        // 覆盖检查：输入区域的每个可见像素都在某个输出区域内
+        bool covered = true;
+        memset(s_cover, 0, sizeof(s_cover));
+        for (uint32_t i = 0; i < m; i++) {
+            for (int32_t y = out[i].y1; y <= out[i].y2; y++) {
+                memset(&s_cover[y][out[i].x1], 1, (size_t)lv_area_get_width(&out[i]));
+            }
+        }
+        for (uint32_t i = 0; i < n && covered; i++) {
+            int32_t x1, x2;
+            for (int32_t y = in[i].y1; y <= in[i].y2 && covered; y++) {
+                if (!lvgl_area_row_span(y, &in[i], &x1, &x2)) {
+                    continue;
+                }
+                for (int32_t x = x1; x <= x2; x++) {
+                    if (!s_cover[y][x]) {
+                        covered = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!covered || m > n || m == 0 || c_out > c_in) {
+            if (errors < 5) {
+                printf("frame %" PRIu32 ": %" PRIu32 " -> %" PRIu32 " areas, cost %" PRId64 " -> %" PRId64 "%s\n",
+                       f, n, m, c_in, c_out, covered ? "" : ", visible pixels lost");
+            }
+            errors++;
+        }
+        areas_in += n;
+        areas_out += m;
+        cost_in += (uint64_t)c_in;
+        cost_out += (uint64_t)c_out;
+    }
+
+    printf("merge: %" PRIu32 " frames, areas %.2f -> %.2f, txns %.2f -> %.2f, cost %.0f -> %.0f bytes/frame "
+           "(-%.1f%%), %" PRIu32 " errors\n", frames, (double)areas_in / frames, (double)areas_out / frames,
+           (double)txns_in / frames, (double)txns_out / frames, (double)cost_in / frames,
+           (double)cost_out / frames, 100.0 * (1.0 - (double)cost_out / cost_in), errors);
+    return errors == 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 20000;
+
+    lvgl_area_round_init();
+    bool ok = test_spans();
+    ok = test_round(frames * 5) && ok;
+    ok = test_merge(frames) && ok;
+
+    printf(ok ? "PASS\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}
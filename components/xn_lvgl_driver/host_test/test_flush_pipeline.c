@@ -0,0 +1,529 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\test_flush_pipeline.c
+ * @Description: 刷新路径测试：xn_lvgl_flush 驱动异步完成的假面板，校验发送顺序、弹跳缓冲区与完成通知
+ *
+ * 假面板按主机后端的总线模型（LVGL_HOST_BUS_BYTES_PER_SEC、LVGL_HOST_TXN_OVERHEAD_US）在 DMA 线程里
+ * 依次完成传输，每完成一块调用 lvgl_flush_on_done()，与 SPD2010 的完成钩子相同。测试模拟 LVGL 的
+ * 双缓冲：渲染下一个区域时上一个区域可能仍在发送，调用刷新前等待上一个区域通知完成。
+ * - 同一区域的传输块落在区域内、互不重叠，按图块行从上到下（同一图块行内的片段从左到右），
+ *   面板按提交顺序完成
+ * - 提交时记录数据校验和，完成时重新计算：弹跳缓冲区或绘制缓冲区在完成前被改写即失败；
+ *   提交时数据与仍在发送的传输重叠也算复用
+ * - 每个区域恰好通知一次，通知时该区域提交的传输已全部完成（发送失败立即通知的情况也一样）
+ * - 局部渲染（分块与无弹跳缓冲区时的整块发送）、直接渲染（行跨度为屏幕宽度）、随机发送失败，
+ *   最后整屏刷新一次，面板可见像素必须与场景一致
+ * 最后对比几种区域形状下分块流水线与整块直接发送的每区域刷新时间（从进入刷新到通知完成）。主机上交换
+ * 字节序比设备上从 PSRAM 读取快得多，流水线重叠带来的收益偏小；设备上的数字见 flush_area_us_avg。
+ *
+ *   test_flush_pipeline [区域数]     默认 3000
+ */
+#include "xn_lvgl_flush.h"
+#include "xn_lvgl_area.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SCREEN_PIXELS       (EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT)
+#define PANEL_QUEUE_LEN     16
+#define BENCH_ROUNDS        200
+#define READY_TIMEOUT_MS    (LVGL_FLUSH_TIMEOUT_MS * 2)     // 等待完成通知的超时，超时记为没有通知
+#define STRIP_PIXELS        ((LVGL_BUFFER_SIZE + 1) & ~1)   // 每块条带缓冲区 4 字节对齐（设备上分别分配）
+
+/** 假面板中排队的传输 */
+typedef struct {
+    int x1, y1, x2, y2;             // 窗口 [x1, x2) × [y1, y2)
+    const uint8_t *data;
+    size_t len;
+    uint32_t sum;                   // 提交时的数据校验和
+    uint64_t deadline_ns;           // 按总线模型完成的时刻
+} panel_txn_t;
+
+struct esp_lcd_panel_t {
+    pthread_t dma;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    panel_txn_t queue[PANEL_QUEUE_LEN];
+    uint32_t head;
+    uint32_t count;
+    uint64_t bus_free_ns;
+    uint32_t submitted;
+    uint32_t done;
+    uint32_t fail_permille;         // 随机发送失败的概率（‰）
+    bool stop;
+    uint16_t fb[SCREEN_PIXELS];     // 面板内容（大端序，与发送的数据相同）
+};
+
+/** 检查结果 */
+typedef struct {
+    uint32_t order;                 // 传输块不按图块行递增、超出区域或与同一区域之前的块重叠
+    uint32_t reuse;                 // 提交的数据与仍在发送的传输重叠
+    uint32_t corrupt;               // 传输完成前数据被改写
+    uint32_t ready_twice;           // 同一区域通知了两次
+    uint32_t ready_early;           // 通知时还有该区域的传输没有完成
+    uint32_t ready_missing;         // 区域没有通知
+    uint32_t mismatch;              // 最终面板内容与场景不同的像素数
+} test_errors_t;
+
+static struct esp_lcd_panel_t s_panel;
+static test_errors_t s_err;
+static uint32_t s_rng = 1;
+
+// 场景（LVGL 渲染结果的真值）、直接渲染的帧缓冲与两块条带缓冲区（图块哈希按 32 位读取，4 字节对齐）
+static uint16_t s_scene[SCREEN_PIXELS];
+static uint16_t s_fb[SCREEN_PIXELS] __attribute__((aligned(4)));
+static uint16_t s_strip[2][STRIP_PIXELS] __attribute__((aligned(4)));
+
+// 当前区域的刷新状态（LVGL 的 flushing 标志）
+static pthread_mutex_t s_ready_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_ready_cond = PTHREAD_COND_INITIALIZER;
+static bool s_flushing;
+static uint32_t s_ready_calls;
+static uint64_t s_ready_ns;
+static lv_area_t s_flush_area;
+static uint32_t s_flush_seq;        // 当前区域序号
+static int32_t s_band_y;            // 当前区域上一块的起始行
+static uint32_t s_sent[SCREEN_PIXELS];  // 每个像素最近一次发送所属的区域序号
+
+static uint32_t test_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t checksum(const uint8_t *data, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ data[i]) * 16777619u;
+    }
+    return h;
+}
+
+/*********************
+ * 刷新完成通知（LVGL 的 lv_display_flush_ready）
+ *********************/
+
+static void test_flush_ready(void)
+{
+    pthread_mutex_lock(&s_panel.lock);
+    bool all_done = s_panel.done == s_panel.submitted;
+    pthread_mutex_unlock(&s_panel.lock);
+
+    pthread_mutex_lock(&s_ready_lock);
+    if (!s_flushing) {
+        s_err.ready_twice++;
+    }
+    if (!all_done) {
+        s_err.ready_early++;
+    }
+    s_flushing = false;
+    s_ready_calls++;
+    s_ready_ns = now_ns();
+    pthread_cond_broadcast(&s_ready_cond);
+    pthread_mutex_unlock(&s_ready_lock);
+}
+
+/* 等待上一个区域通知完成（LVGL 调用刷新回调前的 wait_for_flushing） */
+static bool test_wait_flushing(void)
+{
+    struct timespec deadline;
+    bool ok = true;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += READY_TIMEOUT_MS * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+    pthread_mutex_lock(&s_ready_lock);
+    while (s_flushing && ok) {
+        ok = pthread_cond_timedwait(&s_ready_cond, &s_ready_lock, &deadline) == 0;
+    }
+    if (s_flushing) {
+        s_err.ready_missing++;
+        s_flushing = false;
+    }
+    pthread_mutex_unlock(&s_ready_lock);
+    return ok;
+}
+
+/*********************
+ * 假面板
+ *********************/
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                    const void *color_data)
+{
+    size_t len = (size_t)(x_end - x_start) * (y_end - y_start) * 2;
+    const uint8_t *data = color_data;
+
+    // 下一块不能早于上一块所在图块行的起始行
+    int32_t row_y = LV_MAX(s_flush_area.y1, s_band_y / LVGL_TILE_SIZE * LVGL_TILE_SIZE);
+    bool bad = y_start < row_y || y_end > s_flush_area.y2 + 1 || y_end <= y_start ||
+               x_start < s_flush_area.x1 || x_end > s_flush_area.x2 + 1 || x_end <= x_start;
+    for (int y = y_start; y < y_end && !bad; y++) {
+        for (int x = x_start; x < x_end; x++) {
+            bad = bad || s_sent[y * EXAMPLE_LCD_WIDTH + x] == s_flush_seq;
+            s_sent[y * EXAMPLE_LCD_WIDTH + x] = s_flush_seq;
+        }
+    }
+    s_err.order += bad;
+    s_band_y = y_start;
+
+    if (panel->fail_permille && test_rand() % 1000 < panel->fail_permille) {
+        return ESP_FAIL;
+    }
+
+    pthread_mutex_lock(&panel->lock);
+    for (uint32_t i = 0; i < panel->count; i++) {
+        const panel_txn_t *t = &panel->queue[(panel->head + i) % PANEL_QUEUE_LEN];
+        if (data < t->data + t->len && t->data < data + len) {
+            s_err.reuse++;
+        }
+    }
+    if (panel->count == PANEL_QUEUE_LEN) {
+        pthread_mutex_unlock(&panel->lock);
+        return ESP_FAIL;
+    }
+
+    uint64_t start = LV_MAX(now_ns(), panel->bus_free_ns);
+    panel_txn_t *t = &panel->queue[(panel->head + panel->count) % PANEL_QUEUE_LEN];
+    t->x1 = x_start;
+    t->y1 = y_start;
+    t->x2 = x_end;
+    t->y2 = y_end;
+    t->data = data;
+    t->len = len;
+    t->sum = checksum(data, len);
+    t->deadline_ns = start + LVGL_HOST_TXN_OVERHEAD_US * 1000ull + len * 1000000000ull / LVGL_HOST_BUS_BYTES_PER_SEC;
+    panel->bus_free_ns = t->deadline_ns;
+    panel->count++;
+    panel->submitted++;
+    pthread_cond_signal(&panel->cond);
+    pthread_mutex_unlock(&panel->lock);
+    return ESP_OK;
+}
+
+/* DMA 线程：按提交顺序在模型时刻完成传输，写入面板后调用完成钩子 */
+static void *panel_dma_thread(void *arg)
+{
+    struct esp_lcd_panel_t *panel = arg;
+
+    pthread_mutex_lock(&panel->lock);
+    while (!panel->stop) {
+        if (panel->count == 0) {
+            pthread_cond_wait(&panel->cond, &panel->lock);
+            continue;
+        }
+        panel_txn_t t = panel->queue[panel->head];
+        pthread_mutex_unlock(&panel->lock);
+
+        struct timespec ts = {
+            .tv_sec = (time_t)(t.deadline_ns / 1000000000ull),
+            .tv_nsec = (long)(t.deadline_ns % 1000000000ull),
+        };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+        }
+        if (checksum(t.data, t.len) != t.sum) {
+            s_err.corrupt++;
+        }
+        int w = t.x2 - t.x1;
+        for (int y = t.y1; y < t.y2; y++) {
+            memcpy(&panel->fb[y * EXAMPLE_LCD_WIDTH + t.x1], t.data + (size_t)(y - t.y1) * w * 2, (size_t)w * 2);
+        }
+
+        pthread_mutex_lock(&panel->lock);
+        panel->head = (panel->head + 1) % PANEL_QUEUE_LEN;
+        panel->count--;
+        uint32_t done = ++panel->done;
+        pthread_mutex_unlock(&panel->lock);
+
+        BaseType_t need_yield = pdFALSE;
+        if (lvgl_flush_on_done(done, &need_yield)) {
+            test_flush_ready();
+        }
+        pthread_mutex_lock(&panel->lock);
+    }
+    pthread_mutex_unlock(&panel->lock);
+    return NULL;
+}
+
+/*********************
+ * 模拟 LVGL
+ *********************/
+
+/* 刷新一个区域：等待上一个区域完成后调用刷新，需要时立即通知 */
+static void test_flush(const lv_area_t *area, uint8_t *px, int32_t stride, lvgl_flush_counters_t *cnt)
+{
+    test_wait_flushing();
+    pthread_mutex_lock(&s_ready_lock);
+    s_flushing = true;
+    pthread_mutex_unlock(&s_ready_lock);
+
+    s_flush_area = *area;
+    s_flush_seq++;
+    s_band_y = area->y1;
+    if (lvgl_flush_area(&s_panel, area, px, stride, cnt)) {
+        test_flush_ready();
+    }
+}
+
+/* 改写场景中区域内的内容：不变、随机噪声或纯色矩形 */
+static void scene_update(const lv_area_t *area, bool force_noise)
+{
+    uint32_t kind = force_noise ? 1 : test_rand() % 3;
+    lv_area_t r = *area;
+
+    if (kind == 0) {
+        return;
+    }
+    if (!force_noise) {
+        r.x1 += (int32_t)(test_rand() % (uint32_t)lv_area_get_width(area));
+        r.y1 += (int32_t)(test_rand() % (uint32_t)lv_area_get_height(area));
+    }
+    uint16_t colour = (uint16_t)test_rand();
+    for (int32_t y = r.y1; y <= r.y2; y++) {
+        for (int32_t x = r.x1; x <= r.x2; x++) {
+            s_scene[y * EXAMPLE_LCD_WIDTH + x] = kind == 1 ? (uint16_t)test_rand() : colour;
+        }
+    }
+}
+
+/* 局部渲染：区域按条带缓冲区能容纳的行数拆开，轮流渲染到两块缓冲区后刷新 */
+static uint32_t render_partial(const lv_area_t *area, uint32_t *strip_next, lvgl_flush_counters_t *cnt)
+{
+    int32_t width = lv_area_get_width(area);
+    int32_t max_rows = LVGL_BUFFER_SIZE / width;
+    uint32_t flushes = 0;
+
+    for (int32_t y = area->y1; y <= area->y2; y += max_rows) {
+        lv_area_t strip = {area->x1, y, area->x2, LV_MIN(area->y2, y + max_rows - 1)};
+        uint16_t *buf = s_strip[*strip_next];
+        *strip_next ^= 1;
+        // 这块缓冲区上一次的区域在上一个区域刷新前已通知完成，可以直接改写
+        for (int32_t r = strip.y1; r <= strip.y2; r++) {
+            memcpy(&buf[(r - strip.y1) * width], &s_scene[r * EXAMPLE_LCD_WIDTH + strip.x1], (size_t)width * 2);
+        }
+        test_flush(&strip, (uint8_t *)buf, width * 2, cnt);
+        flushes++;
+    }
+    return flushes;
+}
+
+/* 直接渲染：整屏帧缓冲只有一块，改写前等待上一个区域完成 */
+static uint32_t render_direct(const lv_area_t *area, lvgl_flush_counters_t *cnt)
+{
+    test_wait_flushing();
+    for (int32_t r = area->y1; r <= area->y2; r++) {
+        memcpy(&s_fb[r * EXAMPLE_LCD_WIDTH + area->x1], &s_scene[r * EXAMPLE_LCD_WIDTH + area->x1],
+               (size_t)lv_area_get_width(area) * 2);
+    }
+    test_flush(area, (uint8_t *)&s_fb[area->y1 * EXAMPLE_LCD_WIDTH + area->x1], EXAMPLE_LCD_WIDTH * 2, cnt);
+    return 1;
+}
+
+/* 随机失效区域，经对齐回调处理（完全不可见时为 4 个像素，刷新时没有传输） */
+static lv_area_t random_area(void)
+{
+    lv_area_t a;
+    bool wide = test_rand() % 4 == 0;
+    bool tall = test_rand() % 4 == 0;
+    int32_t w = 4 + (int32_t)(test_rand() % (wide ? EXAMPLE_LCD_WIDTH - 4 : 96));
+    int32_t h = 1 + (int32_t)(test_rand() % (tall ? EXAMPLE_LCD_HEIGHT : 64));
+
+    a.x1 = (int32_t)(test_rand() % (uint32_t)(EXAMPLE_LCD_WIDTH - w + 1));
+    a.y1 = (int32_t)(test_rand() % (uint32_t)(EXAMPLE_LCD_HEIGHT - h + 1));
+    a.x2 = a.x1 + w - 1;
+    a.y2 = a.y1 + h - 1;
+    lvgl_area_round(&a);
+    return a;
+}
+
+typedef enum {
+    PHASE_PIPELINED,            // 局部渲染，分块流水线
+    PHASE_DIRECT_RENDER,        // 直接渲染，分块流水线（行跨度为屏幕宽度）
+    PHASE_NO_BOUNCE,            // 局部渲染，没有弹跳缓冲区，整块直接发送
+    PHASE_FAILURES,             // 局部渲染，分块流水线，随机发送失败
+    PHASE_COUNT,
+} test_phase_t;
+
+static const char *const s_phase_name[PHASE_COUNT] = {"pipelined", "direct render", "no bounce", "failures"};
+
+static bool run_phase(test_phase_t phase, uint32_t areas)
+{
+    lvgl_flush_counters_t cnt = {0};
+    uint32_t strip_next = 0;
+    uint32_t flushes = 0;
+    uint32_t ready_before = s_ready_calls;
+    uint32_t submitted_before = lvgl_flush_submitted();
+    test_errors_t before = s_err;
+
+    if (phase == PHASE_NO_BOUNCE) {
+        lvgl_flush_deinit();
+    } else if (!lvgl_flush_pipelined() && lvgl_flush_init() != ESP_OK) {
+        printf("%s: bounce buffers unavailable\n", s_phase_name[phase]);
+        return false;
+    }
+    s_panel.fail_permille = phase == PHASE_FAILURES ? 20 : 0;
+
+    // 出现没有通知的区域后不再继续，避免每个区域都等到超时
+    for (uint32_t i = 0; i < areas && s_err.ready_missing == before.ready_missing; i++) {
+        lv_area_t a = random_area();
+        scene_update(&a, false);
+        flushes += phase == PHASE_DIRECT_RENDER ? render_direct(&a, &cnt) : render_partial(&a, &strip_next, &cnt);
+    }
+    test_wait_flushing();
+    s_panel.fail_permille = 0;
+
+    uint32_t txns = lvgl_flush_submitted() - submitted_before;
+    if (s_ready_calls - ready_before < flushes) {
+        s_err.ready_missing += flushes - (s_ready_calls - ready_before);
+    }
+    bool ok = memcmp(&before, &s_err, sizeof(s_err)) == 0 && cnt.txns == txns;
+    printf("%-14s %6" PRIu32 " flushes %7" PRIu32 " txns %10" PRIu32 " bytes, tiles %" PRIu32 "/%" PRIu32
+           " skipped  %s\n", s_phase_name[phase], flushes, txns, cnt.bytes, cnt.tiles.skipped, cnt.tiles.checked,
+           ok ? "ok" : "FAILED");
+    return ok;
+}
+
+/* 整屏刷新一次后比较面板与场景的可见像素 */
+static bool check_panel(void)
+{
+    const lv_area_t screen = {0, 0, EXAMPLE_LCD_WIDTH - 1, EXAMPLE_LCD_HEIGHT - 1};
+    lvgl_flush_counters_t cnt = {0};
+    uint32_t strip_next = 0;
+    uint32_t before = s_err.mismatch;
+    int32_t x1, x2;
+
+    render_partial(&screen, &strip_next, &cnt);
+    test_wait_flushing();
+
+    for (int32_t y = 0; y < EXAMPLE_LCD_HEIGHT; y++) {
+        if (!lvgl_area_row_span(y, &screen, &x1, &x2)) {
+            continue;
+        }
+        for (int32_t x = x1; x <= x2; x++) {
+            uint16_t v = s_panel.fb[y * EXAMPLE_LCD_WIDTH + x];
+            if ((uint16_t)((v << 8) | (v >> 8)) != s_scene[y * EXAMPLE_LCD_WIDTH + x]) {
+                s_err.mismatch++;
+            }
+        }
+    }
+    printf("final refresh: %" PRIu32 " txns, %" PRIu32 " bytes, %" PRIu32 " mismatched pixels\n",
+           cnt.txns, cnt.bytes, s_err.mismatch - before);
+    return s_err.mismatch == before;
+}
+
+/*********************
+ * 基准：每区域刷新时间
+ *********************/
+
+typedef struct {
+    const char *name;
+    lv_area_t area;
+} bench_shape_t;
+
+static const bench_shape_t s_shapes[] = {
+    {"strip 412x20", {0, 196, 411, 215}},
+    {"strip 400x20 edge", {4, 40, 403, 59}},
+    {"box 192x40", {112, 192, 303, 231}},
+    {"tile 64x64", {176, 176, 239, 239}},
+    {"small 32x8", {192, 200, 223, 207}},
+};
+
+/* 逐个区域刷新并等待完成，内容每次都变化（不跳过图块），返回平均每区域微秒数 */
+static double bench_shape(const lv_area_t *area, lvgl_flush_counters_t *cnt)
+{
+    int32_t width = lv_area_get_width(area);
+    uint64_t total_ns = 0;
+
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        scene_update(area, true);
+        for (int32_t y = area->y1; y <= area->y2; y++) {
+            memcpy(&s_strip[0][(y - area->y1) * width], &s_scene[y * EXAMPLE_LCD_WIDTH + area->x1],
+                   (size_t)width * 2);
+        }
+        uint64_t t0 = now_ns();
+        test_flush(area, (uint8_t *)s_strip[0], width * 2, cnt);
+        if (!test_wait_flushing()) {
+            return 0;
+        }
+        total_ns += s_ready_ns - t0;
+    }
+    return total_ns / 1000.0 / BENCH_ROUNDS;
+}
+
+static bool run_bench(void)
+{
+    test_errors_t before = s_err;
+
+    printf("flush time per area (%d rounds, bus %.0f MB/s + %d us/txn):\n", BENCH_ROUNDS,
+           LVGL_HOST_BUS_BYTES_PER_SEC / 1e6, LVGL_HOST_TXN_OVERHEAD_US);
+    printf("%-20s %8s %12s %6s %12s %6s %8s\n", "area", "bytes", "pipelined us", "txns", "direct us", "txns",
+           "speedup");
+    for (size_t i = 0; i < sizeof(s_shapes) / sizeof(s_shapes[0]); i++) {
+        lvgl_flush_counters_t pipe = {0};
+        lvgl_flush_counters_t direct = {0};
+
+        lvgl_flush_init();
+        double pipe_us = bench_shape(&s_shapes[i].area, &pipe);
+        lvgl_flush_deinit();
+        double direct_us = bench_shape(&s_shapes[i].area, &direct);
+        printf("%-20s %8" PRIu32 " %12.1f %6.1f %12.1f %6.1f %7.2fx\n", s_shapes[i].name,
+               pipe.bytes / BENCH_ROUNDS, pipe_us, (double)pipe.txns / BENCH_ROUNDS, direct_us,
+               (double)direct.txns / BENCH_ROUNDS, pipe_us > 0 ? direct_us / pipe_us : 0.0);
+    }
+    return memcmp(&before, &s_err, sizeof(s_err)) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t areas = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 3000;
+    bool ok = true;
+
+    // 发送失败阶段每次失败都会打印警告
+    esp_log_level_set("*", ESP_LOG_ERROR);
+    lvgl_area_round_init();
+    lvgl_tile_reset();
+    for (size_t i = 0; i < SCREEN_PIXELS; i++) {
+        s_scene[i] = (uint16_t)test_rand();
+    }
+
+    pthread_mutex_init(&s_panel.lock, NULL);
+    pthread_cond_init(&s_panel.cond, NULL);
+    pthread_create(&s_panel.dma, NULL, panel_dma_thread, &s_panel);
+
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        ok = run_phase((test_phase_t)phase, areas / PHASE_COUNT) && ok;
+    }
+    ok = check_panel() && ok;
+    ok = run_bench() && ok;
+
+    pthread_mutex_lock(&s_panel.lock);
+    s_panel.stop = true;
+    pthread_cond_signal(&s_panel.cond);
+    pthread_mutex_unlock(&s_panel.lock);
+    pthread_join(s_panel.dma, NULL);
+    lvgl_flush_deinit();
+
+    printf("errors: order %" PRIu32 ", reuse %" PRIu32 ", corrupt %" PRIu32 ", ready twice %" PRIu32
+           ", ready early %" PRIu32 ", ready missing %" PRIu32 ", mismatched pixels %" PRIu32 "\n",
+           s_err.order, s_err.reuse, s_err.corrupt, s_err.ready_twice, s_err.ready_early, s_err.ready_missing,
+           s_err.mismatch);
+    printf(ok ? "PASS\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}
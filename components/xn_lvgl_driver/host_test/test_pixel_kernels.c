@@ -0,0 +1,320 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\test_pixel_kernels.c
+ * @Description: xn_lvgl_pixel 内核的正确性与吞吐量测试
+ *
+ * - 字节序交换、ARGB8888 转 RGB565（含有序抖动）：与逐像素参考实现逐位一致，
+ *   覆盖原地 / 异地、各种首地址对齐与奇数长度
+ * - ARGB8888 混合到 RGB565：内核按 5 位 alpha 混合，与按 8 位 alpha 在 RGB565 域混合的结果
+ *   相比每通道误差不超过 1 个最低位（opa = 255 与整体半透明两种情况）
+ * - 吞吐量：每个内核与逐像素参考实现处理 412x412 整屏的像素/秒（主机 CPU，仅作相对比较）
+ *
+ *   test_pixel_kernels [混合随机像素数]     默认 4000000
+ */
+#include "xn_lvgl_pixel.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PIXEL_TEST_W        412
+#define PIXEL_TEST_H        412
+#define PIXEL_TEST_PIXELS   (PIXEL_TEST_W * PIXEL_TEST_H)
+#define PIXEL_BENCH_MS      200
+
+static uint32_t s_rng = 1;
+
+static uint32_t test_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return (s_rng >> 16) | (s_rng << 16);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* ---------------- 逐像素参考实现 ---------------- */
+
+static void ref_swap(uint16_t *dst, const uint16_t *src, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t v = src[i];
+        dst[i] = (uint16_t)((v << 8) | (v >> 8));
+    }
+}
+
+static uint16_t ref_rgb565(uint32_t p)
+{
+    uint32_t r = (p >> 16) & 0xFF;
+    uint32_t g = (p >> 8) & 0xFF;
+    uint32_t b = p & 0xFF;
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+static void ref_convert(uint16_t *dst, const uint32_t *src, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        dst[i] = ref_rgb565(src[i]);
+    }
+}
+
+// 4x4 Bayer 阈值：5 位通道加 t/2，6 位通道加 t/4，饱和后截断
+static void ref_dither(uint16_t *dst, const uint32_t *src, uint32_t width, uint32_t height)
+{
+    static const uint8_t bayer[4][4] = {
+        { 0,  8,  2, 10}, {12,  4, 14,  6}, { 3, 11,  1,  9}, {15,  7, 13,  5},
+    };
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t p = src[y * width + x];
+            uint32_t t = bayer[y & 3][x & 3];
+            uint32_t c[3] = { (p >> 16) & 0xFF, (p >> 8) & 0xFF, p & 0xFF };
+            uint32_t add[3] = { t / 2, t / 4, t / 2 };
+            for (int k = 0; k < 3; k++) {
+                c[k] = c[k] + add[k] > 0xFF ? 0xFF : c[k] + add[k];
+            }
+            dst[y * width + x] = (uint16_t)(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+        }
+    }
+}
+
+// 8 位 alpha（含整体不透明度）在 RGB565 域逐通道混合并四舍五入
+static uint16_t ref_blend8(uint16_t d, uint32_t p, uint8_t opa)
+{
+    uint32_t a = ((p >> 24) * opa + 127) / 255;
+    uint16_t s = ref_rgb565(p);
+    uint32_t sc[3] = { s >> 11, (s >> 5) & 0x3F, s & 0x1F };
+    uint32_t dc[3] = { d >> 11, (d >> 5) & 0x3F, d & 0x1F };
+    uint32_t oc[3];
+    for (int k = 0; k < 3; k++) {
+        oc[k] = (sc[k] * a + dc[k] * (255 - a) + 127) / 255;
+    }
+    return (uint16_t)((oc[0] << 11) | (oc[1] << 5) | oc[2]);
+}
+
+static void ref_blend(uint16_t *dst, const uint32_t *src, uint32_t count, uint8_t opa)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        dst[i] = ref_blend8(dst[i], src[i], opa);
+    }
+}
+
+/* ---------------- 正确性 ---------------- */
+
+static void fill_random(void *buf, size_t bytes)
+{
+    uint8_t *p = buf;
+    for (size_t i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)test_rand();
+    }
+}
+
+static uint32_t check_swap(void)
+{
+    enum { N = 259 };
+    uint16_t src[N + 4], dst[N + 4], ref[N + 4], in_place[N + 4];
+    uint32_t errors = 0;
+
+    for (int so = 0; so < 2; so++) {
+        for (int dof = 0; dof < 2; dof++) {
+            for (uint32_t count = 0; count <= N; count += (count < 20) ? 1 : 37) {
+                fill_random(src, sizeof(src));
+                memset(dst, 0xAA, sizeof(dst));
+                memset(ref, 0xAA, sizeof(ref));
+                lvgl_pixel_rgb565_swap(dst + dof, src + so, count);
+                ref_swap(ref + dof, src + so, count);
+                errors += memcmp(dst, ref, sizeof(dst)) != 0;
+
+                memcpy(in_place, src, sizeof(src));
+                lvgl_pixel_rgb565_swap(in_place + so, in_place + so, count);
+                ref_swap(ref, src, N + 4);
+                errors += memcmp(in_place + so, ref + so, count * 2) != 0;
+            }
+        }
+    }
+    return errors;
+}
+
+static uint32_t check_convert(void)
+{
+    enum { N = 259 };
+    uint32_t src[N];
+    uint16_t dst[N + 2], ref[N + 2];
+    uint32_t errors = 0;
+
+    for (int dof = 0; dof < 2; dof++) {
+        for (uint32_t count = 0; count <= N; count += (count < 20) ? 1 : 37) {
+            fill_random(src, sizeof(src));
+            memset(dst, 0x55, sizeof(dst));
+            memset(ref, 0x55, sizeof(ref));
+            lvgl_pixel_argb8888_to_rgb565(dst + dof, src, count);
+            ref_convert(ref + dof, src, count);
+            errors += memcmp(dst, ref, sizeof(dst)) != 0;
+        }
+    }
+
+    static uint32_t img[37 * 23];
+    static uint16_t out[37 * 23], out_ref[37 * 23];
+    fill_random(img, sizeof(img));
+    lvgl_pixel_argb8888_to_rgb565_dither(out, img, 37, 23);
+    ref_dither(out_ref, img, 37, 23);
+    errors += memcmp(out, out_ref, sizeof(out)) != 0;
+    return errors;
+}
+
+// 返回每通道最大误差（最低位），hist 统计误差为 0 / 1 / >1 的通道数
+static uint32_t check_blend(uint32_t pixels, uint8_t opa, uint64_t hist[3])
+{
+    enum { N = 256 };
+    uint32_t src[N];
+    uint16_t dst[N], ref[N];
+    uint32_t max_err = 0;
+
+    for (uint32_t done = 0; done < pixels; done += N) {
+        fill_random(src, sizeof(src));
+        fill_random(dst, sizeof(dst));
+        // 混入全透明 / 全不透明 / 截断阈值附近的 alpha
+        for (int i = 0; i < 16; i++) {
+            static const uint8_t edge[] = { 0, 1, 3, 4, 5, 251, 252, 253, 255 };
+            src[test_rand() % N] = (src[i] & 0x00FFFFFFu) | ((uint32_t)edge[test_rand() % sizeof(edge)] << 24);
+        }
+        memcpy(ref, dst, sizeof(dst));
+        lvgl_pixel_argb8888_blend_rgb565(dst, src, N, opa);
+        ref_blend(ref, src, N, opa);
+
+        for (int i = 0; i < N; i++) {
+            int o[3] = { dst[i] >> 11, (dst[i] >> 5) & 0x3F, dst[i] & 0x1F };
+            int r[3] = { ref[i] >> 11, (ref[i] >> 5) & 0x3F, ref[i] & 0x1F };
+            for (int k = 0; k < 3; k++) {
+                uint32_t e = (uint32_t)abs(o[k] - r[k]);
+                hist[e > 1 ? 2 : e]++;
+                if (e > max_err) {
+                    max_err = e;
+                }
+            }
+        }
+    }
+    return max_err;
+}
+
+// 混合钩子：行跨度与源对齐检查
+static uint32_t check_blend_image(void)
+{
+    enum { W = 13, H = 7, DST_STRIDE = 40, SRC_STRIDE = 64 };
+    static uint32_t src[H * SRC_STRIDE / 4 + 1];
+    static uint16_t dst[H * DST_STRIDE / 2], ref[H * DST_STRIDE / 2];
+    uint32_t errors = 0;
+
+    fill_random(src, sizeof(src));
+    fill_random(dst, sizeof(dst));
+    memcpy(ref, dst, sizeof(dst));
+    for (int y = 0; y < H; y++) {
+        lvgl_pixel_argb8888_blend_rgb565(ref + y * DST_STRIDE / 2, src + y * SRC_STRIDE / 4, W, 200);
+    }
+    errors += !lvgl_pixel_blend_image_argb8888_to_rgb565(dst, DST_STRIDE, src, SRC_STRIDE, W, H, 200);
+    errors += memcmp(dst, ref, sizeof(dst)) != 0;
+
+    // 源地址或跨度不是 4 字节对齐时交还给 LVGL
+    errors += lvgl_pixel_blend_image_argb8888_to_rgb565(dst, DST_STRIDE, (uint8_t *)src + 2, SRC_STRIDE, W, H, 255);
+    errors += lvgl_pixel_blend_image_argb8888_to_rgb565(dst, DST_STRIDE, src, SRC_STRIDE + 2, W, H, 255);
+    return errors;
+}
+
+/* ---------------- 吞吐量 ---------------- */
+
+typedef void (*bench_fn_t)(void *dst, const void *src);
+
+static uint16_t *s_bench_dst;
+static uint32_t *s_bench_src;
+
+static void run_swap(void *d, const void *s) { lvgl_pixel_rgb565_swap(d, s, PIXEL_TEST_PIXELS); }
+static void run_swap_ref(void *d, const void *s) { ref_swap(d, s, PIXEL_TEST_PIXELS); }
+static void run_conv(void *d, const void *s) { lvgl_pixel_argb8888_to_rgb565(d, s, PIXEL_TEST_PIXELS); }
+static void run_conv_ref(void *d, const void *s) { ref_convert(d, s, PIXEL_TEST_PIXELS); }
+static void run_dither(void *d, const void *s) { lvgl_pixel_argb8888_to_rgb565_dither(d, s, PIXEL_TEST_W, PIXEL_TEST_H); }
+static void run_dither_ref(void *d, const void *s) { ref_dither(d, s, PIXEL_TEST_W, PIXEL_TEST_H); }
+static void run_blend(void *d, const void *s) { lvgl_pixel_argb8888_blend_rgb565(d, s, PIXEL_TEST_PIXELS, 255); }
+static void run_blend_ref(void *d, const void *s) { ref_blend(d, s, PIXEL_TEST_PIXELS, 255); }
+
+static double bench(bench_fn_t fn, const void *src)
+{
+    uint64_t start = now_ns();
+    uint64_t end = start + (uint64_t)PIXEL_BENCH_MS * 1000000ull;
+    uint64_t frames = 0;
+    uint64_t now;
+
+    do {
+        fn(s_bench_dst, src);
+        frames++;
+        now = now_ns();
+    } while (now < end);
+    return (double)frames * PIXEL_TEST_PIXELS * 1e9 / (double)(now - start);
+}
+
+static void bench_pair(const char *name, bench_fn_t fn, bench_fn_t ref, const void *src)
+{
+    double fast = bench(fn, src);
+    double slow = bench(ref, src);
+    printf("  %-22s %8.1f Mpx/s   per-pixel reference %8.1f Mpx/s   x%.2f\n",
+           name, fast / 1e6, slow / 1e6, fast / slow);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t pixels = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 4000000;
+    bool ok = true;
+
+    uint32_t swap_errors = check_swap();
+    uint32_t conv_errors = check_convert();
+    uint32_t image_errors = check_blend_image();
+    printf("swap: %s, convert/dither: %s, blend image hook: %s\n",
+           swap_errors ? "MISMATCH" : "bit-exact", conv_errors ? "MISMATCH" : "bit-exact",
+           image_errors ? "MISMATCH" : "ok");
+    ok = !swap_errors && !conv_errors && !image_errors;
+
+    static const uint8_t opas[] = { 255, 200, 128, 37 };
+    for (size_t i = 0; i < sizeof(opas); i++) {
+        uint64_t hist[3] = { 0 };
+        uint32_t max_err = check_blend(pixels, opas[i], hist);
+        uint64_t total = hist[0] + hist[1] + hist[2];
+        printf("blend opa %3u: max %" PRIu32 " LSB vs 8-bit alpha mix, channels off by 1: %.2f%%, by >1: %" PRIu64 "\n",
+               opas[i], max_err, hist[1] * 100.0 / total, hist[2]);
+        ok = ok && max_err <= 1;
+    }
+
+    s_bench_dst = malloc(PIXEL_TEST_PIXELS * sizeof(uint32_t));
+    s_bench_src = malloc(PIXEL_TEST_PIXELS * sizeof(uint32_t));
+    uint32_t *semi = malloc(PIXEL_TEST_PIXELS * sizeof(uint32_t));
+    fill_random(s_bench_dst, PIXEL_TEST_PIXELS * sizeof(uint32_t));
+    fill_random(s_bench_src, PIXEL_TEST_PIXELS * sizeof(uint32_t));
+    memcpy(semi, s_bench_src, PIXEL_TEST_PIXELS * sizeof(uint32_t));
+
+    // 典型 UI 图像：大部分全透明或不透明，边缘抗锯齿为半透明
+    for (uint32_t i = 0; i < PIXEL_TEST_PIXELS; i++) {
+        uint32_t r = test_rand() % 10;
+        uint32_t a = r < 4 ? 0 : r < 9 ? 0xFF : (test_rand() & 0xFF);
+        s_bench_src[i] = (s_bench_src[i] & 0x00FFFFFFu) | (a << 24);
+    }
+
+    printf("throughput (%dx%d frame, host CPU):\n", PIXEL_TEST_W, PIXEL_TEST_H);
+    bench_pair("rgb565 swap", run_swap, run_swap_ref, s_bench_src);
+    bench_pair("argb8888 -> rgb565", run_conv, run_conv_ref, s_bench_src);
+    bench_pair("argb8888 -> rgb565 dith", run_dither, run_dither_ref, s_bench_src);
+    bench_pair("blend (ui alpha mix)", run_blend, run_blend_ref, s_bench_src);
+    bench_pair("blend (random alpha)", run_blend, run_blend_ref, semi);
+
+    free(semi);
+    free(s_bench_src);
+    free(s_bench_dst);
+
+    printf(ok ? "PASS\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}
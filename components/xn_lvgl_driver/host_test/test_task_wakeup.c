@@ -0,0 +1,172 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\host_test\test_task_wakeup.c
+ * @Description: LVGL 任务唤醒测试：触摸通知在刷新周期到期前唤醒任务，输出输入到刷新的延迟
+ *
+ * 模拟的 LVGL 任务与设备端 lvgl_timer_task 相同：lvgl_wake_wait() 睡眠到定时器处理函数返回的截止时间，
+ * 收到 LVGL_WAKE_TOUCH 时读取输入并让刷新定时器就绪（lv_timer_ready），下一轮立即刷新。定时器处理函数
+ * 只有一个周期为 period 的刷新定时器，刷新时读取输入（LVGL 的读取定时器与刷新周期相同）。
+ * 主线程在一次刷新后的前 1/4 周期内随机按下，记录按下到下一次刷新读到输入的延迟：
+ * - 通知：按下后发送 LVGL_WAKE_TOUCH（触摸中断），每次延迟都必须小于半个刷新周期，且计入 wake_touch
+ * - 轮询：不发送通知（触摸未接中断），输入要等到下一个刷新周期才被读到（接近最坏情况），作为对照
+ *
+ *   test_task_wakeup [每种周期的按下次数]     默认 30
+ */
+#include "xn_lvgl_wake.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WAKE_MAX_SAMPLES    256
+#define WAKE_BUDGET_MS      2000        // 每种周期、每种方式按下间隔的总时长上限（长周期时减少按下次数）
+
+static const uint32_t s_periods_ms[] = {16, 33, 100, LVGL_TASK_MAX_SLEEP_MS};
+
+typedef struct {
+    uint32_t period_ms;
+    volatile bool stop;
+    int64_t next_refr_us;
+    int64_t touch_us;                   // 尚未被读到的按下时刻，0 表示没有
+    uint32_t latency_us[WAKE_MAX_SAMPLES];
+    uint32_t samples;
+    lvgl_driver_stats_t stats;
+    SemaphoreHandle_t refreshed;        // 一次按下被刷新读到
+    SemaphoreHandle_t tick;             // 每次刷新
+    SemaphoreHandle_t exited;
+} wake_ctx_t;
+
+static portMUX_TYPE s_touch_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_rng = 1;
+
+static uint32_t test_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+/* 定时器处理函数：刷新周期到期时刷新并读取输入，返回距下一次刷新的毫秒数 */
+static uint32_t fake_timer_handler(wake_ctx_t *ctx)
+{
+    int64_t now_us = esp_timer_get_time();
+
+    if (now_us >= ctx->next_refr_us) {
+        portENTER_CRITICAL(&s_touch_mux);
+        int64_t touch_us = ctx->touch_us;
+        ctx->touch_us = 0;
+        portEXIT_CRITICAL(&s_touch_mux);
+        if (touch_us) {
+            if (ctx->samples < WAKE_MAX_SAMPLES) {
+                ctx->latency_us[ctx->samples++] = (uint32_t)(now_us - touch_us);
+            }
+            xSemaphoreGive(ctx->refreshed);
+        }
+        xSemaphoreGive(ctx->tick);
+        ctx->next_refr_us = now_us + (int64_t)ctx->period_ms * 1000;
+    }
+    return (uint32_t)((ctx->next_refr_us - now_us + 999) / 1000);
+}
+
+/* 模拟的 LVGL 任务（与 lvgl_timer_task 的循环相同） */
+static void fake_lvgl_task(void *arg)
+{
+    wake_ctx_t *ctx = arg;
+
+    while (!ctx->stop) {
+        uint32_t wake = lvgl_wake_wait(fake_timer_handler(ctx), &ctx->stats);
+        if (wake & LVGL_WAKE_TOUCH) {
+            // lv_indev_read() 后 lv_timer_ready(refr_timer)：下一轮立即刷新
+            ctx->next_refr_us = esp_timer_get_time();
+        }
+    }
+    xSemaphoreGive(ctx->exited);
+    vTaskDelete(NULL);
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* 以一种刷新周期与唤醒方式按下 count 次，返回是否满足要求 */
+static bool run_case(uint32_t period_ms, bool notify, uint32_t count)
+{
+    static wake_ctx_t ctx;
+    TaskHandle_t task = NULL;
+    uint32_t missed = 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.period_ms = period_ms;
+    ctx.refreshed = xSemaphoreCreateBinary();
+    ctx.exited = xSemaphoreCreateBinary();
+    ctx.tick = xSemaphoreCreateBinary();
+    xTaskCreate(fake_lvgl_task, "lvgl_timer", 4096, &ctx, 7, &task);
+
+    for (uint32_t i = 0; i < count; i++) {
+        // 等一次刷新，再在前 1/4 周期内按下
+        xSemaphoreTake(ctx.tick, 0);
+        xSemaphoreTake(ctx.tick, pdMS_TO_TICKS(period_ms * 2 + 100));
+        vTaskDelay(pdMS_TO_TICKS(1 + test_rand() % LV_MAX(period_ms / 4, 1u)));
+        portENTER_CRITICAL(&s_touch_mux);
+        ctx.touch_us = esp_timer_get_time();
+        portEXIT_CRITICAL(&s_touch_mux);
+        if (notify) {
+            xTaskNotify(task, LVGL_WAKE_TOUCH, eSetBits);
+        }
+        if (xSemaphoreTake(ctx.refreshed, pdMS_TO_TICKS(period_ms * 2 + 100)) != pdTRUE) {
+            missed++;
+        }
+    }
+
+    ctx.stop = true;
+    xTaskNotify(task, LVGL_WAKE_REQUEST, eSetBits);
+    xSemaphoreTake(ctx.exited, portMAX_DELAY);
+    vSemaphoreDelete(ctx.refreshed);
+    vSemaphoreDelete(ctx.exited);
+    vSemaphoreDelete(ctx.tick);
+
+    uint32_t n = ctx.samples;
+    uint64_t sum = 0;
+    qsort(ctx.latency_us, n, sizeof(uint32_t), cmp_u32);
+    for (uint32_t i = 0; i < n; i++) {
+        sum += ctx.latency_us[i];
+    }
+    uint32_t max_us = n ? ctx.latency_us[n - 1] : 0;
+
+    // 通知方式：每次都远在刷新周期到期前被读到，且都计为触摸唤醒
+    bool ok = missed == 0 && n == count;
+    if (notify) {
+        ok = ok && max_us < period_ms * 1000 / 2 && ctx.stats.wake_touch == count;
+    }
+    printf("%6" PRIu32 " %-7s %7" PRIu32 " %9.1f %9.1f %9.1f %9.1f %6" PRIu32 " %7" PRIu32 " %6" PRIu32 "  %s\n",
+           period_ms, notify ? "notify" : "poll", n, n ? sum / 1000.0 / n : 0.0,
+           n ? ctx.latency_us[n / 2] / 1000.0 : 0.0, n ? ctx.latency_us[(n * 99) / 100] / 1000.0 : 0.0,
+           max_us / 1000.0, ctx.stats.wake_touch, ctx.stats.wake_timeout, missed, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t count = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 30;
+    bool ok = true;
+
+    count = LV_CLAMP(1u, count, (uint32_t)WAKE_MAX_SAMPLES);
+    printf("input to refresh latency (ms), refresh timer period as LVGL's read/refresh period\n");
+    printf("%6s %-7s %7s %9s %9s %9s %9s %6s %7s %6s\n", "period", "wake", "touches", "avg", "p50", "p99",
+           "max", "touch", "timeout", "missed");
+    for (size_t i = 0; i < sizeof(s_periods_ms) / sizeof(s_periods_ms[0]); i++) {
+        uint32_t n = LV_MAX(1u, LV_MIN(count, WAKE_BUDGET_MS / s_periods_ms[i]));
+        ok = run_case(s_periods_ms[i], true, n) && ok;
+        ok = run_case(s_periods_ms[i], false, n) && ok;
+    }
+
+    printf(ok ? "PASS\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}
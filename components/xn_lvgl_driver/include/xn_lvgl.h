@@ -11,32 +11,159 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include "sdkconfig.h"
 #include "esp_err.h"
 #include "esp_log.h"
-#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 // LVGL 核心头文件
 #include "lvgl.h"
 
+#if CONFIG_IDF_TARGET_LINUX
+// 主机后端：没有 BSP 层，分辨率与触摸点数由主机后端头文件提供
+#include "xn_lvgl_host.h"
+#else
+#include "esp_timer.h"
+
 // 硬件驱动头文件（BSP 层）
 #include "bsp_panel_spd2010.h"
 #include "bsp_touch_spd2010.h"
+#endif
 
 /*********************
  * 配置宏定义
  *********************/
 
-// LVGL Tick 定时器周期 (毫秒)
-// 【性能优化】调整为100ms（10 FPS）以降低CPU负载
-#define LVGL_TICK_PERIOD_MS     20
+// 分块流水线刷新：每个刷新区域按行拆成不超过 LVGL_FLUSH_CHUNK_BYTES 的块，
+// 复制到内部RAM弹跳缓冲区时交换字节序，上一块DMA发送期间准备下一块
+// 设为 0 恢复整块原地交换后直接从PSRAM发送
+#define LVGL_FLUSH_PIPELINE     1
+#define LVGL_FLUSH_CHUNK_BYTES  (8 * 1024)   // 每个弹跳缓冲区字节数（至少容纳一整行）
+#define LVGL_FLUSH_BOUNCE_COUNT 2            // 弹跳缓冲区个数
+#define LVGL_FLUSH_TIMEOUT_MS   100          // 等待弹跳缓冲区空闲的超时
+
+// 圆形屏可见区域裁剪：SPD2010 面板是直径 412 的圆形，四角像素不可见
+// 失效区域先裁到可见圆的外接范围，完全不可见的区域不再渲染；刷新时逐行裁到可见跨度
+// （按 4 像素对齐）再发送。设为 0 按矩形区域完整发送
+#define LVGL_ROUND_MASK         1
+#define LVGL_ROUND_MASK_MARGIN  2            // 可见圆半径向外放宽的像素数，容忍面板安装偏差
+#define LVGL_ROUND_MASK_SLACK   16           // 同一传输块内各行允许多发送的像素数，超过则拆成新块
+
+// 失效区域合并：每帧渲染前按“每次传输固定开销 + 发送字节数”估算各区域的发送时间，
+// 反复合并能缩短总时间的两个区域（小区域多时减少 QSPI 传输次数，相距远的区域保持分开）
+// 设为 0 只使用 LVGL 自带的重叠合并
+#define LVGL_MERGE_AREAS        1
+#define LVGL_MERGE_TXN_COST     1024         // 每次传输的固定开销（命令、地址窗口、队列与中断）折合的字节数
+#define LVGL_FLUSH_REPORT       0            // 设为 1 时每帧打印区域数、传输次数与字节数
+#define LVGL_TRACE_AREAS        0            // 设为 1 时每帧打印对齐前的失效区域（host_test/data/*.trace 的格式）
+
+// 图块哈希跳过：按 LVGL_TILE_SIZE 划分图块并记录上次发送内容的哈希，内容未变的图块刷新时不再发送，
+// 区域拆成变化的片段（Lottie 包围盒中静止的部分）。失效区域扩展到图块边界。设为 0 关闭
+#define LVGL_TILE_SKIP          1
+#define LVGL_TILE_SIZE          16           // 图块边长（像素，4 的倍数）
+
+// 帧计时：每帧的渲染/刷新耗时、像素与字节数写入无锁环形缓冲区（记录数需为 2 的幂）
+#define LVGL_PERF_RING_SIZE     128
+#define LVGL_PERF_OVERLAY_PERIOD_MS 500      // 性能浮层刷新周期
+
+// 分块并行绘制：面积较大的填充与无变换图像绘制任务（背景渐变、Lottie 画面、骰子结果图）按行拆成
+// LVGL_DRAW_TILE_WORKERS 块，由固定在各核心上的绘制任务并行执行（LVGL 9 自定义绘制单元，
+// 需要 CONFIG_LV_OS_FREERTOS），其余任务仍由 LVGL 软件绘制单元执行。设为 0 关闭
+#define LVGL_DRAW_TILE_WORKERS      2
+#define LVGL_DRAW_TILE_CORES        {0, 1}           // 各绘制任务所在核心，个数与 LVGL_DRAW_TILE_WORKERS 一致
+#define LVGL_DRAW_TILE_PRIORITY     7                // 绘制任务优先级（与 LVGL 任务相同）
+#define LVGL_DRAW_TILE_STACK_SIZE   (8 * 1024)       // 绘制任务栈（内部RAM，字节）
+#define LVGL_DRAW_TILE_MIN_PIXELS   (64 * 64)        // 小于此面积的绘制任务不拆分
+
+// LVGL 任务最长睡眠时间 (毫秒)
+// 任务睡眠到 lv_timer_handler() 返回的截止时间，刷新完成、触摸中断或
+// lvgl_driver_wake() 会提前唤醒；没有就绪定时器时最多睡眠这么久
+#define LVGL_TASK_MAX_SLEEP_MS  500
+
+// LVGL 任务唤醒原因（任务通知位）
+#define LVGL_WAKE_FLUSH         (1u << 0)   // 刷新DMA完成
+#define LVGL_WAKE_TOUCH         (1u << 1)   // 触摸中断
+#define LVGL_WAKE_REQUEST       (1u << 2)   // 其他任务修改了界面（如 lottie_task 切换动画）
 
 // LVGL 显示缓冲区大小 (像素数)
 // 【性能优化】设置为屏幕的1/10，减少刷新次数，降低CPU负载
 // 每次可刷新更多像素，减少刷新回调次数（内存增加约8.5KB PSRAM）
 #define LVGL_BUFFER_SIZE        (EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT / 20)
 
+// LVGL 渲染模式
+// LV_DISPLAY_RENDER_MODE_PARTIAL：两块 LVGL_BUFFER_SIZE 的条带缓冲区，大区域按条带多次渲染、多次刷新
+// LV_DISPLAY_RENDER_MODE_DIRECT：两块整屏 RGB565 帧缓冲（PSRAM，共约 663KB），每个失效区域只渲染、刷新一次；
+//   交换缓冲后 LVGL 把上一帧的失效区域复制到新的绘制缓冲（同步区域），未变化的部分不重新渲染。
+//   帧缓冲跨帧保留，刷新时只能复制到弹跳缓冲区交换字节序，弹跳缓冲区不可用时退回 PARTIAL
+#define LVGL_RENDER_MODE        LV_DISPLAY_RENDER_MODE_PARTIAL
+
+/*********************
+ * 类型定义
+ *********************/
+
+/**
+ * @brief LVGL 驱动运行统计
+ */
+typedef struct {
+    uint32_t frame_interval_us_last;    // 最近两帧之间的间隔（微秒）
+    uint32_t frame_interval_us_avg;     // 帧间隔平均值（指数平均，微秒）
+    uint32_t input_latency_us_last;     // 最近一次触摸按下到下一帧提交完成的延迟（微秒）
+    uint32_t input_latency_us_max;      // 输入到刷新延迟最大值（微秒）
+    uint32_t wake_flush;                // 被刷新完成唤醒的次数
+    uint32_t wake_touch;                // 被触摸中断唤醒的次数
+    uint32_t wake_request;              // 被 lvgl_driver_wake() 唤醒的次数
+    uint32_t wake_timeout;              // 睡眠到截止时间自然唤醒的次数
+    uint32_t flush_areas;               // 刷新区域数
+    uint32_t flush_chunks;              // 提交的传输块数（直接发送时每个区域一块）
+    uint32_t flush_area_us_last;        // 最近一个区域从进入刷新回调到最后一块发送完成的耗时（微秒）
+    uint32_t flush_area_us_avg;         // 区域刷新耗时平均值（指数平均，微秒）
+    uint32_t flush_bytes_frame_last;    // 最近一帧实际发送到面板的字节数
+    uint32_t flush_bytes_unmasked_last; // 最近一帧不做圆形裁剪时需要发送的字节数
+    uint32_t mask_skipped_areas;        // 完全不可见、在渲染前丢弃的失效区域数
+    uint32_t flush_txns_frame_last;     // 最近一帧提交的传输次数
+    uint16_t merge_areas_in_last;       // 最近一帧合并前的失效区域数
+    uint16_t merge_areas_out_last;      // 最近一帧合并后的失效区域数
+    uint32_t tiles_checked;             // 累计比较哈希的图块数
+    uint32_t tiles_skipped;             // 累计内容未变、跳过发送的图块数
+    uint32_t tile_bytes_skipped_last;   // 最近一帧因图块未变少发送的字节数（按矩形计）
+    uint32_t tile_hash_us_last;         // 最近一帧计算图块哈希的耗时（微秒）
+    uint32_t draw_buf_bytes;            // 显示缓冲区占用的字节数（两块合计）
+    uint8_t render_mode;                // 实际使用的渲染模式（lv_display_render_mode_t）
+    uint32_t draw_tile_tasks;           // 拆分到多个核心并行绘制的任务数
+} lvgl_driver_stats_t;
+
+/**
+ * @brief 单帧计时记录
+ */
+typedef struct {
+    uint32_t frame;                     // 帧序号（与 lvgl_driver_get_frame_count() 一致）
+    uint32_t interval_us;               // 与上一帧结束的间隔（微秒）
+    uint32_t render_us;                 // 渲染耗时，不含刷新回调与等待刷新完成（微秒）
+    uint32_t flush_us;                  // 各区域从进入刷新回调到发送完成的耗时之和（微秒）
+    uint32_t pixels;                    // 刷新区域像素数
+    uint32_t bytes;                     // 实际发送到面板的字节数
+    uint16_t areas;                     // 刷新区域数
+    uint16_t txns;                      // 传输次数
+} lvgl_frame_record_t;
+
+/**
+ * @brief 帧计时汇总（基于环形缓冲区中的最近若干帧）
+ */
+typedef struct {
+    uint32_t frames;                    // 参与统计的帧数
+    uint32_t fps_x10;                   // 平均帧率 ×10
+    uint32_t interval_us_p50;           // 帧间隔百分位（微秒）
+    uint32_t interval_us_p90;
+    uint32_t interval_us_p99;
+    uint32_t render_us_avg;             // 渲染耗时平均值 / 最大值（微秒）
+    uint32_t render_us_max;
+    uint32_t flush_us_avg;              // 刷新耗时平均值 / 最大值（微秒）
+    uint32_t flush_us_max;
+    uint32_t bytes_per_sec;             // 平均 SPI 吞吐（字节/秒）
+    uint8_t render_load_pct;            // 渲染占用 LVGL 任务所在核心的时间比例（%）
+} lvgl_frame_timing_t;
+
 /*********************
  * 全局变量声明
  *********************/
@@ -63,10 +190,79 @@ esp_err_t lvgl_driver_init(void);
 void lvgl_driver_deinit(void);
 
 /**
- * @brief LVGL tick增加回调函数
- * @param arg 未使用的参数
+ * @brief 获取刷新栅栏（截至当前已提交到面板的刷新次数）
+ * @return 栅栏值，传给 lvgl_driver_flush_wait() 等待其之前的刷新DMA全部完成
+ * @note 需在 lv_lock() 内调用，确保取值时没有正在进行的渲染
+ */
+uint32_t lvgl_driver_flush_fence(void);
+
+/**
+ * @brief 等待栅栏之前提交的刷新DMA全部完成
+ * @param fence lvgl_driver_flush_fence() 返回的栅栏值
+ * @param timeout_ms 超时时间（毫秒）
+ * @return ESP_OK 已完成, ESP_ERR_TIMEOUT 超时
+ * @note 通过调用任务的任务通知等待，不能在 LVGL 任务（含 LVGL 回调）中调用，否则会清掉它的唤醒位；
+ *       LVGL 任务中用 lvgl_driver_flush_done() 查询
+ */
+esp_err_t lvgl_driver_flush_wait(uint32_t fence, uint32_t timeout_ms);
+
+/**
+ * @brief 查询栅栏之前提交的刷新DMA是否已全部完成（只比较完成计数，不等待）
+ * @param fence lvgl_driver_flush_fence() 返回的栅栏值
+ * @return true 已完成
+ * @note 不使用任务通知，任意任务与 LVGL 回调中均可调用
+ */
+bool lvgl_driver_flush_done(uint32_t fence);
+
+/**
+ * @brief 获取已刷新的完整帧数（每帧最后一块刷新区域计数一次）
+ * @return 帧计数（回绕递增）
+ */
+uint32_t lvgl_driver_get_frame_count(void);
+
+/**
+ * @brief 唤醒 LVGL 任务并立即刷新一次
+ * @note 其他任务修改界面后调用，避免等到下一个刷新周期才显示
+ */
+void lvgl_driver_wake(void);
+
+/**
+ * @brief 获取实际帧间隔
+ * @return 帧间隔平均值（微秒），尚未刷新两帧时为 0
+ */
+uint32_t lvgl_driver_get_frame_interval_us(void);
+
+/**
+ * @brief 获取驱动运行统计（帧间隔、输入延迟、唤醒原因）
+ * @param stats 输出统计
+ */
+void lvgl_driver_get_stats(lvgl_driver_stats_t *stats);
+
+/**
+ * @brief 读取最近的帧计时记录（无锁，任意任务可调用）
+ * @param out 输出数组，按时间顺序，最新的在最后
+ * @param max 最多读取条数
+ * @return 实际读取条数
+ */
+uint32_t lvgl_driver_get_frame_records(lvgl_frame_record_t *out, uint32_t max);
+
+/**
+ * @brief 汇总环形缓冲区中的帧计时（帧率、帧间隔百分位、渲染/刷新耗时、吞吐）
+ * @param timing 输出汇总，没有记录时全部为 0
+ */
+void lvgl_driver_get_frame_timing(lvgl_frame_timing_t *timing);
+
+/**
+ * @brief 显示或隐藏性能浮层（FPS、渲染负载、PSRAM 最大空闲块），运行时切换
+ * @param show true 显示，false 隐藏
+ * @return ESP_OK 成功, ESP_ERR_INVALID_STATE 驱动未初始化, ESP_ERR_NO_MEM 创建失败
+ */
+esp_err_t lvgl_driver_overlay_show(bool show);
+
+/**
+ * @brief 性能浮层是否正在显示
  */
-void lvgl_tick_inc_cb(void *arg);
+bool lvgl_driver_overlay_is_shown(void);
 
 /**
  * @brief LVGL显示刷新回调函数
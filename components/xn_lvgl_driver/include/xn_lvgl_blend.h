@@ -0,0 +1,42 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-05 10:20:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-05 10:20:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\include\xn_lvgl_blend.h
+ * @Description: LVGL 软件渲染自定义混合钩子
+ *
+ * sdkconfig 中选择 CONFIG_LV_DRAW_SW_ASM_CUSTOM 并把 CONFIG_LV_DRAW_SW_ASM_CUSTOM_INCLUDE
+ * 设为 "xn_lvgl_blend.h" 后，LVGL 的混合源码会包含本文件，用 xn_lvgl_pixel 的内核替换
+ * 对应的软件实现。钩子返回 LV_RESULT_INVALID 时 LVGL 使用自己的实现。
+ * 本文件只在 LVGL 源码内部被包含，只通过宏访问混合描述符的成员。
+ *
+ * 图像混合钩子使用 5 位 alpha（0~32）的混合（见 lvgl_pixel_argb8888_blend_rgb565），
+ * 结果与 LVGL 自带的 8 位 alpha 混合每通道最多相差 1 个最低位，不是逐位一致。
+ */
+
+#pragma once
+
+#include "xn_lvgl_pixel.h"
+
+// 不带遮罩、整体不透明的 ARGB8888 图像混合到 RGB565（逐像素 alpha 按 5 位混合）
+#ifndef LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565(dsc) \
+    (lvgl_pixel_blend_image_argb8888_to_rgb565((dsc)->dest_buf, (dsc)->dest_stride, (dsc)->src_buf, \
+                                               (dsc)->src_stride, (dsc)->dest_w, (dsc)->dest_h, 0xFF) ? \
+     LV_RESULT_OK : LV_RESULT_INVALID)
+#endif
+
+// 不带遮罩、整体半透明的 ARGB8888 图像混合到 RGB565（alpha × opa 四舍五入后按 5 位混合）
+#ifndef LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc) \
+    (lvgl_pixel_blend_image_argb8888_to_rgb565((dsc)->dest_buf, (dsc)->dest_stride, (dsc)->src_buf, \
+                                               (dsc)->src_stride, (dsc)->dest_w, (dsc)->dest_h, (dsc)->opa) ? \
+     LV_RESULT_OK : LV_RESULT_INVALID)
+#endif
+
+// lv_draw_sw_rgb565_swap()
+#ifndef LV_DRAW_SW_RGB565_SWAP
+#define LV_DRAW_SW_RGB565_SWAP(buf, buf_size_px) \
+    (lvgl_pixel_rgb565_swap((uint16_t *)(buf), (const uint16_t *)(buf), (buf_size_px)), LV_RESULT_OK)
+#endif
@@ -0,0 +1,102 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-05 15:10:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-05 15:10:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\include\xn_lvgl_host.h
+ * @Description: LVGL 驱动主机后端（linux 目标）- 帧缓冲显示、传输耗时模型、脚本触摸、PNG 帧导出
+ *
+ * 以 `idf.py --preview set-target linux` 构建时 xn_lvgl_driver 编译 xn_lvgl_host.c 代替 xn_lvgl.c，
+ * 公共接口（xn_lvgl.h）保持不变，上层代码无需修改。刷新写入 412x412 RGB565 帧缓冲，
+ * 传输耗时按 QSPI 带宽与每次传输固定开销估算，不实际等待。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 与 SPD2010 面板一致的分辨率与触摸点数（主机构建没有 BSP 组件）
+#define EXAMPLE_LCD_WIDTH       (412)
+#define EXAMPLE_LCD_HEIGHT      (412)
+#define TOUCH_MAX_POINTS        5
+
+// 默认传输模型：QSPI 80MHz × 4 线 ≈ 40MB/s，每次传输固定开销（命令、地址窗口、队列与中断）
+#define LVGL_HOST_BUS_BYTES_PER_SEC   (40 * 1000 * 1000)
+#define LVGL_HOST_TXN_OVERHEAD_US     30
+
+/**
+ * @brief 主机后端配置
+ */
+typedef struct {
+    uint32_t bus_bytes_per_sec;     // 传输带宽（字节/秒），0 使用 LVGL_HOST_BUS_BYTES_PER_SEC
+    uint32_t txn_overhead_us;       // 每次传输固定开销（微秒）
+    const char *dump_dir;           // 帧导出目录，NULL 不导出
+    uint32_t dump_every;            // 每隔多少帧导出一次 PNG（0 等同 1）
+} lvgl_host_config_t;
+
+/**
+ * @brief 脚本触摸事件：从脚本开始经过 at_ms 后进入该状态，直到下一个事件
+ */
+typedef struct {
+    uint32_t at_ms;
+    int16_t x;
+    int16_t y;
+    bool pressed;
+} lvgl_host_touch_event_t;
+
+/**
+ * @brief 主机后端统计（传输耗时为模型估算值）
+ */
+typedef struct {
+    uint32_t frames;                // 已完成帧数
+    uint32_t flushes;               // 刷新区域数
+    uint64_t bytes_total;           // 累计“发送”字节数
+    uint64_t transfer_us_total;     // 累计估算传输耗时（微秒）
+    uint32_t transfer_us_frame_last;// 最近一帧估算传输耗时（微秒）
+    uint32_t dumped_frames;         // 已导出的 PNG 数
+    int64_t transfer_us_saved_total;// 图块跳过节省的估算传输耗时（微秒，拆分增加的传输开销已扣除）
+    uint64_t tile_hash_us_total;    // 主机上计算图块哈希的累计耗时（微秒，设备端见 tile_hash_us_last）
+} lvgl_host_stats_t;
+
+/**
+ * @brief 设置主机后端配置（lvgl_driver_init() 前后均可调用，立即生效）
+ * @param config 配置，NULL 恢复默认
+ */
+void lvgl_host_set_config(const lvgl_host_config_t *config);
+
+/**
+ * @brief 设置脚本触摸序列并从当前时刻开始播放
+ * @param events 按 at_ms 递增排列的事件（需在播放期间保持有效），NULL 清除脚本
+ * @param count 事件数
+ */
+void lvgl_host_touch_script(const lvgl_host_touch_event_t *events, size_t count);
+
+/**
+ * @brief 获取帧缓冲（EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT 个 RGB565 像素，主机字节序）
+ * @return 帧缓冲指针，未初始化时返回 NULL
+ */
+const uint16_t *lvgl_host_get_framebuffer(void);
+
+/**
+ * @brief 把当前帧缓冲导出为 24 位 PNG
+ * @param path 文件路径
+ * @return ESP_OK 成功, ESP_ERR_INVALID_STATE 未初始化, ESP_FAIL 写文件失败
+ */
+esp_err_t lvgl_host_dump_png(const char *path);
+
+/**
+ * @brief 获取主机后端统计
+ * @param stats 输出统计
+ */
+void lvgl_host_get_stats(lvgl_host_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
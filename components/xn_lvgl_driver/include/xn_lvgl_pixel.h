@@ -0,0 +1,82 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-05 10:20:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-05 10:20:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\include\xn_lvgl_pixel.h
+ * @Description: 像素处理内核 - RGB565 字节序交换、ARGB8888 转 RGB565（可选有序抖动）、ARGB8888 混合到 RGB565
+ *
+ * 刷新回调、Lottie 格式转换与 LVGL 软件混合共用。内核按 32 位字一次处理两个 RGB565 像素，
+ * 逐行调用即可，对齐不足时自动退回逐像素处理。
+ * 不依赖 LVGL 头文件，可被 xn_lvgl_blend.h 包含进 LVGL 自身的混合源码。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 交换 RGB565 像素的字节序
+ * @param dst 目标缓冲区（可与 src 相同，原地交换）
+ * @param src 源像素
+ * @param count 像素数
+ */
+void lvgl_pixel_rgb565_swap(uint16_t *dst, const uint16_t *src, uint32_t count);
+
+/**
+ * @brief ARGB8888 转 RGB565（直接截断低位，丢弃 alpha）
+ * @param dst RGB565 目标
+ * @param src ARGB8888 源
+ * @param count 像素数
+ */
+void lvgl_pixel_argb8888_to_rgb565(uint16_t *dst, const uint32_t *src, uint32_t count);
+
+/**
+ * @brief ARGB8888 转 RGB565，4x4 有序抖动（Bayer 矩阵）
+ *
+ * 截断前按像素坐标加上阈值，消除渐变中的色带。抖动图案固定在坐标上，
+ * 同一画面逐帧结果一致，不会闪烁。
+ *
+ * @param dst RGB565 目标（width * height 连续像素）
+ * @param src ARGB8888 源（width * height 连续像素）
+ * @param width 宽度
+ * @param height 高度
+ */
+void lvgl_pixel_argb8888_to_rgb565_dither(uint16_t *dst, const uint32_t *src, uint32_t width, uint32_t height);
+
+/**
+ * @brief 非预乘 ARGB8888 按 alpha 混合到 RGB565（src over dst）
+ *
+ * alpha（乘以 opa 后四舍五入）量化为 5 位（0~32），与按 8 位 alpha 在 RGB565 域混合相比
+ * 每通道误差不超过 1 个最低位（host_test/test_pixel_kernels 验证）。
+ * 混合后 alpha 不低于 252 时直接覆盖，低于 4 时跳过。
+ *
+ * @param dst RGB565 目标（原地混合）
+ * @param src ARGB8888 源
+ * @param count 像素数
+ * @param opa 整体不透明度（255 表示只用像素 alpha）
+ */
+void lvgl_pixel_argb8888_blend_rgb565(uint16_t *dst, const uint32_t *src, uint32_t count, uint8_t opa);
+
+/**
+ * @brief 按行混合 ARGB8888 图像到 RGB565 缓冲区（LVGL 混合钩子，见 xn_lvgl_blend.h）
+ * @param dst 目标首行
+ * @param dst_stride 目标行跨度（字节）
+ * @param src 源首行
+ * @param src_stride 源行跨度（字节）
+ * @param width 宽度
+ * @param height 高度
+ * @param opa 整体不透明度
+ * @return true 已处理
+ */
+bool lvgl_pixel_blend_image_argb8888_to_rgb565(void *dst, int32_t dst_stride, const void *src, int32_t src_stride,
+                                               int32_t width, int32_t height, uint8_t opa);
+
+#ifdef __cplusplus
+}
+#endif
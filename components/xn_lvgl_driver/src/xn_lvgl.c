@@ -8,7 +8,24 @@
  */
 
 #include "xn_lvgl.h"
+#include "xn_lvgl_pixel.h"
+#include "xn_lvgl_perf.h"
+#include "xn_lvgl_tile.h"
+#include "xn_lvgl_area.h"
+#include "xn_lvgl_draw.h"
+#include "xn_lvgl_flush.h"
+#include "xn_lvgl_wake.h"
 #include "bsp_panel_spd2010.h"
+#include <stdio.h>
+#include <string.h>
+
+// 失效区域列表（inv_areas / inv_p）定义在 LVGL 私有头文件中
+#if defined(__has_include)
+#if __has_include("display/lv_display_private.h")
+#include "display/lv_display_private.h"
+#define LVGL_HAVE_DISPLAY_PRIVATE 1
+#endif
+#endif
 
 /*********************
  * 静态变量定义
@@ -20,16 +37,37 @@ static const char *TAG = "LVGL_DRIVER";
 lv_display_t *g_lvgl_display = NULL;
 lv_indev_t *g_lvgl_indev = NULL;
 
-// ESP定时器句柄
-static esp_timer_handle_t lvgl_tick_timer = NULL;
-
 // 显示缓冲区
 static uint8_t *lvgl_draw_buf1 = NULL;
 static uint8_t *lvgl_draw_buf2 = NULL;
+static bool lvgl_render_direct = false;        // 直接模式：px_map 是整屏帧缓冲
 
 // LVGL任务句柄
 static TaskHandle_t lvgl_task_handle = NULL;
 
+// 已完成渲染并提交的完整帧数
+static volatile uint32_t lvgl_frame_count = 0;
+
+// 帧间隔与输入延迟统计
+static lvgl_driver_stats_t lvgl_stats;
+static int64_t lvgl_last_frame_us = 0;
+static int64_t lvgl_input_press_us = 0;        // 最近一次按下被读到的时间，0 表示已计入延迟
+static bool lvgl_touch_pressed = false;
+
+static int64_t lvgl_flush_start_us = 0;
+
+// 本帧发送计数（传输次数、实际发送字节数、图块比较与哈希耗时），以及不裁剪时的字节数
+static lvgl_flush_counters_t lvgl_frame_flush;
+static uint32_t lvgl_frame_bytes_unmasked = 0;
+static uint32_t lvgl_frame_areas = 0;
+static uint32_t lvgl_frame_pixels = 0;
+
+#if LVGL_TRACE_AREAS
+// 本帧对齐前的失效区域，帧结束时整行打印（供 bench_inval_trace 回放）
+static char lvgl_trace_line[768];
+static size_t lvgl_trace_len = 0;
+#endif
+
 // LVGL任务栈（使用PSRAM）
 #define LVGL_TASK_STACK_SIZE (1024*64/sizeof(StackType_t))
 static EXT_RAM_BSS_ATTR StackType_t lvgl_task_stack[LVGL_TASK_STACK_SIZE];
@@ -41,7 +79,7 @@ static StaticTask_t lvgl_task_buffer;
 
 static esp_err_t lvgl_display_init(void);
 static esp_err_t lvgl_indev_init(void);
-static esp_err_t lvgl_tick_timer_init(void);
+static esp_err_t lvgl_tick_init(void);
 static esp_err_t lvgl_task_init(void);
 static void lvgl_cleanup_resources(void);
 static void lvgl_timer_task(void *pvParameters);
@@ -50,25 +88,66 @@ static void lvgl_timer_task(void *pvParameters);
  * 回调函数实现
  *********************/
 
-void lvgl_tick_inc_cb(void *arg)
+/* LVGL 时基直接取 esp_timer（1ms 精度），不再需要周期 tick 中断 */
+static uint32_t lvgl_tick_get_cb(void)
 {
-    lv_tick_inc(LVGL_TICK_PERIOD_MS);
+    return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
-/* SPD2010区域对齐回调函数 - 处理4字节对齐要求 */
+/* SPD2010区域对齐回调函数 - 处理4字节对齐要求，并裁掉圆形屏四角不可见的部分 */
 static void lvgl_rounder_cb(lv_event_t *e)
 {
-    (void)lv_event_get_target(e);  // 避免未使用变量警告
     lv_area_t *area = lv_event_get_param(e);
 
-    // SPD2010需要4字节对齐
-    uint16_t x1 = area->x1;
-    uint16_t x2 = area->x2;
+#if LVGL_TRACE_AREAS
+    // 跳过 LVGL 探测最大行数的 (0,0)-(0,h-1)，放不下时丢弃本帧剩余区域
+    bool probe = (area->x1 == 0 && area->x2 == 0 && area->y1 == 0);
+    if (!probe && lvgl_trace_len < sizeof(lvgl_trace_line)) {
+        int n = snprintf(lvgl_trace_line + lvgl_trace_len, sizeof(lvgl_trace_line) - lvgl_trace_len,
+                         "%s%d %d %d %d", lvgl_trace_len ? "; " : "", (int)area->x1, (int)area->y1,
+                         (int)area->x2, (int)area->y2);
+        lvgl_trace_len += (n > 0) ? (size_t)n : 0;
+    }
+#endif
 
-    // 将起始坐标向下对齐到4的倍数
-    area->x1 = (x1 >> 2) << 2;
-    // 将结束坐标向上对齐到4N+3
-    area->x2 = ((x2 >> 2) << 2) + 3;
+    if (!lvgl_area_round(area)) {
+        lvgl_stats.mask_skipped_areas++;
+    }
+}
+
+#if LVGL_MERGE_AREAS && LVGL_HAVE_DISPLAY_PRIVATE
+/* 渲染开始前按传输开销合并失效区域 */
+static void lvgl_refr_start_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    uint32_t n = disp->inv_p;
+    uint32_t merged = lvgl_area_merge(disp->inv_areas, n, lvgl_flush_pipelined() ? LVGL_FLUSH_CHUNK_BYTES : 0);
+
+    if (merged != n) {
+        for (uint32_t i = 0; i < merged; i++) {
+            disp->inv_area_joined[i] = 0;
+        }
+        disp->inv_p = merged;
+    }
+    lvgl_stats.merge_areas_in_last = (uint16_t)n;
+    lvgl_stats.merge_areas_out_last = (uint16_t)merged;
+}
+#endif
+
+/* 刷新完成钩子（SPI中断上下文）：区域最后一块传输完成时才通知 LVGL */
+static bool IRAM_ATTR lvgl_flush_done_hook(uint32_t done_count, void *arg)
+{
+    BaseType_t need_yield = pdFALSE;
+
+    if (lvgl_flush_on_done(done_count, &need_yield)) {
+        uint32_t area_us = (uint32_t)(esp_timer_get_time() - lvgl_flush_start_us);
+        lvgl_stats.flush_area_us_last = area_us;
+        lvgl_stats.flush_area_us_avg = lvgl_stats.flush_area_us_avg ?
+            lvgl_stats.flush_area_us_avg - lvgl_stats.flush_area_us_avg / 8 + area_us / 8 : area_us;
+        lvgl_perf_add_flush_us(area_us);
+        lv_display_flush_ready((lv_display_t *)arg);
+    }
+    return need_yield == pdTRUE;
 }
 
 void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
@@ -82,27 +161,79 @@ void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
     // 计算刷新像素数量
     uint32_t pixel_count = (offsetx2 + 1 - offsetx1) * (offsety2 + 1 - offsety1);
 
-    // 调试：打印刷新信息（仅前几次）
-    static int flush_count = 0;
-    if (flush_count < 5) {
-        ESP_LOGI(TAG, "Flush #%d: area(%d,%d)-(%d,%d), pixels=%lu", 
-                 flush_count, offsetx1, offsety1, offsetx2, offsety2, pixel_count);
-        flush_count++;
+    lvgl_flush_start_us = esp_timer_get_time();
+    lvgl_stats.flush_areas++;
+    lvgl_frame_bytes_unmasked += pixel_count * 2;
+    lvgl_frame_areas++;
+    lvgl_frame_pixels += pixel_count;
+
+    // 直接模式 px_map 是整屏帧缓冲，区域按屏幕坐标定位
+    uint32_t submit_before = lvgl_flush_submitted();
+    bool ready_now;
+    if (lvgl_render_direct) {
+        ready_now = lvgl_flush_area(panel_handle, area,
+                                    px_map + ((size_t)offsety1 * EXAMPLE_LCD_WIDTH + offsetx1) * 2,
+                                    EXAMPLE_LCD_WIDTH * 2, &lvgl_frame_flush);
+    } else {
+        ready_now = lvgl_flush_area(panel_handle, area, px_map, (offsetx2 + 1 - offsetx1) * 2, &lvgl_frame_flush);
+    }
+    lvgl_stats.flush_chunks += lvgl_flush_submitted() - submit_before;
+
+    if (lv_display_flush_is_last(disp)) {
+        lvgl_frame_count++;
+        lvgl_stats.flush_bytes_frame_last = lvgl_frame_flush.bytes;
+        lvgl_stats.flush_bytes_unmasked_last = lvgl_frame_bytes_unmasked;
+        lvgl_stats.flush_txns_frame_last = lvgl_frame_flush.txns;
+        lvgl_stats.tiles_checked += lvgl_frame_flush.tiles.checked;
+        lvgl_stats.tiles_skipped += lvgl_frame_flush.tiles.skipped;
+        lvgl_stats.tile_bytes_skipped_last = lvgl_frame_flush.tiles.skipped_pixels * 2;
+        lvgl_stats.tile_hash_us_last = lvgl_frame_flush.hash_us;
+#if LVGL_FLUSH_REPORT
+        ESP_LOGI(TAG, "Frame %lu: areas %u->%u, txns %lu, bytes %lu (unmasked %lu), tiles %lu/%lu skipped, hash %luus",
+                 (unsigned long)lvgl_frame_count, lvgl_stats.merge_areas_in_last, lvgl_stats.merge_areas_out_last,
+                 (unsigned long)lvgl_frame_flush.txns, (unsigned long)lvgl_frame_flush.bytes,
+                 (unsigned long)lvgl_frame_bytes_unmasked, (unsigned long)lvgl_frame_flush.tiles.skipped,
+                 (unsigned long)lvgl_frame_flush.tiles.checked, (unsigned long)lvgl_frame_flush.hash_us);
+#endif
+#if LVGL_TRACE_AREAS
+        if (lvgl_trace_len) {
+            ESP_LOGI(TAG, "TRACE: %.*s", (int)LV_MIN(lvgl_trace_len, sizeof(lvgl_trace_line) - 1), lvgl_trace_line);
+            lvgl_trace_len = 0;
+        }
+#endif
+        lvgl_perf_frame_end(lvgl_frame_pixels, lvgl_frame_flush.bytes, lvgl_frame_areas, lvgl_frame_flush.txns);
+        memset(&lvgl_frame_flush, 0, sizeof(lvgl_frame_flush));
+        lvgl_frame_bytes_unmasked = 0;
+        lvgl_frame_areas = 0;
+        lvgl_frame_pixels = 0;
+
+        // 帧间隔：相邻两帧最后一块提交的时间差（指数平均，权重 1/8）
+        int64_t now_us = esp_timer_get_time();
+        if (lvgl_last_frame_us) {
+            uint32_t interval_us = (uint32_t)(now_us - lvgl_last_frame_us);
+            lvgl_stats.frame_interval_us_last = interval_us;
+            lvgl_stats.frame_interval_us_avg = lvgl_stats.frame_interval_us_avg ?
+                lvgl_stats.frame_interval_us_avg - lvgl_stats.frame_interval_us_avg / 8 + interval_us / 8 :
+                interval_us;
+        }
+        lvgl_last_frame_us = now_us;
+
+        // 输入到刷新延迟：按下被读到之后第一帧提交完成
+        if (lvgl_input_press_us) {
+            uint32_t latency_us = (uint32_t)(now_us - lvgl_input_press_us);
+            lvgl_stats.input_latency_us_last = latency_us;
+            if (latency_us > lvgl_stats.input_latency_us_max) {
+                lvgl_stats.input_latency_us_max = latency_us;
+            }
+            lvgl_input_press_us = 0;
+        }
     }
 
-    // SPD2010是大端序，需要交换RGB字节顺序
-    lv_draw_sw_rgb565_swap(px_map, pixel_count);
-
-    // 将缓冲区内容复制到显示屏的指定区域
-    esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, px_map);
-
-    // 关键修复：检查返回值，如果失败立即通知LVGL
-    // 原因：SPI队列满时传输失败，中断不会触发，必须手动清除flushing标志，否则死锁
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "⚠️  SPI传输失败(队列满?)，立即通知LVGL");
+    // 发送失败（SPI队列满时中断不会触发）或整个区域都在可见圆外时立即通知LVGL，否则死锁
+    if (ready_now) {
         lv_display_flush_ready(disp);
     }
-    // 正常情况下，由硬件中断回调 notify_lvgl_flush_ready() 调用 lv_display_flush_ready()
+    // 正常情况下，由硬件中断回调在区域最后一块完成时调用 lv_display_flush_ready()
 }
 
 
@@ -122,9 +253,14 @@ void lvgl_touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
         data->point.y = touch_y[0];
         data->state = LV_INDEV_STATE_PRESSED;
         ESP_LOGI("LVGL_TOUCH", "触摸点: (%d, %d)", touch_x[0], touch_y[0]);
+        if (!lvgl_touch_pressed) {
+            lvgl_input_press_us = esp_timer_get_time();
+        }
+        lvgl_touch_pressed = true;
     } else {
         // 无触摸点
         data->state = LV_INDEV_STATE_RELEASED;
+        lvgl_touch_pressed = false;
     }
 }
 
@@ -143,27 +279,55 @@ static esp_err_t lvgl_display_init(void)
         return ESP_FAIL;
     }
 
+    // 分块流水线刷新的弹跳缓冲区（内部RAM，DMA可访问）；分配失败时退回整块直接发送
+#if LVGL_FLUSH_PIPELINE
+    if (lvgl_flush_init() == ESP_OK) {
+        ESP_LOGI(TAG, "Pipelined flush: %d x %d bytes bounce buffers",
+                 LVGL_FLUSH_BOUNCE_COUNT, LVGL_FLUSH_CHUNK_BYTES);
+    } else {
+        ESP_LOGW(TAG, "Bounce buffers unavailable, flushing directly from PSRAM");
+    }
+#endif
+
     // 分配显示缓冲区 (使用PSRAM)
     // LVGL9中缓冲区大小以字节为单位，对于RGB565每像素2字节
-    size_t buffer_size = LVGL_BUFFER_SIZE * 2;  // RGB565每像素2字节
-
-    lvgl_draw_buf1 = heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
-    if (!lvgl_draw_buf1) {
-        ESP_LOGE(TAG, "Failed to allocate draw buffer 1");
-        return ESP_ERR_NO_MEM;
+    lv_display_render_mode_t render_mode = LVGL_RENDER_MODE;
+    if (render_mode == LV_DISPLAY_RENDER_MODE_DIRECT && !lvgl_flush_pipelined()) {
+        ESP_LOGW(TAG, "Direct render mode needs bounce buffers, using partial mode");
+        render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
     }
+    size_t buffer_size = (render_mode == LV_DISPLAY_RENDER_MODE_DIRECT) ?
+                         (size_t)EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT * 2 : LVGL_BUFFER_SIZE * 2;
 
+    lvgl_draw_buf1 = heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
     lvgl_draw_buf2 = heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
-    if (!lvgl_draw_buf2) {
-        ESP_LOGE(TAG, "Failed to allocate draw buffer 2");
+    if ((!lvgl_draw_buf1 || !lvgl_draw_buf2) && render_mode == LV_DISPLAY_RENDER_MODE_DIRECT) {
+        // 两块整屏帧缓冲分配失败，退回条带缓冲区
+        ESP_LOGW(TAG, "Failed to allocate framebuffers, using partial mode");
+        free(lvgl_draw_buf1);
+        free(lvgl_draw_buf2);
+        render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
+        buffer_size = LVGL_BUFFER_SIZE * 2;
+        lvgl_draw_buf1 = heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
+        lvgl_draw_buf2 = heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
+    }
+    if (!lvgl_draw_buf1 || !lvgl_draw_buf2) {
+        ESP_LOGE(TAG, "Failed to allocate draw buffers");
         free(lvgl_draw_buf1);
+        free(lvgl_draw_buf2);
         lvgl_draw_buf1 = NULL;
+        lvgl_draw_buf2 = NULL;
         return ESP_ERR_NO_MEM;
     }
 
     // 设置显示缓冲区 - LVGL9中buffer_size参数是字节数
-    lv_display_set_buffers(g_lvgl_display, lvgl_draw_buf1, lvgl_draw_buf2,
-                           buffer_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    // 直接模式下两块帧缓冲都设置后，LVGL 在交换缓冲时同步上一帧的失效区域
+    lv_display_set_buffers(g_lvgl_display, lvgl_draw_buf1, lvgl_draw_buf2, buffer_size, render_mode);
+    lvgl_render_direct = (render_mode == LV_DISPLAY_RENDER_MODE_DIRECT);
+    lvgl_stats.draw_buf_bytes = (uint32_t)buffer_size * 2;
+    lvgl_stats.render_mode = (uint8_t)render_mode;
+    ESP_LOGI(TAG, "Render mode: %s, 2 x %u bytes PSRAM draw buffers",
+             lvgl_render_direct ? "direct" : "partial", (unsigned)buffer_size);
 
     // 设置颜色格式为RGB565（与SPD2010匹配）
     lv_display_set_color_format(g_lvgl_display, LV_COLOR_FORMAT_RGB565);
@@ -181,9 +345,21 @@ static esp_err_t lvgl_display_init(void)
     // 设置用户数据 (LCD面板句柄)
     lv_display_set_user_data(g_lvgl_display, official_panel);
 
-    // 注册区域对齐回调 - 处理SPD2010的4字节对齐要求
+    // 注册区域对齐回调 - 处理SPD2010的4字节对齐要求，并裁掉圆形屏四角不可见的部分
+    lvgl_area_round_init();
     lv_display_add_event_cb(g_lvgl_display, lvgl_rounder_cb, LV_EVENT_INVALIDATE_AREA, NULL);
 
+    // 面板当前内容未知，第一帧全部发送
+    lvgl_tile_reset();
+
+    // 帧计时（渲染/刷新耗时写入环形缓冲区，性能浮层读取）
+    lvgl_perf_attach(g_lvgl_display);
+
+    // 渲染前按传输开销合并失效区域
+#if LVGL_MERGE_AREAS && LVGL_HAVE_DISPLAY_PRIVATE
+    lv_display_add_event_cb(g_lvgl_display, lvgl_refr_start_cb, LV_EVENT_REFR_START, NULL);
+#endif
+
     // 注册官方组件的硬件完成回调
     esp_err_t ret = SPD2010_Register_LVGL_Callback(g_lvgl_display);
     if (ret != ESP_OK) {
@@ -191,6 +367,8 @@ static esp_err_t lvgl_display_init(void)
         return ret;
     }
 
+    SPD2010_Set_Flush_Done_Hook(lvgl_flush_done_hook, g_lvgl_display);
+
     ESP_LOGI(TAG, "LVGL display initialized successfully");
     return ESP_OK;
 }
@@ -214,53 +392,43 @@ static esp_err_t lvgl_indev_init(void)
     return ESP_OK;
 }
 
-static esp_err_t lvgl_tick_timer_init(void)
+static esp_err_t lvgl_tick_init(void)
 {
-    ESP_LOGI(TAG, "Initializing LVGL tick timer");
-
-    // 创建定时器配置
-    const esp_timer_create_args_t timer_args = {
-        .callback = lvgl_tick_inc_cb,
-        .name = "lvgl_tick"
-    };
-
-    // 创建定时器
-    esp_err_t ret = esp_timer_create(&timer_args, &lvgl_tick_timer);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create tick timer: %s", esp_err_to_name(ret));
-        return ret;
-    }
+    ESP_LOGI(TAG, "Initializing LVGL tick source");
 
-    // 启动定时器
-    ret = esp_timer_start_periodic(lvgl_tick_timer, LVGL_TICK_PERIOD_MS * 1000);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start tick timer: %s", esp_err_to_name(ret));
-        esp_timer_delete(lvgl_tick_timer);
-        lvgl_tick_timer = NULL;
-        return ret;
-    }
+    // 由 LVGL 按需读取 esp_timer 时间，定时器截止时间精确到 1ms
+    lv_tick_set_cb(lvgl_tick_get_cb);
 
-    ESP_LOGI(TAG, "LVGL tick timer started successfully");
+    ESP_LOGI(TAG, "LVGL tick source set to esp_timer");
     return ESP_OK;
 }
 
 static void lvgl_timer_task(void *pvParameters)
 {
     ESP_LOGI(TAG, "LVGL timer task started");
-    
+
+    // 刷新完成和触摸中断通过任务通知提前唤醒（触摸未接中断时由 LVGL 读取定时器轮询）
+    SPD2010_Set_Flush_Notify(xTaskGetCurrentTaskHandle(), LVGL_WAKE_FLUSH);
+    if (Touch_Set_Int_Notify(xTaskGetCurrentTaskHandle(), LVGL_WAKE_TOUCH) != ESP_OK) {
+        ESP_LOGI(TAG, "Touch interrupt not available, polling every %d ms", LV_DEF_REFR_PERIOD);
+    }
+
     while (1) {
-        // 调用LVGL定时器处理函数
-        uint32_t delay_ms = lv_timer_handler();
-        
-        // 动态延时，平衡性能和功耗
-        if (delay_ms == LV_NO_TIMER_READY) {
-            // 无定时器时等待200ms
-            vTaskDelay(pdMS_TO_TICKS(200));
-        } else if (delay_ms < 20) {
-            vTaskDelay(pdMS_TO_TICKS(20));
-        } else {
-            delay_ms = 100;
-            vTaskDelay(pdMS_TO_TICKS(delay_ms));
+        // 调用LVGL定时器处理函数，返回距下一个定时器到期的时间，睡眠到那时或被通知提前唤醒
+        uint32_t wake = lvgl_wake_wait(lv_timer_handler(), &lvgl_stats);
+
+        if (wake & (LVGL_WAKE_TOUCH | LVGL_WAKE_REQUEST)) {
+            lv_lock();
+            if (wake & LVGL_WAKE_TOUCH) {
+                // 触摸中断：立即读取输入，不等读取定时器
+                lv_indev_read(g_lvgl_indev);
+            }
+            // 让本轮 lv_timer_handler 立即刷新，而不是等到下一个刷新周期
+            lv_timer_t *refr_timer = lv_display_get_refr_timer(g_lvgl_display);
+            if (refr_timer) {
+                lv_timer_ready(refr_timer);
+            }
+            lv_unlock();
         }
     }
 }
@@ -291,11 +459,12 @@ static esp_err_t lvgl_task_init(void)
 
 static void lvgl_cleanup_resources(void)
 {
-    // 停止并删除定时器
-    if (lvgl_tick_timer) {
-        esp_timer_stop(lvgl_tick_timer);
-        esp_timer_delete(lvgl_tick_timer);
-        lvgl_tick_timer = NULL;
+    // 停止 LVGL 任务（先取消通知，避免中断回调通知已删除的任务）
+    if (lvgl_task_handle) {
+        SPD2010_Set_Flush_Notify(NULL, 0);
+        Touch_Set_Int_Notify(NULL, 0);
+        vTaskDelete(lvgl_task_handle);
+        lvgl_task_handle = NULL;
     }
 
     // 删除输入设备
@@ -304,7 +473,12 @@ static void lvgl_cleanup_resources(void)
         g_lvgl_indev = NULL;
     }
 
-    // 删除显示对象
+    // 恢复每次传输完成直接通知LVGL，释放弹跳缓冲区
+    SPD2010_Set_Flush_Done_Hook(NULL, NULL);
+    lvgl_flush_deinit();
+
+    // 删除性能浮层与显示对象
+    lvgl_perf_deinit();
     if (g_lvgl_display) {
         lv_display_delete(g_lvgl_display);
         g_lvgl_display = NULL;
@@ -319,6 +493,7 @@ static void lvgl_cleanup_resources(void)
         free(lvgl_draw_buf2);
         lvgl_draw_buf2 = NULL;
     }
+    lvgl_render_direct = false;
 }
 
 /*********************
@@ -336,6 +511,9 @@ esp_err_t lvgl_driver_init(void)
     // 初始化LVGL库
     lv_init();
 
+    // 分块并行绘制单元（失败时全部由 LVGL 软件绘制单元在 LVGL 任务中绘制）
+    lvgl_draw_tile_init();
+
     // 初始化显示驱动
     esp_err_t ret = lvgl_display_init();
     if (ret != ESP_OK) {
@@ -350,10 +528,10 @@ esp_err_t lvgl_driver_init(void)
         goto error;
     }
 
-    // 初始化tick定时器
-    ret = lvgl_tick_timer_init();
+    // 初始化tick时基
+    ret = lvgl_tick_init();
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize tick timer");
+        ESP_LOGE(TAG, "Failed to initialize tick source");
         goto error;
     }
 
@@ -372,6 +550,46 @@ error:
     return ret;
 }
 
+uint32_t lvgl_driver_flush_fence(void)
+{
+    return lvgl_flush_submitted();
+}
+
+esp_err_t lvgl_driver_flush_wait(uint32_t fence, uint32_t timeout_ms)
+{
+    return SPD2010_Wait_Flush_Done(fence, timeout_ms);
+}
+
+bool lvgl_driver_flush_done(uint32_t fence)
+{
+    return (int32_t)(SPD2010_Get_Flush_Done_Count() - fence) >= 0;
+}
+
+uint32_t lvgl_driver_get_frame_count(void)
+{
+    return lvgl_frame_count;
+}
+
+void lvgl_driver_wake(void)
+{
+    if (lvgl_task_handle) {
+        xTaskNotify(lvgl_task_handle, LVGL_WAKE_REQUEST, eSetBits);
+    }
+}
+
+uint32_t lvgl_driver_get_frame_interval_us(void)
+{
+    return lvgl_stats.frame_interval_us_avg;
+}
+
+void lvgl_driver_get_stats(lvgl_driver_stats_t *stats)
+{
+    if (stats) {
+        *stats = lvgl_stats;
+        stats->draw_tile_tasks = lvgl_draw_tile_task_count();
+    }
+}
+
 void lvgl_driver_deinit(void)
 {
     ESP_LOGI(TAG, "Deinitializing LVGL driver");
@@ -0,0 +1,190 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_area.c
+ * @Description: 失效区域处理：圆形屏裁剪与按传输开销合并
+ */
+
+#include "xn_lvgl_area.h"
+#include "xn_lvgl_tile.h"
+#include <math.h>
+
+// 失效区域数组长度 LV_INV_BUF_SIZE 定义在 LVGL 私有头文件中
+#if defined(__has_include)
+#if __has_include("display/lv_display_private.h")
+#include "display/lv_display_private.h"
+#endif
+#endif
+#ifndef LV_INV_BUF_SIZE
+#define LV_INV_BUF_SIZE 32
+#endif
+
+#if LVGL_ROUND_MASK
+int16_t lvgl_area_round_x1[EXAMPLE_LCD_HEIGHT];
+int16_t lvgl_area_round_x2[EXAMPLE_LCD_HEIGHT];
+#endif
+
+/* 计算每行的可见跨度：像素与放宽后的圆有重叠即可见，再按面板要求扩展到 4 像素边界 */
+void lvgl_area_round_init(void)
+{
+#if LVGL_ROUND_MASK
+    float cx = EXAMPLE_LCD_WIDTH / 2.0f;
+    float cy = EXAMPLE_LCD_HEIGHT / 2.0f;
+    float r = LV_MIN(EXAMPLE_LCD_WIDTH, EXAMPLE_LCD_HEIGHT) / 2.0f + LVGL_ROUND_MASK_MARGIN;
+
+    for (int32_t y = 0; y < EXAMPLE_LCD_HEIGHT; y++) {
+        // 取本行离圆心最近的边计算半宽
+        float dy = (y + 1 <= cy) ? cy - (y + 1) : (y >= cy ? y - cy : 0.0f);
+        if (dy >= r) {
+            lvgl_area_round_x1[y] = 1;
+            lvgl_area_round_x2[y] = 0;
+            continue;
+        }
+        float half = sqrtf(r * r - dy * dy);
+        int32_t x1 = LV_MAX(0, (int32_t)floorf(cx - half));
+        int32_t x2 = LV_MIN(EXAMPLE_LCD_WIDTH - 1, (int32_t)ceilf(cx + half) - 1);
+        lvgl_area_round_x1[y] = (int16_t)((x1 >> 2) << 2);
+        lvgl_area_round_x2[y] = (int16_t)LV_MIN(EXAMPLE_LCD_WIDTH - 1, ((x2 >> 2) << 2) + 3);
+    }
+#endif
+}
+
+bool lvgl_area_round_clip(lv_area_t *area)
+{
+    int32_t y1 = LV_MAX(area->y1, 0);
+    int32_t y2 = LV_MIN(area->y2, EXAMPLE_LCD_HEIGHT - 1);
+    int32_t x1, x2, tx1, tx2;
+
+    // 圆内各行跨度互相包含，离圆心最近的一行最宽
+    int32_t yc = LV_CLAMP(y1, EXAMPLE_LCD_HEIGHT / 2, y2);
+    if (y1 > y2 || !lvgl_area_row_span(yc, area, &x1, &x2)) {
+        // 完全不可见：换成左上角不可见的 4 个像素，重复的失效区域会被 LVGL 合并，刷新时整块跳过
+        area->x1 = 0;
+        area->y1 = 0;
+        area->x2 = 3;
+        area->y2 = 0;
+        return false;
+    }
+
+    while (!lvgl_area_row_span(y1, area, &tx1, &tx2)) {
+        y1++;
+    }
+    while (!lvgl_area_row_span(y2, area, &tx1, &tx2)) {
+        y2--;
+    }
+    area->x1 = x1;
+    area->x2 = x2;
+    area->y1 = y1;
+    area->y2 = y2;
+    return true;
+}
+
+bool lvgl_area_round(lv_area_t *area)
+{
+    // SPD2010需要4字节对齐
+    uint16_t x1 = area->x1;
+    uint16_t x2 = area->x2;
+
+    // 将起始坐标向下对齐到4的倍数
+    area->x1 = (x1 >> 2) << 2;
+    // 将结束坐标向上对齐到4N+3
+    area->x2 = ((x2 >> 2) << 2) + 3;
+
+#if LVGL_ROUND_MASK
+    // LVGL 用 (0,0)-(0,h-1) 探测对齐后每次渲染的最大行数，探测区域只对齐不裁剪，
+    // 否则它落在圆外被缩成一行，每次只渲染一行
+    bool probe = (x1 == 0 && x2 == 0 && area->y1 == 0);
+    if (!probe && !lvgl_area_round_clip(area)) {
+        return false;
+    }
+#endif
+    lvgl_tile_align(area);
+    return true;
+}
+
+int32_t lvgl_area_cost(const lv_area_t *area, int32_t chunk_bytes)
+{
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+
+    // 每次传输的行数：流水线发送受弹跳缓冲区限制，直接发送受显示缓冲区限制
+    int32_t rows_per_txn = (chunk_bytes > 0 && w * 2 <= chunk_bytes) ?
+                           chunk_bytes / (w * 2) : LV_MAX(1, LVGL_BUFFER_SIZE / w);
+    int32_t txns = (h + rows_per_txn - 1) / rows_per_txn;
+    return txns * LVGL_MERGE_TXN_COST + w * h * 2;
+}
+
+static inline bool lvgl_area_contains(const lv_area_t *outer, const lv_area_t *inner)
+{
+    return inner->x1 >= outer->x1 && inner->y1 >= outer->y1 &&
+           inner->x2 <= outer->x2 && inner->y2 <= outer->y2;
+}
+
+/* 之后 LVGL 自带的合并只会合并重叠区域，不会拆开这里的结果 */
+uint32_t lvgl_area_merge(lv_area_t *areas, uint32_t n, int32_t chunk_bytes)
+{
+    int32_t cost[LV_INV_BUF_SIZE];
+
+    if (n < 2 || n > LV_INV_BUF_SIZE) {
+        return n;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        cost[i] = lvgl_area_cost(&areas[i], chunk_bytes);
+    }
+
+    while (n > 1) {
+        int32_t best_gain = 0;
+        uint32_t bi = 0, bj = 0;
+        lv_area_t best;
+
+        for (uint32_t i = 0; i < n; i++) {
+            for (uint32_t j = i + 1; j < n; j++) {
+                lv_area_t u = {
+                    .x1 = LV_MIN(areas[i].x1, areas[j].x1),
+                    .y1 = LV_MIN(areas[i].y1, areas[j].y1),
+                    .x2 = LV_MAX(areas[i].x2, areas[j].x2),
+                    .y2 = LV_MAX(areas[i].y2, areas[j].y2),
+                };
+#if LVGL_ROUND_MASK
+                lvgl_area_round_clip(&u);
+#endif
+                lvgl_tile_align(&u);
+                int32_t gain = cost[i] + cost[j] - lvgl_area_cost(&u, chunk_bytes);
+                if (gain > best_gain) {
+                    best_gain = gain;
+                    best = u;
+                    bi = i;
+                    bj = j;
+                }
+            }
+        }
+        if (best_gain <= 0) {
+            break;
+        }
+
+        // bi < bj，用最后一个区域填补 bj 的空位
+        areas[bi] = best;
+        cost[bi] = lvgl_area_cost(&best, chunk_bytes);
+        areas[bj] = areas[n - 1];
+        cost[bj] = cost[n - 1];
+        n--;
+
+        // 删除被合并结果完全覆盖的区域
+        for (uint32_t k = 0; k < n;) {
+            if (k != bi && lvgl_area_contains(&areas[bi], &areas[k])) {
+                areas[k] = areas[n - 1];
+                cost[k] = cost[n - 1];
+                if (bi == n - 1) {
+                    bi = k;
+                }
+                n--;
+            } else {
+                k++;
+            }
+        }
+    }
+    return n;
+}
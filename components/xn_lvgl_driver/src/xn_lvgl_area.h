@@ -0,0 +1,81 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_area.h
+ * @Description: 失效区域处理：圆形屏裁剪与按传输开销合并（驱动内部接口，设备端与主机后端共用）
+ *
+ * 只依赖 lv_area_t，不访问显示对象：对齐回调与 LV_EVENT_REFR_START 回调取出区域后调用这里，
+ * 统计与 inv_areas 的写回留在各后端。
+ */
+
+#pragma once
+
+#include "xn_lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if LVGL_ROUND_MASK
+// 每行可见跨度（已按 4 像素对齐），x1 > x2 表示整行不可见；lvgl_area_round_init() 填写
+extern int16_t lvgl_area_round_x1[EXAMPLE_LCD_HEIGHT];
+extern int16_t lvgl_area_round_x2[EXAMPLE_LCD_HEIGHT];
+#endif
+
+/**
+ * @brief 屏幕第 y 行在区域 area 内需要发送的列范围（刷新路径逐行调用，内联）
+ * @return false 整行不可见
+ */
+static inline bool lvgl_area_row_span(int32_t y, const lv_area_t *area, int32_t *x1, int32_t *x2)
+{
+#if LVGL_ROUND_MASK
+    *x1 = LV_MAX(area->x1, lvgl_area_round_x1[y]);
+    *x2 = LV_MIN(area->x2, lvgl_area_round_x2[y]);
+    return *x1 <= *x2;
+#else
+    *x1 = area->x1;
+    *x2 = area->x2;
+    return true;
+#endif
+}
+
+/**
+ * @brief 计算每行的可见跨度（初始化显示时调用一次，LVGL_ROUND_MASK 为 0 时为空操作）
+ */
+void lvgl_area_round_init(void);
+
+/**
+ * @brief 失效区域裁到可见圆内：列裁到区域内最宽一行的可见跨度，去掉首尾整行不可见的行
+ * @param area 区域，完全不可见时换成左上角不可见的 4 个像素
+ * @return false 完全不可见
+ */
+bool lvgl_area_round_clip(lv_area_t *area);
+
+/**
+ * @brief 对齐回调的完整处理：x 扩展到 4 像素边界，裁到可见圆内，再扩展到图块边界
+ * @param area LV_EVENT_INVALIDATE_AREA 的区域
+ * @return false 区域完全不可见（已换成不可见的 4 个像素，刷新时整块跳过）
+ */
+bool lvgl_area_round(lv_area_t *area);
+
+/**
+ * @brief 估算区域的发送开销（折合字节）：传输次数 × LVGL_MERGE_TXN_COST + 像素字节数
+ * @param area 区域
+ * @param chunk_bytes 流水线刷新每块字节数，0 表示整块直接发送（每块不超过 LVGL_BUFFER_SIZE 个像素）
+ */
+int32_t lvgl_area_cost(const lv_area_t *area, int32_t chunk_bytes);
+
+/**
+ * @brief 合并失效区域：每次合并节省开销最多的一对，直到任何合并都不再划算
+ * @param areas 区域数组，原地改写
+ * @param n 区域数，超过 LVGL 失效区域数组长度（LV_INV_BUF_SIZE）时不处理
+ * @param chunk_bytes 同 lvgl_area_cost()
+ * @return 合并后的区域数，与 n 相同表示没有改动
+ */
+uint32_t lvgl_area_merge(lv_area_t *areas, uint32_t n, int32_t chunk_bytes);
+
+#ifdef __cplusplus
+}
+#endif
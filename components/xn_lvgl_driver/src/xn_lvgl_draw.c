@@ -0,0 +1,213 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-08 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-08 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_draw.c
+ * @Description: 分块并行绘制单元
+ *
+ * LVGL 的软件绘制单元一次只执行一个绘制任务，覆盖整个区域的背景渐变或 Lottie 图像绘制期间
+ * 其它任务都在等待（与之重叠）。这里注册一个自定义绘制单元，认领面积较大的填充与图像任务，
+ * 按行拆成 LVGL_DRAW_TILE_WORKERS 块，由固定在各核心上的绘制任务同时调用 LVGL 软件绘制函数，
+ * 各块的裁剪区域互不重叠，只写各自的行。最后一块完成时把任务标记为完成并请求重新分派。
+ */
+
+#include "xn_lvgl_draw.h"
+
+// 绘制单元与绘制任务的结构定义在 LVGL 私有头文件中
+#if defined(__has_include)
+#if __has_include("draw/lv_draw_private.h")
+#include "draw/lv_draw_private.h"
+#include "draw/sw/lv_draw_sw.h"
+#define LVGL_HAVE_DRAW_PRIVATE 1
+#endif
+#endif
+
+#if LVGL_DRAW_TILE_WORKERS > 0 && CONFIG_LV_OS_FREERTOS && LVGL_HAVE_DRAW_PRIVATE
+#define LVGL_DRAW_TILE_ENABLED 1
+#endif
+
+static const char *TAG = "LVGL_DRAW";
+
+#if LVGL_DRAW_TILE_ENABLED
+
+#define LVGL_DRAW_TILE_UNIT_ID      0x58    // 自定义绘制单元编号，不与 LVGL 内置单元冲突
+#define LVGL_DRAW_TILE_SCORE        80      // 低于软件绘制单元的 100，软件单元不会再抢回
+
+/** 绘制任务上下文：各自的裁剪区域 */
+typedef struct {
+    lv_draw_unit_t unit;            // 只使用 target_layer 与 clip_area
+    lv_area_t clip;
+    TaskHandle_t handle;
+} lvgl_draw_tile_worker_t;
+
+typedef struct {
+    lv_draw_unit_t base_unit;
+    lv_draw_task_t *volatile task_act;
+    uint32_t pending;               // 尚未完成的块数（原子操作）
+    lvgl_draw_tile_worker_t workers[LVGL_DRAW_TILE_WORKERS];
+} lvgl_draw_tile_unit_t;
+
+static const BaseType_t s_worker_cores[] = LVGL_DRAW_TILE_CORES;
+_Static_assert(sizeof(s_worker_cores) / sizeof(s_worker_cores[0]) == LVGL_DRAW_TILE_WORKERS,
+               "LVGL_DRAW_TILE_CORES must list one core per worker");
+
+static lvgl_draw_tile_unit_t *s_unit = NULL;
+static volatile uint32_t s_task_count = 0;
+
+/* 绘制区域：任务区域与裁剪区域的交集 */
+static bool lvgl_draw_tile_area(const lv_draw_task_t *t, lv_area_t *area)
+{
+    area->x1 = LV_MAX(t->area.x1, t->clip_area.x1);
+    area->y1 = LV_MAX(t->area.y1, t->clip_area.y1);
+    area->x2 = LV_MIN(t->area.x2, t->clip_area.x2);
+    area->y2 = LV_MIN(t->area.y2, t->clip_area.y2);
+    return area->x1 <= area->x2 && area->y1 <= area->y2;
+}
+
+/* 认领面积够大的填充与无变换图像任务，其余交给软件绘制单元 */
+static int32_t lvgl_draw_tile_evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *task)
+{
+    LV_UNUSED(draw_unit);
+    lv_area_t area;
+
+    if (task->preference_score <= LVGL_DRAW_TILE_SCORE || !lvgl_draw_tile_area(task, &area) ||
+        !lvgl_draw_tile_splittable(&area)) {
+        return 0;
+    }
+
+    if (task->type == LV_DRAW_TASK_TYPE_IMAGE) {
+        const lv_draw_image_dsc_t *dsc = task->draw_dsc;
+        if (dsc->rotation != 0 || dsc->scale_x != LV_SCALE_NONE || dsc->scale_y != LV_SCALE_NONE ||
+            dsc->bitmap_mask_src != NULL || dsc->header.cf >= LV_COLOR_FORMAT_PROPRIETARY_START) {
+            return 0;
+        }
+    } else if (task->type != LV_DRAW_TASK_TYPE_FILL) {
+        return 0;
+    }
+
+    task->preference_score = LVGL_DRAW_TILE_SCORE;
+    task->preferred_draw_unit_id = LVGL_DRAW_TILE_UNIT_ID;
+    return 0;
+}
+
+/* 取一个认领的任务，按行等分给各绘制任务 */
+static int32_t lvgl_draw_tile_dispatch(lv_draw_unit_t *draw_unit, lv_layer_t *layer)
+{
+    lvgl_draw_tile_unit_t *u = (lvgl_draw_tile_unit_t *)draw_unit;
+    lv_area_t area;
+
+    if (u->task_act) {
+        return 0;
+    }
+
+    lv_draw_task_t *t = lv_draw_get_next_available_task(layer, NULL, LVGL_DRAW_TILE_UNIT_ID);
+    if (t == NULL) {
+        return LV_DRAW_UNIT_IDLE;
+    }
+    if (lv_draw_layer_alloc_buf(layer) == NULL) {
+        return LV_DRAW_UNIT_IDLE;
+    }
+
+    t->state = LV_DRAW_TASK_STATE_IN_PROGRESS;
+    if (!lvgl_draw_tile_area(t, &area)) {
+        t->state = LV_DRAW_TASK_STATE_READY;
+        lv_draw_dispatch_request();
+        return 1;
+    }
+
+    int32_t n = lvgl_draw_tile_band_count(&area, LVGL_DRAW_TILE_WORKERS);
+    u->task_act = t;
+    __atomic_store_n(&u->pending, (uint32_t)n, __ATOMIC_RELEASE);
+    s_task_count++;
+
+    for (int32_t i = 0; i < n; i++) {
+        lvgl_draw_tile_worker_t *w = &u->workers[i];
+        w->clip = lvgl_draw_tile_band(&area, n, i);
+        w->unit.target_layer = layer;
+        w->unit.clip_area = &w->clip;
+        xTaskNotifyGive(w->handle);
+    }
+    return 1;
+}
+
+static void lvgl_draw_tile_worker_task(void *arg)
+{
+    lvgl_draw_tile_worker_t *w = arg;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        lv_draw_task_t *t = s_unit->task_act;
+        if (t->type == LV_DRAW_TASK_TYPE_FILL) {
+            lv_draw_sw_fill(&w->unit, t->draw_dsc, &t->area);
+        } else {
+            lv_draw_sw_image(&w->unit, t->draw_dsc, &t->area);
+        }
+
+        // 最后完成的一块负责收尾：先释放单元再标记完成，LVGL 随即可以分派下一个任务
+        if (__atomic_sub_fetch(&s_unit->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+            s_unit->task_act = NULL;
+            t->state = LV_DRAW_TASK_STATE_READY;
+            lv_draw_dispatch_request();
+        }
+    }
+}
+
+esp_err_t lvgl_draw_tile_init(void)
+{
+    if (s_unit) {
+        return ESP_OK;
+    }
+
+    // LVGL 把新单元插在链表头部，分派与评估都先于软件绘制单元
+    // 分派回调总会被调用，先设置；评估回调在绘制任务创建成功后才设置，之前不会认领任何任务
+    lvgl_draw_tile_unit_t *u = lv_draw_create_unit(sizeof(lvgl_draw_tile_unit_t));
+    if (!u) {
+        return ESP_ERR_NO_MEM;
+    }
+    u->base_unit.dispatch_cb = lvgl_draw_tile_dispatch;
+
+    for (int i = 0; i < LVGL_DRAW_TILE_WORKERS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "lvgl_draw%d", i);
+        if (xTaskCreatePinnedToCore(lvgl_draw_tile_worker_task, name, LVGL_DRAW_TILE_STACK_SIZE, &u->workers[i],
+                                    LVGL_DRAW_TILE_PRIORITY, &u->workers[i].handle, s_worker_cores[i]) != pdPASS) {
+            // 单元已在 LVGL 链表中无法移除，不设置评估回调，它不会认领任何任务
+            ESP_LOGE(TAG, "Failed to create draw worker %d", i);
+            for (int j = 0; j < i; j++) {
+                vTaskDelete(u->workers[j].handle);
+                u->workers[j].handle = NULL;
+            }
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    s_unit = u;
+    u->base_unit.evaluate_cb = lvgl_draw_tile_evaluate;
+
+    ESP_LOGI(TAG, "Tile-parallel draw unit: %d workers, min %d pixels",
+             LVGL_DRAW_TILE_WORKERS, LVGL_DRAW_TILE_MIN_PIXELS);
+    return ESP_OK;
+}
+
+#else
+
+esp_err_t lvgl_draw_tile_init(void)
+{
+#if LVGL_DRAW_TILE_WORKERS > 0
+    ESP_LOGW(TAG, "Tile-parallel drawing needs CONFIG_LV_OS_FREERTOS and LVGL 9.2 private headers");
+#endif
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
+
+uint32_t lvgl_draw_tile_task_count(void)
+{
+#if LVGL_DRAW_TILE_ENABLED
+    return s_task_count;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,62 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-08 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-08 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_draw.h
+ * @Description: 分块并行绘制单元（驱动内部接口）
+ */
+
+#pragma once
+
+#include "xn_lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LVGL_DRAW_TILE_MIN_ROWS     8       // 每块至少的行数
+
+/**
+ * @brief 绘制区域（任务区域与裁剪区域的交集）是否值得拆分：面积不小于 LVGL_DRAW_TILE_MIN_PIXELS，至少能分成两块
+ */
+static inline bool lvgl_draw_tile_splittable(const lv_area_t *area)
+{
+    return lv_area_get_width(area) * lv_area_get_height(area) >= LVGL_DRAW_TILE_MIN_PIXELS &&
+           lv_area_get_height(area) >= LVGL_DRAW_TILE_MIN_ROWS * 2;
+}
+
+/**
+ * @brief 拆分块数：每块至少 LVGL_DRAW_TILE_MIN_ROWS 行，不超过 workers
+ */
+static inline int32_t lvgl_draw_tile_band_count(const lv_area_t *area, int32_t workers)
+{
+    return LV_CLAMP(1, lv_area_get_height(area) / LVGL_DRAW_TILE_MIN_ROWS, workers);
+}
+
+/**
+ * @brief 第 i 块（共 n 块）按行等分，各块互不重叠、合起来正好覆盖 area
+ */
+static inline lv_area_t lvgl_draw_tile_band(const lv_area_t *area, int32_t n, int32_t i)
+{
+    int32_t h = lv_area_get_height(area);
+    lv_area_t band = *area;
+    band.y1 = area->y1 + h * i / n;
+    band.y2 = area->y1 + h * (i + 1) / n - 1;
+    return band;
+}
+
+/**
+ * @brief 创建绘制任务并注册 LVGL 绘制单元（lv_init() 之后调用，重复调用无影响）
+ * @return ESP_OK 成功, ESP_ERR_NOT_SUPPORTED 未启用或 LVGL 不支持, ESP_ERR_NO_MEM 创建失败
+ */
+esp_err_t lvgl_draw_tile_init(void);
+
+/**
+ * @brief 已拆分并行绘制的任务数
+ */
+uint32_t lvgl_draw_tile_task_count(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,287 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_flush.c
+ * @Description: 刷新区域发送到面板：分块流水线与整块直接发送
+ */
+
+#include "xn_lvgl_flush.h"
+#include "xn_lvgl_pixel.h"
+#include "xn_lvgl_area.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "LVGL_FLUSH";
+
+// 分块流水线刷新：内部 DMA 弹跳缓冲区，CPU 交换下一块字节序时 DMA 发送当前块
+static uint8_t *lvgl_bounce_buf[LVGL_FLUSH_BOUNCE_COUNT];
+static uint8_t lvgl_bounce_next = 0;
+static SemaphoreHandle_t lvgl_bounce_sem = NULL;    // 空闲弹跳缓冲区数
+
+static volatile uint32_t lvgl_flush_submit_count = 0;   // 已提交的传输次数
+static volatile uint32_t lvgl_flush_done_count = 0;     // 最近一次完成回调的完成计数
+static volatile uint32_t lvgl_flush_ready_seq = 0;      // 区域最后一块的提交序号，完成时通知 LVGL
+
+/** 刷新传输块：区域内从第 y 行起的 rows 行、列 x1~x2（屏幕坐标） */
+typedef struct {
+    int32_t y;
+    int32_t rows;
+    int32_t x1;
+    int32_t x2;
+} lvgl_flush_band_t;
+
+/** 流水线刷新的块迭代器：先取图块比较后需要发送的片段，再把片段拆成传输块 */
+typedef struct {
+    lvgl_tile_iter_t tiles;
+    lv_area_t part;         // 当前片段（屏幕坐标）
+    int32_t part_y;         // 片段内下一行（相对片段）
+    bool in_part;
+    uint32_t *hash_us;
+} lvgl_flush_iter_t;
+
+esp_err_t lvgl_flush_init(void)
+{
+    bool bounce_ok = true;
+
+    for (int i = 0; i < LVGL_FLUSH_BOUNCE_COUNT; i++) {
+        lvgl_bounce_buf[i] = heap_caps_malloc(LVGL_FLUSH_CHUNK_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        bounce_ok = bounce_ok && lvgl_bounce_buf[i];
+    }
+    if (bounce_ok) {
+        lvgl_bounce_sem = xSemaphoreCreateCounting(LVGL_FLUSH_BOUNCE_COUNT, LVGL_FLUSH_BOUNCE_COUNT);
+    }
+    if (!lvgl_bounce_sem) {
+        lvgl_flush_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+    lvgl_bounce_next = 0;
+    return ESP_OK;
+}
+
+void lvgl_flush_deinit(void)
+{
+    if (lvgl_bounce_sem) {
+        vSemaphoreDelete(lvgl_bounce_sem);
+        lvgl_bounce_sem = NULL;
+    }
+    for (int i = 0; i < LVGL_FLUSH_BOUNCE_COUNT; i++) {
+        heap_caps_free(lvgl_bounce_buf[i]);
+        lvgl_bounce_buf[i] = NULL;
+    }
+}
+
+bool lvgl_flush_pipelined(void)
+{
+    return lvgl_bounce_sem != NULL;
+}
+
+uint32_t lvgl_flush_submitted(void)
+{
+    return lvgl_flush_submit_count;
+}
+
+/* 传输完成（SPI中断上下文）：每完成一块归还一个弹跳缓冲区，区域最后一块完成时返回 true */
+bool IRAM_ATTR lvgl_flush_on_done(uint32_t done_count, BaseType_t *need_yield)
+{
+    lvgl_flush_done_count = done_count;
+
+    // 直接发送时信号量已满，归还失败无影响
+    if (lvgl_bounce_sem) {
+        xSemaphoreGiveFromISR(lvgl_bounce_sem, need_yield);
+    }
+    return done_count == lvgl_flush_ready_seq;
+}
+
+/* 轮询等待完成计数到达 target（LVGL 任务上下文）
+ * 不能用 SPD2010_Wait_Flush_Done()：它借用调用任务的通知值等待，会清掉 LVGL 任务的唤醒位 */
+static bool lvgl_flush_poll_done(uint32_t target, uint32_t timeout_ms)
+{
+    TickType_t start = xTaskGetTickCount();
+
+    while ((int32_t)(lvgl_flush_done_count - target) < 0) {
+        if (xTaskGetTickCount() - start >= pdMS_TO_TICKS(timeout_ms)) {
+            return false;
+        }
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+/* 原路径：整块原地交换字节序后直接从PSRAM发送（只去掉首尾整行不可见的行） */
+static esp_err_t lvgl_flush_direct(esp_lcd_panel_handle_t panel_handle, const lv_area_t *area, uint8_t *px_map,
+                                   lvgl_flush_counters_t *cnt)
+{
+    int32_t width = lv_area_get_width(area);
+    int32_t y1 = area->y1;
+    int32_t y2 = area->y2;
+    int32_t x1, x2;
+
+    while (y1 <= y2 && !lvgl_area_row_span(y1, area, &x1, &x2)) {
+        y1++;
+    }
+    while (y2 >= y1 && !lvgl_area_row_span(y2, area, &x1, &x2)) {
+        y2--;
+    }
+    if (y1 > y2) {
+        return ESP_OK;
+    }
+
+    // 不做图块比较，发送后面板内容与哈希不再对应
+    lvgl_tile_invalidate(area);
+
+    uint8_t *src = px_map + (size_t)(y1 - area->y1) * width * 2;
+    uint32_t pixel_count = (uint32_t)(width * (y2 - y1 + 1));
+    lvgl_pixel_rgb565_swap((uint16_t *)src, (const uint16_t *)src, pixel_count);
+
+    lvgl_flush_ready_seq = lvgl_flush_submit_count + 1;
+    esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, area->x1, y1, area->x2 + 1, y2 + 1, src);
+    if (ret == ESP_OK) {
+        lvgl_flush_submit_count++;
+        cnt->txns++;
+        cnt->bytes += pixel_count * 2;
+    }
+    return ret;
+}
+
+/* 从区域第 y 行起取下一个传输块：跳过不可见行，相邻各行跨度相差不超过 LVGL_ROUND_MASK_SLACK
+ * 时合并成一块（按最宽一行发送），块大小不超过弹跳缓冲区。没有剩余可见行时返回 false */
+static bool lvgl_flush_next_band(const lv_area_t *area, int32_t y, lvgl_flush_band_t *band)
+{
+    int32_t height = lv_area_get_height(area);
+    int32_t x1, x2;
+
+    while (y < height && !lvgl_area_row_span(area->y1 + y, area, &x1, &x2)) {
+        y++;
+    }
+    if (y >= height) {
+        return false;
+    }
+
+    int32_t min_w = x2 - x1 + 1;
+    band->y = y;
+    band->rows = 1;
+    band->x1 = x1;
+    band->x2 = x2;
+
+    while (y + band->rows < height) {
+        if (!lvgl_area_row_span(area->y1 + y + band->rows, area, &x1, &x2)) {
+            break;
+        }
+        int32_t ux1 = LV_MIN(band->x1, x1);
+        int32_t ux2 = LV_MAX(band->x2, x2);
+        int32_t uw = ux2 - ux1 + 1;
+        int32_t w = LV_MIN(min_w, x2 - x1 + 1);
+        if (uw - w > LVGL_ROUND_MASK_SLACK || uw * (band->rows + 1) * 2 > LVGL_FLUSH_CHUNK_BYTES) {
+            break;
+        }
+        band->x1 = ux1;
+        band->x2 = ux2;
+        band->rows++;
+        min_w = w;
+    }
+    return true;
+}
+
+/* 取下一个传输块，band->y 换算为相对整个区域的行 */
+static bool lvgl_flush_iter_next(lvgl_flush_iter_t *it, lvgl_flush_band_t *band)
+{
+    while (1) {
+        if (it->in_part && lvgl_flush_next_band(&it->part, it->part_y, band)) {
+            it->part_y = band->y + band->rows;
+            band->y += it->part.y1 - it->tiles.area->y1;
+            return true;
+        }
+
+        int64_t hash_start_us = esp_timer_get_time();
+        it->in_part = lvgl_tile_iter_next(&it->tiles, &it->part);
+        *it->hash_us += (uint32_t)(esp_timer_get_time() - hash_start_us);
+        if (!it->in_part) {
+            return false;
+        }
+        it->part_y = 0;
+    }
+}
+
+/* 流水线路径：跳过内容未变的图块，其余按行拆块（圆形裁剪时每块只含可见跨度），当前块DMA期间CPU准备下一块
+ * px 指向区域首个像素，stride 为行跨度（字节）；源像素只读，直接模式的帧缓冲不被修改 */
+static esp_err_t lvgl_flush_pipeline(esp_lcd_panel_handle_t panel_handle, const lv_area_t *area,
+                                     const uint8_t *px, int32_t stride, lvgl_flush_counters_t *cnt)
+{
+    int32_t width = lv_area_get_width(area);
+    lvgl_flush_iter_t it = {.hash_us = &cnt->hash_us};
+    lvgl_flush_band_t band, next;
+    esp_err_t ret = ESP_OK;
+
+    lvgl_tile_iter_init(&it.tiles, area, px, stride, &cnt->tiles);
+    bool has_next = lvgl_flush_iter_next(&it, &next);
+
+    while (has_next) {
+        band = next;
+        has_next = lvgl_flush_iter_next(&it, &next);
+        int32_t band_w = band.x2 - band.x1 + 1;
+
+        // 等待最早提交的一块发送完成，腾出弹跳缓冲区
+        if (xSemaphoreTake(lvgl_bounce_sem, pdMS_TO_TICKS(LVGL_FLUSH_TIMEOUT_MS)) != pdTRUE) {
+            return ESP_ERR_TIMEOUT;
+        }
+        uint8_t *bounce = lvgl_bounce_buf[lvgl_bounce_next];
+        lvgl_bounce_next = (lvgl_bounce_next + 1) % LVGL_FLUSH_BOUNCE_COUNT;
+
+        // 复制到弹跳缓冲区的同时交换字节序（SPD2010是大端序），一次读PSRAM一次写内部RAM
+        const uint8_t *src = px + (size_t)band.y * stride + (size_t)(band.x1 - area->x1) * 2;
+        if (band_w == width && stride == width * 2) {
+            lvgl_pixel_rgb565_swap((uint16_t *)bounce, (const uint16_t *)src, (uint32_t)(band.rows * width));
+        } else {
+            for (int32_t r = 0; r < band.rows; r++) {
+                lvgl_pixel_rgb565_swap((uint16_t *)(bounce + (size_t)r * band_w * 2),
+                                       (const uint16_t *)(src + (size_t)r * stride), (uint32_t)band_w);
+            }
+        }
+
+        if (!has_next) {
+            lvgl_flush_ready_seq = lvgl_flush_submit_count + 1;
+        }
+        ret = esp_lcd_panel_draw_bitmap(panel_handle, band.x1, area->y1 + band.y,
+                                        band.x2 + 1, area->y1 + band.y + band.rows, bounce);
+        if (ret != ESP_OK) {
+            xSemaphoreGive(lvgl_bounce_sem);
+            return ret;
+        }
+        lvgl_flush_submit_count++;
+        cnt->txns++;
+        cnt->bytes += (uint32_t)(band.rows * band_w * 2);
+    }
+    return ret;
+}
+
+bool lvgl_flush_area(esp_lcd_panel_handle_t panel, const lv_area_t *area, uint8_t *px, int32_t stride,
+                     lvgl_flush_counters_t *cnt)
+{
+    uint32_t submit_before = lvgl_flush_submit_count;
+    esp_err_t ret;
+
+    // 有弹跳缓冲区时分块流水线发送，否则整块原地交换后直接发送（只用于局部模式，stride 等于区域宽度）
+    if (lvgl_bounce_sem && lv_area_get_width(area) * 2 <= LVGL_FLUSH_CHUNK_BYTES) {
+        ret = lvgl_flush_pipeline(panel, area, px, stride, cnt);
+    } else {
+        ret = lvgl_flush_direct(panel, area, px, cnt);
+    }
+
+    // 关键修复：SPI队列满时传输失败，中断不会触发，必须由调用者清除flushing标志，否则死锁
+    // 分块时已提交的块仍会完成，取消完成通知后等它们发送完再通知，避免LVGL提前复用缓冲区
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️  SPI传输失败(队列满?)，立即通知LVGL");
+        lvgl_tile_invalidate(area);
+        lvgl_flush_ready_seq = lvgl_flush_submit_count - 0x80000000u;
+        if (lvgl_bounce_sem && !lvgl_flush_poll_done(lvgl_flush_submit_count, LVGL_FLUSH_TIMEOUT_MS)) {
+            ESP_LOGW(TAG, "等待已提交的分块发送完成超时");
+        }
+        return true;
+    }
+
+    // 整个区域都在可见圆外，没有提交任何传输，不会有完成中断
+    return lvgl_flush_submit_count == submit_before;
+}
@@ -0,0 +1,80 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_flush.h
+ * @Description: 刷新区域发送到面板：分块流水线与整块直接发送（驱动内部接口）
+ *
+ * 只依赖 esp_lcd_panel_draw_bitmap() 与传输完成回调，不访问显示对象：刷新回调调用
+ * lvgl_flush_area()，面板的完成钩子调用 lvgl_flush_on_done()，区域发送完成后由调用者通知 LVGL。
+ * 主机测试用异步完成的假面板驱动同一份源码。
+ */
+
+#pragma once
+
+#include "xn_lvgl.h"
+#include "xn_lvgl_tile.h"
+#include "esp_lcd_panel_ops.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 刷新计数（按帧累计，调用者在帧结束时读出并清零） */
+typedef struct {
+    uint32_t txns;                  // 提交的传输次数
+    uint32_t bytes;                 // 实际发送字节数
+    lvgl_tile_counters_t tiles;     // 图块比较计数
+    uint32_t hash_us;               // 图块哈希耗时（微秒）
+} lvgl_flush_counters_t;
+
+/**
+ * @brief 分配弹跳缓冲区（内部RAM，DMA可访问）
+ * @return ESP_ERR_NO_MEM 分配失败，之后所有区域整块直接发送
+ */
+esp_err_t lvgl_flush_init(void);
+
+/**
+ * @brief 释放弹跳缓冲区（调用前先取消面板的完成钩子）
+ */
+void lvgl_flush_deinit(void);
+
+/**
+ * @brief 弹跳缓冲区是否可用（可用时才能分块发送，直接渲染模式依赖它）
+ */
+bool lvgl_flush_pipelined(void);
+
+/**
+ * @brief 已提交到面板的传输次数（与面板完成计数配对构成刷新栅栏）
+ */
+uint32_t lvgl_flush_submitted(void);
+
+/**
+ * @brief 发送一个刷新区域（LVGL 任务上下文）
+ *
+ * 有弹跳缓冲区且一行放得下时跳过内容未变的图块，其余按行拆块，复制到弹跳缓冲区时交换字节序，
+ * 当前块DMA期间准备下一块，源像素只读；否则整块原地交换字节序后直接发送。
+ * 发送失败时已提交的块仍会完成，这里取消区域完成通知并等它们发送完。
+ * @param panel 面板句柄
+ * @param area 刷新区域（屏幕坐标）
+ * @param px 区域首个像素（RGB565）
+ * @param stride 行跨度（字节），局部渲染为区域宽度，直接渲染为屏幕宽度
+ * @param cnt 刷新计数，累加到其中
+ * @return true 调用者立即通知 LVGL（发送失败或没有提交任何传输）；
+ *         false 区域最后一块完成时 lvgl_flush_on_done() 返回 true
+ */
+bool lvgl_flush_area(esp_lcd_panel_handle_t panel, const lv_area_t *area, uint8_t *px, int32_t stride,
+                     lvgl_flush_counters_t *cnt);
+
+/**
+ * @brief 传输完成（中断上下文），每完成一块调用一次
+ * @param done_count 面板完成计数
+ * @param need_yield 归还弹跳缓冲区唤醒了更高优先级任务时置 pdTRUE
+ * @return true 区域最后一块已完成，调用者通知 LVGL
+ */
+bool lvgl_flush_on_done(uint32_t done_count, BaseType_t *need_yield);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,620 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-05 15:10:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-05 15:10:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_host.c
+ * @Description: LVGL 驱动主机后端实现（linux 目标）
+ *
+ * 与 xn_lvgl.c 实现相同的公共接口：刷新时把区域复制到帧缓冲并立即完成，
+ * 按传输模型累计估算耗时；触摸来自 lvgl_host_touch_script() 设置的脚本；
+ * 可按帧导出 PNG（无压缩 deflate，不依赖 zlib）。
+ * 目前没有工程以 linux 目标编译本文件；主机测试只覆盖与设备端共用的 xn_lvgl_area / tile / pixel / wake。
+ */
+
+#include "xn_lvgl.h"
+#include "xn_lvgl_perf.h"
+#include "xn_lvgl_tile.h"
+#include "xn_lvgl_area.h"
+#include "xn_lvgl_wake.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// 失效区域列表（inv_areas / inv_p）定义在 LVGL 私有头文件中
+#if defined(__has_include)
+#if __has_include("display/lv_display_private.h")
+#include "display/lv_display_private.h"
+#define LVGL_HAVE_DISPLAY_PRIVATE 1
+#endif
+#endif
+
+/*********************
+ * 静态变量定义
+ *********************/
+
+static const char *TAG = "LVGL_HOST";
+
+// LVGL 全局对象
+lv_display_t *g_lvgl_display = NULL;
+lv_indev_t *g_lvgl_indev = NULL;
+
+// 显示缓冲区与帧缓冲
+static uint8_t *lvgl_draw_buf1 = NULL;
+static uint8_t *lvgl_draw_buf2 = NULL;
+static uint16_t *lvgl_host_fb = NULL;
+static bool lvgl_render_direct = false;        // 直接模式：px_map 是整屏帧缓冲
+
+static TaskHandle_t lvgl_task_handle = NULL;
+
+// 刷新同步完成，提交数即完成数
+static volatile uint32_t lvgl_flush_submit_count = 0;
+static volatile uint32_t lvgl_frame_count = 0;
+
+static lvgl_driver_stats_t lvgl_stats;
+static lvgl_host_stats_t lvgl_host_stats;
+static lvgl_host_config_t lvgl_host_config;
+static int64_t lvgl_last_frame_us = 0;
+static int64_t lvgl_input_press_us = 0;
+static bool lvgl_touch_pressed = false;
+
+// 本帧累计
+static uint32_t lvgl_frame_bytes = 0;
+static uint32_t lvgl_frame_bytes_unmasked = 0;
+static uint32_t lvgl_frame_txns = 0;
+static uint32_t lvgl_frame_transfer_us = 0;
+static uint32_t lvgl_frame_areas = 0;
+static uint32_t lvgl_frame_pixels = 0;
+static lvgl_tile_counters_t lvgl_frame_tiles;
+static uint32_t lvgl_frame_hash_us = 0;
+
+// 脚本触摸
+static const lvgl_host_touch_event_t *lvgl_touch_events = NULL;
+static size_t lvgl_touch_event_count = 0;
+static int64_t lvgl_touch_start_us = 0;
+
+#define LVGL_HOST_TASK_STACK_SIZE  (16 * 1024)
+
+/*********************
+ * 时间与传输模型
+ *********************/
+
+static int64_t lvgl_host_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint32_t lvgl_tick_get_cb(void)
+{
+    return (uint32_t)(lvgl_host_time_us() / 1000);
+}
+
+/* 与设备端流水线刷新一致：每个弹跳缓冲区大小的块一次传输；bytes 为圆形裁剪后实际发送的字节数 */
+static uint32_t lvgl_host_transfer_us(int32_t width, int32_t height, uint32_t bytes, uint32_t *txns)
+{
+    uint32_t bw = lvgl_host_config.bus_bytes_per_sec ? lvgl_host_config.bus_bytes_per_sec :
+                  LVGL_HOST_BUS_BYTES_PER_SEC;
+
+    if (LVGL_FLUSH_PIPELINE && width * 2 <= LVGL_FLUSH_CHUNK_BYTES) {
+        int32_t rows = LVGL_FLUSH_CHUNK_BYTES / (width * 2);
+        *txns = (uint32_t)((height + rows - 1) / rows);
+    } else {
+        *txns = 1;
+    }
+    return *txns * lvgl_host_config.txn_overhead_us + (uint32_t)((uint64_t)bytes * 1000000 / bw);
+}
+
+/*********************
+ * PNG 导出
+ *********************/
+
+static uint32_t png_crc(uint32_t crc, const uint8_t *buf, size_t len)
+{
+    static uint32_t table[256];
+    static bool table_ready = false;
+
+    if (!table_ready) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        table_ready = true;
+    }
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void png_put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static bool png_write_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len)
+{
+    uint8_t hdr[8];
+    uint8_t tail[4];
+
+    png_put_be32(hdr, len);
+    memcpy(hdr + 4, type, 4);
+    png_put_be32(tail, png_crc(png_crc(0xFFFFFFFFu, hdr + 4, 4), data, len) ^ 0xFFFFFFFFu);
+    return fwrite(hdr, 1, 8, f) == 8 && fwrite(data, 1, len, f) == len && fwrite(tail, 1, 4, f) == 4;
+}
+
+esp_err_t lvgl_host_dump_png(const char *path)
+{
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    const uint32_t w = EXAMPLE_LCD_WIDTH;
+    const uint32_t h = EXAMPLE_LCD_HEIGHT;
+    const uint32_t raw_len = h * (1 + w * 3);
+    const uint32_t blocks = (raw_len + 65534) / 65535;
+    const uint32_t z_len = 2 + blocks * 5 + raw_len + 4;
+
+    if (!lvgl_host_fb) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint8_t *raw = malloc(raw_len);
+    uint8_t *z = malloc(z_len);
+    if (!raw || !z) {
+        free(raw);
+        free(z);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 每行：过滤类型 0 + RGB888
+    uint8_t *p = raw;
+    for (uint32_t y = 0; y < h; y++) {
+        *p++ = 0;
+        for (uint32_t x = 0; x < w; x++) {
+            uint16_t c = lvgl_host_fb[y * w + x];
+            uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+            *p++ = (uint8_t)((r << 3) | (r >> 2));
+            *p++ = (uint8_t)((g << 2) | (g >> 4));
+            *p++ = (uint8_t)((b << 3) | (b >> 2));
+        }
+    }
+
+    // zlib 流：不压缩的 deflate 块 + Adler-32
+    uint8_t *q = z;
+    uint32_t s1 = 1, s2 = 0;
+    *q++ = 0x78;
+    *q++ = 0x01;
+    for (uint32_t off = 0; off < raw_len; off += 65535) {
+        uint32_t n = raw_len - off < 65535 ? raw_len - off : 65535;
+        *q++ = (off + n >= raw_len) ? 1 : 0;
+        *q++ = (uint8_t)n;
+        *q++ = (uint8_t)(n >> 8);
+        *q++ = (uint8_t)~n;
+        *q++ = (uint8_t)(~n >> 8);
+        memcpy(q, raw + off, n);
+        q += n;
+    }
+    for (uint32_t i = 0; i < raw_len; i++) {
+        s1 = (s1 + raw[i]) % 65521;
+        s2 = (s2 + s1) % 65521;
+    }
+    png_put_be32(q, (s2 << 16) | s1);
+
+    uint8_t ihdr[13] = {0};
+    png_put_be32(ihdr, w);
+    png_put_be32(ihdr + 4, h);
+    ihdr[8] = 8;    // 位深
+    ihdr[9] = 2;    // 真彩色 RGB
+
+    esp_err_t ret = ESP_FAIL;
+    FILE *f = fopen(path, "wb");
+    if (f) {
+        if (fwrite(signature, 1, 8, f) == 8 &&
+            png_write_chunk(f, "IHDR", ihdr, sizeof(ihdr)) &&
+            png_write_chunk(f, "IDAT", z, z_len) &&
+            png_write_chunk(f, "IEND", NULL, 0)) {
+            ret = ESP_OK;
+        }
+        fclose(f);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write %s", path);
+    }
+
+    free(raw);
+    free(z);
+    return ret;
+}
+
+/*********************
+ * 回调函数实现
+ *********************/
+
+/* 区域内圆形裁剪后需要发送的字节数 */
+static uint32_t lvgl_host_masked_bytes(const lv_area_t *area)
+{
+    uint32_t bytes = 0;
+    int32_t x1, x2;
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        if (lvgl_area_row_span(y, area, &x1, &x2)) {
+            bytes += (uint32_t)(x2 - x1 + 1) * 2;
+        }
+    }
+    return bytes;
+}
+
+/* SPD2010区域对齐回调函数 - 与设备端同一实现，保持相同的刷新区域 */
+static void lvgl_rounder_cb(lv_event_t *e)
+{
+    lv_area_t *area = lv_event_get_param(e);
+
+    if (!lvgl_area_round(area)) {
+        lvgl_stats.mask_skipped_areas++;
+    }
+}
+
+#if LVGL_MERGE_AREAS && LVGL_HAVE_DISPLAY_PRIVATE
+/* 渲染开始前按传输开销合并失效区域（与设备端流水线刷新的分块一致） */
+static void lvgl_refr_start_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    uint32_t n = disp->inv_p;
+    uint32_t merged = lvgl_area_merge(disp->inv_areas, n, LVGL_FLUSH_PIPELINE ? LVGL_FLUSH_CHUNK_BYTES : 0);
+
+    if (merged != n) {
+        for (uint32_t i = 0; i < merged; i++) {
+            disp->inv_area_joined[i] = 0;
+        }
+        disp->inv_p = merged;
+    }
+    lvgl_stats.merge_areas_in_last = (uint16_t)n;
+    lvgl_stats.merge_areas_out_last = (uint16_t)merged;
+}
+#endif
+
+void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    int32_t width = lv_area_get_width(area);
+    int32_t height = lv_area_get_height(area);
+    int32_t stride = lvgl_render_direct ? EXAMPLE_LCD_WIDTH : width;    // 像素
+    const uint16_t *src = (const uint16_t *)px_map;
+    lvgl_tile_iter_t it;
+    lv_area_t part;
+    uint32_t txns = 0;
+    uint32_t transfer_us = 0;
+    uint32_t bytes = 0;
+
+    // 直接模式 px_map 是整屏帧缓冲，区域按屏幕坐标定位
+    if (lvgl_render_direct) {
+        src += (size_t)area->y1 * EXAMPLE_LCD_WIDTH + area->x1;
+    }
+
+    // 与设备端一致：只有内容变化的图块片段写入帧缓冲并计入传输
+    lvgl_tile_iter_init(&it, area, (const uint8_t *)src, stride * 2, &lvgl_frame_tiles);
+    while (1) {
+        int64_t hash_start_us = lvgl_host_time_us();
+        bool has_part = lvgl_tile_iter_next(&it, &part);
+        lvgl_frame_hash_us += (uint32_t)(lvgl_host_time_us() - hash_start_us);
+        if (!has_part) {
+            break;
+        }
+
+        // 与设备端一致只发送每行的可见跨度，圆外的帧缓冲保持为 0
+        uint32_t part_bytes = 0;
+        int32_t x1, x2;
+        for (int32_t y = part.y1; y <= part.y2; y++) {
+            if (!lvgl_area_row_span(y, &part, &x1, &x2)) {
+                continue;
+            }
+            memcpy(&lvgl_host_fb[(size_t)y * EXAMPLE_LCD_WIDTH + x1],
+                   src + (size_t)(y - area->y1) * stride + (x1 - area->x1), (size_t)(x2 - x1 + 1) * 2);
+            part_bytes += (uint32_t)(x2 - x1 + 1) * 2;
+        }
+
+        uint32_t part_txns;
+        transfer_us += lvgl_host_transfer_us(lv_area_get_width(&part), lv_area_get_height(&part), part_bytes,
+                                             &part_txns);
+        txns += part_txns;
+        bytes += part_bytes;
+    }
+
+    // 图块跳过节省的耗时：与整个区域（同样圆形裁剪）一次发送相比
+    uint32_t full_txns;
+    lvgl_host_stats.transfer_us_saved_total +=
+        (int64_t)lvgl_host_transfer_us(width, height, lvgl_host_masked_bytes(area), &full_txns) - transfer_us;
+
+    lvgl_flush_submit_count++;
+    lvgl_stats.flush_areas++;
+    lvgl_stats.flush_chunks += txns;
+    lvgl_stats.flush_area_us_last = transfer_us;
+    lvgl_stats.flush_area_us_avg = lvgl_stats.flush_area_us_avg ?
+        lvgl_stats.flush_area_us_avg - lvgl_stats.flush_area_us_avg / 8 + transfer_us / 8 : transfer_us;
+    lvgl_host_stats.flushes++;
+    lvgl_host_stats.bytes_total += bytes;
+    lvgl_host_stats.transfer_us_total += transfer_us;
+    lvgl_frame_bytes += bytes;
+    lvgl_frame_bytes_unmasked += (uint32_t)(width * height * 2);
+    lvgl_frame_txns += txns;
+    lvgl_frame_transfer_us += transfer_us;
+    lvgl_frame_areas++;
+    lvgl_frame_pixels += (uint32_t)(width * height);
+    lvgl_perf_add_flush_us(transfer_us);
+
+    if (lv_display_flush_is_last(disp)) {
+        lvgl_frame_count++;
+        lvgl_stats.flush_bytes_frame_last = lvgl_frame_bytes;
+        lvgl_stats.flush_bytes_unmasked_last = lvgl_frame_bytes_unmasked;
+        lvgl_stats.flush_txns_frame_last = lvgl_frame_txns;
+        lvgl_host_stats.frames++;
+        lvgl_host_stats.transfer_us_frame_last = lvgl_frame_transfer_us;
+        lvgl_host_stats.tile_hash_us_total += lvgl_frame_hash_us;
+        lvgl_stats.tiles_checked += lvgl_frame_tiles.checked;
+        lvgl_stats.tiles_skipped += lvgl_frame_tiles.skipped;
+        lvgl_stats.tile_bytes_skipped_last = lvgl_frame_tiles.skipped_pixels * 2;
+        lvgl_stats.tile_hash_us_last = lvgl_frame_hash_us;
+        lvgl_perf_frame_end(lvgl_frame_pixels, lvgl_frame_bytes, lvgl_frame_areas, lvgl_frame_txns);
+        lvgl_frame_bytes = 0;
+        lvgl_frame_bytes_unmasked = 0;
+        lvgl_frame_txns = 0;
+        lvgl_frame_transfer_us = 0;
+        lvgl_frame_areas = 0;
+        lvgl_frame_pixels = 0;
+        memset(&lvgl_frame_tiles, 0, sizeof(lvgl_frame_tiles));
+        lvgl_frame_hash_us = 0;
+
+        int64_t now_us = lvgl_host_time_us();
+        if (lvgl_last_frame_us) {
+            uint32_t interval_us = (uint32_t)(now_us - lvgl_last_frame_us);
+            lvgl_stats.frame_interval_us_last = interval_us;
+            lvgl_stats.frame_interval_us_avg = lvgl_stats.frame_interval_us_avg ?
+                lvgl_stats.frame_interval_us_avg - lvgl_stats.frame_interval_us_avg / 8 + interval_us / 8 :
+                interval_us;
+        }
+        lvgl_last_frame_us = now_us;
+
+        if (lvgl_input_press_us) {
+            uint32_t latency_us = (uint32_t)(now_us - lvgl_input_press_us);
+            lvgl_stats.input_latency_us_last = latency_us;
+            if (latency_us > lvgl_stats.input_latency_us_max) {
+                lvgl_stats.input_latency_us_max = latency_us;
+            }
+            lvgl_input_press_us = 0;
+        }
+
+        uint32_t every = lvgl_host_config.dump_every ? lvgl_host_config.dump_every : 1;
+        if (lvgl_host_config.dump_dir && lvgl_frame_count % every == 0) {
+            char path[256];
+            snprintf(path, sizeof(path), "%s/frame_%05u.png", lvgl_host_config.dump_dir,
+                     (unsigned)lvgl_frame_count);
+            if (lvgl_host_dump_png(path) == ESP_OK) {
+                lvgl_host_stats.dumped_frames++;
+            }
+        }
+    }
+
+    lv_display_flush_ready(disp);
+}
+
+void lvgl_touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    const lvgl_host_touch_event_t *cur = NULL;
+    uint32_t elapsed_ms = (uint32_t)((lvgl_host_time_us() - lvgl_touch_start_us) / 1000);
+
+    // 取最后一个已到时间的事件
+    for (size_t i = 0; i < lvgl_touch_event_count && lvgl_touch_events[i].at_ms <= elapsed_ms; i++) {
+        cur = &lvgl_touch_events[i];
+    }
+
+    if (cur && cur->pressed) {
+        data->point.x = cur->x;
+        data->point.y = cur->y;
+        data->state = LV_INDEV_STATE_PRESSED;
+        if (!lvgl_touch_pressed) {
+            lvgl_input_press_us = lvgl_host_time_us();
+        }
+        lvgl_touch_pressed = true;
+    } else {
+        data->state = LV_INDEV_STATE_RELEASED;
+        lvgl_touch_pressed = false;
+    }
+}
+
+/*********************
+ * 任务
+ *********************/
+
+static void lvgl_timer_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "LVGL host task started");
+
+    while (1) {
+        uint32_t wake = lvgl_wake_wait(lv_timer_handler(), &lvgl_stats);
+
+        if (wake & LVGL_WAKE_REQUEST) {
+            lv_lock();
+            lv_timer_t *refr_timer = lv_display_get_refr_timer(g_lvgl_display);
+            if (refr_timer) {
+                lv_timer_ready(refr_timer);
+            }
+            lv_unlock();
+        }
+    }
+}
+
+static void lvgl_cleanup_resources(void)
+{
+    if (lvgl_task_handle) {
+        vTaskDelete(lvgl_task_handle);
+        lvgl_task_handle = NULL;
+    }
+    if (g_lvgl_indev) {
+        lv_indev_delete(g_lvgl_indev);
+        g_lvgl_indev = NULL;
+    }
+    lvgl_perf_deinit();
+    if (g_lvgl_display) {
+        lv_display_delete(g_lvgl_display);
+        g_lvgl_display = NULL;
+    }
+    free(lvgl_draw_buf1);
+    free(lvgl_draw_buf2);
+    free(lvgl_host_fb);
+    lvgl_draw_buf1 = NULL;
+    lvgl_draw_buf2 = NULL;
+    lvgl_host_fb = NULL;
+    lvgl_render_direct = false;
+}
+
+/*********************
+ * 公共函数实现
+ *********************/
+
+void lvgl_host_set_config(const lvgl_host_config_t *config)
+{
+    if (config) {
+        lvgl_host_config = *config;
+    } else {
+        memset(&lvgl_host_config, 0, sizeof(lvgl_host_config));
+        lvgl_host_config.txn_overhead_us = LVGL_HOST_TXN_OVERHEAD_US;
+    }
+}
+
+void lvgl_host_touch_script(const lvgl_host_touch_event_t *events, size_t count)
+{
+    lvgl_touch_events = events;
+    lvgl_touch_event_count = events ? count : 0;
+    lvgl_touch_start_us = lvgl_host_time_us();
+}
+
+const uint16_t *lvgl_host_get_framebuffer(void)
+{
+    return lvgl_host_fb;
+}
+
+void lvgl_host_get_stats(lvgl_host_stats_t *stats)
+{
+    if (stats) {
+        *stats = lvgl_host_stats;
+    }
+}
+
+esp_err_t lvgl_driver_init(void)
+{
+    ESP_LOGI(TAG, "Initializing LVGL host backend (version %d.%d.%d)",
+             lv_version_major(), lv_version_minor(), lv_version_patch());
+
+    if (!lvgl_host_config.bus_bytes_per_sec && !lvgl_host_config.txn_overhead_us) {
+        lvgl_host_set_config(NULL);
+    }
+
+    lv_init();
+    lv_tick_set_cb(lvgl_tick_get_cb);
+
+    // 主机刷新只读取 px_map，直接模式不需要弹跳缓冲区
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    lv_display_render_mode_t render_mode = LVGL_RENDER_MODE;
+    size_t buffer_size = (render_mode == LV_DISPLAY_RENDER_MODE_DIRECT) ?
+                         (size_t)EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT * 2 : LVGL_BUFFER_SIZE * 2;
+    lvgl_draw_buf1 = malloc(buffer_size);
+    lvgl_draw_buf2 = malloc(buffer_size);
+    lvgl_host_fb = calloc((size_t)EXAMPLE_LCD_WIDTH * EXAMPLE_LCD_HEIGHT, sizeof(uint16_t));
+    if (!lvgl_draw_buf1 || !lvgl_draw_buf2 || !lvgl_host_fb) {
+        goto error;
+    }
+
+    ret = ESP_FAIL;
+    g_lvgl_display = lv_display_create(EXAMPLE_LCD_WIDTH, EXAMPLE_LCD_HEIGHT);
+    if (!g_lvgl_display) {
+        goto error;
+    }
+    lv_display_set_buffers(g_lvgl_display, lvgl_draw_buf1, lvgl_draw_buf2, buffer_size, render_mode);
+    lvgl_render_direct = (render_mode == LV_DISPLAY_RENDER_MODE_DIRECT);
+    lvgl_stats.draw_buf_bytes = (uint32_t)buffer_size * 2;
+    lvgl_stats.render_mode = (uint8_t)render_mode;
+    lv_display_set_color_format(g_lvgl_display, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_flush_cb(g_lvgl_display, lvgl_flush_cb);
+    lvgl_area_round_init();
+    lv_display_add_event_cb(g_lvgl_display, lvgl_rounder_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lvgl_tile_reset();
+    lvgl_perf_attach(g_lvgl_display);
+#if LVGL_MERGE_AREAS && LVGL_HAVE_DISPLAY_PRIVATE
+    lv_display_add_event_cb(g_lvgl_display, lvgl_refr_start_cb, LV_EVENT_REFR_START, NULL);
+#endif
+
+    g_lvgl_indev = lv_indev_create();
+    if (!g_lvgl_indev) {
+        goto error;
+    }
+    lv_indev_set_type(g_lvgl_indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(g_lvgl_indev, lvgl_touch_read_cb);
+
+    if (xTaskCreate(lvgl_timer_task, "lvgl_timer", LVGL_HOST_TASK_STACK_SIZE, NULL, 7,
+                    &lvgl_task_handle) != pdPASS) {
+        lvgl_task_handle = NULL;
+        goto error;
+    }
+
+    ESP_LOGI(TAG, "LVGL host backend initialized (%d x %d framebuffer, %s render mode, 2 x %u bytes draw buffers)",
+             EXAMPLE_LCD_WIDTH, EXAMPLE_LCD_HEIGHT, lvgl_render_direct ? "direct" : "partial", (unsigned)buffer_size);
+    return ESP_OK;
+
+error:
+    ESP_LOGE(TAG, "Failed to initialize LVGL host backend");
+    lvgl_cleanup_resources();
+    return ret;
+}
+
+uint32_t lvgl_driver_flush_fence(void)
+{
+    return lvgl_flush_submit_count;
+}
+
+esp_err_t lvgl_driver_flush_wait(uint32_t fence, uint32_t timeout_ms)
+{
+    // 刷新在回调内同步完成
+    (void)fence;
+    (void)timeout_ms;
+    return ESP_OK;
+}
+
+bool lvgl_driver_flush_done(uint32_t fence)
+{
+    // 刷新在回调内同步完成，提交数即完成数
+    return (int32_t)(lvgl_flush_submit_count - fence) >= 0;
+}
+
+uint32_t lvgl_driver_get_frame_count(void)
+{
+    return lvgl_frame_count;
+}
+
+void lvgl_driver_wake(void)
+{
+    if (lvgl_task_handle) {
+        xTaskNotify(lvgl_task_handle, LVGL_WAKE_REQUEST, eSetBits);
+    }
+}
+
+uint32_t lvgl_driver_get_frame_interval_us(void)
+{
+    return lvgl_stats.frame_interval_us_avg;
+}
+
+void lvgl_driver_get_stats(lvgl_driver_stats_t *stats)
+{
+    if (stats) {
+        *stats = lvgl_stats;
+    }
+}
+
+void lvgl_driver_deinit(void)
+{
+    ESP_LOGI(TAG, "Deinitializing LVGL host backend");
+    lvgl_cleanup_resources();
+}
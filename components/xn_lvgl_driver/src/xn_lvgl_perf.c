@@ -0,0 +1,305 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-06 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-06 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_perf.c
+ * @Description: 帧计时环形缓冲区与性能浮层
+ *
+ * 渲染耗时由 LVGL 显示事件测量：RENDER_START 到 RENDER_READY，扣除刷新回调
+ * （FLUSH_START~FLUSH_FINISH）与等待刷新完成（FLUSH_WAIT_START~FLUSH_WAIT_FINISH）的时间。
+ * 一帧最后一个区域提交后记录像素、字节与帧间隔，等该区域发送完成（下一次 FLUSH_START，
+ * 或 REFR_START 时刷新栅栏已到达）再补上刷新耗时并写入环形缓冲区。
+ * 环形缓冲区只由 LVGL 任务写入，读者复制后丢弃复制期间可能被覆盖的记录，不需要加锁。
+ */
+
+#include "xn_lvgl_perf.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#endif
+
+#define LVGL_PERF_RING_MASK (LVGL_PERF_RING_SIZE - 1)
+
+_Static_assert((LVGL_PERF_RING_SIZE & LVGL_PERF_RING_MASK) == 0, "LVGL_PERF_RING_SIZE must be a power of 2");
+
+typedef enum {
+    LVGL_PERF_IDLE = 0,
+    LVGL_PERF_WAIT_RENDER,      // 最后一个区域已提交，等待 RENDER_READY
+    LVGL_PERF_WAIT_FLUSH,       // 渲染完成，等待最后一个区域发送完成
+} lvgl_perf_state_t;
+
+volatile uint32_t lvgl_perf_frame_flush_us = 0;
+
+static lvgl_frame_record_t s_ring[LVGL_PERF_RING_SIZE];
+static uint32_t s_ring_head = 0;            // 已写入的记录总数（原子读写）
+
+static lvgl_frame_record_t s_pending;
+static lvgl_perf_state_t s_state = LVGL_PERF_IDLE;
+static int64_t s_render_start_us = 0;
+static int64_t s_excluded_us = 0;
+static int64_t s_flush_cb_start_us = 0;
+static int64_t s_flush_wait_start_us = 0;
+static int64_t s_last_frame_end_us = 0;
+
+static lv_obj_t *s_overlay = NULL;
+static lv_timer_t *s_overlay_timer = NULL;
+
+static int64_t lvgl_perf_now_us(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+    return esp_timer_get_time();
+#endif
+}
+
+static void lvgl_perf_push(const lvgl_frame_record_t *rec)
+{
+    uint32_t head = __atomic_load_n(&s_ring_head, __ATOMIC_RELAXED);
+    s_ring[head & LVGL_PERF_RING_MASK] = *rec;
+    __atomic_store_n(&s_ring_head, head + 1, __ATOMIC_RELEASE);
+}
+
+/* 上一帧最后一个区域已发送完成时补上刷新耗时并写入 */
+static void lvgl_perf_commit(void)
+{
+    s_pending.flush_us = lvgl_perf_frame_flush_us;
+    lvgl_perf_frame_flush_us = 0;
+    lvgl_perf_push(&s_pending);
+    s_state = LVGL_PERF_IDLE;
+}
+
+static void lvgl_perf_event_cb(lv_event_t *e)
+{
+    int64_t now = lvgl_perf_now_us();
+
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_REFR_START:
+        if (s_state == LVGL_PERF_WAIT_FLUSH &&
+            lvgl_driver_flush_done(lvgl_driver_flush_fence())) {
+            lvgl_perf_commit();
+        }
+        break;
+    case LV_EVENT_RENDER_START:
+        s_render_start_us = now;
+        s_excluded_us = 0;
+        break;
+    case LV_EVENT_FLUSH_START:
+        // 双缓冲时 LVGL 等上一块发送完成后才开始下一次刷新
+        if (s_state == LVGL_PERF_WAIT_FLUSH) {
+            lvgl_perf_commit();
+        }
+        s_flush_cb_start_us = now;
+        break;
+    case LV_EVENT_FLUSH_FINISH:
+        s_excluded_us += now - s_flush_cb_start_us;
+        break;
+    case LV_EVENT_FLUSH_WAIT_START:
+        s_flush_wait_start_us = now;
+        break;
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+        s_excluded_us += now - s_flush_wait_start_us;
+        break;
+    case LV_EVENT_RENDER_READY:
+        if (s_state == LVGL_PERF_WAIT_RENDER) {
+            int64_t render_us = now - s_render_start_us - s_excluded_us;
+            s_pending.render_us = render_us > 0 ? (uint32_t)render_us : 0;
+            s_state = LVGL_PERF_WAIT_FLUSH;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void lvgl_perf_attach(lv_display_t *disp)
+{
+    lv_display_add_event_cb(disp, lvgl_perf_event_cb, LV_EVENT_ALL, NULL);
+}
+
+void lvgl_perf_frame_end(uint32_t pixels, uint32_t bytes, uint32_t areas, uint32_t txns)
+{
+    int64_t now = lvgl_perf_now_us();
+
+    // 上一帧的刷新完成事件还没等到（例如区域刷新失败），直接写入
+    if (s_state != LVGL_PERF_IDLE) {
+        lvgl_perf_commit();
+    }
+
+    memset(&s_pending, 0, sizeof(s_pending));
+    s_pending.frame = lvgl_driver_get_frame_count();
+    s_pending.interval_us = s_last_frame_end_us ? (uint32_t)(now - s_last_frame_end_us) : 0;
+    s_pending.pixels = pixels;
+    s_pending.bytes = bytes;
+    s_pending.areas = (uint16_t)LV_MIN(areas, 0xFFFFu);
+    s_pending.txns = (uint16_t)LV_MIN(txns, 0xFFFFu);
+    s_last_frame_end_us = now;
+    s_state = LVGL_PERF_WAIT_RENDER;
+}
+
+uint32_t lvgl_driver_get_frame_records(lvgl_frame_record_t *out, uint32_t max)
+{
+    if (!out || max == 0) {
+        return 0;
+    }
+
+    uint32_t head = __atomic_load_n(&s_ring_head, __ATOMIC_ACQUIRE);
+    uint32_t n = LV_MIN(max, LV_MIN(head, (uint32_t)LVGL_PERF_RING_SIZE));
+    uint32_t start = head - n;
+
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = s_ring[(start + i) & LVGL_PERF_RING_MASK];
+    }
+
+    // 复制期间写者可能已覆盖最旧的记录（包括正在写入的槽位），丢弃这些记录
+    uint32_t head2 = __atomic_load_n(&s_ring_head, __ATOMIC_ACQUIRE);
+    uint32_t valid_from = head2 + 1 - LVGL_PERF_RING_SIZE;
+    if ((int32_t)(valid_from - start) > 0) {
+        uint32_t drop = valid_from - start;
+        if (drop >= n) {
+            return 0;
+        }
+        memmove(out, out + drop, (n - drop) * sizeof(*out));
+        n -= drop;
+    }
+    return n;
+}
+
+void lvgl_driver_get_frame_timing(lvgl_frame_timing_t *timing)
+{
+    if (!timing) {
+        return;
+    }
+    memset(timing, 0, sizeof(*timing));
+
+    lvgl_frame_record_t *recs = malloc(sizeof(lvgl_frame_record_t) * LVGL_PERF_RING_SIZE);
+    if (!recs) {
+        return;
+    }
+    uint32_t n = lvgl_driver_get_frame_records(recs, LVGL_PERF_RING_SIZE);
+
+    uint32_t intervals[LVGL_PERF_RING_SIZE];
+    uint32_t k = 0;
+    uint64_t sum_interval = 0, sum_render = 0, sum_flush = 0, sum_bytes = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const lvgl_frame_record_t *r = &recs[i];
+        sum_render += r->render_us;
+        sum_flush += r->flush_us;
+        timing->render_us_max = LV_MAX(timing->render_us_max, r->render_us);
+        timing->flush_us_max = LV_MAX(timing->flush_us_max, r->flush_us);
+
+        // 第一帧没有间隔，不计入帧率与吞吐
+        if (r->interval_us == 0) {
+            continue;
+        }
+        sum_interval += r->interval_us;
+        sum_bytes += r->bytes;
+
+        // 插入排序（最多 LVGL_PERF_RING_SIZE 个）
+        uint32_t j = k++;
+        while (j > 0 && intervals[j - 1] > r->interval_us) {
+            intervals[j] = intervals[j - 1];
+            j--;
+        }
+        intervals[j] = r->interval_us;
+    }
+    free(recs);
+
+    timing->frames = n;
+    if (n) {
+        timing->render_us_avg = (uint32_t)(sum_render / n);
+        timing->flush_us_avg = (uint32_t)(sum_flush / n);
+    }
+    if (k) {
+        timing->interval_us_p50 = intervals[(k - 1) * 50 / 100];
+        timing->interval_us_p90 = intervals[(k - 1) * 90 / 100];
+        timing->interval_us_p99 = intervals[(k - 1) * 99 / 100];
+        timing->fps_x10 = (uint32_t)((uint64_t)k * 10000000 / sum_interval);
+        timing->bytes_per_sec = (uint32_t)(sum_bytes * 1000000 / sum_interval);
+        timing->render_load_pct = (uint8_t)LV_MIN(100u, (uint32_t)(sum_render * 100 / sum_interval));
+    }
+}
+
+/*********************
+ * 性能浮层
+ *********************/
+
+static void lvgl_perf_overlay_update(lv_timer_t *timer)
+{
+    (void)timer;
+    lvgl_frame_timing_t t;
+    lvgl_driver_get_frame_timing(&t);
+
+#if CONFIG_IDF_TARGET_LINUX
+    lv_label_set_text_fmt(s_overlay, "FPS %u.%u  render %u%%\nPSRAM -",
+                          (unsigned)(t.fps_x10 / 10), (unsigned)(t.fps_x10 % 10), (unsigned)t.render_load_pct);
+#else
+    size_t psram_block = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    lv_label_set_text_fmt(s_overlay, "FPS %u.%u  render %u%%\nPSRAM %uK",
+                          (unsigned)(t.fps_x10 / 10), (unsigned)(t.fps_x10 % 10), (unsigned)t.render_load_pct,
+                          (unsigned)(psram_block / 1024));
+#endif
+}
+
+esp_err_t lvgl_driver_overlay_show(bool show)
+{
+    if (!g_lvgl_display) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = ESP_OK;
+    lv_lock();
+    if (show && !s_overlay) {
+        // 圆形屏：放在底部中间，离边缘留出距离保证可见
+        s_overlay = lv_label_create(lv_layer_top());
+        s_overlay_timer = s_overlay ? lv_timer_create(lvgl_perf_overlay_update, LVGL_PERF_OVERLAY_PERIOD_MS, NULL) : NULL;
+        if (!s_overlay_timer) {
+            if (s_overlay) {
+                lv_obj_delete(s_overlay);
+                s_overlay = NULL;
+            }
+            ret = ESP_ERR_NO_MEM;
+        } else {
+            lv_obj_set_style_bg_color(s_overlay, lv_color_black(), 0);
+            lv_obj_set_style_bg_opa(s_overlay, LV_OPA_60, 0);
+            lv_obj_set_style_text_color(s_overlay, lv_color_white(), 0);
+            lv_obj_set_style_text_align(s_overlay, LV_TEXT_ALIGN_CENTER, 0);
+            lv_obj_set_style_pad_all(s_overlay, 4, 0);
+            lv_obj_set_style_radius(s_overlay, 4, 0);
+            lv_obj_align(s_overlay, LV_ALIGN_BOTTOM_MID, 0, -48);
+            lvgl_perf_overlay_update(s_overlay_timer);
+        }
+    } else if (!show && s_overlay) {
+        lvgl_perf_deinit();
+    }
+    lv_unlock();
+
+    lvgl_driver_wake();
+    return ret;
+}
+
+bool lvgl_driver_overlay_is_shown(void)
+{
+    return s_overlay != NULL;
+}
+
+void lvgl_perf_deinit(void)
+{
+    if (s_overlay_timer) {
+        lv_timer_delete(s_overlay_timer);
+        s_overlay_timer = NULL;
+    }
+    if (s_overlay) {
+        lv_obj_delete(s_overlay);
+        s_overlay = NULL;
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-06 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-06 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_perf.h
+ * @Description: 帧计时与性能浮层（驱动内部接口，设备端与主机后端共用）
+ */
+
+#pragma once
+
+#include "xn_lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 当前帧已完成区域的刷新耗时之和（刷新完成回调中累加，可在中断上下文调用）
+extern volatile uint32_t lvgl_perf_frame_flush_us;
+
+static inline void lvgl_perf_add_flush_us(uint32_t us)
+{
+    lvgl_perf_frame_flush_us += us;
+}
+
+/**
+ * @brief 注册渲染计时事件（显示对象创建后调用）
+ */
+void lvgl_perf_attach(lv_display_t *disp);
+
+/**
+ * @brief 一帧的最后一个区域已提交（刷新回调中调用）
+ * @param pixels 本帧刷新区域像素数
+ * @param bytes 本帧发送字节数
+ * @param areas 本帧刷新区域数
+ * @param txns 本帧传输次数
+ */
+void lvgl_perf_frame_end(uint32_t pixels, uint32_t bytes, uint32_t areas, uint32_t txns);
+
+/**
+ * @brief 删除性能浮层（LVGL 任务停止后、删除显示对象前调用）
+ */
+void lvgl_perf_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,174 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-05 10:20:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-05 10:20:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_pixel.c
+ * @Description: 像素处理内核实现
+ *
+ * 以 32 位字为单位处理：交换字节序一次两个像素，转换时两个 RGB565 合并成一次 32 位写，
+ * 混合时把 RGB565 展开成 0x07E0F81F 布局，一次乘法同时完成三个通道。
+ * Xtensa 不支持非对齐 32 位访问，源与目标对齐方式不一致时退回逐像素处理。
+ */
+
+#include "xn_lvgl_pixel.h"
+#include <stddef.h>
+
+// 允许与 uint16_t 指针别名的 32 位类型
+typedef uint32_t __attribute__((may_alias)) lvgl_pixel_u32_t;
+
+// 4x4 Bayer 阈值矩阵（0~15）
+static const uint8_t s_bayer4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5},
+};
+
+static inline uint16_t swap16(uint16_t v)
+{
+    return (uint16_t)((v << 8) | (v >> 8));
+}
+
+static inline uint32_t swap16x2(uint32_t v)
+{
+    return ((v & 0x00FF00FFu) << 8) | ((v >> 8) & 0x00FF00FFu);
+}
+
+static inline uint16_t argb_to_rgb565(uint32_t p)
+{
+    return (uint16_t)(((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F));
+}
+
+// RGB565 展开为 00000GGG GGG00000 RRRRR000 000BBBBB，通道间留出 5 位乘法余量
+static inline uint32_t rgb565_expand(uint32_t c)
+{
+    return (c | (c << 16)) & 0x07E0F81Fu;
+}
+
+static inline uint16_t rgb565_pack(uint32_t e)
+{
+    return (uint16_t)((e & 0xF81Fu) | ((e >> 16) & 0x07E0u));
+}
+
+void lvgl_pixel_rgb565_swap(uint16_t *dst, const uint16_t *src, uint32_t count)
+{
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 3) != 0) {
+        for (uint32_t i = 0; i < count; i++) {
+            dst[i] = swap16(src[i]);
+        }
+        return;
+    }
+
+    if (((uintptr_t)src & 3) && count) {
+        *dst++ = swap16(*src++);
+        count--;
+    }
+
+    const lvgl_pixel_u32_t *s32 = (const lvgl_pixel_u32_t *)src;
+    lvgl_pixel_u32_t *d32 = (lvgl_pixel_u32_t *)dst;
+    uint32_t words = count / 2;
+    uint32_t i = 0;
+
+    // 一次 4 个字（8 个像素），先全部读出再写回，原地交换也安全
+    for (; i + 4 <= words; i += 4) {
+        uint32_t a = s32[i], b = s32[i + 1], c = s32[i + 2], d = s32[i + 3];
+        d32[i] = swap16x2(a);
+        d32[i + 1] = swap16x2(b);
+        d32[i + 2] = swap16x2(c);
+        d32[i + 3] = swap16x2(d);
+    }
+    for (; i < words; i++) {
+        d32[i] = swap16x2(s32[i]);
+    }
+    if (count & 1) {
+        dst[count - 1] = swap16(src[count - 1]);
+    }
+}
+
+void lvgl_pixel_argb8888_to_rgb565(uint16_t *dst, const uint32_t *src, uint32_t count)
+{
+    uint32_t i = 0;
+
+    if (((uintptr_t)dst & 3) && count) {
+        dst[0] = argb_to_rgb565(src[0]);
+        i = 1;
+    }
+    for (; i + 2 <= count; i += 2) {
+        *(lvgl_pixel_u32_t *)&dst[i] = argb_to_rgb565(src[i]) | ((uint32_t)argb_to_rgb565(src[i + 1]) << 16);
+    }
+    if (i < count) {
+        dst[i] = argb_to_rgb565(src[i]);
+    }
+}
+
+static inline uint16_t argb_to_rgb565_dither(uint32_t p, uint32_t t)
+{
+    // 5 位通道量化步长 8，阈值 0~7；6 位通道步长 4，阈值 0~3
+    uint32_t r = ((p >> 16) & 0xFF) + (t >> 1);
+    uint32_t g = ((p >> 8) & 0xFF) + (t >> 2);
+    uint32_t b = (p & 0xFF) + (t >> 1);
+
+    r = r > 0xFF ? 0xFF : r;
+    g = g > 0xFF ? 0xFF : g;
+    b = b > 0xFF ? 0xFF : b;
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+void lvgl_pixel_argb8888_to_rgb565_dither(uint16_t *dst, const uint32_t *src, uint32_t width, uint32_t height)
+{
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = s_bayer4[y & 3];
+        for (uint32_t x = 0; x < width; x++) {
+            dst[x] = argb_to_rgb565_dither(src[x], row[x & 3]);
+        }
+        dst += width;
+        src += width;
+    }
+}
+
+void lvgl_pixel_argb8888_blend_rgb565(uint16_t *dst, const uint32_t *src, uint32_t count, uint8_t opa)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t p = src[i];
+        uint32_t a = p >> 24;
+
+        if (opa < 0xFF) {
+            // a * opa / 255 四舍五入（>> 8 会整体偏暗，再叠加 5 位量化误差会超过 1 个最低位）
+            a = a * opa + 128;
+            a = (a + (a >> 8)) >> 8;
+        }
+        a = (a + 4) >> 3;
+        if (a == 0) {
+            continue;
+        }
+
+        uint16_t s = argb_to_rgb565(p);
+        if (a >= 32) {
+            dst[i] = s;
+            continue;
+        }
+
+        // 每个通道加 16 四舍五入，最大值仍在各自的位段内
+        uint32_t e = (rgb565_expand(s) * a + rgb565_expand(dst[i]) * (32 - a) + 0x02008010u) >> 5;
+        dst[i] = rgb565_pack(e & 0x07E0F81Fu);
+    }
+}
+
+bool lvgl_pixel_blend_image_argb8888_to_rgb565(void *dst, int32_t dst_stride, const void *src, int32_t src_stride,
+                                               int32_t width, int32_t height, uint8_t opa)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (((uintptr_t)s & 3) || (src_stride & 3)) {
+        return false;
+    }
+
+    for (int32_t y = 0; y < height; y++) {
+        lvgl_pixel_argb8888_blend_rgb565((uint16_t *)d, (const uint32_t *)s, (uint32_t)width, opa);
+        d += dst_stride;
+        s += src_stride;
+    }
+    return true;
+}
@@ -0,0 +1,195 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-07 09:30:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-07 09:30:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_tile.c
+ * @Description: 图块哈希跳过
+ *
+ * 哈希按 32 位字（两个像素）做 FNV-1a：每一步对当前状态都是双射，只改动一个字时哈希必然不同，
+ * 多处改动误判为相同的概率约 2^-32。0 保留为“未知”，计算结果为 0 时记为 1。
+ */
+
+#include "xn_lvgl_tile.h"
+#include <string.h>
+
+#define LVGL_TILE_HASH_INVALID  0u
+
+_Static_assert(LVGL_TILE_SIZE % 4 == 0, "LVGL_TILE_SIZE must keep the SPD2010 4-pixel alignment");
+_Static_assert(LVGL_TILE_COLS <= 32, "tile columns must fit in a 32-bit mask");
+
+#if LVGL_TILE_SKIP
+// 每个图块上次发送内容的哈希（内部 RAM）
+static uint32_t s_tile_hash[LVGL_TILE_ROWS * LVGL_TILE_COLS];
+
+static uint32_t lvgl_tile_hash(const uint8_t *src, int32_t stride, int32_t width, int32_t rows)
+{
+    uint32_t hash = 0x811C9DC5u;
+
+    for (int32_t r = 0; r < rows; r++) {
+        const uint32_t *p = (const uint32_t *)(src + (size_t)r * stride);
+        for (int32_t i = 0; i < width / 2; i++) {
+            hash = (hash ^ p[i]) * 0x01000193u;
+        }
+    }
+    return hash != LVGL_TILE_HASH_INVALID ? hash : 1u;
+}
+#endif
+
+/* 区域所跨图块列全部置位的掩码 */
+static inline uint32_t lvgl_tile_all_mask(const lv_area_t *area)
+{
+    int32_t cols = area->x2 / LVGL_TILE_SIZE - area->x1 / LVGL_TILE_SIZE + 1;
+    return cols >= 32 ? UINT32_MAX : (1u << cols) - 1;
+}
+
+/* 扫描区域从第 y 行（相对区域）起的一个图块行，返回需要发送的图块列，rows 输出行数
+ * 只部分覆盖的图块无法比较，总是发送并清除其哈希 */
+static uint32_t lvgl_tile_scan(lvgl_tile_iter_t *it, int32_t y, int32_t *rows)
+{
+    const lv_area_t *area = it->area;
+
+#if LVGL_TILE_SKIP
+    int32_t sy = area->y1 + y;
+    int32_t ty1 = sy / LVGL_TILE_SIZE * LVGL_TILE_SIZE;
+    int32_t ty2 = LV_MIN(ty1 + LVGL_TILE_SIZE, EXAMPLE_LCD_HEIGHT) - 1;
+    int32_t y2 = LV_MIN(area->y2, ty2);
+    bool full_rows = (sy == ty1 && y2 == ty2);
+    int32_t first = area->x1 / LVGL_TILE_SIZE;
+    int32_t last = area->x2 / LVGL_TILE_SIZE;
+    uint32_t *hashes = &s_tile_hash[(ty1 / LVGL_TILE_SIZE) * LVGL_TILE_COLS];
+    uint32_t dirty = 0;
+
+    *rows = y2 - sy + 1;
+    for (int32_t c = first; c <= last; c++) {
+        int32_t tx1 = c * LVGL_TILE_SIZE;
+        int32_t tx2 = LV_MIN(tx1 + LVGL_TILE_SIZE, EXAMPLE_LCD_WIDTH) - 1;
+        uint32_t bit = 1u << (c - first);
+
+        if (!full_rows || tx1 < area->x1 || tx2 > area->x2) {
+            hashes[c] = LVGL_TILE_HASH_INVALID;
+            dirty |= bit;
+            continue;
+        }
+
+        const uint8_t *src = it->px_map + (size_t)y * it->stride + (size_t)(tx1 - area->x1) * 2;
+        uint32_t hash = lvgl_tile_hash(src, it->stride, tx2 - tx1 + 1, *rows);
+        it->cnt->checked++;
+        if (hash == hashes[c]) {
+            it->cnt->skipped++;
+            it->cnt->skipped_pixels += (uint32_t)((tx2 - tx1 + 1) * *rows);
+        } else {
+            hashes[c] = hash;
+            dirty |= bit;
+        }
+    }
+    return dirty;
+#else
+    *rows = lv_area_get_height(area) - y;
+    return lvgl_tile_all_mask(area);
+#endif
+}
+
+void lvgl_tile_reset(void)
+{
+#if LVGL_TILE_SKIP
+    memset(s_tile_hash, 0, sizeof(s_tile_hash));
+#endif
+}
+
+void lvgl_tile_invalidate(const lv_area_t *area)
+{
+#if LVGL_TILE_SKIP
+    int32_t c1 = LV_MAX(area->x1, 0) / LVGL_TILE_SIZE;
+    int32_t c2 = LV_MIN(area->x2, EXAMPLE_LCD_WIDTH - 1) / LVGL_TILE_SIZE;
+    int32_t r1 = LV_MAX(area->y1, 0) / LVGL_TILE_SIZE;
+    int32_t r2 = LV_MIN(area->y2, EXAMPLE_LCD_HEIGHT - 1) / LVGL_TILE_SIZE;
+
+    for (int32_t r = r1; r <= r2; r++) {
+        for (int32_t c = c1; c <= c2; c++) {
+            s_tile_hash[r * LVGL_TILE_COLS + c] = LVGL_TILE_HASH_INVALID;
+        }
+    }
+#else
+    (void)area;
+#endif
+}
+
+void lvgl_tile_align(lv_area_t *area)
+{
+#if LVGL_TILE_SKIP
+    area->x1 = area->x1 / LVGL_TILE_SIZE * LVGL_TILE_SIZE;
+    area->y1 = area->y1 / LVGL_TILE_SIZE * LVGL_TILE_SIZE;
+    area->x2 = LV_MIN(area->x2 / LVGL_TILE_SIZE * LVGL_TILE_SIZE + LVGL_TILE_SIZE - 1, EXAMPLE_LCD_WIDTH - 1);
+    area->y2 = LV_MIN(area->y2 / LVGL_TILE_SIZE * LVGL_TILE_SIZE + LVGL_TILE_SIZE - 1, EXAMPLE_LCD_HEIGHT - 1);
+#else
+    (void)area;
+#endif
+}
+
+void lvgl_tile_iter_init(lvgl_tile_iter_t *it, const lv_area_t *area, const uint8_t *px_map, int32_t stride,
+                         lvgl_tile_counters_t *cnt)
+{
+    memset(it, 0, sizeof(*it));
+    it->area = area;
+    it->px_map = px_map;
+    it->stride = stride;
+    it->cnt = cnt;
+}
+
+bool lvgl_tile_iter_next(lvgl_tile_iter_t *it, lv_area_t *part)
+{
+    int32_t height = lv_area_get_height(it->area);
+    uint32_t all = lvgl_tile_all_mask(it->area);
+
+    while (1) {
+        // 当前图块行的下一段连续变化图块
+        if (it->col < 32 && (it->dirty >> it->col)) {
+            while (!(it->dirty & (1u << it->col))) {
+                it->col++;
+            }
+            int32_t start = it->col;
+            while (it->col < 32 && (it->dirty & (1u << it->col))) {
+                it->col++;
+            }
+            int32_t first = it->area->x1 / LVGL_TILE_SIZE;
+            part->x1 = LV_MAX(it->area->x1, (first + start) * LVGL_TILE_SIZE);
+            part->x2 = LV_MIN(it->area->x2, (first + it->col) * LVGL_TILE_SIZE - 1);
+            part->y1 = it->area->y1 + it->row_y;
+            part->y2 = part->y1 + it->row_h - 1;
+            return true;
+        }
+
+        // 取下一图块行
+        if (it->pending) {
+            it->row_y = it->pending_y;
+            it->row_h = it->pending_h;
+            it->dirty = it->pending_dirty;
+            it->pending = false;
+        } else {
+            if (it->next_y >= height) {
+                return false;
+            }
+            it->row_y = it->next_y;
+            it->dirty = lvgl_tile_scan(it, it->next_y, &it->row_h);
+            it->next_y += it->row_h;
+        }
+        it->col = 0;
+
+        // 全部变化的相邻图块行合成一段，避免按图块行拆开传输
+        while (it->dirty == all && it->next_y < height) {
+            int32_t rows;
+            uint32_t dirty = lvgl_tile_scan(it, it->next_y, &rows);
+            if (dirty != all) {
+                it->pending = true;
+                it->pending_y = it->next_y;
+                it->pending_h = rows;
+                it->pending_dirty = dirty;
+                it->next_y += rows;
+                break;
+            }
+            it->row_h += rows;
+            it->next_y += rows;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-07 09:30:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-07 09:30:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_tile.h
+ * @Description: 图块哈希跳过（驱动内部接口，设备端与主机后端共用）
+ *
+ * 屏幕按 LVGL_TILE_SIZE 划分图块，记录每个图块上次发送内容的 32 位哈希。刷新时逐个图块行
+ * 计算哈希，内容未变的图块不再发送，其余图块按列连成片段；全部变化的相邻图块行合成一个片段。
+ */
+
+#pragma once
+
+#include "xn_lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LVGL_TILE_COLS  ((EXAMPLE_LCD_WIDTH + LVGL_TILE_SIZE - 1) / LVGL_TILE_SIZE)
+#define LVGL_TILE_ROWS  ((EXAMPLE_LCD_HEIGHT + LVGL_TILE_SIZE - 1) / LVGL_TILE_SIZE)
+
+/** 图块比较计数（按帧累计） */
+typedef struct {
+    uint32_t checked;           // 比较了哈希的图块数
+    uint32_t skipped;           // 内容未变、跳过的图块数
+    uint32_t skipped_pixels;    // 跳过的像素数（按矩形计，不扣除圆形裁剪）
+} lvgl_tile_counters_t;
+
+/** 区域片段迭代器 */
+typedef struct {
+    const lv_area_t *area;
+    const uint8_t *px_map;      // 区域首个像素
+    int32_t stride;             // 行跨度（字节）
+    lvgl_tile_counters_t *cnt;
+    int32_t next_y;             // 下一个待扫描的行（相对区域）
+    int32_t row_y;              // 当前图块行起始行与行数（相对区域）
+    int32_t row_h;
+    uint32_t dirty;             // 当前图块行中需要发送的图块列（相对区域首列）
+    int32_t col;                // 下一个待检查的图块列
+    bool pending;               // 已扫描、尚未输出的下一图块行
+    int32_t pending_y;
+    int32_t pending_h;
+    uint32_t pending_dirty;
+} lvgl_tile_iter_t;
+
+/**
+ * @brief 清除全部图块哈希（面板内容未知时调用，之后每个图块都会发送一次）
+ */
+void lvgl_tile_reset(void);
+
+/**
+ * @brief 清除与区域重叠的图块哈希（区域未经图块比较直接发送或发送失败时调用）
+ */
+void lvgl_tile_invalidate(const lv_area_t *area);
+
+/**
+ * @brief 区域扩展到图块边界（对齐回调中调用），只有完整覆盖的图块才能比较哈希
+ */
+void lvgl_tile_align(lv_area_t *area);
+
+/**
+ * @brief 开始遍历刷新区域中需要发送的片段
+ * @param it 迭代器
+ * @param area 刷新区域
+ * @param px_map 区域首个像素（RGB565，交换字节序之前）
+ * @param stride 行跨度（字节），局部渲染为区域宽度，直接渲染为屏幕宽度
+ * @param cnt 比较计数，累加到其中
+ */
+void lvgl_tile_iter_init(lvgl_tile_iter_t *it, const lv_area_t *area, const uint8_t *px_map, int32_t stride,
+                         lvgl_tile_counters_t *cnt);
+
+/**
+ * @brief 取下一个需要发送的片段，同时更新所经图块的哈希
+ * @param it 迭代器
+ * @param part 输出片段（屏幕坐标，在区域内）
+ * @return false 没有剩余片段
+ */
+bool lvgl_tile_iter_next(lvgl_tile_iter_t *it, lv_area_t *part);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,42 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_wake.c
+ * @Description: LVGL 任务的睡眠与唤醒
+ */
+
+#include "xn_lvgl_wake.h"
+
+// 毫秒转为至少 1 个节拍，避免节拍不足 1 时忙等
+static TickType_t lvgl_ms_to_ticks(uint32_t ms)
+{
+    TickType_t ticks = (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    return ticks ? ticks : 1;
+}
+
+uint32_t lvgl_wake_wait(uint32_t delay_ms, lvgl_driver_stats_t *stats)
+{
+    // 睡眠到下一个截止时间；没有就绪定时器时只靠通知唤醒
+    if (delay_ms == LV_NO_TIMER_READY || delay_ms > LVGL_TASK_MAX_SLEEP_MS) {
+        delay_ms = LVGL_TASK_MAX_SLEEP_MS;
+    }
+
+    uint32_t wake = 0;
+    if (xTaskNotifyWait(0, UINT32_MAX, &wake, lvgl_ms_to_ticks(delay_ms)) != pdTRUE) {
+        stats->wake_timeout++;
+        return 0;
+    }
+
+    if (wake & LVGL_WAKE_FLUSH) {
+        stats->wake_flush++;
+    }
+    if (wake & LVGL_WAKE_TOUCH) {
+        stats->wake_touch++;
+    }
+    if (wake & LVGL_WAKE_REQUEST) {
+        stats->wake_request++;
+    }
+    return wake;
+}
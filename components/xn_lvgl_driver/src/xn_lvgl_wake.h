@@ -0,0 +1,33 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\components\xn_lvgl_driver\src\xn_lvgl_wake.h
+ * @Description: LVGL 任务的睡眠与唤醒（驱动内部接口，设备端与主机后端共用）
+ *
+ * LVGL 任务睡眠到 lv_timer_handler() 返回的截止时间，刷新完成、触摸中断或 lvgl_driver_wake()
+ * 用任务通知位（LVGL_WAKE_*）提前唤醒。这里只负责等待与唤醒统计，收到通知后读取输入、让刷新
+ * 定时器就绪由各后端在 LVGL 锁内处理。
+ */
+
+#pragma once
+
+#include "xn_lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 等待下一个截止时间或唤醒通知（LVGL 任务上下文），并计入唤醒统计
+ * @param delay_ms lv_timer_handler() 的返回值，LV_NO_TIMER_READY 或超过 LVGL_TASK_MAX_SLEEP_MS 时
+ *                 按 LVGL_TASK_MAX_SLEEP_MS 睡眠
+ * @param stats 累加 wake_* 计数
+ * @return 收到的唤醒位（LVGL_WAKE_*），0 表示睡到了截止时间
+ */
+uint32_t lvgl_wake_wait(uint32_t delay_ms, lvgl_driver_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
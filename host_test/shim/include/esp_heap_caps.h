@@ -0,0 +1,53 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\include\esp_heap_caps.h
+ * @Description: 主机测试用 esp_heap_caps.h
+ *
+ * 带 MALLOC_CAP_SPIRAM 的分配走一块模拟 PSRAM 堆（按地址排序的首次适配 + 相邻合并），
+ * 这样 heap_caps_get_largest_free_block() 能反映真实的碎片情况；其余分配直接走 malloc。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MALLOC_CAP_EXEC         (1 << 0)
+#define MALLOC_CAP_32BIT        (1 << 1)
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_DEFAULT      (1 << 12)
+
+/** 模拟 PSRAM 大小（与板载 8MB PSRAM 一致） */
+#define HOST_PSRAM_SIZE         (8 * 1024 * 1024)
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps);
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps);
+void heap_caps_free(void *ptr);
+
+/**
+ * @brief 剩余字节数
+ * @note 只统计模拟 PSRAM；不带 MALLOC_CAP_SPIRAM 时返回一个足够大的常数
+ */
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_total_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+/** 指针是否位于模拟 PSRAM 中 */
+bool esp_ptr_external_ram(const void *p);
+
+#ifdef __cplusplus
+}
+#endif
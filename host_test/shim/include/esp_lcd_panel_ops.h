@@ -0,0 +1,29 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\include\esp_lcd_panel_ops.h
+ * @Description: 主机测试用 esp_lcd_panel_ops.h（只声明发送位图，由测试提供假面板实现）
+ */
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esp_lcd_panel_t esp_lcd_panel_t;
+typedef esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+/**
+ * @brief 发送位图到面板窗口 [x_start, x_end) × [y_start, y_end)
+ * @note 与 ESP-IDF 相同，返回后传输可能仍在进行，color_data 在完成回调前不能改写
+ */
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                    const void *color_data);
+
+#ifdef __cplusplus
+}
+#endif
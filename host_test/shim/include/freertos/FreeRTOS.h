@@ -0,0 +1,85 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\include\freertos\FreeRTOS.h
+ * @Description: 主机测试用 FreeRTOS 子集（基于 pthread）
+ *
+ * 与 ESP-IDF linux 目标的 POSIX 移植不同，这里每个任务是一个真正并发的线程，
+ * 用来暴露多生产者/多核下的竞争问题。只实现组件实际用到的接口：
+ * - 任务：创建（忽略优先级、栈大小和核心）、删除、延时、任务通知（含索引版本）
+ * - 队列与信号量（二值、计数、互斥）
+ * - portMUX 临界区：按线程可重入的自旋锁，持有期间屏蔽线程取消
+ * 节拍固定 1 ms。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+#include <sched.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+
+#define pdFALSE                 ((BaseType_t)0)
+#define pdTRUE                  ((BaseType_t)1)
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define errQUEUE_EMPTY          ((BaseType_t)0)
+#define errQUEUE_FULL           ((BaseType_t)0)
+
+#define configTICK_RATE_HZ                      1000
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2
+#define configMAX_PRIORITIES                    25
+#define configASSERT(x)                         assert(x)
+
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS      ((TickType_t)(1000 / configTICK_RATE_HZ))
+#define portNUM_PROCESSORS      2
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+#define pdTICKS_TO_MS(ticks)    ((TickType_t)(((uint64_t)(ticks) * 1000U) / configTICK_RATE_HZ))
+
+#define portYIELD_FROM_ISR(...)         ((void)0)
+#define portYIELD()                     sched_yield()
+#define IRAM_ATTR
+#define tskNO_AFFINITY                  ((BaseType_t)0x7FFFFFFF)
+
+/** 临界区：按线程可重入的自旋锁 */
+typedef struct {
+    volatile uint32_t owner;        ///< 持有者线程编号，0 表示空闲
+    uint32_t count;                 ///< 重入次数
+    int saved_cancel_state;         ///< 进入前的线程取消状态
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { 0, 0, 0 }
+
+void vPortEnterCritical(portMUX_TYPE *mux);
+void vPortExitCritical(portMUX_TYPE *mux);
+void spinlock_initialize(portMUX_TYPE *mux);
+BaseType_t xPortGetCoreID(void);
+
+#define portMUX_INITIALIZE(mux)         spinlock_initialize(mux)
+#define portENTER_CRITICAL(mux)         vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)          vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)     vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)      vPortExitCritical(mux)
+#define portENTER_CRITICAL_SAFE(mux)    vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_SAFE(mux)     vPortExitCritical(mux)
+#define taskENTER_CRITICAL(mux)         vPortEnterCritical(mux)
+#define taskEXIT_CRITICAL(mux)          vPortExitCritical(mux)
+#define taskENTER_CRITICAL_ISR(mux)     vPortEnterCritical(mux)
+#define taskEXIT_CRITICAL_ISR(mux)      vPortExitCritical(mux)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\include\freertos\queue.h
+ * @Description: 主机测试用 FreeRTOS 队列接口（互斥锁 + 条件变量 + 环形缓冲区）
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct host_queue_s *QueueHandle_t;
+
+#define queueSEND_TO_BACK       ((BaseType_t)0)
+#define queueSEND_TO_FRONT      ((BaseType_t)1)
+#define queueOVERWRITE          ((BaseType_t)2)
+
+QueueHandle_t xQueueCreateCounting(UBaseType_t length, UBaseType_t item_size, UBaseType_t initial);
+BaseType_t xQueueGenericSend(QueueHandle_t queue, const void *item, TickType_t ticks, BaseType_t position);
+BaseType_t xQueueGenericReceive(QueueHandle_t queue, void *item, TickType_t ticks, bool peek);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+void vQueueDelete(QueueHandle_t queue);
+
+#define xQueueCreate(length, item_size)         xQueueCreateCounting(length, item_size, 0)
+#define xQueueSend(q, item, ticks)              xQueueGenericSend(q, item, ticks, queueSEND_TO_BACK)
+#define xQueueSendToBack(q, item, ticks)        xQueueGenericSend(q, item, ticks, queueSEND_TO_BACK)
+#define xQueueSendToFront(q, item, ticks)       xQueueGenericSend(q, item, ticks, queueSEND_TO_FRONT)
+#define xQueueOverwrite(q, item)                xQueueGenericSend(q, item, 0, queueOVERWRITE)
+#define xQueueReceive(q, item, ticks)           xQueueGenericReceive(q, item, ticks, false)
+#define xQueuePeek(q, item, ticks)              xQueueGenericReceive(q, item, ticks, true)
+#define xQueueSendFromISR(q, item, woken)       ((void)(woken), xQueueGenericSend(q, item, 0, queueSEND_TO_BACK))
+#define xQueueSendToBackFromISR(q, item, woken) ((void)(woken), xQueueGenericSend(q, item, 0, queueSEND_TO_BACK))
+#define xQueueOverwriteFromISR(q, item, woken)  ((void)(woken), xQueueGenericSend(q, item, 0, queueOVERWRITE))
+#define xQueueReceiveFromISR(q, item, woken)    ((void)(woken), xQueueGenericReceive(q, item, 0, false))
+#define uxQueueMessagesWaitingFromISR(q)        uxQueueMessagesWaiting(q)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,33 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\include\freertos\semphr.h
+ * @Description: 主机测试用 FreeRTOS 信号量接口（以零长度条目的队列实现）
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+/** 互斥量不支持优先级继承，也不检查持有者 */
+#define xSemaphoreCreateMutex()                 xQueueCreateCounting(1, 0, 1)
+#define xSemaphoreCreateBinary()                xQueueCreateCounting(1, 0, 0)
+#define xSemaphoreCreateCounting(max, initial)  xQueueCreateCounting(max, 0, initial)
+#define xSemaphoreTake(sem, ticks)              xQueueGenericReceive(sem, NULL, ticks, false)
+#define xSemaphoreGive(sem)                     xQueueGenericSend(sem, NULL, 0, queueSEND_TO_BACK)
+#define xSemaphoreTakeFromISR(sem, woken)       ((void)(woken), xQueueGenericReceive(sem, NULL, 0, false))
+#define xSemaphoreGiveFromISR(sem, woken)       ((void)(woken), xQueueGenericSend(sem, NULL, 0, queueSEND_TO_BACK))
+#define uxSemaphoreGetCount(sem)                uxQueueMessagesWaiting(sem)
+#define vSemaphoreDelete(sem)                   vQueueDelete(sem)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,93 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\include\freertos\task.h
+ * @Description: 主机测试用 FreeRTOS 任务接口（pthread 实现）
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct host_task_s *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+typedef struct {
+    uint8_t opaque;
+} StaticTask_t;
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *out_task,
+                                   BaseType_t core_id);
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                           void *arg, UBaseType_t priority, StackType_t *stack,
+                                           StaticTask_t *tcb, BaseType_t core_id);
+
+#define xTaskCreate(fn, name, stack, arg, prio, out) \
+    xTaskCreatePinnedToCore(fn, name, stack, arg, prio, out, tskNO_AFFINITY)
+#define xTaskCreateStatic(fn, name, stack, arg, prio, stack_buf, tcb) \
+    xTaskCreateStaticPinnedToCore(fn, name, stack, arg, prio, stack_buf, tcb, tskNO_AFFINITY)
+
+/**
+ * @brief 删除任务
+ * @note 删除其他任务时取消并回收其线程（阻塞点在等待处，持有 portMUX 时不会被取消）
+ */
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *prev_wake, TickType_t increment);
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+const char *pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+void vTaskSuspendAll(void);
+BaseType_t xTaskResumeAll(void);
+
+BaseType_t xTaskGenericNotify(TaskHandle_t task, UBaseType_t index, uint32_t value,
+                              eNotifyAction action, uint32_t *prev_value);
+BaseType_t xTaskGenericNotifyWait(UBaseType_t index, uint32_t clear_on_entry, uint32_t clear_on_exit,
+                                  uint32_t *value, TickType_t ticks);
+uint32_t ulTaskGenericNotifyTake(UBaseType_t index, BaseType_t clear_on_exit, TickType_t ticks);
+uint32_t ulTaskGenericNotifyValueClear(TaskHandle_t task, UBaseType_t index, uint32_t bits);
+
+#define xTaskNotifyGive(task) \
+    xTaskGenericNotify(task, 0, 0, eIncrement, NULL)
+#define xTaskNotifyGiveIndexed(task, index) \
+    xTaskGenericNotify(task, index, 0, eIncrement, NULL)
+#define vTaskNotifyGiveFromISR(task, woken) \
+    ((void)(woken), (void)xTaskGenericNotify(task, 0, 0, eIncrement, NULL))
+#define vTaskNotifyGiveIndexedFromISR(task, index, woken) \
+    ((void)(woken), (void)xTaskGenericNotify(task, index, 0, eIncrement, NULL))
+#define xTaskNotify(task, value, action) \
+    xTaskGenericNotify(task, 0, value, action, NULL)
+#define xTaskNotifyIndexed(task, index, value, action) \
+    xTaskGenericNotify(task, index, value, action, NULL)
+#define xTaskNotifyFromISR(task, value, action, woken) \
+    ((void)(woken), xTaskGenericNotify(task, 0, value, action, NULL))
+#define xTaskNotifyWait(clear_entry, clear_exit, value, ticks) \
+    xTaskGenericNotifyWait(0, clear_entry, clear_exit, value, ticks)
+#define xTaskNotifyWaitIndexed(index, clear_entry, clear_exit, value, ticks) \
+    xTaskGenericNotifyWait(index, clear_entry, clear_exit, value, ticks)
+#define ulTaskNotifyTake(clear, ticks) \
+    ulTaskGenericNotifyTake(0, clear, ticks)
+#define ulTaskNotifyTakeIndexed(index, clear, ticks) \
+    ulTaskGenericNotifyTake(index, clear, ticks)
+#define ulTaskNotifyValueClear(task, bits) \
+    ulTaskGenericNotifyValueClear(task, 0, bits)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,56 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\include\lvgl.h
+ * @Description: 主机测试用 lvgl.h（只有区域类型、几何宏与定时器常量，与 LVGL 9.2 定义一致）
+ *
+ * 主机测试不编译 LVGL，只给不访问显示对象的驱动模块（xn_lvgl_tile / xn_lvgl_area / xn_lvgl_flush /
+ * xn_lvgl_wake）使用；显示、输入设备等类型只声明不定义，引用它们的源码不能在这里编译。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LV_MIN(a, b)            ((a) < (b) ? (a) : (b))
+#define LV_MAX(a, b)            ((a) > (b) ? (a) : (b))
+#define LV_CLAMP(min, val, max) (LV_MAX(min, (LV_MIN(val, max))))
+
+#define LV_NO_TIMER_READY       0xFFFFFFFF      // lv_timer_handler() 没有就绪定时器时的返回值
+
+typedef struct {
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+} lv_area_t;
+
+typedef enum {
+    LV_DISPLAY_RENDER_MODE_PARTIAL,
+    LV_DISPLAY_RENDER_MODE_DIRECT,
+    LV_DISPLAY_RENDER_MODE_FULL,
+} lv_display_render_mode_t;
+
+typedef struct _lv_display_t lv_display_t;
+typedef struct _lv_indev_t lv_indev_t;
+typedef struct _lv_indev_data_t lv_indev_data_t;
+
+static inline int32_t lv_area_get_width(const lv_area_t *area)
+{
+    return area->x2 - area->x1 + 1;
+}
+
+static inline int32_t lv_area_get_height(const lv_area_t *area)
+{
+    return area->y2 - area->y1 + 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
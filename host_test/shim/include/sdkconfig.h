@@ -0,0 +1,13 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\include\sdkconfig.h
+ * @Description: 主机测试用 sdkconfig（等同 ESP-IDF linux 目标）
+ */
+#pragma once
+
+#define CONFIG_IDF_TARGET_LINUX             1
+#define CONFIG_IDF_TARGET                   "linux"
+#define CONFIG_FREERTOS_HZ                  1000
@@ -0,0 +1,69 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\src\esp_host.c
+ * @Description: 主机测试用 esp_err / esp_log / esp_timer 实现
+ */
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+
+static esp_log_level_t s_log_level = ESP_LOG_INFO;
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK: return "ESP_OK";
+    case ESP_FAIL: return "ESP_FAIL";
+    case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+    case ESP_ERR_NOT_FINISHED: return "ESP_ERR_NOT_FINISHED";
+    default: return "UNKNOWN ERROR";
+    }
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    (void)tag;
+    __atomic_store_n(&s_log_level, level, __ATOMIC_RELAXED);
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    if (level > __atomic_load_n(&s_log_level, __ATOMIC_RELAXED)) {
+        return;
+    }
+    static const char letters[] = "NEWIDV";
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    // 一次写出整行，避免多线程日志交错
+    fprintf(stderr, "%c (%lld) %s: %s\n", letters[level], (long long)(esp_timer_get_time() / 1000), tag, line);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    static int64_t base_us = 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    int64_t now = (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    int64_t expected = 0;
+    __atomic_compare_exchange_n(&base_us, &expected, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    return now - __atomic_load_n(&base_us, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,576 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\src\freertos_host.c
+ * @Description: 主机测试用 FreeRTOS 子集实现（pthread）
+ *
+ * 所有阻塞等待都用 pthread_cond_timedwait（取消点），并注册清理函数释放互斥锁，
+ * 所以 vTaskDelete() 删除其他任务时，被删任务可以停在任何等待处。
+ * 任务结构体在被其他任务删除时回收；自删除的任务结构体不回收（句柄在删除后仍可能被读到）。
+ */
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct host_task_s {
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    char name[16];
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify_value[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+    bool notify_pending[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+    bool joinable;                  ///< 由 xTaskCreate 创建（可被其他任务删除并回收）
+    bool self_deleted;              ///< 已自删除（线程已分离）
+    bool deleting;                  ///< 正在被其他任务删除
+};
+
+struct host_queue_s {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t *storage;
+    size_t item_size;
+    size_t length;
+    size_t count;
+    size_t head;
+};
+
+static __thread struct host_task_s *s_current = NULL;
+static __thread uint32_t s_thread_id = 0;
+static uint32_t s_next_thread_id = 1;
+static pthread_mutex_t s_suspend_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*********************
+ * 时间
+ *********************/
+
+static uint64_t host_now_ms(void)
+{
+    static uint64_t base_ms = 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+    uint64_t expected = 0;
+    __atomic_compare_exchange_n(&base_ms, &expected, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    return now - __atomic_load_n(&base_ms, __ATOMIC_RELAXED);
+}
+
+/** 计算超时的绝对时间（条件变量使用 CLOCK_MONOTONIC） */
+static void host_deadline(TickType_t ticks, struct timespec *ts)
+{
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    uint64_t ms = pdTICKS_TO_MS(ticks);
+    ts->tv_sec += (time_t)(ms / 1000);
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static void host_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/**
+ * @brief 在持有 lock 时等待条件变量
+ * @return false 超时
+ */
+static bool host_cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, TickType_t ticks,
+                           const struct timespec *deadline)
+{
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+static void host_unlock_cleanup(void *lock)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)lock);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)host_now_ms();
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0) {
+        sched_yield();
+        return;
+    }
+    uint64_t ms = pdTICKS_TO_MS(ticks);
+    struct timespec ts = { .tv_sec = (time_t)(ms / 1000), .tv_nsec = (long)(ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+void vTaskDelayUntil(TickType_t *prev_wake, TickType_t increment)
+{
+    TickType_t target = *prev_wake + increment;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(target - now) > 0) {
+        vTaskDelay(target - now);
+    }
+    *prev_wake = target;
+}
+
+/*********************
+ * 临界区
+ *********************/
+
+static uint32_t host_thread_id(void)
+{
+    if (s_thread_id == 0) {
+        s_thread_id = __atomic_fetch_add(&s_next_thread_id, 1, __ATOMIC_RELAXED);
+    }
+    return s_thread_id;
+}
+
+void spinlock_initialize(portMUX_TYPE *mux)
+{
+    mux->owner = 0;
+    mux->count = 0;
+    mux->saved_cancel_state = 0;
+}
+
+void vPortEnterCritical(portMUX_TYPE *mux)
+{
+    uint32_t self = host_thread_id();
+    if (__atomic_load_n(&mux->owner, __ATOMIC_ACQUIRE) == self) {
+        mux->count++;
+        return;
+    }
+
+    int cancel_state;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancel_state);
+    uint32_t expected = 0;
+    while (!__atomic_compare_exchange_n(&mux->owner, &expected, self, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        expected = 0;
+        sched_yield();
+    }
+    mux->count = 1;
+    mux->saved_cancel_state = cancel_state;
+}
+
+void vPortExitCritical(portMUX_TYPE *mux)
+{
+    assert(mux->owner == host_thread_id() && mux->count > 0);
+    if (--mux->count > 0) {
+        return;
+    }
+    int cancel_state = mux->saved_cancel_state;
+    __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+    pthread_setcancelstate(cancel_state, NULL);
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+void vTaskSuspendAll(void)
+{
+    pthread_mutex_lock(&s_suspend_lock);
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    pthread_mutex_unlock(&s_suspend_lock);
+    return pdFALSE;
+}
+
+/*********************
+ * 任务
+ *********************/
+
+static struct host_task_s *host_task_alloc(TaskFunction_t fn, const char *name, void *arg)
+{
+    struct host_task_s *task = calloc(1, sizeof(*task));
+    if (!task) {
+        return NULL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    snprintf(task->name, sizeof(task->name), "%s", name ? name : "");
+    pthread_mutex_init(&task->lock, NULL);
+    host_cond_init(&task->cond);
+    return task;
+}
+
+static void *host_task_entry(void *arg)
+{
+    struct host_task_s *task = arg;
+    s_current = task;
+    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
+    task->fn(task->arg);
+
+    // FreeRTOS 任务函数不允许返回
+    fprintf(stderr, "task '%s' returned without vTaskDelete\n", task->name);
+    abort();
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *out_task,
+                                   BaseType_t core_id)
+{
+    (void)stack_depth;
+    (void)priority;
+    (void)core_id;
+
+    struct host_task_s *task = host_task_alloc(fn, name, arg);
+    if (!task) {
+        return pdFAIL;
+    }
+    task->joinable = true;
+
+    // 先发布句柄再启动线程：任务里可能立即用句柄与自身比较
+    if (out_task) {
+        *out_task = task;
+    }
+    if (pthread_create(&task->thread, NULL, host_task_entry, task) != 0) {
+        if (out_task) {
+            *out_task = NULL;
+        }
+        free(task);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                           void *arg, UBaseType_t priority, StackType_t *stack,
+                                           StaticTask_t *tcb, BaseType_t core_id)
+{
+    (void)stack;
+    (void)tcb;
+    TaskHandle_t task = NULL;
+    xTaskCreatePinnedToCore(fn, name, stack_depth, arg, priority, &task, core_id);
+    return task;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    // 非 xTaskCreate 创建的线程（如 main）首次调用时补建任务结构体
+    if (!s_current) {
+        s_current = host_task_alloc(NULL, "main", NULL);
+        if (s_current) {
+            s_current->thread = pthread_self();
+        }
+    }
+    return s_current;
+}
+
+const char *pcTaskGetName(TaskHandle_t task)
+{
+    task = task ? task : xTaskGetCurrentTaskHandle();
+    return task ? task->name : "";
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    (void)task;
+    return 4096;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    struct host_task_s *self = xTaskGetCurrentTaskHandle();
+    if (!task || task == self) {
+        pthread_mutex_lock(&self->lock);
+        bool deleting = self->deleting;
+        if (!deleting && self->joinable) {
+            self->self_deleted = true;
+            pthread_detach(pthread_self());
+        }
+        pthread_mutex_unlock(&self->lock);
+        pthread_exit(NULL);
+    }
+
+    pthread_mutex_lock(&task->lock);
+    if (task->self_deleted || task->deleting || !task->joinable) {
+        pthread_mutex_unlock(&task->lock);
+        return;
+    }
+    task->deleting = true;
+    pthread_mutex_unlock(&task->lock);
+
+    pthread_cancel(task->thread);
+    pthread_join(task->thread, NULL);
+    pthread_mutex_destroy(&task->lock);
+    pthread_cond_destroy(&task->cond);
+    free(task);
+}
+
+/*********************
+ * 任务通知
+ *********************/
+
+BaseType_t xTaskGenericNotify(TaskHandle_t task, UBaseType_t index, uint32_t value,
+                              eNotifyAction action, uint32_t *prev_value)
+{
+    assert(task && index < configTASK_NOTIFICATION_ARRAY_ENTRIES);
+    BaseType_t ret = pdPASS;
+
+    pthread_mutex_lock(&task->lock);
+    if (prev_value) {
+        *prev_value = task->notify_value[index];
+    }
+    switch (action) {
+    case eSetBits:
+        task->notify_value[index] |= value;
+        break;
+    case eIncrement:
+        task->notify_value[index]++;
+        break;
+    case eSetValueWithOverwrite:
+        task->notify_value[index] = value;
+        break;
+    case eSetValueWithoutOverwrite:
+        if (task->notify_pending[index]) {
+            ret = pdFAIL;
+        } else {
+            task->notify_value[index] = value;
+        }
+        break;
+    default:
+        break;
+    }
+    task->notify_pending[index] = true;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return ret;
+}
+
+BaseType_t xTaskGenericNotifyWait(UBaseType_t index, uint32_t clear_on_entry, uint32_t clear_on_exit,
+                                  uint32_t *value, TickType_t ticks)
+{
+    struct host_task_s *self = xTaskGetCurrentTaskHandle();
+    assert(index < configTASK_NOTIFICATION_ARRAY_ENTRIES);
+    struct timespec deadline;
+    host_deadline(ticks, &deadline);
+    BaseType_t ret = pdTRUE;
+
+    pthread_mutex_lock(&self->lock);
+    pthread_cleanup_push(host_unlock_cleanup, &self->lock);
+    if (!self->notify_pending[index]) {
+        self->notify_value[index] &= ~clear_on_entry;
+    }
+    while (!self->notify_pending[index]) {
+        if (ticks == 0 || !host_cond_wait(&self->cond, &self->lock, ticks, &deadline)) {
+            if (!self->notify_pending[index]) {
+                ret = pdFALSE;
+                break;
+            }
+        }
+    }
+    if (value) {
+        *value = self->notify_value[index];
+    }
+    if (ret == pdTRUE) {
+        self->notify_value[index] &= ~clear_on_exit;
+    }
+    self->notify_pending[index] = false;
+    pthread_cleanup_pop(1);
+    return ret;
+}
+
+uint32_t ulTaskGenericNotifyTake(UBaseType_t index, BaseType_t clear_on_exit, TickType_t ticks)
+{
+    struct host_task_s *self = xTaskGetCurrentTaskHandle();
+    assert(index < configTASK_NOTIFICATION_ARRAY_ENTRIES);
+    struct timespec deadline;
+    host_deadline(ticks, &deadline);
+
+    pthread_mutex_lock(&self->lock);
+    pthread_cleanup_push(host_unlock_cleanup, &self->lock);
+    while (self->notify_value[index] == 0) {
+        if (ticks == 0 || !host_cond_wait(&self->cond, &self->lock, ticks, &deadline)) {
+            break;
+        }
+    }
+    pthread_cleanup_pop(0);
+    uint32_t value = self->notify_value[index];
+    if (value) {
+        self->notify_value[index] = clear_on_exit ? 0 : value - 1;
+    }
+    self->notify_pending[index] = false;
+    pthread_mutex_unlock(&self->lock);
+    return value;
+}
+
+uint32_t ulTaskGenericNotifyValueClear(TaskHandle_t task, UBaseType_t index, uint32_t bits)
+{
+    task = task ? task : xTaskGetCurrentTaskHandle();
+    pthread_mutex_lock(&task->lock);
+    uint32_t value = task->notify_value[index];
+    task->notify_value[index] &= ~bits;
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+/*********************
+ * 队列与信号量
+ *********************/
+
+QueueHandle_t xQueueCreateCounting(UBaseType_t length, UBaseType_t item_size, UBaseType_t initial)
+{
+    if (length == 0 || initial > length) {
+        return NULL;
+    }
+    struct host_queue_s *q = calloc(1, sizeof(*q));
+    if (!q) {
+        return NULL;
+    }
+    if (item_size) {
+        q->storage = calloc(length, item_size);
+        if (!q->storage) {
+            free(q);
+            return NULL;
+        }
+    }
+    q->item_size = item_size;
+    q->length = length;
+    q->count = initial;
+    pthread_mutex_init(&q->lock, NULL);
+    host_cond_init(&q->not_empty);
+    host_cond_init(&q->not_full);
+    return q;
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t q, const void *item, TickType_t ticks, BaseType_t position)
+{
+    assert(q);
+    struct timespec deadline;
+    host_deadline(ticks, &deadline);
+    BaseType_t ret = pdPASS;
+
+    pthread_mutex_lock(&q->lock);
+    pthread_cleanup_push(host_unlock_cleanup, &q->lock);
+    if (position == queueOVERWRITE && q->count == q->length) {
+        q->count--;     // 覆盖写只用于长度 1 的队列
+    }
+    while (q->count == q->length) {
+        if (ticks == 0 || !host_cond_wait(&q->not_full, &q->lock, ticks, &deadline)) {
+            if (q->count == q->length) {
+                ret = errQUEUE_FULL;
+                break;
+            }
+        }
+    }
+    if (ret == pdPASS) {
+        if (q->item_size) {
+            size_t slot;
+            if (position == queueSEND_TO_FRONT) {
+                q->head = (q->head + q->length - 1) % q->length;
+                slot = q->head;
+            } else {
+                slot = (q->head + q->count) % q->length;
+            }
+            memcpy(q->storage + slot * q->item_size, item, q->item_size);
+        }
+        q->count++;
+        pthread_cond_signal(&q->not_empty);
+    }
+    pthread_cleanup_pop(1);
+    return ret;
+}
+
+BaseType_t xQueueGenericReceive(QueueHandle_t q, void *item, TickType_t ticks, bool peek)
+{
+    assert(q);
+    struct timespec deadline;
+    host_deadline(ticks, &deadline);
+    BaseType_t ret = pdPASS;
+
+    pthread_mutex_lock(&q->lock);
+    pthread_cleanup_push(host_unlock_cleanup, &q->lock);
+    while (q->count == 0) {
+        if (ticks == 0 || !host_cond_wait(&q->not_empty, &q->lock, ticks, &deadline)) {
+            if (q->count == 0) {
+                ret = errQUEUE_EMPTY;
+                break;
+            }
+        }
+    }
+    if (ret == pdPASS) {
+        if (q->item_size && item) {
+            memcpy(item, q->storage + q->head * q->item_size, q->item_size);
+        }
+        if (!peek) {
+            if (q->item_size) {
+                q->head = (q->head + 1) % q->length;
+            }
+            q->count--;
+            pthread_cond_signal(&q->not_full);
+        } else {
+            pthread_cond_signal(&q->not_empty);
+        }
+    }
+    pthread_cleanup_pop(1);
+    return ret;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    pthread_mutex_lock(&q->lock);
+    UBaseType_t count = (UBaseType_t)q->count;
+    pthread_mutex_unlock(&q->lock);
+    return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q)
+{
+    pthread_mutex_lock(&q->lock);
+    UBaseType_t spaces = (UBaseType_t)(q->length - q->count);
+    pthread_mutex_unlock(&q->lock);
+    return spaces;
+}
+
+BaseType_t xQueueReset(QueueHandle_t q)
+{
+    pthread_mutex_lock(&q->lock);
+    q->count = 0;
+    q->head = 0;
+    pthread_cond_broadcast(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+    return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t q)
+{
+    if (!q) {
+        return;
+    }
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+    free(q->storage);
+    free(q);
+}
@@ -0,0 +1,236 @@
+/*
+ * @Author: xingnian jixingnian@gmail.com
+ * @Date: 2025-12-09 10:00:00
+ * @LastEditors: xingnian jixingnian@gmail.com
+ * @LastEditTime: 2025-12-09 10:00:00
+ * @FilePath: \xn_esp32_dice\host_test\shim\src\heap_caps_host.c
+ * @Description: 主机测试用 heap_caps 实现（模拟 PSRAM 堆）
+ *
+ * 模拟 PSRAM 是一块 HOST_PSRAM_SIZE 的连续内存，按 16 字节对齐切块。
+ * 空闲块按地址排序成链表，分配取首个足够大的块，释放时与相邻空闲块合并，
+ * 所以反复分配/释放不同尺寸时最大空闲块会像真实堆一样变小。
+ */
+#include "esp_heap_caps.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_HEAP_ALIGN     16
+#define HOST_HEAP_MAGIC     0x50535241u     // "PSRA"
+
+typedef struct host_block_s {
+    size_t size;                    ///< 含头部的块大小
+    uint32_t magic;                 ///< 已分配块的标记
+    struct host_block_s *next;      ///< 下一个空闲块（仅空闲块有效）
+} host_block_t;
+
+#define HOST_HEADER_SIZE    ((sizeof(host_block_t) + HOST_HEAP_ALIGN - 1) & ~(size_t)(HOST_HEAP_ALIGN - 1))
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t *s_base = NULL;
+static host_block_t *s_free_list = NULL;
+static size_t s_free_bytes = 0;
+static size_t s_min_free_bytes = 0;
+
+static void host_heap_init_locked(void)
+{
+    if (s_base) {
+        return;
+    }
+    s_base = aligned_alloc(HOST_HEAP_ALIGN, HOST_PSRAM_SIZE);
+    assert(s_base);
+    s_free_list = (host_block_t *)s_base;
+    s_free_list->size = HOST_PSRAM_SIZE;
+    s_free_list->magic = 0;
+    s_free_list->next = NULL;
+    s_free_bytes = HOST_PSRAM_SIZE;
+    s_min_free_bytes = HOST_PSRAM_SIZE;
+}
+
+bool esp_ptr_external_ram(const void *p)
+{
+    return s_base && (const uint8_t *)p >= s_base && (const uint8_t *)p < s_base + HOST_PSRAM_SIZE;
+}
+
+static void *psram_malloc(size_t size)
+{
+    size_t need = HOST_HEADER_SIZE + ((size + HOST_HEAP_ALIGN - 1) & ~(size_t)(HOST_HEAP_ALIGN - 1));
+    void *ptr = NULL;
+
+    pthread_mutex_lock(&s_lock);
+    host_heap_init_locked();
+    for (host_block_t **link = &s_free_list; *link; link = &(*link)->next) {
+        host_block_t *block = *link;
+        if (block->size < need) {
+            continue;
+        }
+        if (block->size - need >= HOST_HEADER_SIZE + HOST_HEAP_ALIGN) {
+            host_block_t *rest = (host_block_t *)((uint8_t *)block + need);
+            rest->size = block->size - need;
+            rest->magic = 0;
+            rest->next = block->next;
+            *link = rest;
+            block->size = need;
+        } else {
+            *link = block->next;
+        }
+        block->magic = HOST_HEAP_MAGIC;
+        s_free_bytes -= block->size;
+        if (s_free_bytes < s_min_free_bytes) {
+            s_min_free_bytes = s_free_bytes;
+        }
+        ptr = (uint8_t *)block + HOST_HEADER_SIZE;
+        break;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ptr;
+}
+
+static void psram_free(void *ptr)
+{
+    host_block_t *block = (host_block_t *)((uint8_t *)ptr - HOST_HEADER_SIZE);
+    assert(block->magic == HOST_HEAP_MAGIC);
+
+    pthread_mutex_lock(&s_lock);
+    block->magic = 0;
+    s_free_bytes += block->size;
+
+    // 按地址插入并与前后相邻块合并
+    host_block_t *prev = NULL;
+    host_block_t *cur = s_free_list;
+    while (cur && cur < block) {
+        prev = cur;
+        cur = cur->next;
+    }
+    block->next = cur;
+    if (cur && (uint8_t *)block + block->size == (uint8_t *)cur) {
+        block->size += cur->size;
+        block->next = cur->next;
+    }
+    if (prev && (uint8_t *)prev + prev->size == (uint8_t *)block) {
+        prev->size += block->size;
+        prev->next = block->next;
+    } else if (prev) {
+        prev->next = block;
+    } else {
+        s_free_list = block;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    if (size == 0) {
+        return NULL;
+    }
+    if (caps & MALLOC_CAP_SPIRAM) {
+        return psram_malloc(size);
+    }
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    if (size && n > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = heap_caps_malloc(n * size, caps);
+    if (ptr) {
+        memset(ptr, 0, n * size);
+    }
+    return ptr;
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    if (alignment <= HOST_HEAP_ALIGN) {
+        return heap_caps_malloc(size, caps);
+    }
+    if (caps & MALLOC_CAP_SPIRAM) {
+        return NULL;    // 模拟 PSRAM 只支持 16 字节对齐
+    }
+    return aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+}
+
+void heap_caps_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    if (esp_ptr_external_ram(ptr)) {
+        psram_free(ptr);
+    } else {
+        free(ptr);
+    }
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps)
+{
+    if (!ptr) {
+        return heap_caps_malloc(size, caps);
+    }
+    if (size == 0) {
+        heap_caps_free(ptr);
+        return NULL;
+    }
+    if (!esp_ptr_external_ram(ptr) && !(caps & MALLOC_CAP_SPIRAM)) {
+        return realloc(ptr, size);
+    }
+
+    size_t old_size = esp_ptr_external_ram(ptr)
+                    ? ((host_block_t *)((uint8_t *)ptr - HOST_HEADER_SIZE))->size - HOST_HEADER_SIZE
+                    : size;
+    void *next = heap_caps_malloc(size, caps);
+    if (next) {
+        memcpy(next, ptr, old_size < size ? old_size : size);
+        heap_caps_free(ptr);
+    }
+    return next;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    if (!(caps & MALLOC_CAP_SPIRAM)) {
+        return 256 * 1024;
+    }
+    pthread_mutex_lock(&s_lock);
+    host_heap_init_locked();
+    size_t bytes = s_free_bytes;
+    pthread_mutex_unlock(&s_lock);
+    return bytes;
+}
+
+size_t heap_caps_get_total_size(uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? HOST_PSRAM_SIZE : 512 * 1024;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    if (!(caps & MALLOC_CAP_SPIRAM)) {
+        return 256 * 1024;
+    }
+    pthread_mutex_lock(&s_lock);
+    host_heap_init_locked();
+    size_t bytes = s_min_free_bytes;
+    pthread_mutex_unlock(&s_lock);
+    return bytes;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    if (!(caps & MALLOC_CAP_SPIRAM)) {
+        return 128 * 1024;
+    }
+    size_t largest = 0;
+    pthread_mutex_lock(&s_lock);
+    host_heap_init_locked();
+    for (host_block_t *block = s_free_list; block; block = block->next) {
+        if (block->size > largest) {
+            largest = block->size;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return largest > HOST_HEADER_SIZE ? largest - HOST_HEADER_SIZE : 0;
+}
@@ -42,6 +42,7 @@ void audio_config_app_build(audio_mgr_config_t *cfg,
     cfg->hw_config.mic.din_gpio = 39;         // 数据输入引脚
     cfg->hw_config.mic.sample_rate = 16000;   // 采样率 16kHz
     cfg->hw_config.mic.bits = 32;             // 32 位采样深度
+    cfg->hw_config.mic.channels = 1;          // 单麦克风（双麦克风改为 2，并将 AFE 输入格式设为 "MMR"）
 
     // ========== 扬声器硬件配置 ==========
     cfg->hw_config.speaker.port = 0;          // I2S 端口 0
@@ -74,6 +75,8 @@ void audio_config_app_build(audio_mgr_config_t *cfg,
     cfg->afe_config.ns_enabled = false;        // 启用降噪（NS）
     cfg->afe_config.agc_enabled = false;       // 启用自动增益控制（AGC）
     cfg->afe_config.afe_mode = 1;             // AFE 模式：高质量
+    cfg->afe_config.input_format = "MR";      // AFE 输入格式：麦克风 + 回采
+    cfg->afe_config.engine = AFE_ENGINE_ESP_SR; // AFE 引擎：esp-sr（AFE_ENGINE_REFERENCE 为无模型参考实现）
 
     // ========== 回调配置 ==========
     cfg->event_callback = event_cb;           // 设置事件回调函数
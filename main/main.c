@@ -89,6 +89,9 @@ void app_main(void)
     s_app_state = APP_STATE_IDLE_COOL;
     lottie_manager_play_anim(LOTTIE_ANIM_COOL);
 
+    // 待机时预加载骰子动画，点击后只需交换可见性
+    lottie_manager_preload_anim(LOTTIE_ANIM_DICE);
+
     ESP_LOGI(TAG, "enter idle state, play COOL anim");
 }
 